@@ -238,6 +238,10 @@ def Environment():
                                   allowed_values = ('cusp', 'mkl'))
   vars.Add(hostspblas_variable)
 
+  # add variables to read and write compressed MatrixMarket files
+  vars.Add(BoolVariable('zlib', 'Support gzip compressed MatrixMarket files (requires zlib)', 0))
+  vars.Add(BoolVariable('zstd', 'Support zstd compressed MatrixMarket files (requires libzstd)', 0))
+
   # create an Environment
   env = OldEnvironment(tools = getTools(), variables = vars)
 
@@ -277,6 +281,18 @@ def Environment():
   # XXX ideally this gets handled in nvcc.py if possible
   env.Append(LIBS = 'cudart')
 
+  # the solver checkpoint writer and the compressed file codecs run in POSIX threads
+  if os.name == 'posix':
+    env.Append(LIBS = ['pthread'])
+
+  # the compression codecs used by cusp::io
+  if env['zlib']:
+    env.Append(CPPDEFINES = ['CUSP_USE_ZLIB'])
+    env.Append(LIBS = ['z'])
+  if env['zstd']:
+    env.Append(CPPDEFINES = ['CUSP_USE_ZSTD'])
+    env.Append(LIBS = ['zstd'])
+
   if env['backend'] == 'ocelot':
     if os.name == 'posix':
       env.Append(LIBPATH = ['/usr/local/lib'])
@@ -0,0 +1,331 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file composite_operator.h
+ *  \brief Lazy expressions of linear operators
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+namespace cusp
+{
+
+// forward definitions
+template <typename LinearOperator> class scaled_operator;
+template <typename LinearOperator> class shifted_operator;
+template <typename Array, typename LinearOperator> class diagonal_scaled_operator;
+template <typename LinearOperator1, typename LinearOperator2> class sum_operator;
+template <typename LinearOperator1, typename LinearOperator2> class product_operator;
+template <typename Matrix> class transpose_operator;
+
+namespace detail
+{
+
+// matrices and other user operators are referenced, nested expressions
+// are small and usually temporaries, so they are held by value
+template <typename T>
+struct operator_operand { typedef const T& type; };
+
+template <typename A>
+struct operator_operand< cusp::scaled_operator<A> > { typedef const cusp::scaled_operator<A> type; };
+
+template <typename A>
+struct operator_operand< cusp::shifted_operator<A> > { typedef const cusp::shifted_operator<A> type; };
+
+template <typename D, typename A>
+struct operator_operand< cusp::diagonal_scaled_operator<D,A> > { typedef const cusp::diagonal_scaled_operator<D,A> type; };
+
+template <typename A, typename B>
+struct operator_operand< cusp::sum_operator<A,B> > { typedef const cusp::sum_operator<A,B> type; };
+
+template <typename A, typename B>
+struct operator_operand< cusp::product_operator<A,B> > { typedef const cusp::product_operator<A,B> type; };
+
+template <typename A>
+struct operator_operand< cusp::transpose_operator<A> > { typedef const cusp::transpose_operator<A> type; };
+
+} // end namespace detail
+
+/*! \addtogroup composite_operators Composite Operators
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! \p scaled_operator : the operator <tt>alpha * A</tt>
+ *
+ *  Like the other composite operators, \p scaled_operator is lazy:
+ *  nothing is computed or copied when it is formed, and applying it
+ *  with \p cusp::multiply evaluates the whole expression.  When \c A
+ *  is a \p csr_matrix in host memory the scaling is folded into the
+ *  matrix-vector product, otherwise the product is scaled in place.
+ *  In both cases no temporary vector is needed.
+ *
+ *  Matrices and user-defined operators are held by reference and must
+ *  outlive the expression; nested expressions are held by value.  The
+ *  input and output vectors must not alias.
+ *
+ *  \tparam LinearOperator matrix or linear operator
+ *
+ *  The following code snippet demonstrates how to solve a shifted
+ *  system <tt>(A - sigma I) x = b</tt> without forming the matrix.
+ *
+ *  \code
+ *  #include <cusp/composite_operator.h>
+ *  ...
+ *
+ *  // A - sigma * I
+ *  cusp::shifted_operator< cusp::csr_matrix<int,float,cusp::device_memory> >
+ *      A_shifted = cusp::make_shifted_operator(A, -sigma);
+ *
+ *  cusp::krylov::gmres(A_shifted, x, b, monitor);
+ *  \endcode
+ */
+template <typename LinearOperator>
+class scaled_operator
+    : public cusp::linear_operator<typename LinearOperator::value_type,
+                                   typename LinearOperator::memory_space,
+                                   typename LinearOperator::index_type>
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef cusp::linear_operator<ValueType,
+                                  typename LinearOperator::memory_space,
+                                  typename LinearOperator::index_type> Parent;
+
+public:
+    typename cusp::detail::operator_operand<LinearOperator>::type A;
+    ValueType alpha;
+
+    scaled_operator(const LinearOperator& A, ValueType alpha)
+        : Parent(A.num_rows, A.num_cols, A.num_entries), A(A), alpha(alpha) {}
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p shifted_operator : the operator <tt>A + sigma * I</tt>
+ *
+ *  When \c A is a \p csr_matrix in host memory the shift is added to
+ *  each row as it is computed, otherwise <tt>sigma * x</tt> is added
+ *  to the product in place.
+ *
+ *  \tparam LinearOperator square matrix or linear operator
+ */
+template <typename LinearOperator>
+class shifted_operator
+    : public cusp::linear_operator<typename LinearOperator::value_type,
+                                   typename LinearOperator::memory_space,
+                                   typename LinearOperator::index_type>
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef cusp::linear_operator<ValueType,
+                                  typename LinearOperator::memory_space,
+                                  typename LinearOperator::index_type> Parent;
+
+public:
+    typename cusp::detail::operator_operand<LinearOperator>::type A;
+    ValueType sigma;
+
+    shifted_operator(const LinearOperator& A, ValueType sigma);
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p diagonal_scaled_operator : the operator <tt>diag(d) * A</tt>
+ *
+ *  Scales row \c i of \c A by <tt>d[i]</tt>.  With \c d holding the
+ *  reciprocals of the diagonal of \c A this is the Jacobi-scaled
+ *  operator <tt>D^-1 A</tt>.  When \c A is a \p csr_matrix in host
+ *  memory each row is scaled as it is computed, otherwise the product
+ *  is scaled in place.
+ *
+ *  \tparam Array array1d holding the diagonal, in the memory space of \c A
+ *  \tparam LinearOperator matrix or linear operator
+ */
+template <typename Array, typename LinearOperator>
+class diagonal_scaled_operator
+    : public cusp::linear_operator<typename LinearOperator::value_type,
+                                   typename LinearOperator::memory_space,
+                                   typename LinearOperator::index_type>
+{
+    typedef typename LinearOperator::value_type ValueType;
+    typedef cusp::linear_operator<ValueType,
+                                  typename LinearOperator::memory_space,
+                                  typename LinearOperator::index_type> Parent;
+
+public:
+    const Array& d;
+    typename cusp::detail::operator_operand<LinearOperator>::type A;
+
+    diagonal_scaled_operator(const Array& d, const LinearOperator& A);
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p sum_operator : the operator <tt>alpha * A + beta * B</tt>
+ *
+ *  When \c A and \c B are both \p csr_matrix in host memory the two
+ *  rows are combined in a single pass.  Otherwise <tt>alpha * A x</tt>
+ *  is computed in the output and <tt>beta * B x</tt> is accumulated
+ *  into it, which is fused on the host and uses one workspace vector
+ *  on the device.
+ *
+ *  \tparam LinearOperator1 matrix or linear operator
+ *  \tparam LinearOperator2 matrix or linear operator of the same shape
+ */
+template <typename LinearOperator1, typename LinearOperator2>
+class sum_operator
+    : public cusp::linear_operator<typename LinearOperator1::value_type,
+                                   typename LinearOperator1::memory_space,
+                                   typename LinearOperator1::index_type>
+{
+    typedef typename LinearOperator1::value_type   ValueType;
+    typedef typename LinearOperator1::memory_space MemorySpace;
+    typedef cusp::linear_operator<ValueType, MemorySpace,
+                                  typename LinearOperator1::index_type> Parent;
+
+    mutable cusp::array1d<ValueType,MemorySpace> temp;
+
+public:
+    typename cusp::detail::operator_operand<LinearOperator1>::type A;
+    typename cusp::detail::operator_operand<LinearOperator2>::type B;
+    ValueType alpha;
+    ValueType beta;
+
+    sum_operator(const LinearOperator1& A, const LinearOperator2& B, ValueType alpha, ValueType beta);
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p product_operator : the operator <tt>A * B</tt>
+ *
+ *  Applies \c B and then \c A, so it holds one workspace vector for
+ *  <tt>B x</tt>.  The product of the matrices is never formed.
+ *
+ *  \tparam LinearOperator1 matrix or linear operator
+ *  \tparam LinearOperator2 matrix or linear operator with as many rows as \c A has columns
+ */
+template <typename LinearOperator1, typename LinearOperator2>
+class product_operator
+    : public cusp::linear_operator<typename LinearOperator1::value_type,
+                                   typename LinearOperator1::memory_space,
+                                   typename LinearOperator1::index_type>
+{
+    typedef typename LinearOperator1::value_type   ValueType;
+    typedef typename LinearOperator1::memory_space MemorySpace;
+    typedef cusp::linear_operator<ValueType, MemorySpace,
+                                  typename LinearOperator1::index_type> Parent;
+
+    mutable cusp::array1d<ValueType,MemorySpace> temp;
+
+public:
+    typename cusp::detail::operator_operand<LinearOperator1>::type A;
+    typename cusp::detail::operator_operand<LinearOperator2>::type B;
+
+    product_operator(const LinearOperator1& A, const LinearOperator2& B);
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p transpose_operator : the operator <tt>A^T</tt>
+ *
+ *  A \p csr_matrix or \p coo_matrix in host memory is applied by
+ *  scattering its rows, without a copy.  Other formats and device
+ *  matrices are transposed once, into CSR, when the operator is
+ *  constructed.
+ *
+ *  \tparam Matrix sparse matrix
+ */
+template <typename Matrix>
+class transpose_operator
+    : public cusp::linear_operator<typename Matrix::value_type,
+                                   typename Matrix::memory_space,
+                                   typename Matrix::index_type>
+{
+    typedef typename Matrix::index_type   IndexType;
+    typedef typename Matrix::value_type   ValueType;
+    typedef typename Matrix::memory_space MemorySpace;
+    typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+
+public:
+    typename cusp::detail::operator_operand<Matrix>::type A;
+
+    // explicit transpose, empty when A is applied directly
+    cusp::csr_matrix<IndexType, ValueType, MemorySpace> At;
+
+    transpose_operator(const Matrix& A);
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+
+/*! \p make_scaled_operator : form <tt>alpha * A</tt>
+ */
+template <typename LinearOperator, typename ScalarType>
+scaled_operator<LinearOperator>
+make_scaled_operator(const LinearOperator& A, ScalarType alpha);
+
+/*! \p make_shifted_operator : form <tt>A + sigma * I</tt>
+ */
+template <typename LinearOperator, typename ScalarType>
+shifted_operator<LinearOperator>
+make_shifted_operator(const LinearOperator& A, ScalarType sigma);
+
+/*! \p make_diagonal_scaled_operator : form <tt>diag(d) * A</tt>
+ */
+template <typename Array, typename LinearOperator>
+diagonal_scaled_operator<Array, LinearOperator>
+make_diagonal_scaled_operator(const Array& d, const LinearOperator& A);
+
+/*! \p make_sum_operator : form <tt>A + B</tt>
+ */
+template <typename LinearOperator1, typename LinearOperator2>
+sum_operator<LinearOperator1, LinearOperator2>
+make_sum_operator(const LinearOperator1& A, const LinearOperator2& B);
+
+/*! \p make_sum_operator : form <tt>alpha * A + beta * B</tt>
+ */
+template <typename LinearOperator1, typename LinearOperator2, typename ScalarType1, typename ScalarType2>
+sum_operator<LinearOperator1, LinearOperator2>
+make_sum_operator(const LinearOperator1& A, const LinearOperator2& B, ScalarType1 alpha, ScalarType2 beta);
+
+/*! \p make_product_operator : form <tt>A * B</tt>
+ */
+template <typename LinearOperator1, typename LinearOperator2>
+product_operator<LinearOperator1, LinearOperator2>
+make_product_operator(const LinearOperator1& A, const LinearOperator2& B);
+
+/*! \p make_transpose_operator : form <tt>A^T</tt>
+ */
+template <typename Matrix>
+transpose_operator<Matrix>
+make_transpose_operator(const Matrix& A);
+
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/composite_operator.inl>
@@ -0,0 +1,114 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/format.h>
+#include <cusp/blas.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/functional.h>
+#include <cusp/detail/host/spmv.h>
+
+#include <thrust/functional.h>
+
+// y <- y + alpha * A * x
+//
+// On the host the update is folded into the SpMV itself, so y is read and
+// written once and A x is never stored.  Other formats and memory spaces
+// compute A x into the workspace vector and then apply an axpy.
+
+namespace cusp
+{
+namespace detail
+{
+
+////////////////
+// Host Paths //
+////////////////
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   cusp::coo_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+    cusp::detail::host::spmv_coo(A, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+    cusp::detail::host::spmv_csr(A, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   cusp::dia_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+    cusp::detail::host::spmv_dia(A, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   cusp::ell_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+    cusp::detail::host::spmv_ell(A, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   cusp::hyb_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+    cusp::detail::host::spmv_ell(A.ell, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+    cusp::detail::host::spmv_coo(A.coo, x, y, thrust::identity<ValueType>(),
+                                 cusp::detail::scaled_multiplies<ValueType>(alpha), thrust::plus<ValueType>());
+}
+
+/////////////////////
+// Generic Path    //
+/////////////////////
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType,
+          typename Format, typename MemorySpace>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp,
+                   Format, MemorySpace)
+{
+    cusp::multiply(A, x, temp);
+    cusp::blas::axpy(temp, y, alpha);
+}
+
+/////////////////
+// Entry Point //
+/////////////////
+template <typename Matrix, typename Vector1, typename Vector2, typename Vector3, typename ScalarType>
+void axpy_multiply(Matrix& A, Vector1& x, Vector2& y, ScalarType alpha, Vector3& temp)
+{
+    CUSP_PROFILE_SCOPED();
+    cusp::detail::axpy_multiply(A, x, y, alpha, temp,
+                                typename Matrix::format(), typename Matrix::memory_space());
+}
+
+} // end namespace detail
+} // end namespace cusp
+
@@ -0,0 +1,398 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file composite_operator.inl
+ *  \brief Inline file for composite_operator.h
+ */
+
+#include <cusp/blas.h>
+#include <cusp/exception.h>
+#include <cusp/format.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <cusp/detail/axpy_multiply.h>
+
+namespace cusp
+{
+namespace detail
+{
+
+/////////////////////
+// alpha * A       //
+/////////////////////
+template <typename Matrix, typename Vector1, typename Vector2, typename ScalarType>
+void scaled_operator_multiply(const Matrix& A, const Vector1& x, Vector2& y, ScalarType alpha,
+                              cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        ValueType sum = 0;
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            sum += A.values[jj] * x[A.column_indices[jj]];
+
+        y[i] = alpha * sum;
+    }
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename ScalarType,
+          typename Format, typename MemorySpace>
+void scaled_operator_multiply(const Matrix& A, const Vector1& x, Vector2& y, ScalarType alpha,
+                              Format, MemorySpace)
+{
+    cusp::multiply(A, x, y);
+    cusp::blas::scal(y, alpha);
+}
+
+/////////////////////
+// A + sigma * I   //
+/////////////////////
+template <typename Matrix, typename Vector1, typename Vector2, typename ScalarType>
+void shifted_operator_multiply(const Matrix& A, const Vector1& x, Vector2& y, ScalarType sigma,
+                               cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        ValueType sum = sigma * x[i];
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            sum += A.values[jj] * x[A.column_indices[jj]];
+
+        y[i] = sum;
+    }
+}
+
+template <typename Matrix, typename Vector1, typename Vector2, typename ScalarType,
+          typename Format, typename MemorySpace>
+void shifted_operator_multiply(const Matrix& A, const Vector1& x, Vector2& y, ScalarType sigma,
+                               Format, MemorySpace)
+{
+    cusp::multiply(A, x, y);
+    cusp::blas::axpy(x, y, sigma);
+}
+
+/////////////////////
+// diag(d) * A     //
+/////////////////////
+template <typename Array, typename Matrix, typename Vector1, typename Vector2>
+void diagonal_scaled_operator_multiply(const Array& d, const Matrix& A, const Vector1& x, Vector2& y,
+                                       cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        ValueType sum = 0;
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            sum += A.values[jj] * x[A.column_indices[jj]];
+
+        y[i] = d[i] * sum;
+    }
+}
+
+template <typename Array, typename Matrix, typename Vector1, typename Vector2,
+          typename Format, typename MemorySpace>
+void diagonal_scaled_operator_multiply(const Array& d, const Matrix& A, const Vector1& x, Vector2& y,
+                                       Format, MemorySpace)
+{
+    cusp::multiply(A, x, y);
+    cusp::blas::xmy(d, y, y);
+}
+
+///////////////////////////
+// alpha * A + beta * B  //
+///////////////////////////
+template <typename Matrix1, typename Matrix2, typename Vector1, typename Vector2, typename Vector3,
+          typename ScalarType>
+void sum_operator_multiply(const Matrix1& A, const Matrix2& B, const Vector1& x, Vector2& y,
+                           ScalarType alpha, ScalarType beta, Vector3& temp,
+                           cusp::csr_format, cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Matrix1::index_type IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        ValueType sum_A = 0;
+        ValueType sum_B = 0;
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            sum_A += A.values[jj] * x[A.column_indices[jj]];
+
+        for (IndexType jj = B.row_offsets[i]; jj < B.row_offsets[i + 1]; jj++)
+            sum_B += B.values[jj] * x[B.column_indices[jj]];
+
+        y[i] = alpha * sum_A + beta * sum_B;
+    }
+}
+
+template <typename Matrix1, typename Matrix2, typename Vector1, typename Vector2, typename Vector3,
+          typename ScalarType, typename Format1, typename Format2, typename MemorySpace>
+void sum_operator_multiply(const Matrix1& A, const Matrix2& B, const Vector1& x, Vector2& y,
+                           ScalarType alpha, ScalarType beta, Vector3& temp,
+                           Format1, Format2, MemorySpace)
+{
+    // y <- alpha * A x, then y <- y + beta * B x (fused for host matrices)
+    scaled_operator_multiply(A, x, y, alpha, Format1(), MemorySpace());
+
+    if (temp.size() != B.num_rows)
+        temp.resize(B.num_rows);
+
+    cusp::detail::axpy_multiply(B, x, y, beta, temp);
+}
+
+/////////////////////
+// A^T             //
+/////////////////////
+template <typename Matrix, typename Matrix2, typename Vector1, typename Vector2>
+void transpose_operator_multiply(const Matrix& A, const Matrix2& At, const Vector1& x, Vector2& y,
+                                 cusp::csr_format, cusp::host_memory)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    cusp::blas::fill(y, ValueType(0));
+
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        const ValueType xi = x[i];
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            y[A.column_indices[jj]] += A.values[jj] * xi;
+    }
+}
+
+template <typename Matrix, typename Matrix2, typename Vector1, typename Vector2>
+void transpose_operator_multiply(const Matrix& A, const Matrix2& At, const Vector1& x, Vector2& y,
+                                 cusp::coo_format, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+
+    cusp::blas::fill(y, ValueType(0));
+
+    for (size_t n = 0; n < A.num_entries; n++)
+        y[A.column_indices[n]] += A.values[n] * x[A.row_indices[n]];
+}
+
+template <typename Matrix, typename Matrix2, typename Vector1, typename Vector2,
+          typename Format, typename MemorySpace>
+void transpose_operator_multiply(const Matrix& A, const Matrix2& At, const Vector1& x, Vector2& y,
+                                 Format, MemorySpace)
+{
+    cusp::multiply(At, x, y);
+}
+
+// host CSR and COO matrices are applied directly, everything else is transposed once
+template <typename Matrix, typename Matrix2>
+void transpose_operator_setup(const Matrix& A, Matrix2& At, cusp::csr_format, cusp::host_memory) {}
+
+template <typename Matrix, typename Matrix2>
+void transpose_operator_setup(const Matrix& A, Matrix2& At, cusp::coo_format, cusp::host_memory) {}
+
+template <typename Matrix, typename Matrix2, typename Format, typename MemorySpace>
+void transpose_operator_setup(const Matrix& A, Matrix2& At, Format, MemorySpace)
+{
+    cusp::transpose(A, At);
+}
+
+} // end namespace detail
+
+//////////////////
+// Constructors //
+//////////////////
+template <typename LinearOperator>
+shifted_operator<LinearOperator>
+::shifted_operator(const LinearOperator& A, ValueType sigma)
+    : Parent(A.num_rows, A.num_cols, A.num_entries + A.num_rows), A(A), sigma(sigma)
+{
+    if (A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("shifted_operator requires a square operator");
+}
+
+template <typename Array, typename LinearOperator>
+diagonal_scaled_operator<Array,LinearOperator>
+::diagonal_scaled_operator(const Array& d, const LinearOperator& A)
+    : Parent(A.num_rows, A.num_cols, A.num_entries), d(d), A(A)
+{
+    if (d.size() != A.num_rows)
+        throw cusp::invalid_input_exception("diagonal_scaled_operator requires one diagonal entry per row");
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+sum_operator<LinearOperator1,LinearOperator2>
+::sum_operator(const LinearOperator1& A, const LinearOperator2& B, ValueType alpha, ValueType beta)
+    : Parent(A.num_rows, A.num_cols, A.num_entries + B.num_entries), A(A), B(B), alpha(alpha), beta(beta)
+{
+    if (A.num_rows != B.num_rows || A.num_cols != B.num_cols)
+        throw cusp::invalid_input_exception("sum_operator requires operators of the same shape");
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+product_operator<LinearOperator1,LinearOperator2>
+::product_operator(const LinearOperator1& A, const LinearOperator2& B)
+    : Parent(A.num_rows, B.num_cols, A.num_entries + B.num_entries), temp(B.num_rows), A(A), B(B)
+{
+    if (A.num_cols != B.num_rows)
+        throw cusp::invalid_input_exception("product_operator requires A.num_cols == B.num_rows");
+}
+
+template <typename Matrix>
+transpose_operator<Matrix>
+::transpose_operator(const Matrix& A)
+    : Parent(A.num_cols, A.num_rows, A.num_entries), A(A)
+{
+    cusp::detail::transpose_operator_setup(A, At, typename Matrix::format(), MemorySpace());
+}
+
+/////////////////////
+// Linear Operator //
+/////////////////////
+template <typename LinearOperator>
+template <typename VectorType1, typename VectorType2>
+void scaled_operator<LinearOperator>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::detail::scaled_operator_multiply(A, x, y, alpha,
+                                           typename LinearOperator::format(),
+                                           typename LinearOperator::memory_space());
+}
+
+template <typename LinearOperator>
+template <typename VectorType1, typename VectorType2>
+void shifted_operator<LinearOperator>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::detail::shifted_operator_multiply(A, x, y, sigma,
+                                            typename LinearOperator::format(),
+                                            typename LinearOperator::memory_space());
+}
+
+template <typename Array, typename LinearOperator>
+template <typename VectorType1, typename VectorType2>
+void diagonal_scaled_operator<Array,LinearOperator>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::detail::diagonal_scaled_operator_multiply(d, A, x, y,
+                                                    typename LinearOperator::format(),
+                                                    typename LinearOperator::memory_space());
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+template <typename VectorType1, typename VectorType2>
+void sum_operator<LinearOperator1,LinearOperator2>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::detail::sum_operator_multiply(A, B, x, y, alpha, beta, temp,
+                                        typename LinearOperator1::format(),
+                                        typename LinearOperator2::format(),
+                                        typename LinearOperator1::memory_space());
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+template <typename VectorType1, typename VectorType2>
+void product_operator<LinearOperator1,LinearOperator2>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::multiply(B, x, temp);
+    cusp::multiply(A, temp, y);
+}
+
+template <typename Matrix>
+template <typename VectorType1, typename VectorType2>
+void transpose_operator<Matrix>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::detail::transpose_operator_multiply(A, At, x, y,
+                                              typename Matrix::format(),
+                                              MemorySpace());
+}
+
+/////////////////////////
+// Factory Functions   //
+/////////////////////////
+template <typename LinearOperator, typename ScalarType>
+scaled_operator<LinearOperator>
+make_scaled_operator(const LinearOperator& A, ScalarType alpha)
+{
+    return scaled_operator<LinearOperator>(A, alpha);
+}
+
+template <typename LinearOperator, typename ScalarType>
+shifted_operator<LinearOperator>
+make_shifted_operator(const LinearOperator& A, ScalarType sigma)
+{
+    return shifted_operator<LinearOperator>(A, sigma);
+}
+
+template <typename Array, typename LinearOperator>
+diagonal_scaled_operator<Array, LinearOperator>
+make_diagonal_scaled_operator(const Array& d, const LinearOperator& A)
+{
+    return diagonal_scaled_operator<Array, LinearOperator>(d, A);
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+sum_operator<LinearOperator1, LinearOperator2>
+make_sum_operator(const LinearOperator1& A, const LinearOperator2& B)
+{
+    typedef typename LinearOperator1::value_type ValueType;
+    return sum_operator<LinearOperator1, LinearOperator2>(A, B, ValueType(1), ValueType(1));
+}
+
+template <typename LinearOperator1, typename LinearOperator2, typename ScalarType1, typename ScalarType2>
+sum_operator<LinearOperator1, LinearOperator2>
+make_sum_operator(const LinearOperator1& A, const LinearOperator2& B, ScalarType1 alpha, ScalarType2 beta)
+{
+    return sum_operator<LinearOperator1, LinearOperator2>(A, B, alpha, beta);
+}
+
+template <typename LinearOperator1, typename LinearOperator2>
+product_operator<LinearOperator1, LinearOperator2>
+make_product_operator(const LinearOperator1& A, const LinearOperator2& B)
+{
+    return product_operator<LinearOperator1, LinearOperator2>(A, B);
+}
+
+template <typename Matrix>
+transpose_operator<Matrix>
+make_transpose_operator(const Matrix& A)
+{
+    return transpose_operator<Matrix>(A);
+}
+
+} // end namespace cusp
+
@@ -221,6 +221,14 @@ void extract_diagonal(const Matrix& A, Array& output, cusp::hyb_format)
 }
 
 
+// matrix-free operators such as cusp::stencil_operator provide their own diagonal
+template <typename Matrix, typename Array>
+void extract_diagonal(const Matrix& A, Array& output, cusp::unknown_format)
+{
+    A.extract_diagonal(output);
+}
+
+
 template <typename Matrix, typename Array>
 void extract_diagonal(const Matrix& A, Array& output)
 {
@@ -37,6 +37,16 @@ template<typename T>
   __host__ __device__ T operator()(const T &x) const {return T(0);}
 }; // end minus
 
+template<typename T>
+  struct scaled_multiplies : public thrust::binary_function<T,T,T>
+{
+  T alpha;
+
+  scaled_multiplies(const T alpha) : alpha(alpha) {}
+
+  __host__ __device__ T operator()(const T &x, const T &y) const {return alpha * (x * y);}
+}; // end scaled_multiplies
+
 } // end namespace detail
 } // end namespace cusp
 
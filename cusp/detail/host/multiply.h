@@ -26,6 +26,7 @@
 #else
 #include <cusp/detail/host/spmv.h>
 #endif
+#include <cusp/detail/host/spmv_fixed.h>
 
 #include <cusp/detail/host/detail/coo.h>
 #include <cusp/detail/host/detail/csr.h>
@@ -102,7 +103,8 @@ void multiply(const Matrix&  A,
               cusp::array1d_format,
               cusp::array1d_format)
 {
-    cusp::detail::host::spmv_dia(A, B, C);
+    if (!cusp::detail::host::spmv_dia_specialized(A, B, C))
+        cusp::detail::host::spmv_dia(A, B, C);
 }
 
 template <typename Matrix,
@@ -115,7 +117,8 @@ void multiply(const Matrix&  A,
               cusp::array1d_format,
               cusp::array1d_format)
 {
-    cusp::detail::host::spmv_ell(A, B, C);
+    if (!cusp::detail::host::spmv_ell_specialized(A, B, C))
+        cusp::detail::host::spmv_ell(A, B, C);
 }
 
 template <typename Matrix,
@@ -130,7 +133,8 @@ void multiply(const Matrix&  A,
 {
     typedef typename Vector2::value_type ValueType;
 
-    cusp::detail::host::spmv_ell(A.ell, B, C);
+    if (!cusp::detail::host::spmv_ell_specialized(A.ell, B, C))
+        cusp::detail::host::spmv_ell(A.ell, B, C);
     cusp::detail::host::spmv_coo(A.coo, B, C, thrust::identity<ValueType>(), thrust::multiplies<ValueType>(), thrust::plus<ValueType>());
 }
 
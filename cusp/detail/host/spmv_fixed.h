@@ -0,0 +1,201 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/detail/functional.h>
+
+#include <algorithm>
+
+// SpMV kernels with the row width fixed at compile time
+//
+// ELL matrices with 3 to 32 entries per row and DIA matrices with the
+// diagonal counts of the gallery stencils (3, 5, 7, 9 and 27 points)
+// are dispatched to instantiations whose inner loop over the row has a
+// constant trip count, so the compiler unrolls it and keeps the row
+// sum in a register.  Other widths use the generic kernels.
+
+namespace cusp
+{
+namespace detail
+{
+namespace host
+{
+
+//////////////
+// ELL SpMV //
+//////////////
+template <int K,
+          typename Matrix,
+          typename Vector1,
+          typename Vector2>
+void spmv_ell_fixed(const Matrix&  A,
+                    const Vector1& x,
+                          Vector2& y)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    const IndexType invalid_index = Matrix::invalid_index;
+
+    for(size_t i = 0; i < A.num_rows; i++)
+    {
+        ValueType sum = 0;
+
+        for(int n = 0; n < K; n++)
+        {
+            const IndexType j = A.column_indices(i, n);
+
+            if (j != invalid_index)
+                sum += A.values(i, n) * x[j];
+        }
+
+        y[i] = sum;
+    }
+}
+
+// returns false when the row width has no specialization
+template <typename Matrix,
+          typename Vector1,
+          typename Vector2>
+bool spmv_ell_specialized(const Matrix&  A,
+                          const Vector1& x,
+                                Vector2& y)
+{
+    switch (A.column_indices.num_cols)
+    {
+        case  3: spmv_ell_fixed< 3>(A, x, y); return true;
+        case  4: spmv_ell_fixed< 4>(A, x, y); return true;
+        case  5: spmv_ell_fixed< 5>(A, x, y); return true;
+        case  6: spmv_ell_fixed< 6>(A, x, y); return true;
+        case  7: spmv_ell_fixed< 7>(A, x, y); return true;
+        case  8: spmv_ell_fixed< 8>(A, x, y); return true;
+        case  9: spmv_ell_fixed< 9>(A, x, y); return true;
+        case 10: spmv_ell_fixed<10>(A, x, y); return true;
+        case 11: spmv_ell_fixed<11>(A, x, y); return true;
+        case 12: spmv_ell_fixed<12>(A, x, y); return true;
+        case 13: spmv_ell_fixed<13>(A, x, y); return true;
+        case 14: spmv_ell_fixed<14>(A, x, y); return true;
+        case 15: spmv_ell_fixed<15>(A, x, y); return true;
+        case 16: spmv_ell_fixed<16>(A, x, y); return true;
+        case 17: spmv_ell_fixed<17>(A, x, y); return true;
+        case 18: spmv_ell_fixed<18>(A, x, y); return true;
+        case 19: spmv_ell_fixed<19>(A, x, y); return true;
+        case 20: spmv_ell_fixed<20>(A, x, y); return true;
+        case 21: spmv_ell_fixed<21>(A, x, y); return true;
+        case 22: spmv_ell_fixed<22>(A, x, y); return true;
+        case 23: spmv_ell_fixed<23>(A, x, y); return true;
+        case 24: spmv_ell_fixed<24>(A, x, y); return true;
+        case 25: spmv_ell_fixed<25>(A, x, y); return true;
+        case 26: spmv_ell_fixed<26>(A, x, y); return true;
+        case 27: spmv_ell_fixed<27>(A, x, y); return true;
+        case 28: spmv_ell_fixed<28>(A, x, y); return true;
+        case 29: spmv_ell_fixed<29>(A, x, y); return true;
+        case 30: spmv_ell_fixed<30>(A, x, y); return true;
+        case 31: spmv_ell_fixed<31>(A, x, y); return true;
+        case 32: spmv_ell_fixed<32>(A, x, y); return true;
+        default: return false;
+    }
+}
+
+//////////////
+// DIA SpMV //
+//////////////
+template <int K,
+          typename Matrix,
+          typename Vector1,
+          typename Vector2>
+void spmv_dia_fixed(const Matrix&  A,
+                    const Vector1& x,
+                          Vector2& y)
+{
+    typedef typename Matrix::index_type  IndexType;
+    typedef typename Vector2::value_type ValueType;
+
+    const IndexType num_rows = A.num_rows;
+    const IndexType num_cols = A.num_cols;
+
+    // the offsets depend on the grid size, only their number is fixed
+    IndexType offsets[K];
+
+    // rows in [row_begin, row_end) have every diagonal inside the matrix
+    IndexType row_begin = 0;
+    IndexType row_end   = num_rows;
+
+    for(int n = 0; n < K; n++)
+    {
+        offsets[n] = A.diagonal_offsets[n];
+        row_begin  = std::max<IndexType>(row_begin, -offsets[n]);
+        row_end    = std::min<IndexType>(row_end, num_cols - offsets[n]);
+    }
+    row_end = std::max(row_begin, row_end);
+
+    for(IndexType i = 0; i < row_begin; i++)
+    {
+        ValueType sum = 0;
+        for(int n = 0; n < K; n++)
+        {
+            const IndexType j = i + offsets[n];
+            if (j >= 0 && j < num_cols)
+                sum += A.values(i, n) * x[j];
+        }
+        y[i] = sum;
+    }
+
+    for(IndexType i = row_begin; i < row_end; i++)
+    {
+        ValueType sum = 0;
+        for(int n = 0; n < K; n++)
+            sum += A.values(i, n) * x[i + offsets[n]];
+        y[i] = sum;
+    }
+
+    for(IndexType i = row_end; i < num_rows; i++)
+    {
+        ValueType sum = 0;
+        for(int n = 0; n < K; n++)
+        {
+            const IndexType j = i + offsets[n];
+            if (j >= 0 && j < num_cols)
+                sum += A.values(i, n) * x[j];
+        }
+        y[i] = sum;
+    }
+}
+
+// returns false when the number of diagonals has no specialization
+template <typename Matrix,
+          typename Vector1,
+          typename Vector2>
+bool spmv_dia_specialized(const Matrix&  A,
+                          const Vector1& x,
+                                Vector2& y)
+{
+    switch (A.values.num_cols)
+    {
+        case  3: spmv_dia_fixed< 3>(A, x, y); return true;  // 1D 3-point
+        case  5: spmv_dia_fixed< 5>(A, x, y); return true;  // 2D 5-point
+        case  7: spmv_dia_fixed< 7>(A, x, y); return true;  // 3D 7-point
+        case  9: spmv_dia_fixed< 9>(A, x, y); return true;  // 2D 9-point
+        case 27: spmv_dia_fixed<27>(A, x, y); return true;  // 3D 27-point
+        default: return false;
+    }
+}
+
+} // end namespace host
+} // end namespace detail
+} // end namespace cusp
+
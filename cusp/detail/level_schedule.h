@@ -0,0 +1,187 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file level_schedule.h
+ *  \brief Level scheduling of sparse triangular dependencies
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+
+#include <thrust/fill.h>
+
+#include <algorithm>
+#include <string>
+
+namespace cusp
+{
+namespace detail
+{
+
+// levels smaller than this are processed serially
+const int level_parallel_threshold = 256;
+
+// host CSR copy of A with the columns of every row sorted, and the
+// position of each diagonal entry (-1 when it is missing)
+template <typename MatrixType, typename IndexType, typename ValueType>
+void sorted_csr_with_diagonal(const MatrixType& A,
+                              cusp::csr_matrix<IndexType, ValueType, cusp::host_memory>& B,
+                              cusp::array1d<IndexType, cusp::host_memory>& diagonal)
+{
+    cusp::coo_matrix<IndexType, ValueType, cusp::host_memory> coo(A);
+
+    if (!coo.is_sorted_by_row_and_column())
+        coo.sort_by_row_and_column();
+
+    B = coo;
+
+    diagonal.resize(B.num_rows);
+
+    for (IndexType i = 0; i < (IndexType) B.num_rows; i++)
+    {
+        diagonal[i] = -1;
+
+        for (IndexType jj = B.row_offsets[i]; jj < B.row_offsets[i + 1]; jj++)
+            if (B.column_indices[jj] == i)
+                diagonal[i] = jj;
+    }
+}
+
+// as above, for factorizations that need a square matrix with a full diagonal
+template <typename MatrixType, typename IndexType, typename ValueType>
+void sorted_csr_with_diagonal(const MatrixType& A,
+                              cusp::csr_matrix<IndexType, ValueType, cusp::host_memory>& B,
+                              cusp::array1d<IndexType, cusp::host_memory>& diagonal,
+                              const char * name)
+{
+    if (A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception(std::string(name) + ": matrix must be square");
+
+    sorted_csr_with_diagonal(A, B, diagonal);
+
+    for (size_t i = 0; i < diagonal.size(); i++)
+        if (diagonal[i] < 0)
+            throw cusp::invalid_input_exception(std::string(name) + ": matrix has a missing diagonal entry");
+}
+
+// Rows of a triangular matrix grouped by their depth in the dependency
+// DAG.  Every row of level l depends only on rows of levels < l, so the
+// rows of one level can be processed in parallel.
+template <typename IndexType>
+struct level_schedule
+{
+    // level l consists of rows[offsets[l]] ... rows[offsets[l+1] - 1]
+    cusp::array1d<IndexType,cusp::host_memory> offsets;
+    cusp::array1d<IndexType,cusp::host_memory> rows;
+
+    level_schedule(void) : offsets(1, 0) {}
+
+    size_t num_levels(void) const { return offsets.size() - 1; }
+};
+
+// row i depends on row j when A(i,j) != 0 and j < i (lower) or j > i (upper)
+template <typename Matrix, typename IndexType>
+void build_level_schedule(const Matrix& A, bool lower, level_schedule<IndexType>& schedule)
+{
+    const IndexType N = A.num_rows;
+
+    cusp::array1d<IndexType,cusp::host_memory> level(N, 0);
+    IndexType num_levels = 0;
+
+    for (IndexType n = 0; n < N; n++)
+    {
+        IndexType i = lower ? n : N - 1 - n;
+        IndexType l = 0;
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            IndexType j = A.column_indices[jj];
+
+            if ((lower && j < i) || (!lower && j > i))
+                l = std::max(l, IndexType(level[j] + 1));
+        }
+
+        level[i]   = l;
+        num_levels = std::max(num_levels, IndexType(l + 1));
+    }
+
+    // counting sort of the rows by level, rows stay in ascending order within a level
+    schedule.offsets.resize(num_levels + 1);
+    thrust::fill(schedule.offsets.begin(), schedule.offsets.end(), IndexType(0));
+
+    for (IndexType i = 0; i < N; i++)
+        schedule.offsets[level[i] + 1]++;
+
+    for (IndexType l = 0; l < num_levels; l++)
+        schedule.offsets[l + 1] += schedule.offsets[l];
+
+    cusp::array1d<IndexType,cusp::host_memory> next(schedule.offsets.begin(), schedule.offsets.end() - 1);
+
+    schedule.rows.resize(N);
+
+    for (IndexType i = 0; i < N; i++)
+        schedule.rows[next[level[i]]++] = i;
+}
+
+// copy the strictly lower (or upper) part of A into T, optionally storing
+// the rows in schedule order so that each level is contiguous in memory
+template <typename Matrix1, typename IndexType, typename Matrix2>
+void extract_triangle(const Matrix1& A, bool lower, const level_schedule<IndexType>& schedule, bool permuted, Matrix2& T)
+{
+    const IndexType N = A.num_rows;
+
+    size_t num_entries = 0;
+
+    for (IndexType i = 0; i < N; i++)
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+            if ((lower && A.column_indices[jj] < i) || (!lower && A.column_indices[jj] > i))
+                num_entries++;
+
+    T.resize(N, A.num_cols, num_entries);
+
+    num_entries = 0;
+
+    for (IndexType p = 0; p < N; p++)
+    {
+        IndexType i = permuted ? schedule.rows[p] : p;
+
+        T.row_offsets[p] = num_entries;
+
+        for (IndexType jj = A.row_offsets[i]; jj < A.row_offsets[i + 1]; jj++)
+        {
+            IndexType j = A.column_indices[jj];
+
+            if ((lower && j < i) || (!lower && j > i))
+            {
+                T.column_indices[num_entries] = j;
+                T.values[num_entries]         = A.values[jj];
+                num_entries++;
+            }
+        }
+    }
+
+    T.row_offsets[N] = num_entries;
+}
+
+} // end namespace detail
+} // end namespace cusp
+
@@ -0,0 +1,334 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file stencil_operator.inl
+ *  \brief Inline file for stencil_operator.h
+ */
+
+#include <cusp/blas.h>
+#include <cusp/exception.h>
+#include <cusp/gallery/stencil.h>
+
+#include <thrust/fill.h>
+#include <thrust/transform.h>
+#include <thrust/iterator/counting_iterator.h>
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace cusp
+{
+namespace detail
+{
+
+// rows of a plane that are processed together, so they share their neighbor lines in cache
+const int stencil_operator_tile_rows = 8;
+
+// smaller grids are applied serially
+const size_t stencil_operator_parallel_threshold = 16384;
+
+// host kernel: y = A x one tile of grid lines at a time
+template <typename ValueType>
+void stencil_operator_multiply_host(const int * grid, size_t num_points,
+                                    const int * offsets, const ValueType * weights,
+                                    const ValueType * coefficients, size_t pitch,
+                                    const ValueType * x, ValueType * y)
+{
+    const int nx = grid[0];
+    const int ny = grid[1];
+    const int nz = grid[2];
+
+    // [x_begin, x_end) is the part of every line where all neighbors are inside in x
+    int x_begin = 0;
+    int x_end   = nx;
+    for (size_t k = 0; k < num_points; k++)
+    {
+        x_begin = std::max(x_begin, -offsets[3 * k]);
+        x_end   = std::min(x_end, nx - offsets[3 * k]);
+    }
+    x_end = std::max(x_begin, x_end);
+
+    const int tiles_per_plane = (ny + stencil_operator_tile_rows - 1) / stencil_operator_tile_rows;
+    const int num_tiles       = nz * tiles_per_plane;
+
+#if defined(_OPENMP)
+    #pragma omp parallel for schedule(static) if (size_t(nx) * ny * nz >= stencil_operator_parallel_threshold)
+#endif
+    for (int tile = 0; tile < num_tiles; tile++)
+    {
+        const int iz      = tile / tiles_per_plane;
+        const int y_begin = (tile % tiles_per_plane) * stencil_operator_tile_rows;
+        const int y_end   = std::min(ny, y_begin + stencil_operator_tile_rows);
+
+        for (int iy = y_begin; iy < y_end; iy++)
+        {
+            const int base = nx * (iy + ny * iz);
+
+            ValueType * y_line = y + base;
+
+            for (int ix = 0; ix < nx; ix++)
+                y_line[ix] = ValueType(0);
+
+            for (size_t k = 0; k < num_points; k++)
+            {
+                const int dx = offsets[3 * k + 0];
+                const int dy = offsets[3 * k + 1];
+                const int dz = offsets[3 * k + 2];
+
+                // neighbor line outside the grid
+                if (iy + dy < 0 || iy + dy >= ny || iz + dz < 0 || iz + dz >= nz)
+                    continue;
+
+                const int shift = base + dx + nx * (dy + ny * dz);
+
+                const int lo = std::max(0,  -dx);
+                const int hi = std::min(nx, nx - dx);
+
+                if (coefficients == 0)
+                {
+                    const ValueType w = weights[k];
+
+                    for (int ix = lo; ix < std::min(x_begin, hi); ix++)
+                        y_line[ix] += w * x[shift + ix];
+
+                    // interior, unit stride in x and y
+                    for (int ix = x_begin; ix < x_end; ix++)
+                        y_line[ix] += w * x[shift + ix];
+
+                    for (int ix = std::max(lo, x_end); ix < hi; ix++)
+                        y_line[ix] += w * x[shift + ix];
+                }
+                else
+                {
+                    const ValueType * c_line = coefficients + k * pitch + base;
+
+                    for (int ix = lo; ix < std::min(x_begin, hi); ix++)
+                        y_line[ix] += c_line[ix] * x[shift + ix];
+
+                    for (int ix = x_begin; ix < x_end; ix++)
+                        y_line[ix] += c_line[ix] * x[shift + ix];
+
+                    for (int ix = std::max(lo, x_end); ix < hi; ix++)
+                        y_line[ix] += c_line[ix] * x[shift + ix];
+                }
+            }
+        }
+    }
+}
+
+// device kernel: one grid point per thread
+template <typename ValueType>
+struct stencil_operator_row_functor
+{
+    int nx, ny, nz;
+    int num_points;
+    const int * offsets;
+    const ValueType * weights;
+    const ValueType * coefficients;
+    int pitch;
+    const ValueType * x;
+
+    stencil_operator_row_functor(const int * grid, int num_points,
+                                 const int * offsets, const ValueType * weights,
+                                 const ValueType * coefficients, int pitch, const ValueType * x)
+        : nx(grid[0]), ny(grid[1]), nz(grid[2]), num_points(num_points),
+          offsets(offsets), weights(weights), coefficients(coefficients), pitch(pitch), x(x) {}
+
+    __host__ __device__
+    ValueType operator()(int i) const
+    {
+        const int ix = i % nx;
+        const int iy = (i / nx) % ny;
+        const int iz = i / (nx * ny);
+
+        ValueType sum = 0;
+
+        for (int k = 0; k < num_points; k++)
+        {
+            const int dx = offsets[3 * k + 0];
+            const int dy = offsets[3 * k + 1];
+            const int dz = offsets[3 * k + 2];
+
+            if (ix + dx < 0 || ix + dx >= nx ||
+                iy + dy < 0 || iy + dy >= ny ||
+                iz + dz < 0 || iz + dz >= nz)
+                continue;
+
+            const ValueType w = coefficients ? coefficients[k * pitch + i] : weights[k];
+
+            sum += w * x[i + dx + nx * (dy + ny * dz)];
+        }
+
+        return sum;
+    }
+};
+
+template <typename Operator, typename Vector1, typename Vector2>
+void stencil_operator_multiply(const Operator& A, const Vector1& x, Vector2& y, cusp::host_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+
+    if (A.num_rows == 0)
+        return;
+
+    cusp::detail::stencil_operator_multiply_host(A.grid, A.num_points(),
+                                                 &A.offsets[0], &A.weights[0],
+                                                 A.coefficients.num_entries ? &A.coefficients.values[0] : (const ValueType *) 0,
+                                                 A.coefficients.pitch, &x[0], &y[0]);
+}
+
+template <typename Operator, typename Vector1, typename Vector2>
+void stencil_operator_multiply(const Operator& A, const Vector1& x, Vector2& y, cusp::device_memory)
+{
+    typedef typename Vector2::value_type ValueType;
+
+    if (A.num_rows == 0)
+        return;
+
+    const ValueType * coefficients =
+        A.coefficients.num_entries ? thrust::raw_pointer_cast(&A.coefficients.values[0]) : (const ValueType *) 0;
+
+    stencil_operator_row_functor<ValueType> f(A.grid, A.num_points(),
+                                              thrust::raw_pointer_cast(&A.offsets[0]),
+                                              thrust::raw_pointer_cast(&A.weights[0]),
+                                              coefficients, A.coefficients.pitch,
+                                              thrust::raw_pointer_cast(&x[0]));
+
+    thrust::transform(thrust::counting_iterator<int>(0),
+                      thrust::counting_iterator<int>(A.num_rows),
+                      y.begin(), f);
+}
+
+} // end namespace detail
+
+template <typename ValueType, typename MemorySpace>
+template <typename StencilPoint, typename GridDimension>
+void stencil_operator<ValueType,MemorySpace>
+::initialize(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil, const GridDimension& grid)
+{
+    const int num_dimensions = thrust::tuple_size<GridDimension>::value;
+
+    if (num_dimensions > 3)
+        throw cusp::invalid_input_exception("stencil_operator supports grids of at most three dimensions");
+
+    cusp::array1d<int,cusp::host_memory> grid_sizes(num_dimensions);
+    cusp::gallery::detail::unpack_tuple(grid, grid_sizes.begin());
+
+    for (int d = 0; d < 3; d++)
+        this->grid[d] = d < num_dimensions ? grid_sizes[d] : 1;
+
+    const size_t num_points = stencil.size();
+    const size_t N = size_t(this->grid[0]) * this->grid[1] * this->grid[2];
+
+    cusp::array1d<int,cusp::host_memory>       host_offsets(3 * num_points, 0);
+    cusp::array1d<ValueType,cusp::host_memory> host_weights(num_points);
+
+    // count the entries inside the grid, as in the equivalent dia_matrix
+    size_t num_entries = 0;
+
+    for (size_t k = 0; k < num_points; k++)
+    {
+        cusp::array1d<int,cusp::host_memory> point(num_dimensions);
+        cusp::gallery::detail::unpack_tuple(thrust::get<0>(stencil[k]), point.begin());
+
+        size_t count = 1;
+        for (int d = 0; d < num_dimensions; d++)
+        {
+            host_offsets[3 * k + d] = point[d];
+            count *= std::max(0, this->grid[d] - std::abs(point[d]));
+        }
+
+        host_weights[k] = thrust::get<1>(stencil[k]);
+        num_entries += count;
+    }
+
+    this->resize(N, N, num_entries);
+
+    offsets = host_offsets;
+    weights = host_weights;
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename StencilPoint, typename GridDimension>
+stencil_operator<ValueType,MemorySpace>
+::stencil_operator(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil, const GridDimension& grid)
+{
+    initialize(stencil, grid);
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename StencilPoint, typename GridDimension, typename MemorySpace2, typename Orientation>
+stencil_operator<ValueType,MemorySpace>
+::stencil_operator(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil, const GridDimension& grid,
+                   const cusp::array2d<ValueType,MemorySpace2,Orientation>& coefficients)
+{
+    initialize(stencil, grid);
+
+    if (coefficients.num_rows != this->num_rows || coefficients.num_cols != stencil.size())
+        throw cusp::invalid_input_exception("stencil_operator coefficients must have one row per grid point and one column per stencil point");
+
+    this->coefficients = coefficients;
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename Array>
+void stencil_operator<ValueType,MemorySpace>
+::extract_diagonal(Array& output) const
+{
+    output.resize(this->num_rows);
+    cusp::blas::fill(output, ValueType(0));
+
+    cusp::array1d<int,cusp::host_memory> host_offsets(offsets);
+    cusp::array1d<ValueType,cusp::host_memory> host_weights(weights);
+
+    for (size_t k = 0; k < num_points(); k++)
+    {
+        if (host_offsets[3 * k] != 0 || host_offsets[3 * k + 1] != 0 || host_offsets[3 * k + 2] != 0)
+            continue;
+
+        if (coefficients.num_entries == 0)
+        {
+            cusp::array1d<ValueType,MemorySpace> w(this->num_rows, host_weights[k]);
+            cusp::blas::axpy(w, output, ValueType(1));
+        }
+        else
+        {
+            const size_t begin = k * coefficients.pitch;
+            cusp::blas::axpy(cusp::make_array1d_view(coefficients.values.begin() + begin,
+                                                     coefficients.values.begin() + begin + this->num_rows),
+                             output, ValueType(1));
+        }
+    }
+}
+
+template <typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void stencil_operator<ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    if (num_points() == 0)
+    {
+        cusp::blas::fill(y, ValueType(0));
+        return;
+    }
+
+    cusp::detail::stencil_operator_multiply(*this, x, y, MemorySpace());
+}
+
+} // end namespace cusp
+
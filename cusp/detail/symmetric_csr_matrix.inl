@@ -0,0 +1,362 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file symmetric_csr_matrix.inl
+ *  \brief Inline file for symmetric_csr_matrix.h
+ */
+
+#include <cusp/blas.h>
+#include <cusp/complex.h>
+#include <cusp/convert.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/detail/format_utils.h>
+
+#include <algorithm>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace cusp
+{
+namespace detail
+{
+
+// matrices with fewer stored entries are multiplied serially
+const size_t symmetric_spmv_parallel_threshold = 16384;
+
+template <typename ValueType>
+ValueType conjugate_value(const ValueType& a)
+{
+    return a;
+}
+
+template <typename ValueType>
+cusp::complex<ValueType> conjugate_value(const cusp::complex<ValueType>& a)
+{
+    return cusp::conj(a);
+}
+
+// value of A(j,i) given A(i,j)
+template <typename ValueType>
+ValueType mirror_value(const ValueType& a, cusp::symmetry_kind symmetry)
+{
+    switch (symmetry)
+    {
+        case cusp::symmetry_hermitian:      return conjugate_value(a);
+        case cusp::symmetry_skew_symmetric: return -a;
+        default:                            return a;
+    }
+}
+
+// number of entries of the full matrix with upper triangle U, the SpMV
+// kernel relies on every row being sorted and on or above the diagonal
+template <typename IndexType, typename ValueType>
+size_t symmetric_num_entries(const cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& U)
+{
+    size_t num_diagonals = 0;
+
+    for (size_t i = 0; i < U.num_rows; i++)
+    {
+        for (IndexType jj = U.row_offsets[i]; jj < U.row_offsets[i + 1]; jj++)
+        {
+            if (U.column_indices[jj] < IndexType(i) ||
+                (jj > U.row_offsets[i] && U.column_indices[jj] < U.column_indices[jj - 1]))
+                throw cusp::invalid_input_exception("symmetric_csr_matrix requires an upper triangle with rows sorted by column");
+        }
+
+        if (U.row_offsets[i] < U.row_offsets[i + 1] && size_t(U.column_indices[U.row_offsets[i]]) == i)
+            num_diagonals++;
+    }
+
+    return 2 * U.num_entries - num_diagonals;
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+size_t symmetric_num_entries(const cusp::csr_matrix<IndexType,ValueType,MemorySpace>& U)
+{
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> temp(U);
+    return symmetric_num_entries(temp);
+}
+
+template <typename IndexType, typename ValueType>
+void symmetric_spmv_row(const IndexType * row_offsets, const IndexType * column_indices,
+                        const ValueType * values, cusp::symmetry_kind symmetry,
+                        const ValueType * x, ValueType * y, ValueType * buffer,
+                        IndexType i, IndexType row_end)
+{
+    const ValueType xi = x[i];
+
+    ValueType sum = 0;
+
+    for (IndexType jj = row_offsets[i]; jj < row_offsets[i + 1]; jj++)
+    {
+        const IndexType j = column_indices[jj];
+        const ValueType a = values[jj];
+
+        sum += a * x[j];
+
+        if (j == i)
+            continue;
+
+        // mirrored entry A(j,i) applied to x(i)
+        const ValueType b = mirror_value(a, symmetry) * xi;
+
+        if (j < row_end)
+            y[j] += b;
+        else
+            buffer[j - row_end] += b;
+    }
+
+    y[i] += sum;
+}
+
+// host kernel: y = A x with A given by its upper triangle
+template <typename IndexType, typename ValueType>
+void symmetric_spmv_host(size_t num_rows, size_t num_entries,
+                         const IndexType * row_offsets, const IndexType * column_indices,
+                         const ValueType * values, cusp::symmetry_kind symmetry,
+                         const ValueType * x, ValueType * y,
+                         cusp::array1d<ValueType,cusp::host_memory>& workspace)
+{
+    const long N = num_rows;
+
+    int num_threads = 1;
+#if defined(_OPENMP)
+    if (num_entries >= symmetric_spmv_parallel_threshold)
+        num_threads = omp_get_max_threads();
+#endif
+
+    // split rows into blocks with about the same number of stored entries
+    std::vector<long> bounds(num_threads + 1);
+    for (int t = 0; t < num_threads; t++)
+        bounds[t] = std::lower_bound(row_offsets, row_offsets + N, IndexType(num_entries * t / num_threads)) - row_offsets;
+    bounds[num_threads] = N;
+
+    // block t scatters into rows [bounds[t+1], reach[t]) outside of itself,
+    // rows are sorted so the last entry of a row is its largest column
+    std::vector<long>   reach(num_threads);
+    std::vector<size_t> offsets(num_threads + 1, 0);
+
+    for (int t = 0; t < num_threads; t++)
+    {
+        reach[t] = bounds[t + 1];
+
+        for (long i = bounds[t]; i < bounds[t + 1]; i++)
+            if (row_offsets[i] < row_offsets[i + 1])
+                reach[t] = std::max(reach[t], long(column_indices[row_offsets[i + 1] - 1]) + 1);
+
+        offsets[t + 1] = offsets[t] + (reach[t] - bounds[t + 1]);
+    }
+
+    workspace.resize(offsets[num_threads]);
+
+    ValueType * partial = workspace.size() ? &workspace[0] : (ValueType *) 0;
+
+    // the team may be smaller than requested (nested regions, OMP_DYNAMIC),
+    // so blocks are handed out by the loop rather than by thread number
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static, 1) num_threads(num_threads)
+#endif
+    for (int t = 0; t < num_threads; t++)
+    {
+        const IndexType row_begin = bounds[t];
+        const IndexType row_end   = bounds[t + 1];
+
+        ValueType * buffer = partial + offsets[t];
+
+        std::fill(buffer, partial + offsets[t + 1], ValueType(0));
+        std::fill(y + row_begin, y + row_end, ValueType(0));
+
+        for (IndexType i = row_begin; i < row_end; i++)
+            symmetric_spmv_row(row_offsets, column_indices, values, symmetry, x, y, buffer, i, row_end);
+    }
+
+    if (num_threads == 1)
+        return;
+
+    // add the partial sums of the blocks above each row
+#if defined(_OPENMP)
+#pragma omp parallel for
+#endif
+    for (long j = bounds[1]; j < N; j++)
+    {
+        ValueType sum = 0;
+
+        for (int t = 0; t < num_threads && bounds[t + 1] <= j; t++)
+            if (j < reach[t])
+                sum += partial[offsets[t] + (j - bounds[t + 1])];
+
+        y[j] += sum;
+    }
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::symmetric_csr_matrix(void)
+    : Parent(), symmetry_(symmetry_symmetric) {}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename MatrixType>
+symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::symmetric_csr_matrix(const MatrixType& A, symmetry_kind symmetry)
+    : Parent(), symmetry_(symmetry_symmetric)
+{
+    if (A.num_rows != A.num_cols)
+        throw cusp::invalid_input_exception("symmetric_csr_matrix requires a square matrix");
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(A);
+
+    if (!coo.is_sorted_by_row_and_column())
+        coo.sort_by_row_and_column();
+
+    // keep the upper triangle, and the diagonal unless skew-symmetric
+    size_t num_upper = 0;
+    for (size_t n = 0; n < coo.num_entries; n++)
+        if (coo.column_indices[n] > coo.row_indices[n] ||
+            (coo.column_indices[n] == coo.row_indices[n] && symmetry != symmetry_skew_symmetric))
+            num_upper++;
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> U(coo.num_rows, coo.num_cols, num_upper);
+
+    for (size_t n = 0, k = 0; n < coo.num_entries; n++)
+    {
+        if (coo.column_indices[n] > coo.row_indices[n] ||
+            (coo.column_indices[n] == coo.row_indices[n] && symmetry != symmetry_skew_symmetric))
+        {
+            U.row_indices[k]    = coo.row_indices[n];
+            U.column_indices[k] = coo.column_indices[n];
+            U.values[k]         = coo.values[n];
+            k++;
+        }
+    }
+
+    cusp::csr_matrix<IndexType,ValueType,MemorySpace> temp(U);
+
+    assign_upper(temp, symmetry);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::assign_upper(cusp::csr_matrix<IndexType,ValueType,MemorySpace>& U, symmetry_kind symmetry)
+{
+    if (U.num_rows != U.num_cols)
+        throw cusp::invalid_input_exception("symmetric_csr_matrix requires a square matrix");
+
+    const size_t num_entries = cusp::detail::symmetric_num_entries(U);
+
+    symmetry_ = symmetry;
+
+    upper_.swap(U);
+
+    Parent::resize(upper_.num_rows, upper_.num_cols, num_entries);
+
+    // drop the expanded copy of the previous matrix
+    general.resize(0, 0, 0);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename MatrixType>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::expand(MatrixType& A) const
+{
+    cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> U(upper_);
+
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> coo(U.num_rows, U.num_cols, this->num_entries);
+
+    size_t k = 0;
+
+    for (size_t i = 0; i < U.num_rows; i++)
+    {
+        for (IndexType jj = U.row_offsets[i]; jj < U.row_offsets[i + 1]; jj++)
+        {
+            const IndexType j = U.column_indices[jj];
+
+            coo.row_indices[k]    = i;
+            coo.column_indices[k] = j;
+            coo.values[k]         = U.values[jj];
+            k++;
+
+            if (size_t(j) != i)
+            {
+                coo.row_indices[k]    = j;
+                coo.column_indices[k] = i;
+                coo.values[k]         = cusp::detail::mirror_value(ValueType(U.values[jj]), symmetry_);
+                k++;
+            }
+        }
+    }
+
+    coo.sort_by_row_and_column();
+
+    cusp::convert(coo, A);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename Array>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::extract_diagonal(Array& output) const
+{
+    cusp::detail::extract_diagonal(upper_, output);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::multiply(const VectorType1& x, VectorType2& y, cusp::host_memory) const
+{
+    if (upper_.num_rows == 0)
+        return;
+
+    if (upper_.num_entries == 0)
+    {
+        cusp::blas::fill(y, ValueType(0));
+        return;
+    }
+
+    cusp::detail::symmetric_spmv_host(upper_.num_rows, upper_.num_entries,
+                                      &upper_.row_offsets[0], &upper_.column_indices[0], &upper_.values[0],
+                                      symmetry_, &x[0], &y[0], workspace);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2, typename MemorySpace2>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::multiply(const VectorType1& x, VectorType2& y, MemorySpace2) const
+{
+    if (general.num_rows != upper_.num_rows || general.num_entries != this->num_entries)
+        expand(general);
+
+    cusp::multiply(general, x, y);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+template <typename VectorType1, typename VectorType2>
+void symmetric_csr_matrix<IndexType,ValueType,MemorySpace>
+::operator()(const VectorType1& x, VectorType2& y) const
+{
+    CUSP_PROFILE_SCOPED();
+
+    multiply(x, y, MemorySpace());
+}
+
+} // end namespace cusp
+
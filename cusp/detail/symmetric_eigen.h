@@ -0,0 +1,230 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+/*
+ * Small dense symmetric eigenproblems on the host.
+ *
+ * These are used by the Krylov solvers for Rayleigh-Ritz style
+ * projections whose dimension is a few tens at most, so a cyclic Jacobi
+ * sweep is accurate and fast enough.  Only real value types are supported.
+ */
+
+namespace cusp
+{
+namespace detail
+{
+
+// in place Cholesky factorization A = L L^T of a symmetric positive definite
+// matrix; the lower triangle of A is overwritten with L
+template <typename ValueType, typename Orientation>
+int cholesky_factor(cusp::array2d<ValueType,cusp::host_memory,Orientation>& A)
+{
+    const int n = A.num_rows;
+
+    for (int j = 0; j < n; j++)
+    {
+        ValueType d = A(j,j);
+
+        for (int k = 0; k < j; k++)
+            d -= A(j,k) * A(j,k);
+
+        // matrix is not (numerically) positive definite
+        if (!(d > ValueType(0)))
+            return -1;
+
+        d = std::sqrt(d);
+        A(j,j) = d;
+
+        for (int i = j + 1; i < n; i++)
+        {
+            ValueType sum = A(i,j);
+
+            for (int k = 0; k < j; k++)
+                sum -= A(i,k) * A(j,k);
+
+            A(i,j) = sum / d;
+        }
+    }
+
+    return 0;
+}
+
+// eigenvalues and eigenvectors of the symmetric matrix A by cyclic Jacobi
+// rotations; eigenvalues are returned in ascending order and the columns of
+// V hold the corresponding orthonormal eigenvectors.  A is destroyed.
+template <typename ValueType, typename Orientation1, typename Orientation2>
+void symmetric_eigen(cusp::array2d<ValueType,cusp::host_memory,Orientation1>& A,
+                     cusp::array1d<ValueType,cusp::host_memory>& eigenvalues,
+                     cusp::array2d<ValueType,cusp::host_memory,Orientation2>& V,
+                     size_t max_sweeps = 100)
+{
+    const int n = A.num_rows;
+
+    V.resize(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            V(i,j) = (i == j) ? ValueType(1) : ValueType(0);
+
+    for (size_t sweep = 0; sweep < max_sweeps; sweep++)
+    {
+        ValueType off = 0, total = 0;
+
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+            {
+                total += A(i,j) * A(i,j);
+                if (i != j) off += A(i,j) * A(i,j);
+            }
+
+        const ValueType eps = std::numeric_limits<ValueType>::epsilon();
+
+        if (off <= eps * eps * total)
+            break;
+
+        for (int p = 0; p < n; p++)
+        {
+            for (int q = p + 1; q < n; q++)
+            {
+                if (A(p,q) == ValueType(0))
+                    continue;
+
+                // rotation angle that annihilates A(p,q)
+                ValueType theta = (A(q,q) - A(p,p)) / (ValueType(2) * A(p,q));
+                ValueType t     = ValueType(1) / (std::fabs(theta) + std::sqrt(theta * theta + ValueType(1)));
+                if (theta < ValueType(0))
+                    t = -t;
+                ValueType c = ValueType(1) / std::sqrt(t * t + ValueType(1));
+                ValueType s = t * c;
+
+                for (int k = 0; k < n; k++)
+                {
+                    ValueType a = A(k,p), b = A(k,q);
+                    A(k,p) = c * a - s * b;
+                    A(k,q) = s * a + c * b;
+                }
+
+                for (int k = 0; k < n; k++)
+                {
+                    ValueType a = A(p,k), b = A(q,k);
+                    A(p,k) = c * a - s * b;
+                    A(q,k) = s * a + c * b;
+                }
+
+                for (int k = 0; k < n; k++)
+                {
+                    ValueType a = V(k,p), b = V(k,q);
+                    V(k,p) = c * a - s * b;
+                    V(k,q) = s * a + c * b;
+                }
+            }
+        }
+    }
+
+    eigenvalues.resize(n);
+    for (int i = 0; i < n; i++)
+        eigenvalues[i] = A(i,i);
+
+    // selection sort, moving the eigenvectors along
+    for (int i = 0; i < n; i++)
+    {
+        int m = i;
+        for (int j = i + 1; j < n; j++)
+            if (eigenvalues[j] < eigenvalues[m])
+                m = j;
+
+        if (m != i)
+        {
+            std::swap(eigenvalues[i], eigenvalues[m]);
+            for (int k = 0; k < n; k++)
+                std::swap(V(k,i), V(k,m));
+        }
+    }
+}
+
+// generalized symmetric-definite eigenproblem A y = lambda B y with B
+// positive definite.  Eigenvalues are returned in ascending order and the
+// columns of Y are B-orthonormal.  Returns -1 if B is not positive definite.
+template <typename ValueType, typename Orientation1, typename Orientation2>
+int generalized_symmetric_eigen(const cusp::array2d<ValueType,cusp::host_memory,Orientation1>& A,
+                                const cusp::array2d<ValueType,cusp::host_memory,Orientation1>& B,
+                                cusp::array1d<ValueType,cusp::host_memory>& eigenvalues,
+                                cusp::array2d<ValueType,cusp::host_memory,Orientation2>& Y)
+{
+    const int n = A.num_rows;
+
+    // B = L L^T
+    cusp::array2d<ValueType,cusp::host_memory,Orientation1> L(B);
+    if (cusp::detail::cholesky_factor(L) != 0)
+        return -1;
+
+    // W = L^-1 A
+    cusp::array2d<ValueType,cusp::host_memory,Orientation1> W(A);
+    for (int c = 0; c < n; c++)
+        for (int i = 0; i < n; i++)
+        {
+            ValueType sum = W(i,c);
+            for (int k = 0; k < i; k++)
+                sum -= L(i,k) * W(k,c);
+            W(i,c) = sum / L(i,i);
+        }
+
+    // S = L^-1 W^T = L^-1 A L^-T
+    cusp::array2d<ValueType,cusp::host_memory,Orientation1> S(n, n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            S(i,j) = W(j,i);
+
+    for (int c = 0; c < n; c++)
+        for (int i = 0; i < n; i++)
+        {
+            ValueType sum = S(i,c);
+            for (int k = 0; k < i; k++)
+                sum -= L(i,k) * S(k,c);
+            S(i,c) = sum / L(i,i);
+        }
+
+    // remove rounding asymmetry
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < i; j++)
+            S(i,j) = S(j,i) = (S(i,j) + S(j,i)) / ValueType(2);
+
+    cusp::detail::symmetric_eigen(S, eigenvalues, Y);
+
+    // Y = L^-T Q
+    for (int c = 0; c < n; c++)
+        for (int i = n - 1; i >= 0; i--)
+        {
+            ValueType sum = Y(i,c);
+            for (int k = i + 1; k < n; k++)
+                sum -= L(k,i) * Y(k,c);
+            Y(i,c) = sum / L(i,i);
+        }
+
+    return 0;
+}
+
+} // end namespace detail
+} // end namespace cusp
+
@@ -0,0 +1,284 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array2d.h>
+#include <cusp/exception.h>
+#include <cusp/format.h>
+
+#include <algorithm>
+#include <cassert>
+
+namespace cusp
+{
+namespace detail
+{
+
+// (i,c) of a host array1d or array2d, the columns of an array2d are
+// separate right-hand sides
+template <typename T>
+struct strided_columns
+{
+    T * data;
+    size_t num_rows;
+    size_t num_cols;
+    size_t row_stride;
+    size_t col_stride;
+
+    T& operator()(size_t i, size_t c) const
+    {
+        return data[i * row_stride + c * col_stride];
+    }
+};
+
+template <typename T, typename Array>
+strided_columns<T> make_strided_columns(Array& a, cusp::array1d_format)
+{
+    strided_columns<T> s;
+    s.data       = a.size() == 0 ? 0 : &a[0];
+    s.num_rows   = a.size();
+    s.num_cols   = 1;
+    s.row_stride = 1;
+    s.col_stride = a.size();
+    return s;
+}
+
+template <typename T, typename Array>
+strided_columns<T> make_strided_columns(Array& a, cusp::array2d_format)
+{
+    typedef typename Array::orientation Orientation;
+
+    strided_columns<T> s;
+    s.data       = a.values.size() == 0 ? 0 : &a.values[0];
+    s.num_rows   = a.num_rows;
+    s.num_cols   = a.num_cols;
+    s.row_stride = cusp::detail::index_of(size_t(1), size_t(0), size_t(a.pitch), Orientation());
+    s.col_stride = cusp::detail::index_of(size_t(0), size_t(1), size_t(a.pitch), Orientation());
+    return s;
+}
+
+// x(i,:) = (b(i,:) - sum_j T(t,j) x(j,:)) / d_i for all right-hand sides
+template <typename Matrix, typename Array, typename RHS, typename Solution>
+void triangular_solve_row(const Matrix& T, const Array& inv_diagonal,
+                          size_t i, size_t t, const RHS& b, const Solution& x)
+{
+    typedef typename Matrix::index_type IndexType;
+    typedef typename Matrix::value_type ValueType;
+
+    const bool unit_diagonal = inv_diagonal.size() == 0;
+
+    for (size_t c = 0; c < x.num_cols; c++)
+    {
+        ValueType sum = b(i, c);
+
+        for (IndexType jj = T.row_offsets[t]; jj < T.row_offsets[t + 1]; jj++)
+            sum -= T.values[jj] * x(T.column_indices[jj], c);
+
+        x(i, c) = unit_diagonal ? sum : sum * inv_diagonal[i];
+    }
+}
+
+template <typename Matrix, typename Array, typename IndexType, typename RHS, typename Solution>
+void level_set_triangular_solve(const Matrix& T, const Array& inv_diagonal,
+                                const level_schedule<IndexType>& schedule, bool permuted,
+                                const RHS& b, const Solution& x)
+{
+    for (size_t l = 0; l < schedule.num_levels(); l++)
+    {
+        const long begin = schedule.offsets[l];
+        const long end   = schedule.offsets[l + 1];
+
+        // rows of one level only depend on rows of earlier levels
+#if defined(_OPENMP)
+#pragma omp parallel for if (end - begin >= level_parallel_threshold)
+#endif
+        for (long p = begin; p < end; p++)
+        {
+            size_t i = schedule.rows[p];
+            cusp::detail::triangular_solve_row(T, inv_diagonal, i, permuted ? size_t(p) : i, b, x);
+        }
+    }
+}
+
+template <typename Matrix, typename Array, typename RHS, typename Solution>
+void sync_free_triangular_solve(const Matrix& T, const Array& inv_diagonal, bool lower,
+                                const RHS& b, const Solution& x)
+{
+    typedef typename Matrix::index_type IndexType;
+
+    const long N = T.num_rows;
+
+    if (N == 0)
+        return;
+
+    // completion flag of every row
+    cusp::array1d<int, cusp::host_memory> flags(N, 0);
+    volatile int * done = &flags[0];
+
+    // rows are handed out in dependency order, so the rows a thread
+    // waits for have already been handed out and progress is guaranteed;
+    // since OpenMP 5.0 a plain dynamic schedule may hand chunks out of
+    // order, so ask for a monotonic one where the modifier exists (4.5)
+#if defined(_OPENMP) && _OPENMP >= 201511
+#pragma omp parallel for schedule(monotonic: dynamic, 32)
+#elif defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 32)
+#endif
+    for (long n = 0; n < N; n++)
+    {
+        size_t i = lower ? n : N - 1 - n;
+
+        for (IndexType jj = T.row_offsets[i]; jj < T.row_offsets[i + 1]; jj++)
+        {
+            while (!done[T.column_indices[jj]])
+            {
+#if defined(_OPENMP)
+#pragma omp flush
+#endif
+            }
+        }
+
+#if defined(_OPENMP)
+#pragma omp flush
+#endif
+
+        cusp::detail::triangular_solve_row(T, inv_diagonal, i, i, b, x);
+
+#if defined(_OPENMP)
+#pragma omp flush
+#endif
+
+        done[i] = 1;
+    }
+}
+
+} // end namespace detail
+
+template <typename IndexType, typename ValueType>
+triangular_solver<IndexType,ValueType>
+::triangular_solver(void)
+    : lower(true), reorder(false), algorithm_(triangular_solve_level_set)
+{}
+
+template <typename IndexType, typename ValueType>
+    template <typename MatrixType>
+    triangular_solver<IndexType,ValueType>
+    ::triangular_solver(const MatrixType& A,
+                        bool lower,
+                        bool unit_diagonal,
+                        triangular_solve_algorithm algorithm,
+                        bool reorder)
+    {
+        analyze(A, lower, unit_diagonal, algorithm, reorder);
+    }
+
+template <typename IndexType, typename ValueType>
+    template <typename MatrixType>
+    void triangular_solver<IndexType,ValueType>
+    ::analyze(const MatrixType& A,
+              bool lower,
+              bool unit_diagonal,
+              triangular_solve_algorithm algorithm,
+              bool reorder)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("triangular_solve: matrix must be square");
+
+        cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> B;
+        cusp::array1d<IndexType, cusp::host_memory> diagonal;
+
+        cusp::detail::sorted_csr_with_diagonal(A, B, diagonal);
+
+        const size_t N = B.num_rows;
+
+        if (unit_diagonal)
+        {
+            inv_diagonal.resize(0);
+        }
+        else
+        {
+            inv_diagonal.resize(N);
+
+            for (size_t i = 0; i < N; i++)
+            {
+                if (diagonal[i] < 0 || B.values[diagonal[i]] == ValueType(0))
+                    throw cusp::invalid_input_exception("triangular_solve: matrix has a missing or zero diagonal entry");
+
+                inv_diagonal[i] = ValueType(1) / B.values[diagonal[i]];
+            }
+        }
+
+        cusp::detail::build_level_schedule(B, lower, schedule);
+
+        // a barrier per level pays off when the levels are wide on average
+        if (algorithm == triangular_solve_automatic)
+        {
+            if (N >= cusp::detail::level_parallel_threshold * std::max(size_t(1), schedule.num_levels()))
+                algorithm = triangular_solve_level_set;
+            else
+                algorithm = triangular_solve_sync_free;
+        }
+
+        this->lower      = lower;
+        this->reorder    = reorder && algorithm == triangular_solve_level_set;
+        this->algorithm_ = algorithm;
+
+        cusp::detail::extract_triangle(B, lower, schedule, this->reorder, T);
+    }
+
+template <typename IndexType, typename ValueType>
+    template <typename Array1, typename Array2>
+    void triangular_solver<IndexType,ValueType>
+    ::solve(const Array1& b, Array2& x) const
+    {
+        CUSP_PROFILE_SCOPED();
+
+        typedef typename Array1::value_type ValueType1;
+        typedef typename Array2::value_type ValueType2;
+
+        cusp::detail::strided_columns<const ValueType1> B =
+            cusp::detail::make_strided_columns<const ValueType1>(b, typename Array1::format());
+        cusp::detail::strided_columns<ValueType2> X =
+            cusp::detail::make_strided_columns<ValueType2>(x, typename Array2::format());
+
+        assert(B.num_rows == T.num_rows && X.num_rows == T.num_rows);
+        assert(B.num_cols == X.num_cols);
+
+        if (algorithm_ == triangular_solve_level_set)
+            cusp::detail::level_set_triangular_solve(T, inv_diagonal, schedule, reorder, B, X);
+        else
+            cusp::detail::sync_free_triangular_solve(T, inv_diagonal, lower, B, X);
+    }
+
+template <typename MatrixType, typename Array1, typename Array2>
+void triangular_solve(const MatrixType& A,
+                      Array1& x,
+                      const Array2& b,
+                      bool lower,
+                      bool unit_diagonal)
+{
+    typedef typename MatrixType::index_type IndexType;
+    typedef typename MatrixType::value_type ValueType;
+
+    cusp::triangular_solver<IndexType,ValueType> solver(A, lower, unit_diagonal);
+
+    solver.solve(b, x);
+}
+
+} // end namespace cusp
+
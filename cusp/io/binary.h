@@ -0,0 +1,212 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file binary.h
+ *  \brief Native binary container I/O
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+
+#include <cusp/io/detail/binary_format.h>
+#include <cusp/io/detail/mapped_file.h>
+
+#include <string>
+
+namespace cusp
+{
+namespace io
+{
+
+/*! \addtogroup input_output Input/Output
+ *  \addtogroup binary Binary
+ *  \ingroup input_output
+ *  \{
+ */
+
+/*! \p write_binary : Write a matrix or array to a binary container file
+ *
+ * The file stores the format, the index and value types and the byte
+ * order in its header, followed by one 64-byte aligned section per
+ * array of the container (\p csr_matrix stores \c row_offsets,
+ * \c column_indices and \c values).  Supported containers are
+ * \p array1d, \p array2d, \p coo_matrix, \p csr_matrix, \p dia_matrix,
+ * \p ell_matrix and \p hyb_matrix in any memory space, and their views.
+ *
+ * \param mtx a matrix or array container
+ * \param filename file name of the binary file
+ * \param checksums store a checksum with every section
+ * \tparam Matrix matrix container
+ *
+ * \note if the file already exists it will be overwritten
+ *
+ * \code
+ * #include <cusp/io/binary.h>
+ * #include <cusp/gallery/poisson.h>
+ * #include <cusp/csr_matrix.h>
+ * 
+ * int main(void)
+ * {
+ *     cusp::csr_matrix<int, float, cusp::host_memory> A;
+ *     cusp::gallery::poisson5pt(A, 100, 100);
+ * 
+ *     // save A to disk
+ *     cusp::io::write_binary(A, "A.bin");
+ * 
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see \p read_binary
+ * \see \p binary_file
+ */
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums = true);
+
+/*! \p read_binary : Read a matrix or array from a binary container file
+ *
+ * \param mtx a matrix or array container
+ * \param filename file name of the binary file
+ * \tparam Matrix matrix container
+ *
+ * \note any contents of \p mtx will be overwritten
+ * \note the format, index type and value type of \p mtx must match the
+ *       file, but its memory space and (for \p array2d) orientation may
+ *       differ.  Files written with the other byte order are converted.
+ *
+ * \throws cusp::io_exception if the file is invalid, does not match
+ *         \p mtx, or fails its checksums
+ *
+ * \code
+ * #include <cusp/io/binary.h>
+ * #include <cusp/csr_matrix.h>
+ * 
+ * int main(void)
+ * {
+ *     // read matrix stored in A.bin into a csr_matrix
+ *     cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *     cusp::io::read_binary(A, "A.bin");
+ * 
+ *     return 0;
+ * }
+ * \endcode
+ *
+ * \see \p write_binary
+ */
+template <typename Matrix>
+void read_binary(Matrix& mtx, const std::string& filename);
+
+/*! \p binary_views : host view types over the sections of a mapped
+ *  binary container with the given index and value types.
+ */
+template <typename IndexType, typename ValueType>
+struct binary_views
+{
+  typedef cusp::array1d_view<const IndexType *> index_array;
+  typedef cusp::array1d_view<const ValueType *> value_array;
+
+  typedef value_array                                         array1d;
+  typedef cusp::array2d_view<value_array, cusp::row_major>    array2d;
+  typedef cusp::array2d_view<value_array, cusp::column_major> array2d_column_major;
+
+  typedef cusp::coo_matrix_view<index_array, index_array, value_array,
+                                IndexType, ValueType, cusp::host_memory>   coo_matrix;
+  typedef cusp::csr_matrix_view<index_array, index_array, value_array,
+                                IndexType, ValueType, cusp::host_memory>   csr_matrix;
+  typedef cusp::dia_matrix_view<index_array,
+                                cusp::array2d_view<value_array, cusp::column_major>,
+                                IndexType, ValueType, cusp::host_memory>   dia_matrix;
+  typedef cusp::ell_matrix_view<cusp::array2d_view<index_array, cusp::column_major>,
+                                cusp::array2d_view<value_array, cusp::column_major>,
+                                IndexType, ValueType, cusp::host_memory>   ell_matrix;
+};
+
+/*! \p binary_file : memory-mapped binary container
+ *
+ * Maps a file written by \p write_binary and hands out read-only host
+ * views whose arrays point directly into the mapping, so loading costs
+ * no parsing and no copies; pages are read on first touch.  The views
+ * remain valid for the lifetime of the \p binary_file.
+ *
+ * Views are available for \p array1d, \p array2d, \p coo_matrix,
+ * \p csr_matrix, \p dia_matrix and \p ell_matrix files written with the
+ * host byte order; use \p read_binary for \p hyb_matrix files and for
+ * files from machines with the other byte order.
+ *
+ * \code
+ * #include <cusp/io/binary.h>
+ * #include <cusp/multiply.h>
+ * 
+ * int main(void)
+ * {
+ *     typedef cusp::io::binary_views<int, float>::csr_matrix View;
+ *
+ *     cusp::io::binary_file file("A.bin");
+ *     View A = file.view<View>();
+ *
+ *     cusp::array1d<float, cusp::host_memory> x(A.num_cols, 1);
+ *     cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+ *     cusp::multiply(A, x, y);
+ * 
+ *     return 0;
+ * }
+ * \endcode
+ */
+class binary_file
+{
+  public:
+    /*! Map a binary container.
+     *
+     *  \param filename file name of the binary file
+     *  \param verify_checksums check all section checksums now, which
+     *         reads the whole file
+     */
+    explicit binary_file(const std::string& filename, bool verify_checksums = false);
+
+    /*! Return a view of the mapped container.
+     *
+     *  \tparam View a view type from \p binary_views matching the
+     *          format and types of the file
+     */
+    template <typename View>
+    View view(void) const;
+
+    size_t num_rows(void)    const { return contents.header.num_rows;    }
+    size_t num_cols(void)    const { return contents.header.num_cols;    }
+    size_t num_entries(void) const { return contents.header.num_entries; }
+
+  private:
+    detail::mapped_file     file;
+    detail::binary_contents contents;
+};
+
+/*! \}
+ */
+
+} //end namespace io
+} //end namespace cusp
+
+#include <cusp/io/detail/binary.inl>
+
@@ -0,0 +1,647 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/copy.h>
+#include <cusp/exception.h>
+
+#include <thrust/detail/type_traits.h>
+
+#include <cstring>
+#include <fstream>
+#include <list>
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+//////////////
+// Writing  //
+//////////////
+
+class binary_writer
+{
+  public:
+    binary_writer(unsigned int format, unsigned int index_type, unsigned int value_type,
+                  size_t num_rows, size_t num_cols, size_t num_entries)
+    {
+      std::memset(&header, 0, sizeof(binary_header));
+      std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+      header.version     = binary_version;
+      header.byte_order  = binary_byte_order;
+      header.format      = format;
+      header.index_type  = index_type;
+      header.value_type  = value_type;
+      header.num_rows    = num_rows;
+      header.num_cols    = num_cols;
+      header.num_entries = num_entries;
+    }
+
+    template <typename Array>
+    void add(const Array& a)
+    {
+      add(a, typename Array::format());
+    }
+
+    void write(const std::string& filename, bool checksums)
+    {
+      header.num_sections = sections.size();
+      header.flags        = checksums ? binary_has_checksums : 0;
+
+      size_t offset = binary_round_up(sizeof(binary_header) + sections.size() * sizeof(binary_section));
+
+      for (size_t i = 0; i < sections.size(); i++)
+      {
+        const size_t num_bytes = sections[i].size * binary_type_size(sections[i].type);
+
+        sections[i].offset   = offset;
+        sections[i].checksum = checksums ? binary_checksum(data[i], num_bytes) : 0;
+
+        offset = binary_round_up(offset + num_bytes);
+      }
+
+      std::ofstream file(filename.c_str(), std::ios::out | std::ios::binary);
+
+      if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for writing"));
+
+      static const char padding[binary_alignment] = {0};
+
+      file.write(reinterpret_cast<const char *>(&header), sizeof(binary_header));
+
+      if (!sections.empty())
+        file.write(reinterpret_cast<const char *>(&sections[0]), sections.size() * sizeof(binary_section));
+
+      size_t position = sizeof(binary_header) + sections.size() * sizeof(binary_section);
+
+      for (size_t i = 0; i < sections.size(); i++)
+      {
+        const size_t num_bytes = sections[i].size * binary_type_size(sections[i].type);
+
+        file.write(padding, sections[i].offset - position);
+        file.write(data[i], num_bytes);
+
+        position = sections[i].offset + num_bytes;
+      }
+
+      if (!file)
+        throw cusp::io_exception(std::string("error while writing file \"") + filename + std::string("\""));
+    }
+
+  private:
+    binary_header               header;
+    std::vector<binary_section> sections;
+    std::vector<const char *>   data;
+    std::list< std::vector<char> > staging;  // host copies of device arrays
+
+    template <typename Array>
+    void add(const Array& a, cusp::array1d_format)
+    {
+      typedef typename Array::value_type ValueType;
+
+      binary_section section;
+      std::memset(&section, 0, sizeof(binary_section));
+      section.size = a.size();
+      section.type = binary_type<ValueType>::tag;
+
+      sections.push_back(section);
+      data.push_back(host_data(a, typename Array::memory_space()));
+    }
+
+    template <typename Array>
+    void add(const Array& a, cusp::array2d_format)
+    {
+      typedef typename Array::orientation Orientation;
+
+      add(a.values, cusp::array1d_format());
+
+      binary_section& section = sections.back();
+      section.num_rows = a.num_rows;
+      section.num_cols = a.num_cols;
+      section.pitch    = a.pitch;
+      section.flags    = thrust::detail::is_same<Orientation, cusp::column_major>::value ? binary_column_major : 0;
+    }
+
+    template <typename Array>
+    const char * host_data(const Array& a, cusp::host_memory)
+    {
+      return a.size() == 0 ? 0 : reinterpret_cast<const char *>(&a[0]);
+    }
+
+    template <typename Array, typename MemorySpace>
+    const char * host_data(const Array& a, MemorySpace)
+    {
+      typedef typename Array::value_type ValueType;
+
+      cusp::array1d<ValueType, cusp::host_memory> temp(a);
+
+      staging.push_back(std::vector<char>(temp.size() * sizeof(ValueType)));
+
+      if (temp.size() == 0)
+        return 0;
+
+      std::memcpy(&staging.back()[0], &temp[0], temp.size() * sizeof(ValueType));
+
+      return &staging.back()[0];
+    }
+};
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::array1d_format)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_array1d, 0, binary_type<ValueType>::tag, mtx.size(), 1, mtx.size());
+  writer.add(mtx);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::array2d_format)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_array2d, 0, binary_type<ValueType>::tag, mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::coo_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_coo, binary_type<IndexType>::tag, binary_type<ValueType>::tag,
+                       mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx.row_indices);
+  writer.add(mtx.column_indices);
+  writer.add(mtx.values);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::csr_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_csr, binary_type<IndexType>::tag, binary_type<ValueType>::tag,
+                       mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx.row_offsets);
+  writer.add(mtx.column_indices);
+  writer.add(mtx.values);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::dia_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_dia, binary_type<IndexType>::tag, binary_type<ValueType>::tag,
+                       mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx.diagonal_offsets);
+  writer.add(mtx.values);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::ell_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  binary_writer writer(binary_ell, binary_type<IndexType>::tag, binary_type<ValueType>::tag,
+                       mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx.column_indices);
+  writer.add(mtx.values);
+  writer.write(filename, checksums);
+}
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums, cusp::hyb_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  // the ELL part has num_entries - coo.num_entries entries
+  binary_writer writer(binary_hyb, binary_type<IndexType>::tag, binary_type<ValueType>::tag,
+                       mtx.num_rows, mtx.num_cols, mtx.num_entries);
+  writer.add(mtx.ell.column_indices);
+  writer.add(mtx.ell.values);
+  writer.add(mtx.coo.row_indices);
+  writer.add(mtx.coo.column_indices);
+  writer.add(mtx.coo.values);
+  writer.write(filename, checksums);
+}
+
+//////////////
+// Reading  //
+//////////////
+
+inline void check_binary(bool condition, const char * message)
+{
+  if (!condition)
+    throw cusp::io_exception(message);
+}
+
+inline void check_binary_header(const binary_contents& contents, unsigned int format,
+                                unsigned int index_type, unsigned int value_type, size_t num_sections)
+{
+  const binary_header& header = contents.header;
+
+  check_binary(header.format == format,             "binary file format does not match the container");
+  check_binary(header.index_type == index_type,     "binary file index type does not match the container");
+  check_binary(header.value_type == value_type,     "binary file value type does not match the container");
+  check_binary(header.num_sections == num_sections, "invalid binary section table");
+}
+
+// a 2d section holds pitch elements per row (column for column-major
+// sections), which must cover the row and fit in the section
+inline void check_binary_shape(const binary_section& section, size_t num_rows, size_t num_cols)
+{
+  check_binary(section.num_rows == num_rows && section.num_cols == num_cols,
+               "binary section shape does not match the header");
+
+  const bool   column_major = (section.flags & binary_column_major) != 0;
+  const size_t inner        = column_major ? num_rows : num_cols;
+  const size_t outer        = column_major ? num_cols : num_rows;
+
+  check_binary(outer == 0 || (section.pitch >= inner && section.pitch <= section.size / outer),
+               "binary section pitch does not match its size");
+}
+
+template <typename T>
+const T * binary_section_data(const binary_contents& contents, size_t i, size_t size)
+{
+  const binary_section& section = contents.sections[i];
+
+  check_binary(section.type == binary_type<T>::tag, "binary section type does not match the container");
+  check_binary(section.size == size,                "binary section size does not match the header");
+
+  return reinterpret_cast<const T *>(contents.base + section.offset);
+}
+
+template <typename T>
+void read_binary_section(const binary_contents& contents, size_t i, size_t size,
+                         cusp::array1d<T, cusp::host_memory>& a)
+{
+  const T * src = binary_section_data<T>(contents, i, size);
+
+  verify_binary_section(contents, i);
+
+  a.resize(size);
+
+  if (size == 0)
+    return;
+
+  std::memcpy(&a[0], src, size * sizeof(T));
+
+  if (contents.foreign)
+    swap_bytes(reinterpret_cast<char *>(&a[0]), size * sizeof(T) / binary_type<T>::unit, binary_type<T>::unit);
+}
+
+template <typename T, typename Orientation>
+void read_binary_section(const binary_contents& contents, size_t i, size_t num_rows, size_t num_cols,
+                         cusp::array2d<T, cusp::host_memory, Orientation>& a)
+{
+  const binary_section& section = contents.sections[i];
+
+  const unsigned int orientation = thrust::detail::is_same<Orientation, cusp::column_major>::value ? binary_column_major : 0;
+
+  check_binary(section.flags == orientation, "binary section orientation does not match the container");
+  check_binary_shape(section, num_rows, num_cols);
+
+  a.resize(num_rows, num_cols, section.pitch);
+
+  read_binary_section(contents, i, a.values.size(), a.values);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::array1d_format)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_array1d, 0, binary_type<ValueType>::tag, 1);
+
+  cusp::array1d<ValueType, cusp::host_memory> temp;
+  read_binary_section(contents, 0, contents.header.num_rows, temp);
+
+  cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::array2d_format)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_array2d, 0, binary_type<ValueType>::tag, 1);
+
+  const binary_header& header = contents.header;
+
+  // read in the stored orientation and let copy() reorder if needed
+  if (contents.sections[0].flags & binary_column_major)
+  {
+    cusp::array2d<ValueType, cusp::host_memory, cusp::column_major> temp;
+    read_binary_section(contents, 0, header.num_rows, header.num_cols, temp);
+    cusp::copy(temp, mtx);
+  }
+  else
+  {
+    cusp::array2d<ValueType, cusp::host_memory, cusp::row_major> temp;
+    read_binary_section(contents, 0, header.num_rows, header.num_cols, temp);
+    cusp::copy(temp, mtx);
+  }
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::coo_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_coo, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 3);
+
+  const binary_header& header = contents.header;
+
+  cusp::coo_matrix<IndexType, ValueType, cusp::host_memory> temp;
+  temp.resize(header.num_rows, header.num_cols, header.num_entries);
+
+  read_binary_section(contents, 0, header.num_entries, temp.row_indices);
+  read_binary_section(contents, 1, header.num_entries, temp.column_indices);
+  read_binary_section(contents, 2, header.num_entries, temp.values);
+
+  cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::csr_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_csr, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 3);
+
+  const binary_header& header = contents.header;
+
+  cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> temp;
+  temp.resize(header.num_rows, header.num_cols, header.num_entries);
+
+  read_binary_section(contents, 0, header.num_rows + 1, temp.row_offsets);
+  read_binary_section(contents, 1, header.num_entries,  temp.column_indices);
+  read_binary_section(contents, 2, header.num_entries,  temp.values);
+
+  cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::dia_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_dia, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 2);
+
+  const binary_header& header = contents.header;
+  const size_t num_diagonals  = contents.sections[0].size;
+
+  cusp::dia_matrix<IndexType, ValueType, cusp::host_memory> temp;
+  temp.resize(header.num_rows, header.num_cols, header.num_entries, num_diagonals);
+
+  read_binary_section(contents, 0, num_diagonals, temp.diagonal_offsets);
+  read_binary_section(contents, 1, header.num_rows, num_diagonals, temp.values);
+
+  cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::ell_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_ell, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 2);
+
+  const binary_header& header = contents.header;
+  const size_t num_entries_per_row = contents.sections[0].num_cols;
+
+  cusp::ell_matrix<IndexType, ValueType, cusp::host_memory> temp;
+  temp.resize(header.num_rows, header.num_cols, header.num_entries, num_entries_per_row);
+
+  read_binary_section(contents, 0, header.num_rows, num_entries_per_row, temp.column_indices);
+  read_binary_section(contents, 1, header.num_rows, num_entries_per_row, temp.values);
+
+  cusp::copy(temp, mtx);
+}
+
+template <typename Matrix>
+void read_binary(const binary_contents& contents, Matrix& mtx, cusp::hyb_format)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  check_binary_header(contents, binary_hyb, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 5);
+
+  const binary_header& header = contents.header;
+  const size_t num_entries_per_row = contents.sections[0].num_cols;
+  const size_t num_coo_entries     = contents.sections[4].size;
+
+  check_binary(num_coo_entries <= header.num_entries, "invalid binary section table");
+
+  const size_t num_ell_entries = header.num_entries - num_coo_entries;
+
+  cusp::hyb_matrix<IndexType, ValueType, cusp::host_memory> temp;
+  temp.resize(header.num_rows, header.num_cols, num_ell_entries, num_coo_entries, num_entries_per_row, 1);
+
+  read_binary_section(contents, 0, header.num_rows, num_entries_per_row, temp.ell.column_indices);
+  read_binary_section(contents, 1, header.num_rows, num_entries_per_row, temp.ell.values);
+  read_binary_section(contents, 2, num_coo_entries, temp.coo.row_indices);
+  read_binary_section(contents, 3, num_coo_entries, temp.coo.column_indices);
+  read_binary_section(contents, 4, num_coo_entries, temp.coo.values);
+
+  cusp::copy(temp, mtx);
+}
+
+///////////
+// Views //
+///////////
+
+template <typename Array>
+Array binary_array_view(const binary_contents& contents, size_t i, size_t size)
+{
+  typedef typename Array::value_type ValueType;
+
+  const ValueType * data = binary_section_data<ValueType>(contents, i, size);
+
+  return Array(data, data + size);
+}
+
+template <typename Array>
+Array binary_array_view(const binary_contents& contents, size_t i, size_t num_rows, size_t num_cols)
+{
+  typedef typename Array::orientation       Orientation;
+  typedef typename Array::values_array_type ValuesArray;
+
+  const binary_section& section = contents.sections[i];
+
+  const unsigned int orientation = thrust::detail::is_same<Orientation, cusp::column_major>::value ? binary_column_major : 0;
+
+  check_binary(section.flags == orientation, "binary section orientation does not match the view");
+  check_binary_shape(section, num_rows, num_cols);
+
+  ValuesArray values = binary_array_view<ValuesArray>(contents, i, section.size);
+
+  return Array(num_rows, num_cols, section.pitch, values);
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::array1d_format)
+{
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_array1d, 0, binary_type<ValueType>::tag, 1);
+
+  return binary_array_view<View>(contents, 0, contents.header.num_rows);
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::array2d_format)
+{
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_array2d, 0, binary_type<ValueType>::tag, 1);
+
+  return binary_array_view<View>(contents, 0, contents.header.num_rows, contents.header.num_cols);
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::coo_format)
+{
+  typedef typename View::index_type IndexType;
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_coo, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 3);
+
+  const binary_header& header = contents.header;
+
+  return View(header.num_rows, header.num_cols, header.num_entries,
+              binary_array_view<typename View::row_indices_array_type>   (contents, 0, header.num_entries),
+              binary_array_view<typename View::column_indices_array_type>(contents, 1, header.num_entries),
+              binary_array_view<typename View::values_array_type>        (contents, 2, header.num_entries));
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::csr_format)
+{
+  typedef typename View::index_type IndexType;
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_csr, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 3);
+
+  const binary_header& header = contents.header;
+
+  return View(header.num_rows, header.num_cols, header.num_entries,
+              binary_array_view<typename View::row_offsets_array_type>   (contents, 0, header.num_rows + 1),
+              binary_array_view<typename View::column_indices_array_type>(contents, 1, header.num_entries),
+              binary_array_view<typename View::values_array_type>        (contents, 2, header.num_entries));
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::dia_format)
+{
+  typedef typename View::index_type IndexType;
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_dia, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 2);
+
+  const binary_header& header = contents.header;
+  const size_t num_diagonals  = contents.sections[0].size;
+
+  const typename View::diagonal_offsets_array_type diagonal_offsets =
+    binary_array_view<typename View::diagonal_offsets_array_type>(contents, 0, num_diagonals);
+  const typename View::values_array_type values =
+    binary_array_view<typename View::values_array_type>(contents, 1, header.num_rows, num_diagonals);
+
+  return View(header.num_rows, header.num_cols, header.num_entries, diagonal_offsets, values);
+}
+
+template <typename View>
+View binary_view(const binary_contents& contents, cusp::ell_format)
+{
+  typedef typename View::index_type IndexType;
+  typedef typename View::value_type ValueType;
+
+  check_binary_header(contents, binary_ell, binary_type<IndexType>::tag, binary_type<ValueType>::tag, 2);
+
+  const binary_header& header = contents.header;
+  const size_t num_entries_per_row = contents.sections[0].num_cols;
+
+  const typename View::column_indices_array_type column_indices =
+    binary_array_view<typename View::column_indices_array_type>(contents, 0, header.num_rows, num_entries_per_row);
+  const typename View::values_array_type values =
+    binary_array_view<typename View::values_array_type>(contents, 1, header.num_rows, num_entries_per_row);
+
+  return View(header.num_rows, header.num_cols, header.num_entries, column_indices, values);
+}
+
+} // end namespace detail
+
+
+template <typename Matrix>
+void write_binary(const Matrix& mtx, const std::string& filename, bool checksums)
+{
+  cusp::io::detail::write_binary(mtx, filename, checksums, typename Matrix::format());
+}
+
+template <typename Matrix>
+void read_binary(Matrix& mtx, const std::string& filename)
+{
+  cusp::io::detail::mapped_file file(filename);
+
+  cusp::io::detail::binary_contents contents;
+  cusp::io::detail::parse_binary_contents(contents, file.begin(), file.end());
+
+  cusp::io::detail::read_binary(contents, mtx, typename Matrix::format());
+}
+
+inline binary_file::binary_file(const std::string& filename, bool verify_checksums)
+  : file(filename)
+{
+  cusp::io::detail::parse_binary_contents(contents, file.begin(), file.end());
+
+  if (verify_checksums)
+    for (size_t i = 0; i < contents.sections.size(); i++)
+      cusp::io::detail::verify_binary_section(contents, i);
+}
+
+template <typename View>
+View binary_file::view(void) const
+{
+  if (contents.foreign)
+    throw cusp::io_exception("binary file was written with the other byte order and cannot be viewed in place");
+
+  return cusp::io::detail::binary_view<View>(contents, typename View::format());
+}
+
+} //end namespace io
+} //end namespace cusp
+
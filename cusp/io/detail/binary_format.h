@@ -0,0 +1,265 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/complex.h>
+#include <cusp/exception.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// Layout of the cusp binary container
+//
+//   [binary_header]                          64 bytes
+//   [binary_section] x header.num_sections   64 bytes each
+//   [section data]                           each starting on a 64-byte boundary
+//
+// All fields are stored in the byte order of the writer, recorded in
+// header.byte_order.  Every section is one contiguous array (a 2d
+// section keeps its pitch), so a mapped file can be viewed in place.
+// Section checksums are Fletcher-64 sums over little-endian 32-bit
+// words and are zero when the writer did not compute them.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+const char         binary_magic[8]   = {'C','U','S','P','B','I','N','\0'};
+const unsigned int binary_version    = 1;
+const unsigned int binary_byte_order = 0x01020304;
+const size_t       binary_alignment  = 64;
+
+// container formats
+enum binary_format_tag
+{
+  binary_array1d = 1,
+  binary_array2d = 2,
+  binary_coo     = 3,
+  binary_csr     = 4,
+  binary_dia     = 5,
+  binary_ell     = 6,
+  binary_hyb     = 7
+};
+
+// header.flags
+const unsigned int binary_has_checksums = 1;
+
+// section.flags
+const unsigned int binary_column_major = 1;
+
+struct binary_header
+{
+  char               magic[8];      // binary_magic
+  unsigned int       version;
+  unsigned int       byte_order;    // binary_byte_order as written
+  unsigned int       format;        // binary_format_tag
+  unsigned int       index_type;    // binary_type<IndexType>::tag, 0 for arrays
+  unsigned int       value_type;    // binary_type<ValueType>::tag
+  unsigned int       flags;
+  unsigned int       num_sections;
+  unsigned int       reserved;
+  unsigned long long num_rows;
+  unsigned long long num_cols;
+  unsigned long long num_entries;
+};
+
+struct binary_section
+{
+  unsigned long long offset;        // from the start of the file
+  unsigned long long size;          // number of elements
+  unsigned long long num_rows;      // shape of 2d sections
+  unsigned long long num_cols;
+  unsigned long long pitch;
+  unsigned long long checksum;
+  unsigned int       type;          // binary_type<T>::tag
+  unsigned int       flags;
+  unsigned long long reserved;
+};
+
+// type tags encode the kind of number and its size in bytes
+template <typename T>
+struct binary_type
+{
+  static const unsigned int kind = std::numeric_limits<T>::is_integer ? (std::numeric_limits<T>::is_signed ? 1 : 2) : 3;
+  static const unsigned int tag  = (kind << 8) | sizeof(T);
+  static const size_t       unit = sizeof(T);  // size of the byte-swapped unit
+};
+
+template <typename T>
+struct binary_type< cusp::complex<T> >
+{
+  static const unsigned int tag  = (4 << 8) | sizeof(cusp::complex<T>);
+  static const size_t       unit = sizeof(T);
+};
+
+inline size_t binary_type_size(unsigned int tag)
+{
+  return tag & 0xFF;
+}
+
+inline size_t binary_type_unit(unsigned int tag)
+{
+  return (tag >> 8) == 4 ? binary_type_size(tag) / 2 : binary_type_size(tag);
+}
+
+inline size_t binary_round_up(size_t n)
+{
+  return (n + binary_alignment - 1) / binary_alignment * binary_alignment;
+}
+
+inline void swap_bytes(char * data, size_t count, size_t unit)
+{
+  for (size_t i = 0; i < count; i++)
+    std::reverse(data + i * unit, data + (i + 1) * unit);
+}
+
+template <typename T>
+void swap_value(T& value)
+{
+  swap_bytes(reinterpret_cast<char *>(&value), 1, sizeof(T));
+}
+
+inline unsigned long long binary_checksum(const char * data, size_t num_bytes)
+{
+  const unsigned char * bytes = reinterpret_cast<const unsigned char *>(data);
+  const unsigned long long modulus = 0xFFFFFFFFULL;
+
+  unsigned long long sum1 = 0;
+  unsigned long long sum2 = 0;
+
+  size_t n = 0;
+
+  while (n < num_bytes)
+  {
+    // reduce often enough that sum2 cannot overflow
+    const size_t block_end = std::min(num_bytes, n + 4 * 4096);
+
+    for (; n < block_end; n += 4)
+    {
+      unsigned long long word = 0;
+
+      for (size_t k = 0; k < 4 && n + k < num_bytes; k++)
+        word |= (unsigned long long) bytes[n + k] << (8 * k);
+
+      sum1 += word;
+      sum2 += sum1;
+    }
+
+    sum1 %= modulus;
+    sum2 %= modulus;
+  }
+
+  return (sum2 << 32) | sum1;
+}
+
+// parsed header and section table of a binary container
+struct binary_contents
+{
+  binary_header               header;
+  std::vector<binary_section> sections;
+  const char *                base;
+  bool                        foreign;  // written with the opposite byte order
+};
+
+inline void parse_binary_contents(binary_contents& contents, const char * begin, const char * end)
+{
+  const size_t num_bytes = end - begin;
+
+  if (num_bytes < sizeof(binary_header))
+    throw cusp::io_exception("invalid binary header");
+
+  binary_header& header = contents.header;
+
+  std::memcpy(&header, begin, sizeof(binary_header));
+
+  if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0)
+    throw cusp::io_exception("invalid binary header");
+
+  contents.base    = begin;
+  contents.foreign = header.byte_order != binary_byte_order;
+
+  if (contents.foreign)
+  {
+    swap_value(header.version);
+    swap_value(header.byte_order);
+    swap_value(header.format);
+    swap_value(header.index_type);
+    swap_value(header.value_type);
+    swap_value(header.flags);
+    swap_value(header.num_sections);
+    swap_value(header.num_rows);
+    swap_value(header.num_cols);
+    swap_value(header.num_entries);
+
+    if (header.byte_order != binary_byte_order)
+      throw cusp::io_exception("invalid binary byte order");
+  }
+
+  if (header.version > binary_version)
+    throw cusp::io_exception("unsupported binary version");
+
+  if (header.num_sections > (num_bytes - sizeof(binary_header)) / sizeof(binary_section))
+    throw cusp::io_exception("invalid binary section table");
+
+  contents.sections.resize(header.num_sections);
+
+  for (size_t i = 0; i < header.num_sections; i++)
+  {
+    binary_section& section = contents.sections[i];
+
+    std::memcpy(&section, begin + sizeof(binary_header) + i * sizeof(binary_section), sizeof(binary_section));
+
+    if (contents.foreign)
+    {
+      swap_value(section.offset);
+      swap_value(section.size);
+      swap_value(section.num_rows);
+      swap_value(section.num_cols);
+      swap_value(section.pitch);
+      swap_value(section.checksum);
+      swap_value(section.type);
+      swap_value(section.flags);
+    }
+
+    const size_t type_size = binary_type_size(section.type);
+
+    if (type_size == 0 || section.offset % binary_alignment != 0 || section.offset > num_bytes ||
+        section.size > (num_bytes - section.offset) / type_size)
+      throw cusp::io_exception("invalid binary section");
+  }
+}
+
+inline void verify_binary_section(const binary_contents& contents, size_t i)
+{
+  const binary_section& section = contents.sections[i];
+
+  if (!(contents.header.flags & binary_has_checksums))
+    return;
+
+  if (binary_checksum(contents.base + section.offset, section.size * binary_type_size(section.type)) != section.checksum)
+    throw cusp::io_exception("binary section checksum mismatch");
+}
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
@@ -0,0 +1,452 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/exception.h>
+#include <cusp/io/detail/compression.h>
+#include <cusp/io/detail/text_source.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <deque>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+// Text sources and compressed output for the MatrixMarket readers
+//
+// buffer_source returns a buffer as a single span (see text_source.h for
+// the text source interface).  decompressed_source decodes on a background
+// thread, which keeps up to compressed_queue_blocks blocks ahead of the
+// caller, so decoding overlaps with parsing.
+//
+// compressed_filebuf is a streambuf that hands every filled buffer to a
+// background thread, which compresses it and writes it to the file.
+// Without pthreads both run synchronously on the calling thread.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+// decoded or encoded in blocks of this many bytes unless a size is given
+const size_t compressed_block_bytes  = 1 << 22;
+const size_t compressed_queue_blocks = 4;
+
+class buffer_source
+{
+  public:
+    buffer_source(const char * begin, const char * end)
+      : first(begin), last(end) {}
+
+    bool next(const char *& begin, const char *& end)
+    {
+      if (first == last)
+        return false;
+
+      begin = first;
+      end   = last;
+      first = last;
+
+      return true;
+    }
+
+    void put_back(const char * p)
+    {
+      first = p;
+    }
+
+  private:
+    const char * first;
+    const char * last;
+};
+
+class decompressed_source
+{
+  public:
+    decompressed_source(const char * begin, const char * end, compression_format format,
+                        size_t block_bytes = compressed_block_bytes)
+      : input(begin), input_end(end), codec(format), block_bytes(block_bytes),
+        spans(*this), finished(false)
+#if !defined(_WIN32)
+        , stop(false)
+#endif
+    {
+#if !defined(_WIN32)
+      pthread_mutex_init(&mutex, 0);
+      pthread_cond_init(&cond, 0);
+
+      if (pthread_create(&producer, 0, producer_main, this) != 0)
+      {
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+        throw cusp::runtime_exception("unable to start decompression thread");
+      }
+#endif
+    }
+
+    ~decompressed_source(void)
+    {
+#if !defined(_WIN32)
+      pthread_mutex_lock(&mutex);
+      stop = true;
+      pthread_cond_broadcast(&cond);
+      pthread_mutex_unlock(&mutex);
+
+      pthread_join(producer, 0);
+
+      pthread_cond_destroy(&cond);
+      pthread_mutex_destroy(&mutex);
+#endif
+    }
+
+    bool next(const char *& begin, const char *& end)
+    {
+      return spans.next(begin, end);
+    }
+
+    void put_back(const char * p)
+    {
+      spans.put_back(p);
+    }
+
+  private:
+    const char *  input;
+    const char *  input_end;
+    decoder       codec;
+    size_t        block_bytes;
+
+    // consumer: decoded text split at line boundaries
+    line_spans<decompressed_source> spans;
+    friend class line_spans<decompressed_source>;
+
+    // shared: decoded blocks in order, end of data, first error
+    std::deque< std::vector<char> > queue;
+    bool        finished;
+    std::string error;
+
+#if !defined(_WIN32)
+    bool            stop;
+    pthread_t       producer;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+#endif
+
+    // decodes the next block, returns false after the last one
+    bool decode_block(std::vector<char>& block)
+    {
+      block.resize(block_bytes);
+
+      size_t size = 0;
+
+      while (size < block.size() && !codec.finished())
+        size += codec.decode(input, input_end, &block[0] + size, block.size() - size);
+
+      block.resize(size);
+
+      return !codec.finished();
+    }
+
+    // takes the next decoded block, returns false at the end of the data
+    bool take(std::vector<char>& block)
+    {
+#if !defined(_WIN32)
+      pthread_mutex_lock(&mutex);
+
+      while (queue.empty() && !finished)
+        pthread_cond_wait(&cond, &mutex);
+
+      const bool available = !queue.empty();
+
+      if (available)
+      {
+        block.swap(queue.front());
+        queue.pop_front();
+        pthread_cond_broadcast(&cond);
+      }
+
+      const std::string message = error;
+
+      pthread_mutex_unlock(&mutex);
+
+      if (!available && !message.empty())
+        throw cusp::io_exception(message);
+
+      return available;
+#else
+      if (finished)
+        return false;
+
+      finished = !decode_block(block);
+
+      return true;
+#endif
+    }
+
+#if !defined(_WIN32)
+    static void * producer_main(void * arg)
+    {
+      decompressed_source& s = *static_cast<decompressed_source *>(arg);
+
+      pthread_mutex_lock(&s.mutex);
+
+      while (!s.finished)
+      {
+        while (s.queue.size() >= compressed_queue_blocks && !s.stop)
+          pthread_cond_wait(&s.cond, &s.mutex);
+
+        if (s.stop)
+          break;
+
+        pthread_mutex_unlock(&s.mutex);
+
+        std::vector<char> block;
+        std::string       message;
+        bool              more = false;
+
+        try
+        {
+          more = s.decode_block(block);
+        }
+        catch (const std::exception& e)
+        {
+          // drop the partly decoded block, the error ends the data
+          block.clear();
+          message = e.what();
+        }
+
+        pthread_mutex_lock(&s.mutex);
+
+        if (!block.empty())
+        {
+          s.queue.push_back(std::vector<char>());
+          s.queue.back().swap(block);
+        }
+
+        if (!more)
+        {
+          s.finished = true;
+          s.error    = message;
+        }
+
+        pthread_cond_broadcast(&s.cond);
+      }
+
+      pthread_mutex_unlock(&s.mutex);
+
+      return 0;
+    }
+#endif
+
+    // non-copyable
+    decompressed_source(const decompressed_source&);
+    decompressed_source& operator=(const decompressed_source&);
+};
+
+class compressed_filebuf : public std::streambuf
+{
+  public:
+    compressed_filebuf(const std::string& filename, compression_format format,
+                       size_t block_bytes = compressed_block_bytes)
+      : codec(format), file(0), closed(false), failed(false)
+#if !defined(_WIN32)
+        , last(false)
+#endif
+    {
+      file = std::fopen(filename.c_str(), "wb");
+
+      if (file == 0)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for writing"));
+
+      buffer.resize(block_bytes);
+      setp(&buffer[0], &buffer[0] + buffer.size());
+
+#if !defined(_WIN32)
+      pthread_mutex_init(&mutex, 0);
+      pthread_cond_init(&cond, 0);
+
+      if (pthread_create(&consumer, 0, consumer_main, this) != 0)
+      {
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+        std::fclose(file);
+        throw cusp::runtime_exception("unable to start compression thread");
+      }
+#endif
+    }
+
+    ~compressed_filebuf(void)
+    {
+      try
+      {
+        close();
+      }
+      catch (...)
+      {
+      }
+    }
+
+    // compresses the remaining output and closes the file
+    void close(void)
+    {
+      if (closed)
+        return;
+
+      closed = true;
+
+      hand_off(true);
+
+#if !defined(_WIN32)
+      pthread_join(consumer, 0);
+
+      pthread_cond_destroy(&cond);
+      pthread_mutex_destroy(&mutex);
+#endif
+
+      if (std::fclose(file) != 0)
+        failed = true;
+
+      if (failed)
+        throw cusp::io_exception("unable to write compressed file");
+    }
+
+  protected:
+    int_type overflow(int_type c)
+    {
+      hand_off(false);
+
+      if (!traits_type::eq_int_type(c, traits_type::eof()))
+      {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+      }
+
+      // write errors are reported by close()
+      return traits_type::not_eof(c);
+    }
+
+  private:
+    encoder           codec;
+    std::FILE *       file;
+    std::vector<char> buffer;
+    bool              closed;
+    bool              failed;
+
+#if !defined(_WIN32)
+    // filled buffers waiting to be compressed, last marks the end
+    std::deque< std::vector<char> > queue;
+    bool            last;
+    pthread_t       consumer;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+#endif
+
+    // compresses a filled buffer and writes it, returns false on failure
+    bool write_block(const std::vector<char>& block, bool end)
+    {
+      std::vector<char> output;
+
+      try
+      {
+        codec.encode(block.empty() ? 0 : &block[0], block.size(), output, end);
+      }
+      catch (const std::exception&)
+      {
+        return false;
+      }
+
+      return output.empty() || std::fwrite(&output[0], 1, output.size(), file) == output.size();
+    }
+
+    // passes the filled part of the buffer on and starts a new one
+    void hand_off(bool end)
+    {
+      std::vector<char> block(pbase(), pptr());
+
+#if !defined(_WIN32)
+      pthread_mutex_lock(&mutex);
+
+      while (queue.size() >= compressed_queue_blocks)
+        pthread_cond_wait(&cond, &mutex);
+
+      queue.push_back(std::vector<char>());
+      queue.back().swap(block);
+      last = end;
+
+      pthread_cond_broadcast(&cond);
+      pthread_mutex_unlock(&mutex);
+#else
+      if (!write_block(block, end))
+        failed = true;
+#endif
+
+      setp(&buffer[0], &buffer[0] + buffer.size());
+    }
+
+#if !defined(_WIN32)
+    static void * consumer_main(void * arg)
+    {
+      compressed_filebuf& b = *static_cast<compressed_filebuf *>(arg);
+
+      pthread_mutex_lock(&b.mutex);
+
+      for (;;)
+      {
+        while (b.queue.empty())
+          pthread_cond_wait(&b.cond, &b.mutex);
+
+        std::vector<char> block;
+        block.swap(b.queue.front());
+        b.queue.pop_front();
+
+        const bool end = b.last && b.queue.empty();
+
+        pthread_cond_broadcast(&b.cond);
+        pthread_mutex_unlock(&b.mutex);
+
+        const bool ok = b.failed || b.write_block(block, end);
+
+        pthread_mutex_lock(&b.mutex);
+
+        if (!ok)
+          b.failed = true;
+
+        if (end)
+          break;
+      }
+
+      pthread_mutex_unlock(&b.mutex);
+
+      return 0;
+    }
+#endif
+
+    // non-copyable
+    compressed_filebuf(const compressed_filebuf&);
+    compressed_filebuf& operator=(const compressed_filebuf&);
+};
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
@@ -0,0 +1,362 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/exception.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#if defined(CUSP_USE_ZLIB)
+#include <zlib.h>
+#endif
+
+#if defined(CUSP_USE_ZSTD)
+#include <zstd.h>
+#endif
+
+// Streaming gzip and zstd codecs
+//
+// Compressed data is recognized by its magic bytes.  The codecs wrap
+// zlib and libzstd, which are used only when CUSP_USE_ZLIB and
+// CUSP_USE_ZSTD are defined (and the program is linked with -lz and
+// -lzstd 1.4 or later); otherwise constructing a codec for that format throws
+// cusp::io_exception.  Concatenated gzip members and zstd frames are
+// decoded as one stream.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+enum compression_format
+{
+  compression_none,
+  compression_gzip,
+  compression_zstd
+};
+
+inline compression_format detect_compression(const char * begin, const char * end)
+{
+  const unsigned char * p = reinterpret_cast<const unsigned char *>(begin);
+  const size_t n = end - begin;
+
+  if (n >= 2 && p[0] == 0x1f && p[1] == 0x8b)
+    return compression_gzip;
+  if (n >= 4 && p[0] == 0x28 && p[1] == 0xb5 && p[2] == 0x2f && p[3] == 0xfd)
+    return compression_zstd;
+
+  return compression_none;
+}
+
+// output files are compressed according to their extension
+inline compression_format compression_from_filename(const std::string& filename)
+{
+  const size_t n = filename.size();
+
+  if (n >= 3 && filename.compare(n - 3, 3, ".gz") == 0)
+    return compression_gzip;
+  if (n >= 4 && filename.compare(n - 4, 4, ".zst") == 0)
+    return compression_zstd;
+
+  return compression_none;
+}
+
+inline void require_codec(compression_format format)
+{
+#if !defined(CUSP_USE_ZLIB)
+  if (format == compression_gzip)
+    throw cusp::io_exception("gzip compressed file: cusp was compiled without zlib support (define CUSP_USE_ZLIB)");
+#endif
+#if !defined(CUSP_USE_ZSTD)
+  if (format == compression_zstd)
+    throw cusp::io_exception("zstd compressed file: cusp was compiled without zstd support (define CUSP_USE_ZSTD)");
+#endif
+  (void) format;
+}
+
+class decoder
+{
+  public:
+    explicit decoder(compression_format format)
+      : format(format), done(false)
+    {
+      require_codec(format);
+
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+      {
+        zstream.zalloc = Z_NULL;
+        zstream.zfree  = Z_NULL;
+        zstream.opaque = Z_NULL;
+        zstream.next_in  = Z_NULL;
+        zstream.avail_in = 0;
+
+        // 15 + 32: any window size, gzip or zlib header
+        if (inflateInit2(&zstream, 15 + 32) != Z_OK)
+          throw cusp::io_exception("unable to initialize gzip decoder");
+      }
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+      {
+        dstream = ZSTD_createDStream();
+
+        if (dstream == 0 || ZSTD_isError(ZSTD_initDStream(dstream)))
+        {
+          ZSTD_freeDStream(dstream);
+          throw cusp::io_exception("unable to initialize zstd decoder");
+        }
+      }
+#endif
+    }
+
+    ~decoder(void)
+    {
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+        inflateEnd(&zstream);
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+        ZSTD_freeDStream(dstream);
+#endif
+    }
+
+    // decodes from [in,in_end) into [out,out + out_size), advances in
+    // and returns the number of bytes written
+    size_t decode(const char *& in, const char * in_end, char * out, size_t out_size)
+    {
+      size_t written = 0;
+
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+      {
+        while (written < out_size && !done)
+        {
+          const size_t in_size = std::min<size_t>(in_end - in, 1u << 30);
+
+          zstream.next_in   = reinterpret_cast<Bytef *>(const_cast<char *>(in));
+          zstream.avail_in  = in_size;
+          zstream.next_out  = reinterpret_cast<Bytef *>(out + written);
+          zstream.avail_out = std::min<size_t>(out_size - written, 1u << 30);
+
+          const size_t out_before = zstream.avail_out;
+          const int    status     = inflate(&zstream, Z_NO_FLUSH);
+
+          in      += in_size - zstream.avail_in;
+          written += out_before - zstream.avail_out;
+
+          if (status == Z_STREAM_END)
+          {
+            // another member may follow
+            if (detect_compression(in, in_end) == compression_gzip)
+              inflateReset(&zstream);
+            else
+              done = true;
+          }
+          else if (status == Z_BUF_ERROR && in == in_end)
+          {
+            throw cusp::io_exception("truncated gzip data");
+          }
+          else if (status != Z_OK && status != Z_BUF_ERROR)
+          {
+            throw cusp::io_exception("corrupt gzip data");
+          }
+        }
+      }
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+      {
+        while (written < out_size && !done)
+        {
+          ZSTD_inBuffer  input  = { in, size_t(in_end - in), 0 };
+          ZSTD_outBuffer output = { out + written, out_size - written, 0 };
+
+          const size_t status = ZSTD_decompressStream(dstream, &output, &input);
+
+          if (ZSTD_isError(status))
+            throw cusp::io_exception(std::string("corrupt zstd data: ") + ZSTD_getErrorName(status));
+
+          in      += input.pos;
+          written += output.pos;
+
+          // a frame ended; another one may follow
+          if (status == 0 && in == in_end)
+            done = true;
+          else if (input.pos == 0 && output.pos == 0 && in == in_end)
+            throw cusp::io_exception("truncated zstd data");
+        }
+      }
+#endif
+
+      return written;
+    }
+
+    // true once the end of the compressed stream has been decoded
+    bool finished(void) const { return done; }
+
+  private:
+    compression_format format;
+    bool done;
+
+#if defined(CUSP_USE_ZLIB)
+    z_stream zstream;
+#endif
+#if defined(CUSP_USE_ZSTD)
+    ZSTD_DStream * dstream;
+#endif
+
+    // non-copyable
+    decoder(const decoder&);
+    decoder& operator=(const decoder&);
+};
+
+class encoder
+{
+  public:
+    explicit encoder(compression_format format)
+      : format(format)
+    {
+      require_codec(format);
+
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+      {
+        zstream.zalloc = Z_NULL;
+        zstream.zfree  = Z_NULL;
+        zstream.opaque = Z_NULL;
+
+        // 15 + 16: largest window, gzip header
+        if (deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+          throw cusp::io_exception("unable to initialize gzip encoder");
+      }
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+      {
+        cstream = ZSTD_createCStream();
+
+        // frames carry a content checksum, so damage that still decodes
+        // (e.g. inside literals) is reported by the decoder
+        if (cstream == 0 || ZSTD_isError(ZSTD_initCStream(cstream, 3)) ||
+            ZSTD_isError(ZSTD_CCtx_setParameter(cstream, ZSTD_c_checksumFlag, 1)))
+        {
+          ZSTD_freeCStream(cstream);
+          throw cusp::io_exception("unable to initialize zstd encoder");
+        }
+      }
+#endif
+    }
+
+    ~encoder(void)
+    {
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+        deflateEnd(&zstream);
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+        ZSTD_freeCStream(cstream);
+#endif
+    }
+
+    // appends the encoding of [data,data + size) to output, last ends the stream
+    void encode(const char * data, size_t size, std::vector<char>& output, bool last)
+    {
+      const size_t block = 1 << 18;
+
+#if defined(CUSP_USE_ZLIB)
+      if (format == compression_gzip)
+      {
+        zstream.next_in  = reinterpret_cast<Bytef *>(const_cast<char *>(data));
+        zstream.avail_in = size;
+
+        for (;;)
+        {
+          const size_t offset = output.size();
+          output.resize(offset + block);
+
+          zstream.next_out  = reinterpret_cast<Bytef *>(&output[offset]);
+          zstream.avail_out = block;
+
+          const int status = deflate(&zstream, last ? Z_FINISH : Z_NO_FLUSH);
+
+          output.resize(offset + block - zstream.avail_out);
+
+          if (status == Z_STREAM_ERROR)
+            throw cusp::io_exception("gzip encoder failed");
+
+          if (last ? status == Z_STREAM_END : (zstream.avail_in == 0 && zstream.avail_out != 0))
+            break;
+        }
+      }
+#endif
+#if defined(CUSP_USE_ZSTD)
+      if (format == compression_zstd)
+      {
+        ZSTD_inBuffer input = { data, size, 0 };
+
+        bool flushed = !last;
+
+        while (input.pos < input.size || !flushed)
+        {
+          const size_t offset = output.size();
+          output.resize(offset + block);
+
+          ZSTD_outBuffer out = { &output[offset], block, 0 };
+
+          const bool   ending = input.pos == input.size;
+          const size_t status = ending ? ZSTD_endStream(cstream, &out)
+                                       : ZSTD_compressStream(cstream, &out, &input);
+
+          output.resize(offset + out.pos);
+
+          if (ZSTD_isError(status))
+            throw cusp::io_exception(std::string("zstd encoder failed: ") + ZSTD_getErrorName(status));
+
+          // endStream returns the number of bytes still to be flushed
+          flushed = flushed || (ending && status == 0);
+        }
+      }
+#endif
+      (void) data; (void) size; (void) output; (void) last; (void) block;
+    }
+
+  private:
+    compression_format format;
+
+#if defined(CUSP_USE_ZLIB)
+    z_stream zstream;
+#endif
+#if defined(CUSP_USE_ZSTD)
+    ZSTD_CStream * cstream;
+#endif
+
+    // non-copyable
+    encoder(const encoder&);
+    encoder& operator=(const encoder&);
+};
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
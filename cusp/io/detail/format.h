@@ -0,0 +1,130 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+// Locale-free formatters for MatrixMarket text
+//
+// Each format_* function writes one token starting at p and returns the
+// position following it; the caller provides max_integer_chars or
+// max_real_chars bytes.  Reals are written with the fewest significant
+// digits that read back to the same value: integral values directly,
+// everything else by trying %.15g, %.16g and %.17g (%.6g through %.9g
+// for float) and keeping the first that round-trips.  A decimal comma
+// produced by the C locale is replaced with a point.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+const size_t max_integer_chars = 24;
+const size_t max_real_chars    = 32;
+
+inline char * format_unsigned(char * p, unsigned long long value)
+{
+  char digits[max_integer_chars];
+  int  n = 0;
+
+  do
+  {
+    digits[n++] = char('0' + value % 10);
+    value /= 10;
+  } while (value != 0);
+
+  while (n > 0)
+    *p++ = digits[--n];
+
+  return p;
+}
+
+inline char * format_integer(char * p, long long value)
+{
+  if (value < 0)
+  {
+    *p++ = '-';
+    return format_unsigned(p, 0ULL - (unsigned long long) value);
+  }
+
+  return format_unsigned(p, value);
+}
+
+inline int format_printf(char * buffer, size_t size, int digits, double value)
+{
+#if defined(_MSC_VER) && _MSC_VER < 1900
+  return _snprintf(buffer, size, "%.*g", digits, value);
+#else
+  return std::snprintf(buffer, size, "%.*g", digits, value);
+#endif
+}
+
+inline char * format_shortest(char * p, double value, int min_digits, int max_digits, bool single)
+{
+  // integral values, including zero, need no search
+  if (value > -1e15 && value < 1e15 && value == (double) (long long) value)
+  {
+    if (value == 0 && 1 / value < 0)
+      *p++ = '-';
+
+    return format_integer(p, (long long) value);
+  }
+
+  char buffer[max_real_chars];
+
+  for (int digits = min_digits; ; digits++)
+  {
+    format_printf(buffer, sizeof(buffer), digits, value);
+
+    if (digits == max_digits)
+      break;
+
+    const double parsed = std::strtod(buffer, 0);
+
+    if (single ? (float) parsed == (float) value : parsed == value)
+      break;
+  }
+
+  for (const char * q = buffer; *q; q++)
+    *p++ = (*q == ',') ? '.' : *q;
+
+  return p;
+}
+
+// subnormals carry fewer significant digits, so their search starts at one
+inline char * format_real(char * p, double value)
+{
+  const bool subnormal = value > -2.2250738585072014e-308 && value < 2.2250738585072014e-308;
+
+  return format_shortest(p, value, subnormal ? 1 : 15, 17, false);
+}
+
+inline char * format_real(char * p, float value)
+{
+  const bool subnormal = value > -1.17549435e-38f && value < 1.17549435e-38f;
+
+  return format_shortest(p, value, subnormal ? 1 : 6, 9, true);
+}
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/exception.h>
+
+#include <string>
+#include <vector>
+#include <fstream>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define CUSP_IO_HAS_MMAP
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+// Read-only view of a whole file
+//
+// On POSIX systems the file is memory-mapped so the parser reads the
+// page cache directly; elsewhere, or when the file cannot be mapped
+// (e.g. a pipe), its contents are read into a buffer once.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+class mapped_file
+{
+  public:
+    explicit mapped_file(const std::string& filename)
+      : ptr(0), length(0), mapped(false)
+    {
+#if defined(CUSP_IO_HAS_MMAP)
+      int fd = ::open(filename.c_str(), O_RDONLY);
+
+      if (fd < 0)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+      struct stat status;
+
+      if (::fstat(fd, &status) == 0 && S_ISREG(status.st_mode) && status.st_size > 0)
+      {
+        void * address = ::mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (address != MAP_FAILED)
+        {
+#if defined(MADV_SEQUENTIAL)
+          ::madvise(address, status.st_size, MADV_SEQUENTIAL);
+#endif
+          ptr    = static_cast<const char *>(address);
+          length = status.st_size;
+          mapped = true;
+        }
+      }
+
+      ::close(fd);
+
+      if (mapped)
+        return;
+#endif
+
+      std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+
+      if (!file)
+        throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+
+      char block[1 << 16];
+
+      while (file.read(block, sizeof(block)) || file.gcount() > 0)
+        buffer.insert(buffer.end(), block, block + file.gcount());
+
+      ptr    = buffer.empty() ? 0 : &buffer[0];
+      length = buffer.size();
+    }
+
+    ~mapped_file(void)
+    {
+#if defined(CUSP_IO_HAS_MMAP)
+      if (mapped)
+        ::munmap(const_cast<char *>(ptr), length);
+#endif
+    }
+
+    const char * begin(void) const { return ptr; }
+    const char * end(void)   const { return ptr + length; }
+    size_t       size(void)  const { return length; }
+
+  private:
+    const char *      ptr;
+    size_t            length;
+    bool              mapped;
+    std::vector<char> buffer;
+
+    // non-copyable
+    mapped_file(const mapped_file&);
+    mapped_file& operator=(const mapped_file&);
+};
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
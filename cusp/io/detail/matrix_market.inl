@@ -19,12 +19,24 @@
 
 #include <cusp/array2d.h>
 #include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
 #include <cusp/complex.h>
 #include <cusp/convert.h>
 #include <cusp/exception.h>
+#include <cusp/symmetric_csr_matrix.h>
 
+#include <cusp/io/detail/compressed_file.h>
+#include <cusp/io/detail/format.h>
+#include <cusp/io/detail/mapped_file.h>
+#include <cusp/io/detail/parse.h>
+#include <cusp/io/detail/text_source.h>
+
+#include <thrust/copy.h>
 #include <thrust/sort.h>
 
+#include <algorithm>
+#include <deque>
+#include <limits>
 #include <vector>
 #include <string>
 #include <fstream>
@@ -110,18 +122,53 @@ void assign_complex(cusp::complex<ScalarType>& value, double real, double imag)
   value.imag(imag);
 }
 
-template <typename Stream, typename ScalarType>
-void write_value(Stream& output, const ScalarType& value)
+// integral values
+template <typename ScalarType>
+char * format_value(char * p, const ScalarType& value)
+{
+  return format_integer(p, (long long) value);
+}
+
+inline char * format_value(char * p, const float& value)
 {
-  output << value;
+  return format_real(p, value);
 }
 
-template <typename Stream, typename ScalarType>
-void write_value(Stream& output, const cusp::complex<ScalarType>& value)
+inline char * format_value(char * p, const double& value)
 {
-  output << value.real() << " " << value.imag();
+  return format_real(p, value);
 }
 
+template <typename ScalarType>
+char * format_value(char * p, const cusp::complex<ScalarType>& value)
+{
+  p = format_value(p, ScalarType(value.real()));
+  *p++ = ' ';
+  return format_value(p, ScalarType(value.imag()));
+}
+
+template <typename ScalarType>
+size_t max_value_chars(const ScalarType&)
+{
+  return max_real_chars;
+}
+
+template <typename ScalarType>
+size_t max_value_chars(const cusp::complex<ScalarType>&)
+{
+  return 2 * max_real_chars + 1;
+}
+
+// relation between the triangles of a non-general file
+inline cusp::symmetry_kind matrix_market_symmetry(const matrix_market_banner& banner)
+{
+  if (banner.symmetry == "hermitian")
+    return cusp::symmetry_hermitian;
+  else if (banner.symmetry == "skew-symmetric")
+    return cusp::symmetry_skew_symmetric;
+  else
+    return cusp::symmetry_symmetric;
+}
 
 template <typename IndexType, typename ValueType, typename Stream>
 void read_coordinate_stream(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo, Stream& input, const matrix_market_banner& banner)
@@ -236,37 +283,26 @@ void read_coordinate_stream(cusp::coo_matrix<IndexType,ValueType,cusp::host_memo
 
     cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> general(num_rows, num_cols, general_num_entries);
 
-    if (banner.symmetry == "symmetric")
-    {
-      size_t nnz = 0;
+    const cusp::symmetry_kind symmetry = matrix_market_symmetry(banner);
 
-      for (size_t n = 0; n < coo.num_entries; n++)
-      {
-        // copy entry over
-        general.row_indices[nnz]    = coo.row_indices[n];
-        general.column_indices[nnz] = coo.column_indices[n];
-        general.values[nnz]         = coo.values[n];
-        nnz++;
+    size_t nnz = 0;
 
-        // duplicate off-diagonals
-        if (coo.row_indices[n] != coo.column_indices[n])
-        {
-          general.row_indices[nnz]    = coo.column_indices[n];
-          general.column_indices[nnz] = coo.row_indices[n];
-          general.values[nnz]         = coo.values[n];
-          nnz++;
-        } 
-      }       
-    } 
-    else if (banner.symmetry == "hermitian")
-    {
-      throw cusp::not_implemented_exception("MatrixMarket I/O does not currently support hermitian matrices");
-      //TODO
-    } 
-    else if (banner.symmetry == "skew-symmetric")
+    for (size_t n = 0; n < coo.num_entries; n++)
     {
-      //TODO
-      throw cusp::not_implemented_exception("MatrixMarket I/O does not currently support skew-symmetric matrices");
+      // copy entry over
+      general.row_indices[nnz]    = coo.row_indices[n];
+      general.column_indices[nnz] = coo.column_indices[n];
+      general.values[nnz]         = coo.values[n];
+      nnz++;
+
+      // duplicate off-diagonals
+      if (coo.row_indices[n] != coo.column_indices[n])
+      {
+        general.row_indices[nnz]    = coo.column_indices[n];
+        general.column_indices[nnz] = coo.row_indices[n];
+        general.values[nnz]         = cusp::detail::mirror_value(ValueType(coo.values[n]), symmetry);
+        nnz++;
+      }
     }
 
     // store full matrix in coo
@@ -353,6 +389,714 @@ void read_array_stream(cusp::array2d<ValueType,cusp::host_memory>& mtx, Stream&
 }
 
 
+// MatrixMarket files are parsed in chunks of about this many bytes
+const size_t parse_chunk_bytes = 1 << 18;
+
+// split [begin,end) into chunks that start at line boundaries
+inline void split_lines(std::vector<const char *>& bounds, const char * begin, const char * end)
+{
+  const size_t num_bytes  = end - begin;
+  const size_t num_chunks = num_bytes / parse_chunk_bytes + 1;
+
+  bounds.resize(num_chunks + 1);
+
+  bounds[0]          = begin;
+  bounds[num_chunks] = end;
+
+  for (size_t i = 1; i < num_chunks; i++)
+  {
+    const char * p = begin + i * (num_bytes / num_chunks);
+
+    // advance to the beginning of the next line
+    bounds[i] = std::max(bounds[i - 1], next_line(p - 1, end));
+  }
+}
+
+// value of a token of the size line
+inline size_t parse_size_token(const std::string& token)
+{
+  const char * p   = token.data();
+  const char * end = p + token.size();
+
+  unsigned long long value;
+
+  if (!parse_unsigned(p, end, value) || p != end || value > std::numeric_limits<size_t>::max())
+    throw cusp::io_exception("invalid MatrixMarket size [" + token + "]");
+
+  return value;
+}
+
+// skips comments and blank lines in [p,end) and returns the position
+// after the size line, whose tokens are left in tokens (empty if the
+// size line was not found before end)
+inline const char * read_matrix_market_size_line(std::vector<std::string>& tokens,
+                                                 const char * p, const char * end)
+{
+  while (tokens.empty() && p != end)
+  {
+    const char * q = next_line(p, end);
+
+    if (*p != '%')
+      detail::tokenize(tokens, std::string(p, q));
+
+    p = q;
+  }
+
+  return p;
+}
+
+// reads the banner and returns the tokens of the size line
+inline const char * read_matrix_market_header(matrix_market_banner& banner,
+                                              std::vector<std::string>& tokens,
+                                              const char * begin, const char * end)
+{
+  const char * p = next_line(begin, end);
+
+  std::istringstream first_line(std::string(begin, p));
+  read_matrix_market_banner(banner, first_line);
+
+  tokens.clear();
+
+  return read_matrix_market_size_line(tokens, p, end);
+}
+
+// reads the header from a text source and leaves the source at the first
+// entry; the comments may continue over any number of spans
+template <typename Source>
+void read_matrix_market_header(matrix_market_banner& banner,
+                               std::vector<std::string>& tokens,
+                               Source& source)
+{
+  const char * begin;
+  const char * end;
+
+  if (!source.next(begin, end))
+    throw cusp::io_exception("invalid MatrixMarket banner");
+
+  const char * p = read_matrix_market_header(banner, tokens, begin, end);
+
+  while (tokens.empty())
+  {
+    if (!source.next(begin, end))
+      return;
+
+    p = read_matrix_market_size_line(tokens, begin, end);
+  }
+
+  source.put_back(p);
+}
+
+template <typename IndexType, typename ValueType>
+struct coordinate_chunk
+{
+  std::vector<IndexType> row_indices;
+  std::vector<IndexType> column_indices;
+  std::vector<ValueType> values;
+  const char * error;
+
+  coordinate_chunk(void) : error(0) {}
+};
+
+template <typename IndexType, typename ValueType>
+void parse_coordinate_chunk(coordinate_chunk<IndexType,ValueType>& chunk,
+                            const char * p, const char * end,
+                            const matrix_market_banner& banner,
+                            size_t num_rows, size_t num_cols)
+{
+  const bool is_pattern = banner.type == "pattern";
+  const bool is_complex = banner.type == "complex";
+
+  while (p != end)
+  {
+    p = skip_blanks(p, end);
+
+    if (p == end)
+      break;
+
+    // skip blank lines and comments
+    if (*p == '\n' || *p == '%')
+    {
+      p = next_line(p, end);
+      continue;
+    }
+
+    unsigned long long i, j;
+    double real = 1, imag = 0;
+
+    if (!parse_unsigned(p, end, i) || !parse_unsigned(p, end, j) ||
+        (!is_pattern && !parse_real(p, end, real)) ||
+        ( is_complex && !parse_real(p, end, imag)))
+    {
+      chunk.error = "invalid MatrixMarket coordinate entry";
+      return;
+    }
+
+    if (i < 1)        { chunk.error = "found invalid row index (index < 1)";             return; }
+    if (j < 1)        { chunk.error = "found invalid column index (index < 1)";          return; }
+    if (i > num_rows) { chunk.error = "found invalid row index (index > num_rows)";      return; }
+    if (j > num_cols) { chunk.error = "found invalid column index (index > num_columns)"; return; }
+
+    ValueType value;
+    assign_complex(value, real, imag);
+
+    // convert base-1 indices to base-0
+    chunk.row_indices.push_back(i - 1);
+    chunk.column_indices.push_back(j - 1);
+    chunk.values.push_back(value);
+
+    p = next_line(p, end);
+  }
+}
+
+// parse the entries of a coordinate file into chunks and determine how
+// many entries of each chunk belong to the matrix
+template <typename IndexType, typename ValueType, typename Source>
+void parse_coordinate_chunks(std::deque< coordinate_chunk<IndexType,ValueType> >& chunks,
+                             std::vector<size_t>& counts,
+                             size_t& num_rows, size_t& num_cols,
+                             Source& body,
+                             const matrix_market_banner& banner,
+                             const std::vector<std::string>& tokens)
+{
+  if (tokens.size() != 3)
+    throw cusp::io_exception("invalid MatrixMarket coordinate format");
+
+  num_rows = parse_size_token(tokens[0]);
+  num_cols = parse_size_token(tokens[1]);
+  const size_t num_entries = parse_size_token(tokens[2]);
+
+  if (banner.type != "complex" && banner.type != "real" &&
+      banner.type != "integer" && banner.type != "pattern")
+    throw cusp::io_exception("invalid MatrixMarket data type");
+
+  std::vector<const char *> bounds;
+  const char * begin;
+  const char * end;
+
+  // every span of the source is split into chunks parsed in parallel
+  while (body.next(begin, end))
+  {
+    split_lines(bounds, begin, end);
+
+    const long first = chunks.size();
+    const long count = bounds.size() - 1;
+
+    // a deque grows without moving the chunks parsed so far
+    chunks.resize(first + count);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (count > 1)
+#endif
+    for (long c = 0; c < count; c++)
+      parse_coordinate_chunk(chunks[first + c], bounds[c], bounds[c + 1], banner, num_rows, num_cols);
+  }
+
+  const long num_chunks = chunks.size();
+
+  // keep the first num_entries entries, as the stream reader does
+  counts.resize(num_chunks);
+  size_t num_entries_read = 0;
+
+  for (long c = 0; c < num_chunks; c++)
+  {
+    counts[c] = std::min(chunks[c].values.size(), num_entries - num_entries_read);
+
+    if (chunks[c].error && num_entries_read + counts[c] < num_entries)
+      throw cusp::io_exception(chunks[c].error);
+
+    num_entries_read += counts[c];
+  }
+
+  if (num_entries_read != num_entries)
+    throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
+}
+
+template <typename IndexType, typename ValueType>
+void release_coordinate_chunk(coordinate_chunk<IndexType,ValueType>& chunk)
+{
+  std::vector<IndexType>().swap(chunk.row_indices);
+  std::vector<IndexType>().swap(chunk.column_indices);
+  std::vector<ValueType>().swap(chunk.values);
+}
+
+template <typename IndexType, typename ValueType, typename Source>
+void read_coordinate_source(cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo,
+                            Source& body,
+                            const matrix_market_banner& banner,
+                            const std::vector<std::string>& tokens)
+{
+  std::deque< coordinate_chunk<IndexType,ValueType> > chunks;
+  std::vector<size_t> counts;
+  size_t num_rows, num_cols;
+
+  parse_coordinate_chunks(chunks, counts, num_rows, num_cols, body, banner, tokens);
+
+  const long num_chunks   = chunks.size();
+  const bool is_symmetric = banner.symmetry != "general";
+
+  const cusp::symmetry_kind symmetry = matrix_market_symmetry(banner);
+
+  // symmetric formats are expanded to "general" format while merging
+  std::vector<size_t> offsets(num_chunks + 1, 0);
+
+#if defined(_OPENMP)
+#pragma omp parallel for if (num_chunks > 1)
+#endif
+  for (long c = 0; c < num_chunks; c++)
+  {
+    size_t size = counts[c];
+
+    if (is_symmetric)
+      for (size_t n = 0; n < counts[c]; n++)
+        if (chunks[c].row_indices[n] != chunks[c].column_indices[n])
+          size++;
+
+    offsets[c + 1] = size;
+  }
+
+  for (long c = 0; c < num_chunks; c++)
+    offsets[c + 1] += offsets[c];
+
+  coo.resize(num_rows, num_cols, offsets[num_chunks]);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+#endif
+  for (long c = 0; c < num_chunks; c++)
+  {
+    coordinate_chunk<IndexType,ValueType>& chunk = chunks[c];
+
+    size_t nnz = offsets[c];
+
+    for (size_t n = 0; n < counts[c]; n++)
+    {
+      coo.row_indices[nnz]    = chunk.row_indices[n];
+      coo.column_indices[nnz] = chunk.column_indices[n];
+      coo.values[nnz]         = chunk.values[n];
+      nnz++;
+
+      // duplicate off-diagonals
+      if (is_symmetric && chunk.row_indices[n] != chunk.column_indices[n])
+      {
+        coo.row_indices[nnz]    = chunk.column_indices[n];
+        coo.column_indices[nnz] = chunk.row_indices[n];
+        coo.values[nnz]         = cusp::detail::mirror_value(chunk.values[n], symmetry);
+        nnz++;
+      }
+    }
+
+    // release chunk storage as soon as it has been merged
+    release_coordinate_chunk(chunk);
+  }
+
+  // sort indices by (row,column) unless the file already was
+  if (!coo.is_sorted_by_row_and_column())
+    coo.sort_by_row_and_column();
+}
+
+template <typename IndexType>
+IndexType fetch_and_increment(IndexType& counter)
+{
+  IndexType old;
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp atomic capture
+#endif
+  old = counter++;
+  return old;
+}
+
+template <typename IndexType, typename ValueType>
+struct column_less
+{
+  bool operator()(const std::pair<IndexType,ValueType>& a, const std::pair<IndexType,ValueType>& b) const
+  {
+    return a.first < b.first;
+  }
+};
+
+// Assembles parsed coordinate chunks straight into CSR: a counting pass
+// over the chunks builds the row offsets, a second pass scatters every
+// entry into its row, and each row is then sorted by column on its own.
+// No intermediate COO is formed.  With \p mirror every off-diagonal entry
+// is also stored at its transposed position; with \p fold entries below
+// the diagonal are moved to their transposed position instead, which
+// leaves only the upper triangle.  Duplicate entries of a row keep their
+// file order unless the scatter runs in parallel.
+template <typename IndexType, typename ValueType>
+void assemble_coordinate_chunks(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr,
+                                std::deque< coordinate_chunk<IndexType,ValueType> >& chunks,
+                                std::vector<size_t>& counts,
+                                size_t num_rows, size_t num_cols,
+                                cusp::symmetry_kind symmetry,
+                                bool mirror, bool fold)
+{
+  const long num_chunks = chunks.size();
+
+  // count row lengths, including mirrored entries
+  std::vector<IndexType> row_lengths(num_rows + 1, 0);
+  IndexType * lengths = &row_lengths[0];
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+#endif
+  for (long c = 0; c < num_chunks; c++)
+  {
+    const coordinate_chunk<IndexType,ValueType>& chunk = chunks[c];
+
+    for (size_t n = 0; n < counts[c]; n++)
+    {
+      IndexType i = chunk.row_indices[n];
+      IndexType j = chunk.column_indices[n];
+
+      if (fold && i > j)
+        std::swap(i, j);
+
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+      lengths[i + 1]++;
+
+      if (mirror && i != j)
+      {
+#if defined(_OPENMP)
+#pragma omp atomic
+#endif
+        lengths[j + 1]++;
+      }
+    }
+  }
+
+  for (size_t i = 0; i < num_rows; i++)
+    row_lengths[i + 1] += row_lengths[i];
+
+  csr.resize(num_rows, num_cols, row_lengths[num_rows]);
+
+  thrust::copy(row_lengths.begin(), row_lengths.end(), csr.row_offsets.begin());
+
+  // scatter entries into their rows, row_lengths[i] becomes the next free slot of row i
+  IndexType * next = &row_lengths[0];
+
+#if defined(_OPENMP) && _OPENMP >= 201107
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+#endif
+  for (long c = 0; c < num_chunks; c++)
+  {
+    coordinate_chunk<IndexType,ValueType>& chunk = chunks[c];
+
+    for (size_t n = 0; n < counts[c]; n++)
+    {
+      IndexType i = chunk.row_indices[n];
+      IndexType j = chunk.column_indices[n];
+      ValueType v = chunk.values[n];
+
+      if (fold && i > j)
+      {
+        std::swap(i, j);
+        v = cusp::detail::mirror_value(v, symmetry);
+      }
+
+      IndexType k = fetch_and_increment(next[i]);
+      csr.column_indices[k] = j;
+      csr.values[k]         = v;
+
+      if (mirror && i != j)
+      {
+        k = fetch_and_increment(next[j]);
+        csr.column_indices[k] = i;
+        csr.values[k]         = cusp::detail::mirror_value(v, symmetry);
+      }
+    }
+
+    release_coordinate_chunk(chunk);
+  }
+
+  std::vector<size_t>().swap(counts);
+  std::vector<IndexType>().swap(row_lengths);
+
+  // sort every row by column index
+  const long N = num_rows;
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic, 256)
+#endif
+  for (long i = 0; i < N; i++)
+  {
+    const IndexType row_start = csr.row_offsets[i];
+    const IndexType row_end   = csr.row_offsets[i + 1];
+
+    bool sorted = true;
+
+    for (IndexType jj = row_start + 1; jj < row_end && sorted; jj++)
+      sorted = csr.column_indices[jj - 1] <= csr.column_indices[jj];
+
+    if (sorted)
+      continue;
+
+    std::vector< std::pair<IndexType,ValueType> > row(row_end - row_start);
+
+    for (IndexType jj = row_start; jj < row_end; jj++)
+      row[jj - row_start] = std::make_pair(csr.column_indices[jj], csr.values[jj]);
+
+    std::stable_sort(row.begin(), row.end(), column_less<IndexType,ValueType>());
+
+    for (IndexType jj = row_start; jj < row_end; jj++)
+    {
+      csr.column_indices[jj] = row[jj - row_start].first;
+      csr.values[jj]         = row[jj - row_start].second;
+    }
+  }
+}
+
+// Reads a coordinate file straight into CSR, symmetric formats are
+// expanded to "general" format during assembly.
+template <typename IndexType, typename ValueType, typename Source>
+void read_coordinate_source(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr,
+                            Source& body,
+                            const matrix_market_banner& banner,
+                            const std::vector<std::string>& tokens)
+{
+  std::deque< coordinate_chunk<IndexType,ValueType> > chunks;
+  std::vector<size_t> counts;
+  size_t num_rows, num_cols;
+
+  parse_coordinate_chunks(chunks, counts, num_rows, num_cols, body, banner, tokens);
+
+  assemble_coordinate_chunks(csr, chunks, counts, num_rows, num_cols,
+                             matrix_market_symmetry(banner), banner.symmetry != "general", false);
+}
+
+// Reads the upper triangle of a symmetric, Hermitian or skew-symmetric
+// coordinate file into CSR.  Entries stored below the diagonal are
+// folded onto the upper triangle, nothing is expanded.
+template <typename IndexType, typename ValueType, typename Source>
+void read_upper_triangle_source(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& csr,
+                                Source& body,
+                                const matrix_market_banner& banner,
+                                const std::vector<std::string>& tokens)
+{
+  std::deque< coordinate_chunk<IndexType,ValueType> > chunks;
+  std::vector<size_t> counts;
+  size_t num_rows, num_cols;
+
+  parse_coordinate_chunks(chunks, counts, num_rows, num_cols, body, banner, tokens);
+
+  if (num_rows != num_cols)
+    throw cusp::io_exception("symmetric MatrixMarket file must be square");
+
+  assemble_coordinate_chunks(csr, chunks, counts, num_rows, num_cols,
+                             matrix_market_symmetry(banner), false, true);
+}
+
+template <typename ValueType>
+struct array_chunk
+{
+  std::vector<ValueType> values;
+  const char * error;
+
+  array_chunk(void) : error(0) {}
+};
+
+template <typename ValueType>
+void parse_array_chunk(array_chunk<ValueType>& chunk,
+                       const char * p, const char * end,
+                       const matrix_market_banner& banner)
+{
+  const bool is_complex = banner.type == "complex";
+
+  while (p != end)
+  {
+    p = skip_blanks(p, end);
+
+    if (p == end)
+      break;
+
+    // skip blank lines and comments
+    if (*p == '\n' || *p == '%')
+    {
+      p = next_line(p, end);
+      continue;
+    }
+
+    double real, imag = 0;
+
+    if (!parse_real(p, end, real) || (is_complex && !parse_real(p, end, imag)))
+    {
+      chunk.error = "invalid MatrixMarket array entry";
+      return;
+    }
+
+    ValueType value;
+    assign_complex(value, real, imag);
+
+    chunk.values.push_back(value);
+
+    p = next_line(p, end);
+  }
+}
+
+template <typename ValueType>
+void read_array_buffer(cusp::array2d<ValueType,cusp::host_memory>& mtx,
+                       const char * begin, const char * end,
+                       const matrix_market_banner& banner,
+                       const std::vector<std::string>& tokens)
+{
+  if (tokens.size() != 2)
+    throw cusp::io_exception("invalid MatrixMarket array format");
+
+  const size_t num_rows = parse_size_token(tokens[0]);
+  const size_t num_cols = parse_size_token(tokens[1]);
+
+  if (banner.type == "pattern")
+    throw cusp::not_implemented_exception("pattern array MatrixMarket format is not supported");
+  if (banner.type != "complex" && banner.type != "real" && banner.type != "integer")
+    throw cusp::io_exception("invalid MatrixMarket data type");
+
+  std::vector<const char *> bounds;
+  split_lines(bounds, begin, end);
+
+  const long num_chunks = bounds.size() - 1;
+
+  std::vector< array_chunk<ValueType> > chunks(num_chunks);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(dynamic) if (num_chunks > 1)
+#endif
+  for (long c = 0; c < num_chunks; c++)
+    parse_array_chunk(chunks[c], bounds[c], bounds[c + 1], banner);
+
+  cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> dense(num_rows, num_cols);
+
+  size_t num_entries      = num_rows * num_cols;
+  size_t num_entries_read = 0;
+
+  for (long c = 0; c < num_chunks; c++)
+  {
+    size_t count = std::min(chunks[c].values.size(), num_entries - num_entries_read);
+
+    if (chunks[c].error && num_entries_read + count < num_entries)
+      throw cusp::io_exception(chunks[c].error);
+
+    std::copy(chunks[c].values.begin(), chunks[c].values.begin() + count, dense.values.begin() + num_entries_read);
+
+    num_entries_read += count;
+  }
+
+  if (num_entries_read != num_entries)
+    throw cusp::io_exception("unexpected EOF while reading MatrixMarket entries");
+
+  if (banner.symmetry != "general")
+    throw cusp::not_implemented_exception("only general array symmetric MatrixMarket format is supported");
+
+  cusp::copy(dense, mtx);
+}
+
+
+
+// array files are parsed from one contiguous buffer
+template <typename ValueType>
+void read_array_source(cusp::array2d<ValueType,cusp::host_memory>& mtx,
+                       buffer_source& body,
+                       const matrix_market_banner& banner,
+                       const std::vector<std::string>& tokens)
+{
+  const char * begin = 0;
+  const char * end   = 0;
+
+  body.next(begin, end);
+
+  read_array_buffer(mtx, begin, end, banner, tokens);
+}
+
+// spans of other sources are gathered first
+template <typename ValueType, typename Source>
+void read_array_source(cusp::array2d<ValueType,cusp::host_memory>& mtx,
+                       Source& body,
+                       const matrix_market_banner& banner,
+                       const std::vector<std::string>& tokens)
+{
+  std::vector<char> storage;
+
+  const char * begin;
+  const char * end;
+
+  while (body.next(begin, end))
+    storage.insert(storage.end(), begin, end);
+
+  begin = storage.empty() ? 0 : &storage[0];
+  end   = begin + storage.size();
+
+  read_array_buffer(mtx, begin, end, banner, tokens);
+}
+
+// lines formatted by one thread before a single write
+const size_t format_chunk_lines = 1 << 14;
+
+// Formats lines [0,num_lines) in chunks, one chunk per thread at a time,
+// into per-thread buffers of max_line_chars bytes per line and writes
+// every chunk with one call to output.write, in order.
+template <typename LineFormatter, typename Stream>
+void write_formatted_lines(Stream& output, size_t num_lines, size_t max_line_chars, const LineFormatter& format_line)
+{
+  const long num_chunks = (num_lines + format_chunk_lines - 1) / format_chunk_lines;
+
+#if defined(_OPENMP)
+#pragma omp parallel if (num_chunks > 1)
+#endif
+  {
+    std::vector<char> buffer(std::min(num_lines, format_chunk_lines) * max_line_chars + 1);
+
+#if defined(_OPENMP)
+#pragma omp for ordered schedule(static, 1)
+#endif
+    for (long c = 0; c < num_chunks; c++)
+    {
+      const size_t first = c * format_chunk_lines;
+      const size_t last  = std::min(num_lines, first + format_chunk_lines);
+
+      char * p = &buffer[0];
+
+      for (size_t n = first; n < last; n++)
+        p = format_line(p, n);
+
+#if defined(_OPENMP)
+#pragma omp ordered
+#endif
+      output.write(&buffer[0], p - &buffer[0]);
+    }
+  }
+}
+
+template <typename IndexType, typename ValueType>
+struct coordinate_line_formatter
+{
+  const IndexType * row_indices;
+  const IndexType * column_indices;
+  const ValueType * values;
+
+  char * operator()(char * p, size_t n) const
+  {
+    p = format_integer(p, (long long) row_indices[n] + 1);
+    *p++ = ' ';
+    p = format_integer(p, (long long) column_indices[n] + 1);
+    *p++ = ' ';
+    p = format_value(p, values[n]);
+    *p++ = '\n';
+    return p;
+  }
+};
+
+template <typename ValueType>
+struct array_line_formatter
+{
+  const ValueType * values;
+
+  char * operator()(char * p, size_t n) const
+  {
+    p = format_value(p, values[n]);
+    *p++ = '\n';
+    return p;
+  }
+};
 
 template <typename IndexType, typename ValueType, typename Stream>
 void write_coordinate_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::host_memory>& coo, Stream& output)
@@ -366,13 +1110,38 @@ void write_coordinate_stream(const cusp::coo_matrix<IndexType,ValueType,cusp::ho
 
   output << "\t" << coo.num_rows << "\t" << coo.num_cols << "\t" << coo.num_entries << "\n";
 
-  for(size_t i = 0; i < coo.num_entries; i++)
-  {
-    output << (coo.row_indices[i]    + 1) << " ";
-    output << (coo.column_indices[i] + 1) << " ";
-    cusp::io::detail::write_value(output, coo.values[i]);
-    output << "\n";
-  }
+  if (coo.num_entries == 0)
+    return;
+
+  coordinate_line_formatter<IndexType,ValueType> formatter;
+  formatter.row_indices    = &coo.row_indices[0];
+  formatter.column_indices = &coo.column_indices[0];
+  formatter.values         = &coo.values[0];
+
+  write_formatted_lines(output, coo.num_entries,
+                        2 * max_integer_chars + 3 + max_value_chars(ValueType()), formatter);
+}
+
+template <typename ValueType, typename Stream>
+void write_array_stream(const cusp::array1d<ValueType,cusp::host_memory>& values,
+                        size_t num_rows, size_t num_cols, Stream& output)
+{
+  bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename norm_type<ValueType>::type> >::value;
+
+  if (is_complex)
+    output << "%%MatrixMarket matrix array complex general\n";
+  else
+    output << "%%MatrixMarket matrix array real general\n";
+
+  output << "\t" << num_rows << "\t" << num_cols << "\n";
+
+  if (values.empty())
+    return;
+
+  array_line_formatter<ValueType> formatter;
+  formatter.values = &values[0];
+
+  write_formatted_lines(output, values.size(), 1 + max_value_chars(ValueType()), formatter);
 }
 
 
@@ -418,6 +1187,146 @@ void read_matrix_market_stream(Matrix& mtx, Stream& input, cusp::array1d_format)
   cusp::convert(temp, mtx);
 }
 
+template <typename Matrix, typename Source, typename Format>
+void read_matrix_market_source(Matrix& mtx, Source& source, Format)
+{
+  // general case
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  // read banner and size line
+  matrix_market_banner banner;
+  std::vector<std::string> tokens;
+  read_matrix_market_header(banner, tokens, source);
+
+  if (banner.storage == "coordinate")
+  {
+    cusp::coo_matrix<IndexType,ValueType,cusp::host_memory> temp;
+
+    read_coordinate_source(temp, source, banner, tokens);
+
+    cusp::convert(temp, mtx);
+  }
+  else // banner.storage == "array"
+  {
+    cusp::array2d<ValueType,cusp::host_memory> temp;
+
+    read_array_source(temp, source, banner, tokens);
+
+    cusp::convert(temp, mtx);
+  }
+}
+
+template <typename IndexType, typename ValueType, typename Source>
+void read_coordinate_source_into(cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx,
+                                 Source& body,
+                                 const matrix_market_banner& banner,
+                                 const std::vector<std::string>& tokens)
+{
+  read_coordinate_source(mtx, body, banner, tokens);
+}
+
+template <typename Matrix, typename Source>
+void read_coordinate_source_into(Matrix& mtx,
+                                 Source& body,
+                                 const matrix_market_banner& banner,
+                                 const std::vector<std::string>& tokens)
+{
+  typedef typename Matrix::index_type IndexType;
+  typedef typename Matrix::value_type ValueType;
+
+  cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> temp;
+
+  read_coordinate_source(temp, body, banner, tokens);
+
+  cusp::convert(temp, mtx);
+}
+
+template <typename Matrix, typename Source>
+void read_matrix_market_source(Matrix& mtx, Source& source, cusp::csr_format)
+{
+  // csr case
+  typedef typename Matrix::value_type ValueType;
+
+  // read banner and size line
+  matrix_market_banner banner;
+  std::vector<std::string> tokens;
+  read_matrix_market_header(banner, tokens, source);
+
+  if (banner.storage == "coordinate")
+  {
+    // build the CSR arrays directly, without a COO intermediate
+    read_coordinate_source_into(mtx, source, banner, tokens);
+  }
+  else // banner.storage == "array"
+  {
+    cusp::array2d<ValueType,cusp::host_memory> temp;
+
+    read_array_source(temp, source, banner, tokens);
+
+    cusp::convert(temp, mtx);
+  }
+}
+
+template <typename IndexType, typename ValueType>
+void assign_upper_triangle(cusp::symmetric_csr_matrix<IndexType,ValueType,cusp::host_memory>& mtx,
+                           cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& upper,
+                           cusp::symmetry_kind symmetry)
+{
+  mtx.assign_upper(upper, symmetry);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace>
+void assign_upper_triangle(cusp::symmetric_csr_matrix<IndexType,ValueType,MemorySpace>& mtx,
+                           cusp::csr_matrix<IndexType,ValueType,cusp::host_memory>& upper,
+                           cusp::symmetry_kind symmetry)
+{
+  cusp::csr_matrix<IndexType,ValueType,MemorySpace> temp(upper);
+
+  mtx.assign_upper(temp, symmetry);
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Source>
+void read_matrix_market_source(cusp::symmetric_csr_matrix<IndexType,ValueType,MemorySpace>& mtx,
+                               Source& source, cusp::unknown_format)
+{
+  // symmetric csr case: keep the stored triangle, do not expand
+  matrix_market_banner banner;
+  std::vector<std::string> tokens;
+  read_matrix_market_header(banner, tokens, source);
+
+  if (banner.storage != "coordinate" || banner.symmetry == "general")
+    throw cusp::io_exception("symmetric_csr_matrix requires a symmetric, hermitian or skew-symmetric coordinate MatrixMarket file");
+
+  cusp::csr_matrix<IndexType,ValueType,cusp::host_memory> upper;
+
+  read_upper_triangle_source(upper, source, banner, tokens);
+
+  assign_upper_triangle(mtx, upper, matrix_market_symmetry(banner));
+}
+
+template <typename IndexType, typename ValueType, typename MemorySpace, typename Stream>
+void read_matrix_market_stream(cusp::symmetric_csr_matrix<IndexType,ValueType,MemorySpace>& mtx, Stream& input, cusp::unknown_format)
+{
+  // symmetric csr case: read the stored triangle like the file path does
+  stream_source<Stream> source(input);
+
+  read_matrix_market_source(mtx, source, cusp::unknown_format());
+}
+
+template <typename Matrix, typename Source>
+void read_matrix_market_source(Matrix& mtx, Source& source, cusp::array1d_format)
+{
+  // array1d case
+  typedef typename Matrix::value_type ValueType;
+
+  cusp::array2d<ValueType,cusp::host_memory> temp;
+
+  read_matrix_market_source(temp, source, cusp::array2d_format());
+
+  cusp::convert(temp, mtx);
+}
+
 template <typename Matrix, typename Stream>
 void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::sparse_format)
 {
@@ -435,20 +1344,9 @@ void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array1d
 {
   typedef typename Matrix::value_type ValueType;
 
-  bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename norm_type<ValueType>::type> >::value;
-
-  if (is_complex)
-    output << "%%MatrixMarket matrix array complex general\n";
-  else
-    output << "%%MatrixMarket matrix array real general\n";
-
-  output << "\t" << mtx.size() << "\t1\n";
+  cusp::array1d<ValueType,cusp::host_memory> values(mtx);
 
-  for(size_t i = 0; i < mtx.size(); i++)
-  {
-    write_value(output, mtx[i]);
-    output << "\n";
-  }
+  write_array_stream(values, values.size(), 1, output);
 }
 
 template <typename Matrix, typename Stream>
@@ -456,23 +1354,11 @@ void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array2d
 {
   typedef typename Matrix::value_type ValueType;
 
-  bool is_complex = thrust::detail::is_same<ValueType, cusp::complex<typename norm_type<ValueType>::type> >::value;
-
-  if (is_complex)
-    output << "%%MatrixMarket matrix array complex general\n";
-  else
-    output << "%%MatrixMarket matrix array real general\n";
-
-  output << "\t" << mtx.num_rows << "\t" << mtx.num_cols << "\n";
+  // MatrixMarket arrays are stored in column-major order
+  cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> dense(mtx.num_rows, mtx.num_cols);
+  cusp::copy(mtx, dense);
 
-  for(size_t j = 0; j < mtx.num_cols; j++)
-  {
-    for(size_t i = 0; i < mtx.num_rows; i++)
-    {
-      write_value(output, mtx(i,j));
-      output << "\n";
-    }
-  }
+  write_array_stream(dense.values, dense.num_rows, dense.num_cols, output);
 }
 
 } // end namespace detail
@@ -481,23 +1367,23 @@ void write_matrix_market_stream(const Matrix& mtx, Stream& output, cusp::array2d
 template <typename Matrix>
 void read_matrix_market_file(Matrix& mtx, const std::string& filename)
 {
-  std::ifstream file(filename.c_str());
+  // map the whole file and parse it in parallel chunks
+  cusp::io::detail::mapped_file file(filename);
 
-  if (!file)
-    throw cusp::io_exception(std::string("unable to open file \"") + filename + std::string("\" for reading"));
+  const cusp::io::detail::compression_format compression =
+    cusp::io::detail::detect_compression(file.begin(), file.end());
 
-#ifdef __APPLE__
-  // WAR OSX-specific issue using rdbuf
-  std::stringstream file_string (std::stringstream::in | std::stringstream::out);
-  std::vector<char> buffer(file.rdbuf()->pubseekoff(0, std::ios::end,std::ios::in));
-  file.rdbuf()->pubseekpos(0, std::ios::in);
-  file.rdbuf()->sgetn(&buffer[0], buffer.size());
-  file_string.write(&buffer[0], buffer.size());
-
-  cusp::io::read_matrix_market_stream(mtx, file_string);
-#else
-  cusp::io::read_matrix_market_stream(mtx, file);
-#endif
+  if (compression == cusp::io::detail::compression_none)
+  {
+    cusp::io::detail::buffer_source source(file.begin(), file.end());
+    cusp::io::detail::read_matrix_market_source(mtx, source, typename Matrix::format());
+  }
+  else
+  {
+    // decompress on a background thread while the parsed blocks are merged
+    cusp::io::detail::decompressed_source source(file.begin(), file.end(), compression);
+    cusp::io::detail::read_matrix_market_source(mtx, source, typename Matrix::format());
+  }
 }
 
 template <typename Matrix, typename Stream>
@@ -509,6 +1395,21 @@ void read_matrix_market_stream(Matrix& mtx, Stream& input)
 template <typename Matrix>
 void write_matrix_market_file(const Matrix& mtx, const std::string& filename)
 {
+  const cusp::io::detail::compression_format compression =
+    cusp::io::detail::compression_from_filename(filename);
+
+  if (compression != cusp::io::detail::compression_none)
+  {
+    // compress on a background thread while the entries are formatted
+    cusp::io::detail::compressed_filebuf buffer(filename, compression);
+    std::ostream output(&buffer);
+
+    cusp::io::write_matrix_market_stream(mtx, output);
+
+    buffer.close();
+    return;
+  }
+
   std::ofstream file(filename.c_str());
 
   if (!file)
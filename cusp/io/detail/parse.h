@@ -0,0 +1,262 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cctype>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+
+// Locale-free scanners for MatrixMarket text
+//
+// Each parse_* function skips leading blanks, consumes one token
+// starting at p and advances p past it.  They return false, leaving p
+// unspecified, when the token is missing or malformed.  Decimal numbers
+// with at most 19 significant digits and a decimal exponent within
+// [-22,22] are converted exactly with one floating point operation;
+// anything else (long mantissas, large exponents, inf/nan) falls back
+// to a stream in the classic locale on a copy of the token.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+inline bool is_blank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+}
+
+inline bool is_digit(char c)
+{
+  return c >= '0' && c <= '9';
+}
+
+inline const char * skip_blanks(const char * p, const char * end)
+{
+  while (p != end && is_blank(*p))
+    ++p;
+  return p;
+}
+
+// returns the position following the next newline (or end)
+inline const char * next_line(const char * p, const char * end)
+{
+  while (p != end && *p != '\n')
+    ++p;
+  return p == end ? end : p + 1;
+}
+
+inline bool parse_unsigned(const char *& p, const char * end, unsigned long long& value)
+{
+  p = skip_blanks(p, end);
+
+  if (p != end && *p == '+')
+    ++p;
+
+  if (p == end || !is_digit(*p))
+    return false;
+
+  const unsigned long long max_value = std::numeric_limits<unsigned long long>::max();
+
+  unsigned long long result = 0;
+
+  while (p != end && is_digit(*p))
+  {
+    const unsigned digit = *p++ - '0';
+
+    // too large to represent
+    if (result > (max_value - digit) / 10)
+      return false;
+
+    result = 10 * result + digit;
+  }
+
+  value = result;
+
+  return p == end || is_blank(*p) || *p == '\n';
+}
+
+// case-insensitive match of a token against a lower case word
+inline bool token_equals(const char * begin, const char * end, const char * word)
+{
+  for (; begin != end && *word; ++begin, ++word)
+    if (std::tolower(static_cast<unsigned char>(*begin)) != *word)
+      return false;
+
+  return begin == end && *word == '\0';
+}
+
+inline bool parse_real_fallback(const char *& p, const char * start, const char * end, double& value)
+{
+  const char * stop = start;
+
+  while (stop != end && !is_blank(*stop) && *stop != '\n')
+    ++stop;
+
+  // inf and nan, which operator>> does not accept
+  const char * word = start;
+  const bool negative = word != stop && *word == '-';
+
+  if (word != stop && (*word == '-' || *word == '+'))
+    ++word;
+
+  if (token_equals(word, stop, "inf") || token_equals(word, stop, "infinity"))
+  {
+    value = negative ? -std::numeric_limits<double>::infinity() : std::numeric_limits<double>::infinity();
+    p = stop;
+    return true;
+  }
+
+  if (token_equals(word, stop, "nan"))
+  {
+    value = std::numeric_limits<double>::quiet_NaN();
+    p = stop;
+    return true;
+  }
+
+  // read in the classic locale, strtod would use the global decimal point
+  std::istringstream token(std::string(start, stop));
+  token.imbue(std::locale::classic());
+
+  token >> value;
+
+  if (token.fail() || token.peek() != std::char_traits<char>::eof())
+    return false;
+
+  p = stop;
+
+  return true;
+}
+
+inline bool parse_real(const char *& p, const char * end, double& value)
+{
+  static const double powers_of_ten[] =
+    {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+     1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+  p = skip_blanks(p, end);
+
+  const char * start = p;
+
+  bool negative = false;
+
+  if (p != end && (*p == '-' || *p == '+'))
+    negative = (*p++ == '-');
+
+  unsigned long long mantissa = 0;
+  int  significant = 0;
+  int  exponent    = 0;
+  bool any_digits  = false;
+  bool truncated   = false;
+
+  // integer part
+  for (; p != end && is_digit(*p); ++p)
+  {
+    any_digits = true;
+
+    if (significant < 19)
+    {
+      mantissa = 10 * mantissa + (*p - '0');
+      if (mantissa != 0) significant++;
+    }
+    else
+    {
+      exponent++;
+      truncated = true;
+    }
+  }
+
+  // fractional part
+  if (p != end && *p == '.')
+  {
+    for (++p; p != end && is_digit(*p); ++p)
+    {
+      any_digits = true;
+
+      if (significant < 19)
+      {
+        mantissa = 10 * mantissa + (*p - '0');
+        if (mantissa != 0) significant++;
+        exponent--;
+      }
+      else
+      {
+        truncated = true;
+      }
+    }
+  }
+
+  if (!any_digits)
+    return parse_real_fallback(p, start, end, value);
+
+  // exponent
+  if (p != end && (*p == 'e' || *p == 'E'))
+  {
+    const char * mark = p++;
+
+    bool negative_exponent = false;
+
+    if (p != end && (*p == '-' || *p == '+'))
+      negative_exponent = (*p++ == '-');
+
+    if (p == end || !is_digit(*p))
+    {
+      p = mark;
+    }
+    else
+    {
+      int e = 0;
+
+      for (; p != end && is_digit(*p); ++p)
+        if (e < 100000) e = 10 * e + (*p - '0');
+
+      exponent += negative_exponent ? -e : e;
+    }
+  }
+
+  if (p != end && !is_blank(*p) && *p != '\n')
+    return false;
+
+  if (mantissa == 0)
+  {
+    value = negative ? -0.0 : 0.0;
+    return true;
+  }
+
+  if (truncated || mantissa > (1ULL << 53) || exponent < -22 || exponent > 22)
+    return parse_real_fallback(p, start, end, value);
+
+  double result = static_cast<double>(mantissa);
+
+  if (exponent < 0)
+    result /= powers_of_ten[-exponent];
+  else
+    result *= powers_of_ten[exponent];
+
+  value = negative ? -result : result;
+
+  return true;
+}
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// Text sources for the MatrixMarket readers
+//
+// A text source hands out the contents of a file as consecutive spans
+// that end at line boundaries (the last span may lack its newline):
+//
+//   bool next(const char *& begin, const char *& end);
+//   void put_back(const char * p);   // next() resumes at p
+//
+// A span stays valid until the following call to next().  stream_source
+// reads a stream in blocks; line_spans holds the line splitting shared
+// with the other block-wise sources.
+
+namespace cusp
+{
+namespace io
+{
+namespace detail
+{
+
+// streams are read in blocks of this many bytes unless a size is given
+const size_t text_block_bytes = 1 << 22;
+
+// Splits the blocks returned by producer.take(block) into spans of
+// complete lines; a partial line is carried over to the next block.
+template <typename Producer>
+class line_spans
+{
+  public:
+    explicit line_spans(Producer& producer)
+      : producer(producer), span_end(0), resume(0) {}
+
+    bool next(const char *& begin, const char *& end)
+    {
+      if (resume != 0)
+      {
+        begin  = resume;
+        end    = text.empty() ? resume : &text[0] + span_end;
+        resume = 0;
+
+        if (begin != end)
+          return true;
+      }
+
+      // keep the partial line that followed the previous span
+      text.erase(text.begin(), text.begin() + span_end);
+      span_end = 0;
+
+      std::vector<char> block;
+
+      while (producer.take(block))
+      {
+        if (text.empty())
+          text.swap(block);
+        else
+          text.insert(text.end(), block.begin(), block.end());
+
+        // hand out complete lines only
+        size_t n = text.size();
+        while (n > 0 && text[n - 1] != '\n')
+          n--;
+
+        if (n > 0)
+        {
+          span_end = n;
+          begin    = &text[0];
+          end      = &text[0] + n;
+          return true;
+        }
+      }
+
+      // the last line need not end with a newline
+      if (text.empty())
+        return false;
+
+      span_end = text.size();
+      begin    = &text[0];
+      end      = &text[0] + span_end;
+
+      return true;
+    }
+
+    void put_back(const char * p)
+    {
+      resume = p;
+    }
+
+  private:
+    Producer& producer;
+
+    // text of which [0,span_end) was handed out last
+    std::vector<char> text;
+    size_t            span_end;
+    const char *      resume;
+};
+
+// reads a std::istream in blocks of block_bytes
+template <typename Stream>
+class stream_source
+{
+  public:
+    explicit stream_source(Stream& input, size_t block_bytes = text_block_bytes)
+      : input(input), block_bytes(block_bytes), spans(*this) {}
+
+    bool next(const char *& begin, const char *& end)
+    {
+      return spans.next(begin, end);
+    }
+
+    void put_back(const char * p)
+    {
+      spans.put_back(p);
+    }
+
+  private:
+    Stream& input;
+    size_t  block_bytes;
+    line_spans<stream_source> spans;
+    friend class line_spans<stream_source>;
+
+    bool take(std::vector<char>& block)
+    {
+      block.resize(block_bytes);
+
+      input.read(&block[0], block.size());
+      block.resize(input.gcount());
+
+      return !block.empty();
+    }
+
+    // non-copyable
+    stream_source(const stream_source&);
+    stream_source& operator=(const stream_source&);
+};
+
+} // end namespace detail
+} // end namespace io
+} // end namespace cusp
+
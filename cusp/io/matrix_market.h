@@ -42,6 +42,18 @@ namespace io
  * \tparam Matrix matrix container
  *
  * \note any contents of \p mtx will be overwritten
+ * \note the file is memory-mapped where the platform supports it and
+ *       its entries are parsed in parallel chunks when OpenMP is enabled
+ * \note coordinate files are assembled directly into a \p csr_matrix,
+ *       without an intermediate \p coo_matrix or a global sort
+ * \note symmetric, Hermitian and skew-symmetric files are expanded to
+ *       the full matrix, except when read into a \p symmetric_csr_matrix,
+ *       which keeps only the upper triangle
+ * \note gzip and zstd compressed files are recognized by their magic
+ *       bytes and decompressed on a background thread while the
+ *       entries are parsed; this requires building with CUSP_USE_ZLIB
+ *       or CUSP_USE_ZSTD (scons zlib=1 / zstd=1), otherwise reading a
+ *       compressed file throws \p cusp::io_exception
  *
  * \code
  * #include <cusp/io/matrix_market.h>
@@ -100,6 +112,11 @@ void read_matrix_market_stream(Matrix& mtx, Stream& input);
  * \tparam Matrix matrix container
  *
  * \note if the file already exists it will be overwritten
+ * \note values are written with the fewest digits that read back exactly,
+ *       independent of the locale; entries are formatted in parallel
+ *       chunks when OpenMP is enabled and each chunk is written at once
+ * \note files named \c *.gz or \c *.zst are compressed on a background
+ *       thread while the entries are formatted (see \p read_matrix_market_file)
  *
  * \code
  * #include <cusp/io/matrix_market.h>
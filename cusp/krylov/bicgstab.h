@@ -22,6 +22,10 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+#include <cusp/complex.h>
+#include <cusp/krylov/checkpoint.h>
+
 namespace cusp
 {
 namespace krylov
@@ -117,6 +121,126 @@ void bicgstab(LinearOperator& A,
               Vector& b,
               Monitor& monitor,
               Preconditioner& M);
+
+/*! \p bicgstab : Biconjugate Gradient Stabilized method with checkpointing
+ *
+ * Solves the linear system A x = b with preconditioner \p M and writes
+ * a snapshot of the solver state to \p ckpt every
+ * <tt>ckpt.interval()</tt> iterations.
+ *
+ * \see \p checkpoint
+ * \see \p bicgstab_resume
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab(LinearOperator& A,
+              Vector& x,
+              Vector& b,
+              Monitor& monitor,
+              Preconditioner& M,
+              checkpoint& ckpt);
+
+/*! \p bicgstab_resume : resume a checkpointed BiCGstab solve
+ *
+ * Restores \p x, the solver state and the iteration count of
+ * \p monitor from the snapshot in \p ckpt and continues the solve.
+ * \p A, \p b and \p M must be those of the interrupted solve.
+ *
+ * \throws cusp::io_exception if \p ckpt does not hold a \p bicgstab
+ *         snapshot of a system of this size
+ *
+ * \see \p checkpoint
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab_resume(LinearOperator& A,
+                     Vector& x,
+                     Vector& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+                     checkpoint& ckpt);
+
+/*! \p bicgstab_solver : resumable Biconjugate Gradient Stabilized method
+ *
+ * Holds the complete state of a preconditioned \p bicgstab solve, so
+ * the solve can advance one iteration at a time.  The constructor
+ * computes the initial residual; each call to \p step performs one
+ * iteration.  The iterates are the same as those of \p bicgstab.
+ *
+ * The solver keeps pointers to \p A, \p x, \p b, \p monitor and \p M,
+ * which must outlive it.
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Vector vector
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ *  \see \p cg_solver
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+class bicgstab_solver
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename norm_type<ValueType>::type   NormType;
+
+public:
+    /*! set up the solve of A x = b and test the initial residual
+     */
+    bicgstab_solver(LinearOperator& A,
+                    Vector& x,
+                    Vector& b,
+                    Monitor& monitor,
+                    Preconditioner& M);
+
+    /*! restore the state of an interrupted solve from \p ckpt
+     */
+    bicgstab_solver(LinearOperator& A,
+                    Vector& x,
+                    Vector& b,
+                    Monitor& monitor,
+                    Preconditioner& M,
+                    checkpoint& ckpt);
+
+    /*! perform one iteration, unless the solve is done
+     */
+    void step(void);
+
+    /*! write a snapshot of the current state to \p ckpt
+     */
+    void save(checkpoint& ckpt) const;
+
+    /*! whether the monitor has stopped the iteration
+     */
+    bool done(void) const { return done_; }
+
+protected:
+    LinearOperator * A;
+    Vector         * x;
+    Monitor        * monitor;
+    Preconditioner * M;
+
+    cusp::array1d<ValueType,MemorySpace> y;
+    cusp::array1d<ValueType,MemorySpace> p;
+    cusp::array1d<ValueType,MemorySpace> r;
+    cusp::array1d<ValueType,MemorySpace> r_star;
+    cusp::array1d<ValueType,MemorySpace> s;
+    cusp::array1d<ValueType,MemorySpace> Mp;
+    cusp::array1d<ValueType,MemorySpace> AMp;
+    cusp::array1d<ValueType,MemorySpace> Ms;
+    cusp::array1d<ValueType,MemorySpace> AMs;
+
+    ValueType r_r_star_old;
+    NormType  r_norm;
+    bool done_;
+};
 /*! \}
  */
 
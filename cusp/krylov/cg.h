@@ -22,6 +22,9 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+#include <cusp/krylov/checkpoint.h>
+
 namespace cusp
 {
 namespace krylov
@@ -123,6 +126,149 @@ void cg(LinearOperator& A,
         Vector& b,
         Monitor& monitor,
         Preconditioner& M);
+
+/*! \p cg : Conjugate Gradient method with checkpointing
+ *
+ * Solves the symmetric, positive-definite linear system A x = b
+ * with preconditioner \p M and writes a snapshot of the solver state
+ * to \p ckpt every <tt>ckpt.interval()</tt> iterations.
+ *
+ * \see \p checkpoint
+ * \see \p cg_resume
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg(LinearOperator& A,
+        Vector& x,
+        Vector& b,
+        Monitor& monitor,
+        Preconditioner& M,
+        checkpoint& ckpt);
+
+/*! \p cg_resume : resume a checkpointed Conjugate Gradient solve
+ *
+ * Restores \p x, the solver state and the iteration count of
+ * \p monitor from the snapshot in \p ckpt and continues the solve,
+ * writing further snapshots to \p ckpt.  \p A, \p b and \p M must be
+ * those of the interrupted solve; the iterates are then the same as
+ * those of an uninterrupted solve.
+ *
+ * \throws cusp::io_exception if \p ckpt does not hold a \p cg snapshot
+ *         of a system of this size
+ *
+ * \see \p checkpoint
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg_resume(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M,
+               checkpoint& ckpt);
+
+/*! \p cg_solver : resumable Conjugate Gradient method
+ *
+ * Holds the complete state of a preconditioned \p cg solve, so the
+ * solve can advance one iteration at a time and be interleaved with
+ * other work.  The constructor computes the initial residual; each
+ * call to \p step performs one iteration.  The iterates are the same
+ * as those of \p cg.
+ *
+ * The solver keeps pointers to \p A, \p x, \p b, \p monitor and \p M,
+ * which must outlive it, and owns its workspace, so independent
+ * solvers can be stepped from different threads.
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Vector vector
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ *  The following code snippet demonstrates how to advance several
+ *  solves in round-robin order.
+ *
+ *  \code
+ *  typedef cusp::csr_matrix<int, float, cusp::host_memory> Matrix;
+ *  typedef cusp::array1d<float, cusp::host_memory>         Array;
+ *  typedef cusp::default_monitor<float>                    Monitor;
+ *  typedef cusp::precond::diagonal<float, cusp::host_memory> Precond;
+ *  typedef cusp::krylov::cg_solver<Matrix, Array, Monitor, Precond> Solver;
+ *
+ *  std::vector<Solver> solvers;
+ *  for (size_t i = 0; i < num_systems; i++)
+ *      solvers.push_back(Solver(A[i], x[i], b[i], monitor[i], M[i]));
+ *
+ *  for (bool active = true; active; )
+ *  {
+ *      active = false;
+ *      for (size_t i = 0; i < num_systems; i++)
+ *      {
+ *          if (!solvers[i].done())
+ *          {
+ *              solvers[i].step();
+ *              active = true;
+ *          }
+ *      }
+ *  }
+ *  \endcode
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+class cg_solver
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+public:
+    /*! set up the solve of A x = b and test the initial residual
+     */
+    cg_solver(LinearOperator& A,
+              Vector& x,
+              Vector& b,
+              Monitor& monitor,
+              Preconditioner& M);
+
+    /*! restore the state of an interrupted solve from \p ckpt
+     */
+    cg_solver(LinearOperator& A,
+              Vector& x,
+              Vector& b,
+              Monitor& monitor,
+              Preconditioner& M,
+              checkpoint& ckpt);
+
+    /*! perform one iteration, unless the solve is done
+     */
+    void step(void);
+
+    /*! write a snapshot of the current state to \p ckpt
+     */
+    void save(checkpoint& ckpt) const;
+
+    /*! whether the monitor has stopped the iteration
+     */
+    bool done(void) const { return done_; }
+
+protected:
+    LinearOperator * A;
+    Vector         * x;
+    Monitor        * monitor;
+    Preconditioner * M;
+
+    cusp::array1d<ValueType,MemorySpace> y;
+    cusp::array1d<ValueType,MemorySpace> z;
+    cusp::array1d<ValueType,MemorySpace> r;
+    cusp::array1d<ValueType,MemorySpace> p;
+
+    ValueType rz;
+    bool done_;
+};
 /*! \}
  */
 
@@ -0,0 +1,166 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file chebyshev.h
+ *  \brief Chebyshev iteration
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+namespace krylov
+{
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p chebyshev : Chebyshev iteration
+ *
+ * Solves the symmetric, positive-definite linear system A x = b
+ * using the default convergence criteria.  The spectral bounds are
+ * estimated with a few Lanczos steps.
+ */
+template <class LinearOperator,
+          class Vector>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b);
+
+/*! \p chebyshev : Chebyshev iteration
+ *
+ * Solves the symmetric, positive-definite linear system A x = b without
+ * preconditioning.  The spectral bounds are estimated with a few Lanczos steps.
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor);
+
+/*! \p chebyshev : Chebyshev iteration
+ *
+ * Solves the symmetric, positive-definite linear system A x = b with
+ * preconditioner \p M.  The bounds of the spectrum of M A are estimated
+ * with a few Lanczos steps.
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M);
+
+/*! \p chebyshev : Chebyshev iteration
+ *
+ * Solves the symmetric, positive-definite linear system A x = b with
+ * preconditioner \p M, given bounds on the spectrum of M A.
+ *
+ * Unlike the other Krylov methods, the Chebyshev iteration needs no inner
+ * products: its coefficients follow from the spectral bounds alone.  The
+ * only reductions are the residual norms computed by the monitor, which
+ * can be limited with \p default_monitor::set_check_interval.  The SpMV
+ * and the residual update are fused for host matrices.
+ *
+ * The iteration converges for any eigenvalue in (0, lambda_min + lambda_max),
+ * so \p lambda_max should not be underestimated by much.
+ *
+ * \param A matrix of the linear system 
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param monitor montiors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ * \param lambda_min lower bound on the eigenvalues of M A
+ * \param lambda_max upper bound on the eigenvalues of M A
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Vector vector
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \note \p A and \p M must be symmetric and positive-definite.
+ *
+ *  The following code snippet demonstrates how to use \p chebyshev to 
+ *  solve a 10x10 Poisson problem.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/chebyshev.h>
+ *  #include <cusp/gallery/poisson.h>
+ *  
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // allocate storage for solution (x) and right hand side (b)
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      // set stopping criteria:
+ *      //  iteration_limit    = 500
+ *      //  relative_tolerance = 1e-6
+ *      cusp::default_monitor<float> monitor(b, 500, 1e-6);
+ *
+ *      // only compute the residual norm every 10 iterations
+ *      monitor.set_check_interval(10);
+ *
+ *      // set preconditioner (identity)
+ *      cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *      // the eigenvalues of the 5-point Laplacian lie in (0,8)
+ *      cusp::krylov::chebyshev(A, x, b, monitor, M, 0.16f, 8.0f);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p default_monitor
+ *  \see \p verbose_monitor
+ */
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner,
+          typename Real>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M,
+               Real lambda_min,
+               Real lambda_max);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/chebyshev.inl>
+
@@ -0,0 +1,194 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file checkpoint.h
+ *  \brief Checkpoint and restart of iterative solver state
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <string>
+#include <vector>
+
+#if !defined(_WIN32)
+#include <pthread.h>
+#endif
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p checkpoint : binary snapshot file of an in-flight solve
+ *
+ *  A \p checkpoint is passed to the checkpointing overloads of \p cg,
+ *  \p bicgstab and \p gmres.  Every \p interval iterations the solver
+ *  copies its complete state (the current iterate, the recurrence
+ *  vectors and scalars, the monitor's iteration count and, for GMRES,
+ *  the Arnoldi basis and Hessenberg matrix) into an in-memory buffer.
+ *  A background thread writes that buffer to \p filename while the
+ *  solver continues, so the iteration only pays for the copy.  Two
+ *  buffers are used: if the previous snapshot is still being written
+ *  when the next one is taken, the newer snapshot replaces the pending
+ *  one.  The file is written to a temporary name and then renamed, so
+ *  \p filename always holds a complete snapshot.
+ *
+ *  After an interruption, \p cg_resume, \p bicgstab_resume and
+ *  \p gmres_resume restore the state from \p filename and continue
+ *  the solve.  Given the same matrix, right-hand side, preconditioner
+ *  and monitor settings, the resumed solve produces the same iterates
+ *  as an uninterrupted one.
+ *
+ *  The file format is a raw memory image and is only meant to be read
+ *  back on the same kind of machine with the same value type.
+ *
+ *  The following code snippet demonstrates how to checkpoint a solve
+ *  and resume it after the job was killed.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/cg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *      cusp::gallery::poisson5pt(A, 1000, 1000);
+ *
+ *      cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *      cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *      cusp::default_monitor<float> monitor(b, 100000, 1e-8);
+ *      cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *      // snapshot the solver state every 500 iterations
+ *      cusp::krylov::checkpoint ckpt("poisson.ckpt", 500);
+ *
+ *      if (ckpt.exists())
+ *          cusp::krylov::cg_resume(A, x, b, monitor, M, ckpt);
+ *      else
+ *          cusp::krylov::cg(A, x, b, monitor, M, ckpt);
+ *
+ *      // the solve has finished, the snapshot is no longer needed
+ *      ckpt.remove();
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+class checkpoint
+{
+public:
+    /*! Construct a \p checkpoint
+     *
+     *  \param filename file the snapshots are written to and read from
+     *  \param interval number of iterations between snapshots
+     */
+    checkpoint(const std::string& filename, size_t interval = 100);
+
+    /*! wait for the last snapshot to be written
+     */
+    ~checkpoint(void);
+
+    /*! file the snapshots are written to and read from
+     */
+    const std::string& filename(void) const { return filename_; }
+
+    /*! number of iterations between snapshots
+     */
+    size_t interval(void) const { return interval_; }
+
+    /*! whether \p filename holds a snapshot to resume from
+     */
+    bool exists(void) const;
+
+    /*! block until all snapshots taken so far are on disk
+     *
+     *  \throws cusp::io_exception if a snapshot could not be written
+     */
+    void flush(void);
+
+    /*! wait for pending snapshots, then delete \p filename, e.g. once
+     *  the solve has finished
+     */
+    void remove(void);
+
+    /*! \cond */
+    // serialization interface used by the solvers
+    void begin_snapshot(const char * solver, size_t value_size);
+    template <typename T> void write(const T& value);
+    template <typename Array> void write_array(const Array& array);
+    void commit(void);
+
+    void begin_restore(const char * solver, size_t value_size);
+    template <typename T> void read(T& value);
+    template <typename Array> void read_array(Array& array);
+    void end_restore(void);
+    /*! \endcond */
+
+protected:
+    // write buffers[index] to disk, returns false on failure
+    bool write_file(size_t index);
+
+    // reserve space for size bytes in the front buffer
+    char * append(size_t size);
+
+    // next size bytes of the restored snapshot
+    const char * consume(size_t size);
+
+    std::string filename_;
+    size_t interval_;
+
+    // buffers[front] is filled by the solver, the other one is written out
+    std::vector<char> buffers[2];
+    size_t front;
+    std::vector<char> restored;
+    size_t position;
+
+    bool pending;   // buffers[front] holds a snapshot to be written
+    bool failed;    // a snapshot could not be written
+
+#if !defined(_WIN32)
+    static void * writer_main(void * arg);
+
+    bool busy;      // the writer is writing the back buffer
+    bool stop;      // the writer should exit
+    pthread_t writer;
+    pthread_mutex_t mutex;
+    pthread_cond_t  cond;
+#endif
+
+private:
+    // not copyable
+    checkpoint(const checkpoint&);
+    checkpoint& operator=(const checkpoint&);
+};
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/checkpoint.inl>
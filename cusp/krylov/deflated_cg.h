@@ -0,0 +1,162 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file deflated_cg.h
+ *  \brief Deflated Conjugate Gradient method with subspace recycling
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/krylov/recycle_space.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p deflated_cg : Deflated Conjugate Gradient method
+ *
+ * Solves the symmetric, positive-definite linear system A x = b
+ * using the default convergence criteria.
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space);
+
+/*! \p deflated_cg : Deflated Conjugate Gradient method
+ *
+ * Solves the symmetric, positive-definite linear system A x = b without preconditioning.
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space,
+                 Monitor& monitor);
+
+/*! \p deflated_cg : Deflated Conjugate Gradient method
+ *
+ * Solves the symmetric, positive-definite linear system A x = b
+ * with preconditioner \p M, deflating the subspace held in \p space.
+ *
+ * The search directions are kept A-orthogonal to the recycled basis
+ * \c U, so the eigenmodes it approximates no longer slow down
+ * convergence.  On return \p space holds the Ritz vectors of \p A
+ * for the smallest Ritz values in the span of the old basis and the
+ * first search directions of this solve, ready for the next system.
+ * When \p space is empty the method reduces to \p cg.
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param space recycled subspace, updated on return
+ * \param monitor montiors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Vector vector
+ * \tparam RecycleSpace is a \p recycle_space
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \note \p A and \p M must be symmetric and positive-definite, and
+ * <tt>space.C</tt> must equal <tt>A space.U</tt>; call
+ * <tt>space.update(A)</tt> whenever \p A changes.
+ *
+ * \note Complex value types are not supported: the projected Ritz
+ * problem is solved with a real symmetric eigensolver.
+ *
+ *  The following code snippet demonstrates how to use \p deflated_cg to
+ *  solve a sequence of 10x10 Poisson problems.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/deflated_cg.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // recycle 8 vectors between solves
+ *      cusp::krylov::recycle_space<float, cusp::device_memory> space(8);
+ *
+ *      for (int i = 0; i < 4; i++)
+ *      {
+ *          // allocate storage for solution (x) and right hand side (b)
+ *          cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *          cusp::array1d<float, cusp::device_memory> b(A.num_rows, i + 1);
+ *
+ *          // set stopping criteria:
+ *          //  iteration_limit    = 100
+ *          //  relative_tolerance = 1e-6
+ *          cusp::verbose_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *          // set preconditioner (identity)
+ *          cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *          // solve the linear system A x = b
+ *          cusp::krylov::deflated_cg(A, x, b, space, monitor, M);
+ *      }
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+
+ *  \see \p recycle_space
+ *  \see \p default_monitor
+ *  \see \p verbose_monitor
+ *
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor,
+          class Preconditioner>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space,
+                 Monitor& monitor,
+                 Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/deflated_cg.inl>
+
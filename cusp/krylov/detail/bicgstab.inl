@@ -21,12 +21,69 @@
 #include <cusp/monitor.h>
 #include <cusp/linear_operator.h>
 
+#include <thrust/transform_reduce.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+
 namespace blas = cusp::blas;
 
 namespace cusp
 {
 namespace krylov
 {
+namespace detail
+{
+
+// (conj(r_star_i) * r_i, r_i * conj(r_i)) for one entry
+template <typename ValueType>
+struct bicgstab_dotc_norm
+{
+    typedef thrust::tuple<ValueType,ValueType> result_type;
+
+    template <typename Tuple>
+    __host__ __device__
+    result_type operator()(const Tuple& t) const
+    {
+        ValueType r_star = thrust::get<0>(t);
+        ValueType r      = thrust::get<1>(t);
+
+        return result_type(cusp::blas::detail::conjugate<ValueType>()(r_star) * r,
+                           cusp::blas::detail::norm_squared<ValueType>()(r));
+    }
+};
+
+template <typename ValueType>
+struct bicgstab_tuple_plus
+{
+    typedef thrust::tuple<ValueType,ValueType> result_type;
+
+    __host__ __device__
+    result_type operator()(const result_type& a, const result_type& b) const
+    {
+        return result_type(thrust::get<0>(a) + thrust::get<0>(b),
+                           thrust::get<1>(a) + thrust::get<1>(b));
+    }
+};
+
+// computes <r_star, r> and ||r|| in a single pass over r
+template <typename Array1, typename Array2, typename ValueType, typename Real>
+void bicgstab_dotc_nrm2(const Array1& r_star, const Array2& r, ValueType& r_r_star, Real& r_norm)
+{
+    thrust::tuple<ValueType,ValueType> init(ValueType(0), ValueType(0));
+
+    thrust::tuple<ValueType,ValueType> result =
+        thrust::transform_reduce(thrust::make_zip_iterator(thrust::make_tuple(r_star.begin(), r.begin())),
+                                 thrust::make_zip_iterator(thrust::make_tuple(r_star.end(),   r.end())),
+                                 bicgstab_dotc_norm<ValueType>(),
+                                 init,
+                                 bicgstab_tuple_plus<ValueType>());
+
+    r_r_star = thrust::get<0>(result);
+    r_norm   = std::sqrt(abs(thrust::get<1>(result)));
+}
+
+} // end namespace detail
 
 template <class LinearOperator,
           class Vector>
@@ -69,24 +126,63 @@ void bicgstab(LinearOperator& A,
 {
     CUSP_PROFILE_SCOPED();
 
-    typedef typename LinearOperator::value_type   ValueType;
-    typedef typename LinearOperator::memory_space MemorySpace;
+    cusp::krylov::bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M);
 
-    assert(A.num_rows == A.num_cols);        // sanity check
+    while (!solver.done())
+        solver.step();
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab(LinearOperator& A,
+              Vector& x,
+              Vector& b,
+              Monitor& monitor,
+              Preconditioner& M,
+              checkpoint& ckpt)
+{
+    CUSP_PROFILE_SCOPED();
 
-    const size_t N = A.num_rows;
+    cusp::krylov::bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M);
 
-    // allocate workspace
-    cusp::array1d<ValueType,MemorySpace> y(N);
+    cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+}
 
-    cusp::array1d<ValueType,MemorySpace>   p(N);
-    cusp::array1d<ValueType,MemorySpace>   r(N);
-    cusp::array1d<ValueType,MemorySpace>   r_star(N);
-    cusp::array1d<ValueType,MemorySpace>   s(N);
-    cusp::array1d<ValueType,MemorySpace>  Mp(N);
-    cusp::array1d<ValueType,MemorySpace> AMp(N);
-    cusp::array1d<ValueType,MemorySpace>  Ms(N);
-    cusp::array1d<ValueType,MemorySpace> AMs(N);
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab_resume(LinearOperator& A,
+                     Vector& x,
+                     Vector& b,
+                     Monitor& monitor,
+                     Preconditioner& M,
+                     checkpoint& ckpt)
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::krylov::bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M, ckpt);
+
+    cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::bicgstab_solver(LinearOperator& A,
+                  Vector& x,
+                  Vector& b,
+                  Monitor& monitor,
+                  Preconditioner& M)
+    : A(&A), x(&x), monitor(&monitor), M(&M),
+      y(A.num_rows), p(A.num_rows), r(A.num_rows), r_star(A.num_rows), s(A.num_rows),
+      Mp(A.num_rows), AMp(A.num_rows), Ms(A.num_rows), AMs(A.num_rows)
+{
+    assert(A.num_rows == A.num_cols);        // sanity check
 
     // y <- Ax
     cusp::multiply(A, x, y);
@@ -100,53 +196,124 @@ void bicgstab(LinearOperator& A,
     // r_star <- r
     blas::copy(r, r_star);
 
-    ValueType r_r_star_old = blas::dotc(r_star, r);
+    r_r_star_old = blas::dotc(r_star, r);
+    r_norm       = blas::nrm2(r);
+
+    done_ = cusp::detail::monitor_finished(monitor, r, r_norm);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::bicgstab_solver(LinearOperator& A,
+                  Vector& x,
+                  Vector& b,
+                  Monitor& monitor,
+                  Preconditioner& M,
+                  checkpoint& ckpt)
+    : A(&A), x(&x), monitor(&monitor), M(&M),
+      y(A.num_rows), p(A.num_rows), r(A.num_rows), r_star(A.num_rows), s(A.num_rows),
+      Mp(A.num_rows), AMp(A.num_rows), Ms(A.num_rows), AMs(A.num_rows)
+{
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    size_t iteration_count;
+
+    ckpt.begin_restore("bicgstab", sizeof(ValueType));
+    ckpt.read(iteration_count);
+    ckpt.read_array(x);
+    ckpt.read_array(p);
+    ckpt.read_array(r);
+    ckpt.read_array(r_star);
+    ckpt.read(r_r_star_old);
+    ckpt.read(r_norm);
+    ckpt.end_restore();
+
+    monitor.set_iteration_count(iteration_count);
+
+    // repeats the test made right after the snapshot was taken
+    done_ = cusp::detail::monitor_finished(monitor, r, r_norm);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::save(checkpoint& ckpt) const
+{
+    // the remaining vectors are overwritten before they are used
+    ckpt.begin_snapshot("bicgstab", sizeof(ValueType));
+    ckpt.write(monitor->iteration_count());
+    ckpt.write_array(*x);
+    ckpt.write_array(p);
+    ckpt.write_array(r);
+    ckpt.write_array(r_star);
+    ckpt.write(r_r_star_old);
+    ckpt.write(r_norm);
+    ckpt.commit();
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void bicgstab_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::step(void)
+{
+    if (done_)
+        return;
+
+    // Mp = M*p
+    cusp::multiply(*M, p, Mp);
+
+    // AMp = A*Mp
+    cusp::multiply(*A, Mp, AMp);
 
-    while (!monitor.finished(r))
+    // alpha = (r_j, r_star) / (A*M*p, r_star)
+    ValueType alpha = r_r_star_old / blas::dotc(r_star, AMp);
+    
+    // s_j = r_j - alpha * AMp
+    blas::axpby(r, AMp, s, ValueType(1), ValueType(-alpha));
+
+    if (monitor->finished(s))
     {
-        // Mp = M*p
-        cusp::multiply(M, p, Mp);
-
-        // AMp = A*Mp
-        cusp::multiply(A, Mp, AMp);
-
-        // alpha = (r_j, r_star) / (A*M*p, r_star)
-        ValueType alpha = r_r_star_old / blas::dotc(r_star, AMp);
-        
-        // s_j = r_j - alpha * AMp
-        blas::axpby(r, AMp, s, ValueType(1), ValueType(-alpha));
-
-	if (monitor.finished(s)){
-	  // x += alpha*M*p_j
-	  blas::axpby(x, Mp, x, ValueType(1), ValueType(alpha));
-	  break;
-	}
-
-        // Ms = M*s_j
-        cusp::multiply(M, s, Ms);
-        
-        // AMs = A*Ms
-        cusp::multiply(A, Ms, AMs);
-
-        // omega = (AMs, s) / (AMs, AMs)
-        ValueType omega = blas::dotc(AMs, s) / blas::dotc(AMs, AMs);
-        
-        // x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j
-        blas::axpbypcz(x, Mp, Ms, x, ValueType(1), alpha, omega);
-
-        // r_{j+1} = s_j - omega*A*M*s
-        blas::axpby(s, AMs, r, ValueType(1), -omega);
-
-        // beta_j = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
-        ValueType r_r_star_new = blas::dotc(r_star, r);
-        ValueType beta = (r_r_star_new / r_r_star_old) * (alpha / omega);
-        r_r_star_old = r_r_star_new;
-
-        // p_{j+1} = r_{j+1} + beta*(p_j - omega*A*M*p)
-        blas::axpbypcz(r, p, AMp, p, ValueType(1), beta, -beta*omega);
-
-        ++monitor;
+        // x += alpha*M*p_j
+        blas::axpby(*x, Mp, *x, ValueType(1), ValueType(alpha));
+        done_ = true;
+        return;
     }
+
+    // Ms = M*s_j
+    cusp::multiply(*M, s, Ms);
+    
+    // AMs = A*Ms
+    cusp::multiply(*A, Ms, AMs);
+
+    // omega = (AMs, s) / (AMs, AMs)
+    ValueType omega = blas::dotc(AMs, s) / blas::dotc(AMs, AMs);
+    
+    // x_{j+1} = x_j + alpha*M*p_j + omega*M*s_j
+    blas::axpbypcz(*x, Mp, Ms, *x, ValueType(1), alpha, omega);
+
+    // r_{j+1} = s_j - omega*A*M*s
+    blas::axpby(s, AMs, r, ValueType(1), -omega);
+
+    // beta_j = (r_{j+1}, r_star) / (r_j, r_star) * (alpha/omega)
+    // ||r_{j+1}|| for the monitor is accumulated in the same pass
+    ValueType r_r_star_new;
+    cusp::krylov::detail::bicgstab_dotc_nrm2(r_star, r, r_r_star_new, r_norm);
+    ValueType beta = (r_r_star_new / r_r_star_old) * (alpha / omega);
+    r_r_star_old = r_r_star_new;
+
+    // p_{j+1} = r_{j+1} + beta*(p_j - omega*A*M*p)
+    blas::axpbypcz(r, p, AMp, p, ValueType(1), beta, -beta*omega);
+
+    ++(*monitor);
+
+    done_ = cusp::detail::monitor_finished(*monitor, r, r_norm);
 }
 
 } // end namespace krylov
@@ -19,12 +19,15 @@
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
 
+#include <cusp/krylov/detail/host_m.h>
+
 #include <thrust/copy.h>
 #include <thrust/fill.h>
 #include <thrust/functional.h>
 #include <thrust/transform.h>
 #include <thrust/transform_reduce.h>
 #include <thrust/inner_product.h>
+#include <thrust/sequence.h>
 
 #include <thrust/iterator/transform_iterator.h>
 
@@ -442,6 +445,56 @@ namespace trans_m
     cusp::krylov::detail_m::KERNEL_XS<ScalarType>(N, raw_ptr_beta_0_s, raw_ptr_chi_0_s, raw_ptr_rho_0_s, raw_ptr_zeta_0_s, raw_ptr_alpha_1_s, raw_ptr_rho_1_s, raw_ptr_zeta_1_s, raw_ptr_r_0, raw_ptr_r_1, raw_ptr_w_1));
   }
 
+  // compute x^\sigma, s^\sigma for the shifts in the active set
+  // the host path walks each shift's column contiguously (see host_m)
+  template <typename Array1, typename Array2, typename Array3, typename Array4,
+	   typename Array5, typename Array6, typename Array7, typename Array8,
+	   typename Array9, typename Array10, typename Array11,typename Array12,
+	   typename Array13>
+  void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
+                const Array3& rho_0_s, const Array4& zeta_0_s,
+                const Array5& alpha_1_s, const Array6& rho_1_s,
+		const Array7& zeta_1_s,
+                const Array8& r_0, Array9& r_1,
+                const Array10& w_1, Array11& s_0_s, Array12& x,
+                const Array13& active, cusp::host_memory)
+  {
+    cusp::krylov::host_m::compute_xs_m(beta_0_s, chi_0_s, rho_0_s, zeta_0_s,
+		    alpha_1_s, rho_1_s, zeta_1_s, r_0, r_1, w_1, s_0_s, x, active);
+  }
+
+  // the device path updates every shift
+  template <typename Array1, typename Array2, typename Array3, typename Array4,
+	   typename Array5, typename Array6, typename Array7, typename Array8,
+	   typename Array9, typename Array10, typename Array11,typename Array12,
+	   typename Array13>
+  void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
+                const Array3& rho_0_s, const Array4& zeta_0_s,
+                const Array5& alpha_1_s, const Array6& rho_1_s,
+		const Array7& zeta_1_s,
+                const Array8& r_0, Array9& r_1,
+                const Array10& w_1, Array11& s_0_s, Array12& x,
+                const Array13& active, cusp::device_memory)
+  {
+    cusp::krylov::trans_m::compute_xs_m(beta_0_s, chi_0_s, rho_0_s, zeta_0_s,
+		    alpha_1_s, rho_1_s, zeta_1_s, r_0, r_1, w_1, s_0_s, x);
+  }
+
+  // drop shifts whose residual |\zeta^\sigma \rho^\sigma| ||r|| meets the tolerance
+  template <typename Array1, typename Array2, typename Array3, typename Real>
+  void update_active_shifts(Array1& active, const Array2& z_s, const Array3& rho_s,
+                Real r_norm, Real tolerance, cusp::host_memory)
+  {
+    cusp::krylov::host_m::update_active_shifts(active, z_s, rho_s, r_norm, tolerance);
+  }
+
+  template <typename Array1, typename Array2, typename Array3, typename Real>
+  void update_active_shifts(Array1& active, const Array2& z_s, const Array3& rho_s,
+                Real r_norm, Real tolerance, cusp::device_memory)
+  {
+    // reading \zeta^\sigma back costs more than updating converged shifts
+  }
+
   template <typename InputIterator1, typename InputIterator2,
 	    typename OutputIterator, typename ScalarType>
   void compute_w_1_m(InputIterator1 r_0_b, InputIterator1 r_0_e,
@@ -670,12 +723,20 @@ void bicgstab_m(LinearOperator& A,
 
   delta_1 = cusp::blas::dotc(w_0,r_0);
   phi_0 = cusp::blas::dotc(w_0,As)/delta_1;
+
+  // shifts that have not converged yet
+  cusp::array1d<int,cusp::host_memory> active(N_s);
+  thrust::sequence(active.begin(), active.end());
   
   //
   // Initialization is done. Solve iteratively
   //
   while (!monitor.finished(r_0))
   {
+    // the residual of shift \sigma is \zeta_0^\sigma \rho_0^\sigma r_0
+    cusp::krylov::trans_m::update_active_shifts(active, z_0_s, rho_0_s,
+                    monitor.residual_norm(), monitor.tolerance(), MemorySpace());
+
     // recycle iterates
     beta_m1 = beta_0;
     beta_0 = ValueType(-1.0)/phi_0;
@@ -722,7 +783,8 @@ void bicgstab_m(LinearOperator& A,
 
     // compute the new solution and s_0^sigma
     cusp::krylov::trans_m::compute_xs_m(beta_0_s, chi_0_s, rho_0_s, z_0_s,
-		    alpha_0_s, rho_1_s, z_1_s, r_0, r_1, w_1, s_0_s, x);
+		    alpha_0_s, rho_1_s, z_1_s, r_0, r_1, w_1, s_0_s, x,
+		    active, MemorySpace());
 
     // recycle r_i
     cusp::blas::copy(r_1,r_0);
@@ -19,14 +19,35 @@
 #include <cusp/blas.h>
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
+#include <cusp/cmath.h>
 #include <cusp/linear_operator.h>
 
+#include <cmath>
+
 namespace blas = cusp::blas;
 
 namespace cusp
 {
 namespace krylov
 {
+namespace detail
+{
+
+// with a general preconditioner the monitor computes ||r|| itself
+template <typename Monitor, typename Vector, typename Preconditioner, typename ValueType>
+bool cg_finished(Monitor& monitor, const Vector& r, const Preconditioner& M, ValueType rz)
+{
+    return monitor.finished(r);
+}
+
+// without preconditioning <r,z> = <r,r>, so ||r|| comes for free
+template <typename Monitor, typename Vector, typename ValueType2, typename MemorySpace, typename IndexType, typename ValueType>
+bool cg_finished(Monitor& monitor, const Vector& r, const cusp::identity_operator<ValueType2,MemorySpace,IndexType>& M, ValueType rz)
+{
+    return cusp::detail::monitor_finished(monitor, r, std::sqrt(cusp::abs(rz)));
+}
+
+} // end namespace detail
 
 template <class LinearOperator,
           class Vector>
@@ -69,19 +90,63 @@ void cg(LinearOperator& A,
 {
     CUSP_PROFILE_SCOPED();
 
-    typedef typename LinearOperator::value_type   ValueType;
-    typedef typename LinearOperator::memory_space MemorySpace;
+    cusp::krylov::cg_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M);
 
-    assert(A.num_rows == A.num_cols);        // sanity check
+    while (!solver.done())
+        solver.step();
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg(LinearOperator& A,
+        Vector& x,
+        Vector& b,
+        Monitor& monitor,
+        Preconditioner& M,
+        checkpoint& ckpt)
+{
+    CUSP_PROFILE_SCOPED();
 
-    const size_t N = A.num_rows;
+    cusp::krylov::cg_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M);
+
+    cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg_resume(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M,
+               checkpoint& ckpt)
+{
+    CUSP_PROFILE_SCOPED();
+
+    cusp::krylov::cg_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, monitor, M, ckpt);
+
+    cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+cg_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::cg_solver(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            Monitor& monitor,
+            Preconditioner& M)
+    : A(&A), x(&x), monitor(&monitor), M(&M),
+      y(A.num_rows), z(A.num_rows), r(A.num_rows), p(A.num_rows)
+{
+    assert(A.num_rows == A.num_cols);        // sanity check
 
-    // allocate workspace
-    cusp::array1d<ValueType,MemorySpace> y(N);
-    cusp::array1d<ValueType,MemorySpace> z(N);
-    cusp::array1d<ValueType,MemorySpace> r(N);
-    cusp::array1d<ValueType,MemorySpace> p(N);
-        
     // y <- Ax
     cusp::multiply(A, x, y);
 
@@ -95,38 +160,99 @@ void cg(LinearOperator& A,
     blas::copy(z, p);
 		
     // rz = <r^H, z>
-    ValueType rz = blas::dotc(r, z);
+    rz = blas::dotc(r, z);
 
-    while (!monitor.finished(r))
-    {
-        // y <- Ap
-        cusp::multiply(A, p, y);
-        
-        // alpha <- <r,z>/<y,p>
-        ValueType alpha =  rz / blas::dotc(y, p);
+    done_ = cusp::krylov::detail::cg_finished(monitor, r, M, rz);
+}
 
-        // x <- x + alpha * p
-        blas::axpy(p, x, alpha);
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+cg_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::cg_solver(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            Monitor& monitor,
+            Preconditioner& M,
+            checkpoint& ckpt)
+    : A(&A), x(&x), monitor(&monitor), M(&M),
+      y(A.num_rows), z(A.num_rows), r(A.num_rows), p(A.num_rows)
+{
+    assert(A.num_rows == A.num_cols);        // sanity check
 
-        // r <- r - alpha * y		
-        blas::axpy(y, r, -alpha);
+    size_t iteration_count;
 
-        // z <- M*r
-        cusp::multiply(M, r, z);
-		
-        ValueType rz_old = rz;
+    ckpt.begin_restore("cg", sizeof(ValueType));
+    ckpt.read(iteration_count);
+    ckpt.read_array(x);
+    ckpt.read_array(r);
+    ckpt.read_array(p);
+    ckpt.read(rz);
+    ckpt.end_restore();
 
-        // rz = <r^H, z>
-        rz = blas::dotc(r, z);
+    monitor.set_iteration_count(iteration_count);
 
-        // beta <- <r_{i+1},r_{i+1}>/<r,r> 
-        ValueType beta = rz / rz_old;
-		
-        // p <- r + beta*p
-        blas::axpby(z, p, p, ValueType(1), beta);
+    // repeats the test made right after the snapshot was taken
+    done_ = cusp::krylov::detail::cg_finished(monitor, r, M, rz);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::save(checkpoint& ckpt) const
+{
+    // z and y are recomputed from r and p before they are used
+    ckpt.begin_snapshot("cg", sizeof(ValueType));
+    ckpt.write(monitor->iteration_count());
+    ckpt.write_array(*x);
+    ckpt.write_array(r);
+    ckpt.write_array(p);
+    ckpt.write(rz);
+    ckpt.commit();
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void cg_solver<LinearOperator,Vector,Monitor,Preconditioner>
+::step(void)
+{
+    if (done_)
+        return;
+
+    // y <- Ap
+    cusp::multiply(*A, p, y);
+    
+    // alpha <- <r,z>/<y,p>
+    ValueType alpha =  rz / blas::dotc(y, p);
+
+    // x <- x + alpha * p
+    blas::axpy(p, *x, alpha);
+
+    // r <- r - alpha * y		
+    blas::axpy(y, r, -alpha);
+
+    // z <- M*r
+    cusp::multiply(*M, r, z);
+	
+    ValueType rz_old = rz;
+
+    // rz = <r^H, z>
+    rz = blas::dotc(r, z);
+
+    // beta <- <r_{i+1},r_{i+1}>/<r,r> 
+    ValueType beta = rz / rz_old;
+	
+    // p <- r + beta*p
+    blas::axpby(z, p, p, ValueType(1), beta);
+
+    ++(*monitor);
 
-        ++monitor;
-    }
+    done_ = cusp::krylov::detail::cg_finished(*monitor, r, *M, rz);
 }
 
 } // end namespace krylov
@@ -20,12 +20,15 @@
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
 
+#include <cusp/krylov/detail/host_m.h>
+
 #include <thrust/copy.h>
 #include <thrust/fill.h>
 #include <thrust/functional.h>
 #include <thrust/transform.h>
 #include <thrust/transform_reduce.h>
 #include <thrust/inner_product.h>
+#include <thrust/sequence.h>
 
 #include <thrust/iterator/transform_iterator.h>
 
@@ -312,6 +315,48 @@ namespace trans_m
     cusp::krylov::detail_m::KERNEL_XP<ScalarType>(N,raw_ptr_alpha_0_s,raw_ptr_beta_0_s,raw_ptr_z_1_s,raw_ptr_r_0));
   }
 
+  // compute x^\sigma, p^\sigma for the shifts in the active set
+  // the host path walks each shift's column contiguously (see host_m)
+  template <typename Array1, typename Array2, typename Array3,
+            typename Array4, typename Array5, typename Array6,
+            typename Array7>
+  void compute_xp_m(const Array1& alpha_0_s, const Array2& z_1_s,
+                const Array3& beta_0_s, const Array4& r_0,
+                Array5& x_0_s, Array6& p_0_s, const Array7& active,
+                cusp::host_memory)
+  {
+    cusp::krylov::host_m::compute_xp_m(alpha_0_s, z_1_s, beta_0_s, r_0,
+                                       x_0_s, p_0_s, active);
+  }
+
+  // the device path updates every shift
+  template <typename Array1, typename Array2, typename Array3,
+            typename Array4, typename Array5, typename Array6,
+            typename Array7>
+  void compute_xp_m(const Array1& alpha_0_s, const Array2& z_1_s,
+                const Array3& beta_0_s, const Array4& r_0,
+                Array5& x_0_s, Array6& p_0_s, const Array7& active,
+                cusp::device_memory)
+  {
+    cusp::krylov::trans_m::compute_xp_m(alpha_0_s, z_1_s, beta_0_s, r_0,
+                                        x_0_s, p_0_s);
+  }
+
+  // drop shifts whose residual |\zeta^\sigma| ||r|| meets the tolerance
+  template <typename Array1, typename Array2, typename Real>
+  void update_active_shifts(Array1& active, const Array2& z_s,
+                Real r_norm, Real tolerance, cusp::host_memory)
+  {
+    cusp::krylov::host_m::update_active_shifts(active, z_s, r_norm, tolerance);
+  }
+
+  template <typename Array1, typename Array2, typename Real>
+  void update_active_shifts(Array1& active, const Array2& z_s,
+                Real r_norm, Real tolerance, cusp::device_memory)
+  {
+    // reading \zeta^\sigma back costs more than updating converged shifts
+  }
+
   template <typename Array1, typename Array2, typename Array3>
   void doublecopy(const Array1& s, Array2& sd, Array3& d)
   {
@@ -466,12 +511,20 @@ void cg_m(LinearOperator& A,
   // set up initial value of p_0 and p_0^\sigma
   cusp::krylov::trans_m::vectorize_copy(b,p_0_s);
   cusp::blas::copy(b,p_0);
+
+  // shifts that have not converged yet
+  cusp::array1d<int,cusp::host_memory> active(N_s);
+  thrust::sequence(active.begin(), active.end());
   
   //
   // Initialization is done. Solve iteratively
   //
   while (!monitor.finished(r_0))
   {
+    // the residual of shift \sigma is \zeta_0^\sigma r_0
+    cusp::krylov::trans_m::update_active_shifts(active, z_0_s,
+                    monitor.residual_norm(), monitor.tolerance(), MemorySpace());
+
     // recycle iterates
     rsq_0 = rsq_1;
     beta_m1 = beta_0;
@@ -503,7 +556,7 @@ void cg_m(LinearOperator& A,
 
     // compute x_0^\sigma, p_0^\sigma
     cusp::krylov::trans_m::compute_xp_m(alpha_0_s, z_1_s, beta_0_s, r_0,
-                                      x, p_0_s);
+                                      x, p_0_s, active, MemorySpace());
 
     // recycle \zeta_i^\sigma
     cusp::krylov::trans_m::doublecopy(z_1_s,z_0_s,z_m1_s);
@@ -0,0 +1,376 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/copy.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/axpy_multiply.h>
+#include <cusp/detail/random.h>
+
+#include <thrust/fill.h>
+#include <thrust/for_each.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// the preconditioned operator M A, used to estimate its spectrum
+template <typename LinearOperator, typename Preconditioner>
+class chebyshev_operator
+    : public cusp::linear_operator<typename LinearOperator::value_type,
+                                   typename LinearOperator::memory_space>
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef cusp::linear_operator<ValueType,MemorySpace> Parent;
+
+    LinearOperator * A;
+    Preconditioner * M;
+    mutable cusp::array1d<ValueType,MemorySpace> temp;
+
+    public:
+    chebyshev_operator(LinearOperator& A, Preconditioner& M)
+        : Parent(A.num_rows, A.num_cols), A(&A), M(&M), temp(A.num_rows) {}
+
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const
+    {
+        cusp::multiply(*A, x, temp);
+        cusp::multiply(*M, temp, y);
+    }
+};
+
+// number of eigenvalues of the symmetric tridiagonal matrix T below x (Sturm count)
+template <typename Matrix, typename Real>
+size_t tridiagonal_sturm_count(const Matrix& T, Real x)
+{
+    const size_t n = T.num_rows;
+    const Real tiny = std::numeric_limits<Real>::min();
+
+    size_t count = 0;
+    Real d = 1;
+
+    for (size_t i = 0; i < n; i++)
+    {
+        Real b2 = (i == 0) ? Real(0) : Real(T(i,i-1)) * Real(T(i,i-1));
+
+        d = (Real(T(i,i)) - x) - b2 / d;
+
+        if (d == Real(0))
+            d = -tiny;
+        if (d < Real(0))
+            count++;
+    }
+
+    return count;
+}
+
+// smallest and largest eigenvalues of the symmetric tridiagonal matrix T by bisection
+template <typename Matrix, typename Real>
+void tridiagonal_extreme_eigenvalues(const Matrix& T, Real& lambda_min, Real& lambda_max)
+{
+    const size_t n = T.num_rows;
+
+    // Gershgorin bounds
+    Real lower =  std::numeric_limits<Real>::max();
+    Real upper = -std::numeric_limits<Real>::max();
+
+    for (size_t i = 0; i < n; i++)
+    {
+        Real radius = 0;
+        if (i > 0)     radius += std::abs(Real(T(i,i-1)));
+        if (i + 1 < n) radius += std::abs(Real(T(i+1,i)));
+
+        lower = std::min(lower, Real(T(i,i)) - radius);
+        upper = std::max(upper, Real(T(i,i)) + radius);
+    }
+
+    // smallest: count(x) >= 1 on the right of lambda_min
+    Real a = lower, b = upper;
+    for (size_t iter = 0; iter < 100 && b - a > std::numeric_limits<Real>::epsilon() * std::abs(b); iter++)
+    {
+        Real c = (a + b) / 2;
+        if (tridiagonal_sturm_count(T, c) >= 1) b = c; else a = c;
+    }
+    lambda_min = b;
+
+    // largest: count(x) == n on the right of lambda_max
+    a = lower; b = upper;
+    for (size_t iter = 0; iter < 100 && b - a > std::numeric_limits<Real>::epsilon() * std::abs(b); iter++)
+    {
+        Real c = (a + b) / 2;
+        if (tridiagonal_sturm_count(T, c) >= n) b = c; else a = c;
+    }
+    lambda_max = b;
+}
+
+// k steps of Lanczos on the symmetric operator A from the start vector v.
+// Unlike cusp::krylov::lanczos, T keeps the step at which the iteration
+// breaks down; beta returns the norm of the last residual.
+template <typename LinearOperator, typename Array1d, typename Array2d, typename Real>
+void chebyshev_lanczos(const LinearOperator& A, Array1d& v, Array2d& T, Real& beta, size_t k)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    const size_t N = A.num_rows;
+    const size_t maxiter = std::min(N, k);
+    const Real tolerance = std::sqrt(std::numeric_limits<Real>::epsilon());
+
+    cusp::array1d<ValueType,MemorySpace> v0(N, ValueType(0));
+    cusp::array1d<ValueType,MemorySpace> w(N);
+
+    std::vector<Real> alpha;
+    std::vector<Real> off_diagonal;
+
+    beta = 0;
+
+    if (maxiter > 0)
+        blas::scal(v, ValueType(1) / blas::nrm2(v));
+
+    for (size_t j = 0; j < maxiter; j++)
+    {
+        cusp::multiply(A, v, w);
+
+        if (j > 0)
+            blas::axpy(v0, w, ValueType(-beta));
+
+        alpha.push_back(Real(blas::dot(v, w)));
+
+        blas::axpy(v, w, ValueType(-alpha[j]));
+
+        const Real beta_previous = beta;
+
+        beta = blas::nrm2(w);
+
+        // w is rounding error: the Krylov space is invariant
+        if (beta <= tolerance * (std::abs(alpha[j]) + beta_previous))
+            break;
+
+        off_diagonal.push_back(beta);
+
+        blas::scal(w, ValueType(1) / beta);
+
+        // [v0 v w] -> [v w v0]
+        v0.swap(v);
+        v.swap(w);
+    }
+
+    const size_t n = alpha.size();
+
+    T.resize(n, n);
+    thrust::fill(T.values.begin(), T.values.end(), Real(0));
+
+    for (size_t i = 0; i < n; i++)
+    {
+        T(i,i) = alpha[i];
+
+        if (i + 1 < n)
+            T(i,i+1) = T(i+1,i) = off_diagonal[i];
+    }
+}
+
+// estimate the spectral bounds of M A from the Ritz values of k Lanczos steps
+template <typename LinearOperator, typename Preconditioner, typename Real>
+void chebyshev_bounds(LinearOperator& A, Preconditioner& M, Real& lambda_min, Real& lambda_max, size_t k = 20)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::krylov::detail::chebyshev_operator<LinearOperator,Preconditioner> MA(A, M);
+
+    // start from random values in [0,1)
+    cusp::array1d<ValueType,MemorySpace> v(A.num_rows);
+    cusp::copy(cusp::detail::random_reals<ValueType>(A.num_rows), v);
+
+    cusp::array2d<Real,cusp::host_memory> T;
+    Real beta;
+
+    chebyshev_lanczos(MA, v, T, beta, k);
+
+    if (T.num_rows == 0)
+    {
+        lambda_min = lambda_max = Real(1);
+        return;
+    }
+
+    cusp::krylov::detail::tridiagonal_extreme_eigenvalues(T, lambda_min, lambda_max);
+
+    // every Ritz value lies within beta of an eigenvalue and inside the
+    // spectrum, so widen the interval: overestimating lambda_max is cheap,
+    // underestimating it diverges
+    lambda_max = (lambda_max + beta) * Real(1.1);
+    lambda_min *= Real(0.9);
+}
+
+// x <- x + d
+// d <- alpha * d + beta * z
+template <typename ScalarType>
+struct chebyshev_update
+{
+    ScalarType alpha;
+    ScalarType beta;
+
+    chebyshev_update(ScalarType alpha, ScalarType beta)
+        : alpha(alpha), beta(beta) {}
+
+    template <typename Tuple>
+    __host__ __device__
+    void operator()(Tuple t)
+    {
+        thrust::get<0>(t) = thrust::get<0>(t) + thrust::get<1>(t);
+        thrust::get<1>(t) = alpha * thrust::get<1>(t) + beta * thrust::get<2>(t);
+    }
+};
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Vector>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::default_monitor<ValueType> monitor(b);
+
+    cusp::krylov::chebyshev(A, x, b, monitor);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename norm_type<ValueType>::type   NormType;
+
+    NormType lambda_min, lambda_max;
+    cusp::krylov::detail::chebyshev_bounds(A, M, lambda_min, lambda_max);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M, lambda_min, lambda_max);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner,
+          typename Real>
+void chebyshev(LinearOperator& A,
+               Vector& x,
+               Vector& b,
+               Monitor& monitor,
+               Preconditioner& M,
+               Real lambda_min,
+               Real lambda_max)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+    assert(0 < lambda_min && lambda_min < lambda_max);
+
+    const size_t N = A.num_rows;
+
+    // center and half width of the spectral interval
+    const ValueType theta = ValueType(lambda_max + lambda_min) / ValueType(2);
+    const ValueType delta = ValueType(lambda_max - lambda_min) / ValueType(2);
+    const ValueType sigma = theta / delta;
+
+    // allocate workspace
+    cusp::array1d<ValueType,MemorySpace> r(N);
+    cusp::array1d<ValueType,MemorySpace> z(N);
+    cusp::array1d<ValueType,MemorySpace> d(N);
+    cusp::array1d<ValueType,MemorySpace> t(N);
+
+    // r <- b - A*x
+    blas::copy(b, r);
+    cusp::detail::axpy_multiply(A, x, r, ValueType(-1), t);
+
+    // z <- M*r
+    cusp::multiply(M, r, z);
+
+    // d <- z / theta
+    blas::axpby(z, z, d, ValueType(1) / theta, ValueType(0));
+
+    ValueType rho = ValueType(1) / sigma;
+
+    while (!monitor.finished(r))
+    {
+        // r <- r - A*d
+        cusp::detail::axpy_multiply(A, d, r, ValueType(-1), t);
+
+        // z <- M*r
+        cusp::multiply(M, r, z);
+
+        ValueType rho_new = ValueType(1) / (ValueType(2) * sigma - rho);
+
+        // x <- x + d
+        // d <- rho_new * rho * d + 2 * rho_new / delta * z
+        thrust::for_each(thrust::make_zip_iterator(thrust::make_tuple(x.begin(), d.begin(), z.begin())),
+                         thrust::make_zip_iterator(thrust::make_tuple(x.end(),   d.end(),   z.end())),
+                         cusp::krylov::detail::chebyshev_update<ValueType>(rho_new * rho, ValueType(2) * rho_new / delta));
+
+        rho = rho_new;
+
+        ++monitor;
+    }
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
@@ -0,0 +1,340 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/exception.h>
+
+#include <thrust/copy.h>
+
+#include <cstdio>
+#include <cstring>
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// every record starts on a boundary suitable for any value type
+inline size_t checkpoint_align(size_t offset)
+{
+    return (offset + 15) & ~size_t(15);
+}
+
+const char         checkpoint_magic[8]   = {'C','U','S','P','C','K','P','T'};
+const unsigned int checkpoint_version    = 1;
+const size_t       checkpoint_name_size  = 16;
+
+// run a solver object to completion, snapshotting it every interval iterations
+template <typename Solver, typename Monitor>
+void checkpointed_solve(Solver& solver, Monitor& monitor, cusp::krylov::checkpoint& ckpt)
+{
+    while (!solver.done())
+    {
+        solver.step();
+
+        if (!solver.done() && monitor.iteration_count() % ckpt.interval() == 0)
+            solver.save(ckpt);
+    }
+
+    ckpt.flush();
+}
+
+} // end namespace detail
+
+inline checkpoint::checkpoint(const std::string& filename, size_t interval)
+    : filename_(filename),
+      interval_(interval > 0 ? interval : 1),
+      front(0),
+      position(0),
+      pending(false),
+      failed(false)
+#if !defined(_WIN32)
+      , busy(false),
+      stop(false)
+#endif
+{
+#if !defined(_WIN32)
+    pthread_mutex_init(&mutex, 0);
+    pthread_cond_init(&cond, 0);
+
+    if (pthread_create(&writer, 0, writer_main, this) != 0)
+    {
+        pthread_cond_destroy(&cond);
+        pthread_mutex_destroy(&mutex);
+        throw cusp::runtime_exception("checkpoint: unable to start writer thread");
+    }
+#endif
+}
+
+inline checkpoint::~checkpoint(void)
+{
+#if !defined(_WIN32)
+    // the writer drains a pending snapshot before it exits
+    pthread_mutex_lock(&mutex);
+    stop = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+
+    pthread_join(writer, 0);
+
+    pthread_cond_destroy(&cond);
+    pthread_mutex_destroy(&mutex);
+#endif
+}
+
+inline bool checkpoint::exists(void) const
+{
+    std::FILE * file = std::fopen(filename_.c_str(), "rb");
+
+    if (file == 0)
+        return false;
+
+    std::fclose(file);
+    return true;
+}
+
+inline void checkpoint::remove(void)
+{
+    flush();
+    std::remove(filename_.c_str());
+}
+
+inline void checkpoint::flush(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_lock(&mutex);
+    while (pending || busy)
+        pthread_cond_wait(&cond, &mutex);
+    bool write_failed = failed;
+    failed = false;
+    pthread_mutex_unlock(&mutex);
+#else
+    bool write_failed = failed;
+    failed = false;
+#endif
+
+    if (write_failed)
+        throw cusp::io_exception("checkpoint: unable to write " + filename_);
+}
+
+inline void checkpoint::begin_snapshot(const char * solver, size_t value_size)
+{
+#if !defined(_WIN32)
+    // reclaim the front buffer if the writer has not picked it up yet
+    pthread_mutex_lock(&mutex);
+    pending = false;
+    pthread_mutex_unlock(&mutex);
+#endif
+
+    buffers[front].clear();
+
+    char name[detail::checkpoint_name_size];
+    std::memset(name, 0, sizeof(name));
+    std::strncpy(name, solver, sizeof(name) - 1);
+
+    std::memcpy(append(sizeof(detail::checkpoint_magic)), detail::checkpoint_magic, sizeof(detail::checkpoint_magic));
+    write(detail::checkpoint_version);
+    std::memcpy(append(sizeof(name)), name, sizeof(name));
+    write(value_size);
+}
+
+template <typename T>
+void checkpoint::write(const T& value)
+{
+    std::memcpy(append(sizeof(T)), &value, sizeof(T));
+}
+
+template <typename Array>
+void checkpoint::write_array(const Array& array)
+{
+    typedef typename Array::value_type ValueType;
+
+    size_t n = array.size();
+    write(n);
+
+    ValueType * dst = reinterpret_cast<ValueType *>(append(n * sizeof(ValueType)));
+    thrust::copy(array.begin(), array.end(), dst);
+}
+
+inline void checkpoint::commit(void)
+{
+#if !defined(_WIN32)
+    pthread_mutex_lock(&mutex);
+    pending = true;
+    pthread_cond_broadcast(&cond);
+    pthread_mutex_unlock(&mutex);
+#else
+    // no writer thread, write synchronously
+    if (!write_file(front))
+        failed = true;
+#endif
+}
+
+inline void checkpoint::begin_restore(const char * solver, size_t value_size)
+{
+    std::FILE * file = std::fopen(filename_.c_str(), "rb");
+
+    if (file == 0)
+        throw cusp::io_exception("checkpoint: unable to open " + filename_);
+
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+
+    restored.resize(size > 0 ? size : 0);
+    size_t num_read = restored.empty() ? 0 : std::fread(&restored[0], 1, restored.size(), file);
+    std::fclose(file);
+
+    if (num_read != restored.size())
+        throw cusp::io_exception("checkpoint: unable to read " + filename_);
+
+    position = 0;
+
+    const char * magic = consume(sizeof(detail::checkpoint_magic));
+    if (std::memcmp(magic, detail::checkpoint_magic, sizeof(detail::checkpoint_magic)) != 0)
+        throw cusp::io_exception("checkpoint: " + filename_ + " is not a checkpoint file");
+
+    unsigned int version;
+    read(version);
+    if (version != detail::checkpoint_version)
+        throw cusp::io_exception("checkpoint: unsupported version in " + filename_);
+
+    const char * name = consume(detail::checkpoint_name_size);
+    if (std::strncmp(name, solver, detail::checkpoint_name_size) != 0)
+        throw cusp::io_exception("checkpoint: " + filename_ + " does not hold a " + solver + " snapshot");
+
+    size_t stored_value_size;
+    read(stored_value_size);
+    if (stored_value_size != value_size)
+        throw cusp::io_exception("checkpoint: value type mismatch in " + filename_);
+}
+
+template <typename T>
+void checkpoint::read(T& value)
+{
+    std::memcpy(&value, consume(sizeof(T)), sizeof(T));
+}
+
+template <typename Array>
+void checkpoint::read_array(Array& array)
+{
+    typedef typename Array::value_type ValueType;
+
+    size_t n;
+    read(n);
+
+    if (n != array.size())
+        throw cusp::io_exception("checkpoint: array size mismatch in " + filename_);
+
+    const ValueType * src = reinterpret_cast<const ValueType *>(consume(n * sizeof(ValueType)));
+    thrust::copy(src, src + n, array.begin());
+}
+
+inline void checkpoint::end_restore(void)
+{
+    // release the file image
+    std::vector<char>().swap(restored);
+    position = 0;
+}
+
+inline bool checkpoint::write_file(size_t index)
+{
+    const std::vector<char>& buffer = buffers[index];
+    const std::string temporary = filename_ + ".tmp";
+
+    std::FILE * file = std::fopen(temporary.c_str(), "wb");
+
+    if (file == 0)
+        return false;
+
+    size_t num_written = buffer.empty() ? 0 : std::fwrite(&buffer[0], 1, buffer.size(), file);
+
+    if (std::fclose(file) != 0 || num_written != buffer.size())
+        return false;
+
+#if defined(_WIN32)
+    // rename does not replace an existing file on Windows
+    std::remove(filename_.c_str());
+#endif
+
+    return std::rename(temporary.c_str(), filename_.c_str()) == 0;
+}
+
+inline char * checkpoint::append(size_t size)
+{
+    std::vector<char>& buffer = buffers[front];
+
+    size_t offset = detail::checkpoint_align(buffer.size());
+    buffer.resize(offset + size);
+
+    return size > 0 ? &buffer[offset] : 0;
+}
+
+inline const char * checkpoint::consume(size_t size)
+{
+    size_t offset = detail::checkpoint_align(position);
+
+    if (offset + size > restored.size())
+        throw cusp::io_exception("checkpoint: " + filename_ + " is truncated");
+
+    position = offset + size;
+
+    return size > 0 ? &restored[offset] : 0;
+}
+
+#if !defined(_WIN32)
+inline void * checkpoint::writer_main(void * arg)
+{
+    checkpoint& c = *static_cast<checkpoint *>(arg);
+
+    pthread_mutex_lock(&c.mutex);
+
+    for (;;)
+    {
+        while (!c.pending && !c.stop)
+            pthread_cond_wait(&c.cond, &c.mutex);
+
+        if (!c.pending)
+            break;
+
+        // take the filled buffer and hand the other one to the solver
+        size_t back = c.front;
+        c.front   = 1 - c.front;
+        c.pending = false;
+        c.busy    = true;
+
+        pthread_mutex_unlock(&c.mutex);
+        bool ok = c.write_file(back);
+        pthread_mutex_lock(&c.mutex);
+
+        c.busy = false;
+        if (!ok)
+            c.failed = true;
+
+        pthread_cond_broadcast(&c.cond);
+    }
+
+    pthread_mutex_unlock(&c.mutex);
+
+    return 0;
+}
+#endif
+
+} // end namespace krylov
+} // end namespace cusp
+
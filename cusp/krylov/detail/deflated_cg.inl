@@ -0,0 +1,298 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/lu.h>
+#include <cusp/detail/symmetric_eigen.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/detail/multivector.h>
+
+#include <algorithm>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// p <- p - U E^-1 C^H z, which makes p A-orthogonal to U
+template <typename Matrix, typename Array2d, typename Array1d, typename Vector1, typename Vector2>
+void deflated_cg_project(const Matrix& U, const Matrix& C, size_t k,
+                         const Array2d& E, const Array1d& pivot,
+                         const Vector1& z, Vector2& p)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::array1d<ValueType,cusp::host_memory> c(k);
+    cusp::array1d<ValueType,cusp::host_memory> mu(k);
+
+    cusp::krylov::detail::multi_dotc(C, 0, k, z, c);
+    cusp::detail::lu_solve(E, pivot, c, mu);
+
+    for (size_t i = 0; i < k; i++)
+        mu[i] = -mu[i];
+
+    cusp::krylov::detail::multi_axpy(U, 0, k, mu, p);
+}
+
+// replace the recycle space with the Ritz vectors of A for the smallest
+// Ritz values in span[U P], where AP = A P
+template <typename RecycleSpace, typename Matrix>
+void deflated_cg_update(RecycleSpace& space, size_t k,
+                        Matrix& P, Matrix& AP, size_t num_directions)
+{
+    typedef typename RecycleSpace::value_type ValueType;
+    typedef typename RecycleSpace::basis_type Basis;
+
+    const size_t n = k + num_directions;
+
+    if (n == 0)
+        return;
+
+    // G = [U P]^H A [U P] and F = [U P]^H [U P]
+    cusp::array2d<ValueType,cusp::host_memory> G(n, n);
+    cusp::array2d<ValueType,cusp::host_memory> F(n, n);
+
+    for (size_t j = 0; j < k; j++)
+    {
+        cusp::krylov::detail::multi_gram_column(space.U, k, P, num_directions, space.C.column(j), G, j);
+        cusp::krylov::detail::multi_gram_column(space.U, k, P, num_directions, space.U.column(j), F, j);
+    }
+    for (size_t j = 0; j < num_directions; j++)
+    {
+        cusp::krylov::detail::multi_gram_column(space.U, k, P, num_directions, AP.column(j), G, k + j);
+        cusp::krylov::detail::multi_gram_column(space.U, k, P, num_directions, P.column(j),  F, k + j);
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < i; j++)
+        {
+            G(i,j) = G(j,i) = (G(i,j) + G(j,i)) / ValueType(2);
+            F(i,j) = F(j,i) = (F(i,j) + F(j,i)) / ValueType(2);
+        }
+
+    // Ritz pairs G y = theta F y
+    cusp::array1d<ValueType,cusp::host_memory> theta;
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> Y;
+
+    // keep the old space if [U P] is numerically rank deficient
+    if (cusp::detail::generalized_symmetric_eigen(G, F, theta, Y) != 0)
+        return;
+
+    const size_t num_vectors = std::min(space.max_size(), n);
+
+    Basis U_new(space.U.num_rows, space.max_size());
+    Basis C_new(space.C.num_rows, space.max_size());
+
+    cusp::krylov::detail::multi_combine(space.U, k, P,  num_directions, Y, num_vectors, U_new);
+    cusp::krylov::detail::multi_combine(space.C, k, AP, num_directions, Y, num_vectors, C_new);
+
+    space.assign(U_new, C_new, num_vectors);
+}
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::default_monitor<ValueType> monitor(b);
+
+    cusp::krylov::deflated_cg(A, x, b, space, monitor);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space,
+                 Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    cusp::krylov::deflated_cg(A, x, b, space, monitor, M);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor,
+          class Preconditioner>
+void deflated_cg(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 RecycleSpace& space,
+                 Monitor& monitor,
+                 Preconditioner& M)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename RecycleSpace::basis_type     Basis;
+    typedef typename norm_type<ValueType>::type   NormType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N = A.num_rows;
+
+    space.resize(N);
+
+    size_t k = space.size();
+
+    // number of search directions kept to refine the space
+    const size_t L = space.max_size();
+
+    // E = U^H A U, factored on the host
+    cusp::array2d<ValueType,cusp::host_memory> E(k, k);
+    cusp::array1d<int,cusp::host_memory>       pivot(k);
+
+    for (size_t j = 0; j < k; j++)
+    {
+        cusp::array1d<ValueType,cusp::host_memory> e(k);
+        cusp::krylov::detail::multi_dotc(space.U, 0, k, space.C.column(j), e);
+
+        for (size_t i = 0; i < k; i++)
+            E(i,j) = e[i];
+    }
+
+    for (size_t i = 0; i < k; i++)
+        for (size_t j = 0; j < i; j++)
+            E(i,j) = E(j,i) = (E(i,j) + E(j,i)) / ValueType(2);
+
+    // fall back to plain CG if E is singular
+    if (k > 0 && cusp::detail::lu_factor(E, pivot) != 0)
+        k = 0;
+
+    // allocate workspace
+    cusp::array1d<ValueType,MemorySpace> y(N);
+    cusp::array1d<ValueType,MemorySpace> z(N);
+    cusp::array1d<ValueType,MemorySpace> r(N);
+    cusp::array1d<ValueType,MemorySpace> p(N);
+
+    // search directions and their images for the update of the space
+    Basis P(N, L);
+    Basis AP(N, L);
+    size_t num_directions = 0;
+
+    // y <- Ax
+    cusp::multiply(A, x, y);
+
+    // r <- b - A*x
+    blas::axpby(b, y, r, ValueType(1), ValueType(-1));
+
+    if (k > 0)
+    {
+        // mu <- E^-1 U^H r
+        cusp::array1d<ValueType,cusp::host_memory> c(k);
+        cusp::array1d<ValueType,cusp::host_memory> mu(k);
+
+        cusp::krylov::detail::multi_dotc(space.U, 0, k, r, c);
+        cusp::detail::lu_solve(E, pivot, c, mu);
+
+        // x <- x + U mu
+        cusp::krylov::detail::multi_axpy(space.U, 0, k, mu, x);
+
+        // r <- r - C mu
+        for (size_t i = 0; i < k; i++)
+            mu[i] = -mu[i];
+        cusp::krylov::detail::multi_axpy(space.C, 0, k, mu, r);
+    }
+
+    // z <- M*r
+    cusp::multiply(M, r, z);
+
+    // p <- z - U E^-1 C^H z
+    blas::copy(z, p);
+    if (k > 0)
+        cusp::krylov::detail::deflated_cg_project(space.U, space.C, k, E, pivot, z, p);
+
+    // rz = <r^H, z>
+    ValueType rz = blas::dotc(r, z);
+
+    while (!cusp::krylov::detail::cg_finished(monitor, r, M, rz))
+    {
+        // y <- Ap
+        cusp::multiply(A, p, y);
+
+        // keep the first search directions, normalized
+        if (num_directions < L)
+        {
+            NormType p_norm = blas::nrm2(p);
+
+            blas::axpby(p, p, P.column(num_directions),  ValueType(1) / p_norm, ValueType(0));
+            blas::axpby(y, y, AP.column(num_directions), ValueType(1) / p_norm, ValueType(0));
+
+            num_directions++;
+        }
+
+        // alpha <- <r,z>/<y,p>
+        ValueType alpha =  rz / blas::dotc(y, p);
+
+        // x <- x + alpha * p
+        blas::axpy(p, x, alpha);
+
+        // r <- r - alpha * y
+        blas::axpy(y, r, -alpha);
+
+        // z <- M*r
+        cusp::multiply(M, r, z);
+
+        ValueType rz_old = rz;
+
+        // rz = <r^H, z>
+        rz = blas::dotc(r, z);
+
+        // beta <- <r_{i+1},r_{i+1}>/<r,r>
+        ValueType beta = rz / rz_old;
+
+        // p <- z + beta*p - U E^-1 C^H z
+        blas::axpby(z, p, p, ValueType(1), beta);
+        if (k > 0)
+            cusp::krylov::detail::deflated_cg_project(space.U, space.C, k, E, pivot, z, p);
+
+        ++monitor;
+    }
+
+    // refine the recycle space for the next solve
+    cusp::krylov::detail::deflated_cg_update(space, k, P, AP, num_directions);
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
@@ -0,0 +1,337 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/cmath.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/symmetric_eigen.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/krylov/detail/multivector.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// Replace the recycle space with the k vectors of Z = [U V(0:j)] along
+// which M A is smallest, i.e. the solutions of
+//
+//     G^H G y = theta Z^H Z y
+//
+// for the smallest theta, where M A Z = [C V(0:j+1)] G.  This is a
+// symmetric stand-in for the harmonic Ritz vectors of the original
+// method that needs no nonsymmetric eigensolver.
+template <typename RecycleSpace, typename Matrix, typename Array2d>
+void gcrodr_update(RecycleSpace& space, size_t k,
+                   Matrix& V, size_t j, const Array2d& G)
+{
+    typedef typename RecycleSpace::value_type ValueType;
+    typedef typename RecycleSpace::basis_type Basis;
+
+    const size_t n = k + j;
+
+    // K = G^H G
+    cusp::array2d<ValueType,cusp::host_memory> K(n, n);
+    for (size_t a = 0; a < n; a++)
+        for (size_t b = 0; b <= a; b++)
+        {
+            ValueType sum = 0;
+            for (size_t i = 0; i < n + 1; i++)
+                sum += G(i,a) * G(i,b);
+            K(a,b) = K(b,a) = sum;
+        }
+
+    // F = Z^H Z, where V has orthonormal columns
+    cusp::array2d<ValueType,cusp::host_memory> F(n, n, ValueType(0));
+    for (size_t i = k; i < n; i++)
+        F(i,i) = ValueType(1);
+
+    for (size_t b = 0; b < n; b++)
+    {
+        cusp::array1d<ValueType,cusp::host_memory> f(k);
+
+        if (b < k)
+            cusp::krylov::detail::multi_dotc(space.U, 0, k, space.U.column(b), f);
+        else
+            cusp::krylov::detail::multi_dotc(space.U, 0, k, V.column(b - k), f);
+
+        for (size_t a = 0; a < k; a++)
+            F(a,b) = F(b,a) = f[a];
+    }
+
+    for (size_t a = 0; a < k; a++)
+        for (size_t b = 0; b < a; b++)
+            F(a,b) = F(b,a) = (F(a,b) + F(b,a)) / ValueType(2);
+
+    cusp::array1d<ValueType,cusp::host_memory> theta;
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> Y;
+
+    // keep the old space if Z is numerically rank deficient
+    if (cusp::detail::generalized_symmetric_eigen(K, F, theta, Y) != 0)
+        return;
+
+    const size_t num_vectors = std::min(space.max_size(), n);
+
+    // GY = G Y
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> GY(n + 1, num_vectors);
+    for (size_t i = 0; i < n + 1; i++)
+        for (size_t q = 0; q < num_vectors; q++)
+        {
+            ValueType sum = 0;
+            for (size_t a = 0; a < n; a++)
+                sum += G(i,a) * Y(a,q);
+            GY(i,q) = sum;
+        }
+
+    Basis U_new(space.U.num_rows, space.max_size());
+    Basis C_new(space.C.num_rows, space.max_size());
+
+    // U <- Z Y and C <- [C V(0:j+1)] G Y = M A U
+    cusp::krylov::detail::multi_combine(space.U, k, V, j,     Y,  num_vectors, U_new);
+    cusp::krylov::detail::multi_combine(space.C, k, V, j + 1, GY, num_vectors, C_new);
+
+    space.assign(U_new, C_new, num_vectors);
+}
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::default_monitor<ValueType> monitor(b);
+
+    cusp::krylov::gcrodr(A, x, b, restart, space, monitor);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space,
+            Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    cusp::krylov::gcrodr(A, x, b, restart, space, monitor, M);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor,
+          class Preconditioner>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space,
+            Monitor& monitor,
+            Preconditioner& M)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename RecycleSpace::basis_type     Basis;
+    typedef typename norm_type<ValueType>::type   NormType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+    assert(space.max_size() < restart);
+
+    const size_t N = A.num_rows;
+    const size_t m = restart;
+
+    space.resize(N);
+
+    // allocate workspace
+    cusp::array1d<ValueType,MemorySpace> r(N);
+    cusp::array1d<ValueType,MemorySpace> w(N);
+    cusp::array1d<ValueType,MemorySpace> t(N);
+    Basis V(N, m + 1);
+
+    // host workspace
+    //   G : M A [U V(0:j)] = [C V(0:j+1)] G, kept for the space update
+    //   R : G reduced to upper triangular form by plane rotations
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> G(m + 1, m);
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> R(m + 1, m);
+    cusp::array1d<ValueType,cusp::host_memory> s(m + 1);
+    cusp::array1d<ValueType,cusp::host_memory> cs(m);
+    cusp::array1d<ValueType,cusp::host_memory> sn(m);
+    cusp::array1d<NormType,cusp::host_memory>  resid(1);
+
+    while (true)
+    {
+        const size_t k = space.size();
+
+        // r <- M*(b - A*x)
+        cusp::multiply(A, x, t);
+        blas::axpby(b, t, t, ValueType(1), ValueType(-1));
+        cusp::multiply(M, t, r);
+
+        // split r = C c + beta * V(0)
+        cusp::array1d<ValueType,cusp::host_memory> c(k);
+        cusp::array1d<ValueType,cusp::host_memory> minus_c(k);
+        cusp::krylov::detail::multi_dotc(space.C, 0, k, r, c);
+
+        NormType c_norm2 = 0;
+        for (size_t i = 0; i < k; i++)
+        {
+            c_norm2 += cusp::abs(c[i]) * cusp::abs(c[i]);
+            minus_c[i] = -c[i];
+        }
+
+        blas::copy(r, w);
+        cusp::krylov::detail::multi_axpy(space.C, 0, k, minus_c, w);
+
+        NormType beta = blas::nrm2(w);
+
+        resid[0] = std::sqrt(beta * beta + c_norm2);
+        if (cusp::detail::monitor_finished(monitor, resid, resid[0]))
+            break;
+
+        // r lies in the range of C, so x + U c solves the system
+        if (beta == NormType(0))
+        {
+            cusp::krylov::detail::multi_axpy(space.U, 0, k, c, x);
+            continue;
+        }
+
+        // rows 0..k-1 of the least squares problem are already triangular
+        blas::fill(G.values, ValueType(0));
+        blas::fill(R.values, ValueType(0));
+        blas::fill(s,        ValueType(0));
+        for (size_t i = 0; i < k; i++)
+        {
+            G(i,i) = R(i,i) = ValueType(1);
+            cs[i] = ValueType(1);
+            sn[i] = ValueType(0);
+            s[i]  = c[i];
+        }
+        s[k] = beta;
+
+        // V(0) = w / beta
+        blas::axpby(w, w, V.column(0), ValueType(1) / beta, ValueType(0));
+
+        size_t j = 0;
+
+        while (j < m - k && monitor.iteration_count() < monitor.iteration_limit())
+        {
+            ++monitor;
+
+            const size_t col = k + j;
+
+            // w <- M*A*V(j)
+            blas::copy(V.column(j), w);
+            cusp::multiply(A, w, t);
+            cusp::multiply(M, t, w);
+
+            // G(0:k,col) = C^H w, w <- w - C G(0:k,col)
+            cusp::array1d<ValueType,cusp::host_memory> h(k);
+            cusp::krylov::detail::multi_dotc(space.C, 0, k, w, h);
+            for (size_t i = 0; i < k; i++)
+            {
+                G(i,col) = h[i];
+                h[i] = -h[i];
+            }
+            cusp::krylov::detail::multi_axpy(space.C, 0, k, h, w);
+
+            // Arnoldi step
+            for (size_t i = 0; i <= j; i++)
+            {
+                G(k + i, col) = blas::dotc(V.column(i), w);
+                blas::axpy(V.column(i), w, -G(k + i, col));
+            }
+
+            NormType h_norm = blas::nrm2(w);
+            G(col + 1, col) = h_norm;
+
+            if (h_norm != NormType(0))
+                blas::axpby(w, w, V.column(j + 1), ValueType(1) / h_norm, ValueType(0));
+
+            // apply the plane rotations to the new column
+            for (size_t i = 0; i <= col + 1; i++)
+                R(i,col) = G(i,col);
+
+            for (size_t i = 0; i < col; i++)
+                ApplyPlaneRotation(R(i,col), R(i+1,col), cs[i], sn[i]);
+
+            GeneratePlaneRotation(R(col,col), R(col+1,col), cs[col], sn[col]);
+            ApplyPlaneRotation(R(col,col), R(col+1,col), cs[col], sn[col]);
+            ApplyPlaneRotation(s[col], s[col+1], cs[col], sn[col]);
+
+            j++;
+
+            resid[0] = cusp::abs(s[col+1]);
+
+            // stop on convergence or a lucky breakdown
+            if (cusp::detail::monitor_finished(monitor, resid, resid[0]) || h_norm == NormType(0))
+                break;
+        }
+
+        const size_t n = k + j;
+
+        // solve upper triangular system R y = s in place
+        for (int i = n - 1; i >= 0; i--)
+        {
+            s[i] /= R(i,i);
+            for (int l = i - 1; l >= 0; l--)
+                s[l] -= R(l,i) * s[i];
+        }
+
+        // x <- x + U y(0:k) + V y(k:n)
+        cusp::array1d<ValueType,cusp::host_memory> y_u(s.begin(),     s.begin() + k);
+        cusp::array1d<ValueType,cusp::host_memory> y_v(s.begin() + k, s.begin() + n);
+
+        cusp::krylov::detail::multi_axpy(space.U, 0, k, y_u, x);
+        cusp::krylov::detail::multi_axpy(V,       0, j, y_v, x);
+
+        // recycle the slowest directions of this cycle
+        if (space.max_size() > 0 && j > 0)
+            cusp::krylov::detail::gcrodr_update(space, k, V, j, G);
+    }
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
@@ -108,95 +108,246 @@ namespace cusp
 	       Monitor& monitor,
 	       Preconditioner& M)
     {
-      typedef typename LinearOperator::value_type   ValueType;
-      typedef typename LinearOperator::memory_space MemorySpace;
-      typedef typename norm_type<ValueType>::type NormType;
+      cusp::krylov::gmres_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, restart, monitor, M);
+
+      while (!solver.done())
+        solver.step();
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres(LinearOperator& A,
+	       Vector& x,
+	       Vector& b,
+	       const size_t restart,
+	       Monitor& monitor,
+	       Preconditioner& M,
+	       checkpoint& ckpt)
+    {
+      cusp::krylov::gmres_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, restart, monitor, M);
+
+      cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres_resume(LinearOperator& A,
+		      Vector& x,
+		      Vector& b,
+		      const size_t restart,
+		      Monitor& monitor,
+		      Preconditioner& M,
+		      checkpoint& ckpt)
+    {
+      cusp::krylov::gmres_solver<LinearOperator,Vector,Monitor,Preconditioner> solver(A, x, b, restart, monitor, M, ckpt);
+
+      cusp::krylov::detail::checkpointed_solve(solver, monitor, ckpt);
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::gmres_solver(LinearOperator& A,
+		   Vector& x,
+		   Vector& b,
+		   const size_t restart,
+		   Monitor& monitor,
+		   Preconditioner& M)
+      : A(&A), x(&x), b(&b), monitor(&monitor), M(&M),
+	R(restart), i(-1),
+	resid(1),
+	//allocate workspace
+	w(A.num_rows),
+	V0(A.num_rows),                                        //Arnoldi matrix pos 0
+	V(A.num_rows, restart+1, ValueType(0.0)),              //Arnoldi matrix
+	//HOST WORKSPACE
+	H(restart+1, restart),                                 //Hessenberg matrix
+	s(restart+1),
+	cs(restart),
+	sn(restart),
+	done_(false)
+    {
       assert(A.num_rows == A.num_cols);        // sanity check
-      const size_t N = A.num_rows;
-      const int R = restart;
-      int i, j, k;
-      NormType beta = 0;
-      cusp::array1d<NormType,cusp::host_memory> resid(1);
-      //allocate workspace
-      cusp::array1d<ValueType,MemorySpace> w(N);
-      cusp::array1d<ValueType,MemorySpace> V0(N); //Arnoldi matrix pos 0
-      cusp::array2d<ValueType,MemorySpace,cusp::column_major> V(N,R+1,ValueType(0.0)); //Arnoldi matrix
-      //duplicate copy of s on GPU
-      cusp::array1d<ValueType,MemorySpace> sDev(R+1);
-      //HOST WORKSPACE
-      cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> H(R+1, R); //Hessenberg matrix
-      cusp::array1d<ValueType,cusp::host_memory> s(R+1);
-      cusp::array1d<ValueType,cusp::host_memory> cs(R);
-      cusp::array1d<ValueType,cusp::host_memory> sn(R);
-      do{
-	// compute initial residual and its norm //
-	cusp::multiply(A, x, w);                     // V(0) = A*x        //
-	blas::axpy(b,w,ValueType(-1));               // V(0) = V(0) - b   //
-	cusp::multiply(M,w,w);                       // V(0) = M*V(0)     //
-	beta = blas::nrm2(w);                        // beta = norm(V(0)) //
-	blas::scal(w, ValueType(-1.0/beta));         // V(0) = -V(0)/beta //
-	blas::copy(w,V.column(0));
-	//s = 0 //
-	blas::fill(s,ValueType(0.0));
-	s[0] = beta;
-	i = -1;
-	resid[0] = s[0];
-	if (monitor.finished(resid)){
-	  break;
-	}
+      start_cycle();
+    }
 
-	do{
-	  ++i;
-	  ++monitor;
-	  
-	  //apply preconditioner
-	  //can't pass in ref to column in V so need to use copy (w)
-	  cusp::multiply(A,w,V0);
-	  //V(i+1) = A*w = M*A*V(i)    //
-	  cusp::multiply(M,V0,w);
-	  
-	  for (k = 0; k <= i; k++){
-	    //  H(k,i) = <V(i+1),V(k)>    //
-	    H(k, i) = blas::dotc(w, V.column(k));
-	    // V(i+1) -= H(k, i) * V(k)  //
-	    blas::axpy(V.column(k),w,-H(k,i));
-	  }
-	  
-	  H(i+1,i) = blas::nrm2(w);   
-	  // V(i+1) = V(i+1) / H(i+1, i) //
-	  blas::scal(w,ValueType(1.0)/H(i+1,i));
-	  blas::copy(w,V.column(i+1));
-	  
-	  PlaneRotation(H,cs,sn,s,i);
-	  
-	  resid[0] = s[i+1];
-	  
-	  //check convergence condition
-	  if (monitor.finished(resid)){
-	    break;
-	  }
-	}while (i+1 < R && monitor.iteration_count()+1 <= monitor.iteration_limit());
-	
-
-	// solve upper triangular system in place //
-	for (j = i; j >= 0; j--){
-	  s[j] /= H(j,j);
-	  //S(0:j) = s(0:j) - s[j] H(0:j,j)
-	  for (k = j-1; k >= 0; k--){
-	    s[k] -= H(k,j) * s[j];
-	  }
-	}
-	
-	// update the solution //
-	
-	//copy s to gpu 
-	blas::copy(s,sDev);
-	// x= V(1:N,0:i)*s(0:i)+x //
-	for (j = 0; j <= i; j++){
-	  // x = x + s[j] * V(j) //
-	  blas::axpy(V.column(j),x,s[j]);
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::gmres_solver(LinearOperator& A,
+		   Vector& x,
+		   Vector& b,
+		   const size_t restart,
+		   Monitor& monitor,
+		   Preconditioner& M,
+		   checkpoint& ckpt)
+      : A(&A), x(&x), b(&b), monitor(&monitor), M(&M),
+	R(restart), i(-1),
+	resid(1),
+	w(A.num_rows),
+	V0(A.num_rows),
+	V(A.num_rows, restart+1, ValueType(0.0)),
+	H(restart+1, restart),
+	s(restart+1),
+	cs(restart),
+	sn(restart),
+	done_(false)
+    {
+      assert(A.num_rows == A.num_cols);        // sanity check
+
+      size_t iteration_count;
+      int stored_R;
+
+      ckpt.begin_restore("gmres", sizeof(ValueType));
+      ckpt.read(iteration_count);
+      ckpt.read(stored_R);
+      if (stored_R != R)
+	throw cusp::io_exception("gmres: checkpoint was taken with a different restart length");
+      ckpt.read(i);
+      ckpt.read_array(x);
+      ckpt.read_array(w);
+      ckpt.read_array(V.values);
+      ckpt.read_array(H.values);
+      ckpt.read_array(s);
+      ckpt.read_array(cs);
+      ckpt.read_array(sn);
+      ckpt.read_array(resid);
+      ckpt.end_restore();
+
+      monitor.set_iteration_count(iteration_count);
+
+      // repeats the test made right after the snapshot was taken
+      done_ = cusp::detail::monitor_finished(monitor, resid, resid[0]);
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::save(checkpoint& ckpt) const
+    {
+      // the current cycle: basis, Hessenberg matrix and Givens rotations
+      ckpt.begin_snapshot("gmres", sizeof(ValueType));
+      ckpt.write(monitor->iteration_count());
+      ckpt.write(R);
+      ckpt.write(i);
+      ckpt.write_array(*x);
+      ckpt.write_array(w);
+      ckpt.write_array(V.values);
+      ckpt.write_array(H.values);
+      ckpt.write_array(s);
+      ckpt.write_array(cs);
+      ckpt.write_array(sn);
+      ckpt.write_array(resid);
+      ckpt.commit();
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::start_cycle(void)
+    {
+      // compute initial residual and its norm //
+      cusp::multiply(*A, *x, w);                   // V(0) = A*x        //
+      blas::axpy(*b,w,ValueType(-1));              // V(0) = V(0) - b   //
+      cusp::multiply(*M,w,w);                      // V(0) = M*V(0)     //
+      NormType beta = blas::nrm2(w);               // beta = norm(V(0)) //
+      blas::scal(w, ValueType(-1.0/beta));         // V(0) = -V(0)/beta //
+      blas::copy(w,V.column(0));
+      //s = 0 //
+      blas::fill(s,ValueType(0.0));
+      s[0] = beta;
+      i = -1;
+      // the residual norm estimate comes from the Givens rotations
+      resid[0] = abs(s[0]);
+      done_ = cusp::detail::monitor_finished(*monitor, resid, resid[0]);
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::end_cycle(void)
+    {
+      int j, k;
+
+      // solve upper triangular system in place //
+      for (j = i; j >= 0; j--){
+	s[j] /= H(j,j);
+	//S(0:j) = s(0:j) - s[j] H(0:j,j)
+	for (k = j-1; k >= 0; k--){
+	  s[k] -= H(k,j) * s[j];
 	}
-      } while (!monitor.finished(resid));
+      }
+
+      // update the solution //
+
+      // x= V(1:N,0:i)*s(0:i)+x //
+      for (j = 0; j <= i; j++){
+	// x = x + s[j] * V(j) //
+	blas::axpy(V.column(j),*x,s[j]);
+      }
+    }
+
+    template <class LinearOperator,
+	      class Vector,
+	      class Monitor,
+	      class Preconditioner>
+    void gmres_solver<LinearOperator,Vector,Monitor,Preconditioner>
+    ::step(void)
+    {
+      if (done_)
+	return;
+
+      ++i;
+      ++(*monitor);
+
+      //apply preconditioner
+      //can't pass in ref to column in V so need to use copy (w)
+      cusp::multiply(*A,w,V0);
+      //V(i+1) = A*w = M*A*V(i)    //
+      cusp::multiply(*M,V0,w);
+
+      for (int k = 0; k <= i; k++){
+	//  H(k,i) = <V(i+1),V(k)>    //
+	H(k, i) = blas::dotc(w, V.column(k));
+	// V(i+1) -= H(k, i) * V(k)  //
+	blas::axpy(V.column(k),w,-H(k,i));
+      }
+
+      H(i+1,i) = blas::nrm2(w);
+      // V(i+1) = V(i+1) / H(i+1, i) //
+      blas::scal(w,ValueType(1.0)/H(i+1,i));
+      blas::copy(w,V.column(i+1));
+
+      PlaneRotation(H,cs,sn,s,i);
+
+      resid[0] = abs(s[i+1]);
+
+      //check convergence condition, then whether the cycle is over
+      if (cusp::detail::monitor_finished(*monitor, resid, resid[0]) ||
+	  !(i+1 < R && monitor->iteration_count()+1 <= monitor->iteration_limit()))
+      {
+	end_cycle();
+
+	if (cusp::detail::monitor_finished(*monitor, resid, resid[0]))
+	  done_ = true;
+	else
+	  start_cycle();
+      }
     }
+
   } // end namespace krylov
 } // end namespace cusp
@@ -0,0 +1,206 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/cmath.h>
+#include <cusp/complex.h>
+
+#include <algorithm>
+
+/*
+ * Host kernels for the multi-shift solvers (CG-M and BiCGStab-M).
+ *
+ * The shifted solutions x^\sigma and search directions are stored in one
+ * flat array in shift-major order, i.e. as a column-major N x N_s matrix
+ * whose column s holds the vector for shift sigma[s].  The device kernels
+ * in detail_m recover (shift, row) from a flat index with a division and
+ * a modulo per element.  On the host we instead walk each column
+ * contiguously, so the inner loops are unit-stride and vectorizable, and
+ * distribute (shift, row block) pairs over threads when OpenMP is enabled.
+ *
+ * Shifts whose residual has dropped below the monitor tolerance are removed
+ * from the active set and their columns are left untouched from then on.
+ */
+
+namespace cusp
+{
+namespace krylov
+{
+namespace host_m
+{
+
+// number of rows handled by one task of the (shift, row block) loops
+const size_t block_size = 4096;
+
+// remove converged shifts from the active set
+//
+// the residual of shifted system s is z_s[s] * r, where |r| is the
+// residual norm of the seed system, so no vector pass is needed
+template <typename Array1, typename Array2, typename Real>
+void update_active_shifts(Array1& active, const Array2& z_s,
+                          Real r_norm, Real tolerance)
+{
+  size_t num_active = 0;
+
+  for (size_t n = 0; n < active.size(); n++)
+  {
+    const int s = active[n];
+
+    if (cusp::abs(z_s[s]) * r_norm > tolerance)
+      active[num_active++] = s;
+  }
+
+  active.resize(num_active);
+}
+
+// same as above for BiCGStab-M, where the shifted residual is
+// z_s[s] * rho_s[s] * r
+template <typename Array1, typename Array2, typename Array3, typename Real>
+void update_active_shifts(Array1& active, const Array2& z_s, const Array3& rho_s,
+                          Real r_norm, Real tolerance)
+{
+  size_t num_active = 0;
+
+  for (size_t n = 0; n < active.size(); n++)
+  {
+    const int s = active[n];
+
+    if (cusp::abs(z_s[s] * rho_s[s]) * r_norm > tolerance)
+      active[num_active++] = s;
+  }
+
+  active.resize(num_active);
+}
+
+// x^\sigma <- x^\sigma - \beta_0^\sigma p^\sigma
+// p^\sigma <- \zeta_1^\sigma r_0 + \alpha_0^\sigma p^\sigma
+template <typename Array1, typename Array2, typename Array3, typename Array4,
+          typename Array5, typename Array6, typename Array7>
+void compute_xp_m(const Array1& alpha_0_s, const Array2& z_1_s,
+                  const Array3& beta_0_s, const Array4& r_0,
+                  Array5& x_0_s, Array6& p_0_s, const Array7& active)
+{
+  typedef typename Array5::value_type ScalarType;
+
+  const size_t N          = r_0.size();
+  const size_t num_active = active.size();
+
+  if (N == 0 || num_active == 0)
+    return;
+
+  const int num_blocks = (N + block_size - 1) / block_size;
+  const int num_tasks  = num_blocks * num_active;
+
+  const ScalarType * r = thrust::raw_pointer_cast(&r_0[0]);
+  ScalarType * x_base  = thrust::raw_pointer_cast(&x_0_s[0]);
+  ScalarType * p_base  = thrust::raw_pointer_cast(&p_0_s[0]);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int task = 0; task < num_tasks; task++)
+  {
+    // one division per block of rows, not per element
+    const size_t s     = active[task / num_blocks];
+    const size_t begin = (task % num_blocks) * block_size;
+    const size_t end   = std::min(begin + block_size, N);
+
+    const ScalarType alpha = alpha_0_s[s];
+    const ScalarType beta  = beta_0_s[s];
+    const ScalarType z     = z_1_s[s];
+
+    ScalarType * x = x_base + s * N;
+    ScalarType * p = p_base + s * N;
+
+    for (size_t i = begin; i < end; i++)
+    {
+      const ScalarType p_i = p[i];
+      x[i] = x[i] - beta * p_i;
+      p[i] = z * r[i] + alpha * p_i;
+    }
+  }
+}
+
+// x^\sigma <- x^\sigma - \beta_0^\sigma s^\sigma + \chi_0^\sigma \rho_0^\sigma \zeta_1^\sigma w_1
+// s^\sigma <- \zeta_1^\sigma \rho_1^\sigma r_1 + \alpha_1^\sigma (s^\sigma
+//             - \chi_0^\sigma \rho_0^\sigma / \beta_0^\sigma (\zeta_1^\sigma w_1 - \zeta_0^\sigma r_0))
+template <typename Array1, typename Array2, typename Array3, typename Array4,
+          typename Array5, typename Array6, typename Array7, typename Array8,
+          typename Array9, typename Array10, typename Array11, typename Array12,
+          typename Array13>
+void compute_xs_m(const Array1& beta_0_s, const Array2& chi_0_s,
+                  const Array3& rho_0_s, const Array4& zeta_0_s,
+                  const Array5& alpha_1_s, const Array6& rho_1_s,
+                  const Array7& zeta_1_s,
+                  const Array8& r_0, const Array9& r_1,
+                  const Array10& w_1, Array11& s_0_s, Array12& x,
+                  const Array13& active)
+{
+  typedef typename Array12::value_type ScalarType;
+
+  const size_t N          = w_1.size();
+  const size_t num_active = active.size();
+
+  if (N == 0 || num_active == 0)
+    return;
+
+  const int num_blocks = (N + block_size - 1) / block_size;
+  const int num_tasks  = num_blocks * num_active;
+
+  const ScalarType * r0 = thrust::raw_pointer_cast(&r_0[0]);
+  const ScalarType * r1 = thrust::raw_pointer_cast(&r_1[0]);
+  const ScalarType * w  = thrust::raw_pointer_cast(&w_1[0]);
+  ScalarType * x_base   = thrust::raw_pointer_cast(&x[0]);
+  ScalarType * s_base   = thrust::raw_pointer_cast(&s_0_s[0]);
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int task = 0; task < num_tasks; task++)
+  {
+    const size_t s     = active[task / num_blocks];
+    const size_t begin = (task % num_blocks) * block_size;
+    const size_t end   = std::min(begin + block_size, N);
+
+    // fold the per-shift scalars once per block
+    const ScalarType z1s = zeta_1_s[s];
+    const ScalarType z0s = zeta_0_s[s];
+    const ScalarType b0s = beta_0_s[s];
+    const ScalarType a1s = alpha_1_s[s];
+    const ScalarType cr  = chi_0_s[s] * rho_0_s[s];
+    const ScalarType c_w = cr * z1s;
+    const ScalarType c_r = z1s * rho_1_s[s];
+    const ScalarType c_d = cr / b0s;
+
+    ScalarType * xs = x_base + s * N;
+    ScalarType * ss = s_base + s * N;
+
+    for (size_t i = begin; i < end; i++)
+    {
+      const ScalarType s_i = ss[i];
+      const ScalarType w_i = w[i];
+      xs[i] = xs[i] - b0s * s_i + c_w * w_i;
+      ss[i] = c_r * r1[i] + a1s * (s_i - c_d * (z1s * w_i - z0s * r0[i]));
+    }
+  }
+}
+
+} // end namespace host_m
+} // end namespace krylov
+} // end namespace cusp
+
@@ -0,0 +1,281 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/copy.h>
+#include <cusp/multiply.h>
+#include <cusp/monitor.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/random.h>
+#include <cusp/krylov/detail/multivector.h>
+
+#include <cmath>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// fill P with random vectors and orthonormalize its columns
+template <typename Matrix>
+void idrs_shadow_space(Matrix& P)
+{
+    typedef typename Matrix::value_type             ValueType;
+    typedef typename norm_type<ValueType>::type     NormType;
+
+    const size_t N = P.num_rows;
+    const size_t s = P.num_cols;
+
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> P_host(N, s);
+    cusp::copy(cusp::detail::random_reals<NormType>(N * s), P_host.values);
+
+    // modified Gram-Schmidt
+    for (size_t j = 0; j < s; j++)
+    {
+        for (size_t i = 0; i < j; i++)
+        {
+            ValueType h = blas::dotc(P_host.column(i), P_host.column(j));
+            blas::axpy(P_host.column(i), P_host.column(j), -h);
+        }
+
+        blas::scal(P_host.column(j), ValueType(1) / blas::nrm2(P_host.column(j)));
+    }
+
+    P = P_host;
+}
+
+// solves the lower triangular system L(k:n,k:n) y = f(k:n)
+template <typename Matrix, typename Array1, typename Array2>
+void idrs_forward_solve(const Matrix& L, const Array1& f, Array2& y, size_t k, size_t n)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    for (size_t i = k; i < n; i++)
+    {
+        ValueType sum = f[i - k];
+
+        for (size_t j = k; j < i; j++)
+            sum -= L(i,j) * y[j - k];
+
+        y[i - k] = sum / L(i,i);
+    }
+}
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Vector>
+void idrs(LinearOperator& A,
+          Vector& x,
+          Vector& b,
+          const size_t s)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+
+    cusp::default_monitor<ValueType> monitor(b);
+
+    cusp::krylov::idrs(A, x, b, s, monitor);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor>
+void idrs(LinearOperator& A,
+          Vector& x,
+          Vector& b,
+          const size_t s,
+          Monitor& monitor)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    cusp::krylov::idrs(A, x, b, s, monitor, M);
+}
+
+template <class LinearOperator,
+          class Vector,
+          class Monitor,
+          class Preconditioner>
+void idrs(LinearOperator& A,
+          Vector& x,
+          Vector& b,
+          const size_t s,
+          Monitor& monitor,
+          Preconditioner& M)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename norm_type<ValueType>::type   NormType;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+    assert(s > 0);
+
+    const size_t N = A.num_rows;
+
+    // threshold on the angle between t and r in the omega computation
+    const NormType kappa = 0.7;
+
+    // allocate workspace
+    cusp::array1d<ValueType,MemorySpace> r(N);
+    cusp::array1d<ValueType,MemorySpace> v(N);
+    cusp::array1d<ValueType,MemorySpace> t(N);
+
+    // shadow space P and the directions G = A U, kept biorthogonal to P
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> P(N, s);
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> G(N, s, ValueType(0));
+    cusp::array2d<ValueType,MemorySpace,cusp::column_major> U(N, s, ValueType(0));
+
+    // HOST WORKSPACE
+    // Mk = P^H G is lower triangular
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> Mk(s, s, ValueType(0));
+    cusp::array1d<ValueType,cusp::host_memory> f(s);
+    cusp::array1d<ValueType,cusp::host_memory> c(s);
+    cusp::array1d<ValueType,cusp::host_memory> m(s);
+
+    for (size_t i = 0; i < s; i++)
+        Mk(i,i) = ValueType(1);
+
+    cusp::krylov::detail::idrs_shadow_space(P);
+
+    // t <- Ax
+    cusp::multiply(A, x, t);
+
+    // r <- b - A*x
+    blas::axpby(b, t, r, ValueType(1), ValueType(-1));
+
+    ValueType omega(1);
+
+    while (!monitor.finished(r))
+    {
+        // f <- P^H r
+        cusp::krylov::detail::multi_dotc(P, 0, s, r, f);
+
+        for (size_t k = 0; k < s; k++)
+        {
+            // solve Mk(k:s,k:s) c = f(k:s)
+            cusp::krylov::detail::idrs_forward_solve(Mk, f.begin() + k, c, k, s);
+
+            // v <- r - G(:,k:s) c
+            for (size_t i = 0; i < s - k; i++)
+                m[i] = -c[i];
+
+            blas::copy(r, v);
+            cusp::krylov::detail::multi_axpy(G, k, s - k, m, v);
+
+            // t <- omega * M v + U(:,k:s) c
+            cusp::multiply(M, v, t);
+            blas::scal(t, omega);
+            cusp::krylov::detail::multi_axpy(U, k, s - k, c, t);
+
+            // v <- A t
+            cusp::multiply(A, t, v);
+
+            // make v orthogonal to P(:,0:k), applying the same
+            // combination to t so that v = A t still holds
+            if (k > 0)
+            {
+                cusp::krylov::detail::multi_dotc(P, 0, k, v, m);
+                cusp::krylov::detail::idrs_forward_solve(Mk, m.begin(), c, 0, k);
+
+                for (size_t i = 0; i < k; i++)
+                    c[i] = -c[i];
+
+                cusp::krylov::detail::multi_axpy(G, 0, k, c, v);
+                cusp::krylov::detail::multi_axpy(U, 0, k, c, t);
+            }
+
+            blas::copy(v, G.column(k));
+            blas::copy(t, U.column(k));
+
+            // Mk(k:s,k) <- P(:,k:s)^H G(:,k)
+            cusp::krylov::detail::multi_dotc(P, k, s - k, v, m);
+
+            for (size_t i = k; i < s; i++)
+                Mk(i,k) = m[i - k];
+
+            // make r orthogonal to P(:,0:k+1)
+            ValueType beta = f[k] / Mk(k,k);
+
+            // r <- r - beta * G(:,k)
+            blas::axpy(v, r, -beta);
+
+            // x <- x + beta * U(:,k)
+            blas::axpy(t, x, beta);
+
+            ++monitor;
+
+            if (monitor.finished(r))
+                return;
+
+            // f(k+1:s) <- f(k+1:s) - beta * Mk(k+1:s,k)
+            for (size_t i = k + 1; i < s; i++)
+                f[i] -= beta * Mk(i,k);
+        }
+
+        // enter the next G space: v <- M r, t <- A v
+        cusp::multiply(M, r, v);
+        cusp::multiply(A, v, t);
+
+        // omega minimizes ||r - omega t||, increased when t and r are
+        // nearly orthogonal so that the next space does not degenerate
+        NormType  t_norm = blas::nrm2(t);
+        NormType  r_norm = blas::nrm2(r);
+
+        // x is exact, but the monitor may have skipped the last check
+        if (r_norm == NormType(0))
+        {
+            cusp::detail::monitor_finished(monitor, r, r_norm);
+            return;
+        }
+
+        // M A annihilates r: no direction is left to minimize along
+        if (t_norm == NormType(0))
+            return;
+
+        ValueType tr     = blas::dotc(t, r);
+        NormType  rho    = abs(tr / (t_norm * r_norm));
+
+        omega = tr / (t_norm * t_norm);
+
+        // for t orthogonal to r use the limit of the increased omega
+        if (rho < kappa)
+            omega = (rho > NormType(0)) ? omega * (kappa / rho) : ValueType(kappa * r_norm / t_norm);
+
+        // r <- r - omega * t
+        blas::axpy(t, r, -omega);
+
+        // x <- x + omega * v
+        blas::axpy(v, x, omega);
+
+        ++monitor;
+    }
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
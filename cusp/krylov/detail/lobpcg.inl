@@ -0,0 +1,337 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/multiply.h>
+#include <cusp/linear_operator.h>
+
+#include <cusp/detail/random.h>
+#include <cusp/detail/symmetric_eigen.h>
+#include <cusp/krylov/detail/multivector.h>
+
+#include <thrust/copy.h>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// AS(:,j) <- A*S(:,j) for first <= j < first + count
+template <typename LinearOperator, typename Matrix, typename Vector>
+void lobpcg_apply(LinearOperator& A, Matrix& S, Matrix& AS,
+                  size_t first, size_t count, Vector& u, Vector& v)
+{
+    for (size_t j = first; j < first + count; j++)
+    {
+        blas::copy(S.column(j), u);
+        cusp::multiply(A, u, v);
+        blas::copy(v, AS.column(j));
+    }
+}
+
+// Rayleigh-Ritz projection onto S(:,0:n), where AS = A S.
+//
+// The columns of S are laid out as [X W P]: X is nev wide, W and P hold
+// the search directions of the active (unconverged) columns of X.  The
+// new X and AX are the Ritz vectors for the wanted Ritz values, and for
+// every active column q the new P(:,q) and AP(:,q) are its components
+// along [W P], normalized.  ritz_max grows to the largest Ritz value in
+// magnitude, an estimate of ||A||.  Returns -1 if S(:,0:n) is numerically
+// rank deficient.
+template <typename Matrix, typename Array, typename NormType>
+int lobpcg_rayleigh_ritz(Matrix& S, Matrix& AS, size_t n, size_t nev,
+                         bool largest, Array& lambda,
+                         const std::vector<size_t>& active,
+                         Matrix& P, Matrix& AP, NormType& ritz_max,
+                         Matrix& X_new, Matrix& AX_new)
+{
+    typedef typename Matrix::value_type ValueType;
+    typedef typename norm_type<ValueType>::type NormType;
+    typedef cusp::array2d<ValueType,cusp::host_memory> HostMatrix;
+
+    // G = S^H A S and F = S^H S
+    HostMatrix G(n, n);
+    HostMatrix F(n, n);
+
+    for (size_t j = 0; j < n; j++)
+    {
+        cusp::array1d<ValueType,cusp::host_memory> g(n);
+
+        cusp::krylov::detail::multi_dotc(S, 0, n, AS.column(j), g);
+        for (size_t i = 0; i < n; i++)
+            G(i,j) = g[i];
+
+        cusp::krylov::detail::multi_dotc(S, 0, n, S.column(j), g);
+        for (size_t i = 0; i < n; i++)
+            F(i,j) = g[i];
+    }
+
+    for (size_t i = 0; i < n; i++)
+        for (size_t j = 0; j < i; j++)
+        {
+            G(i,j) = G(j,i) = (G(i,j) + G(j,i)) / ValueType(2);
+            F(i,j) = F(j,i) = (F(i,j) + F(j,i)) / ValueType(2);
+        }
+
+    cusp::array1d<ValueType,cusp::host_memory> theta;
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> Y;
+
+    if (cusp::detail::generalized_symmetric_eigen(G, F, theta, Y) != 0)
+        return -1;
+
+    ritz_max = std::max(ritz_max, std::max(NormType(std::abs(theta[0])), NormType(std::abs(theta[n - 1]))));
+
+    // Ritz vectors for the wanted end of the spectrum
+    cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> Y_wanted(n, nev);
+    for (size_t q = 0; q < nev; q++)
+    {
+        const size_t s = largest ? n - 1 - q : q;
+
+        lambda[q] = theta[s];
+
+        for (size_t i = 0; i < n; i++)
+            Y_wanted(i,q) = Y(i,s);
+    }
+
+    cusp::krylov::detail::multi_combine(S,  n, S,  0, Y_wanted, nev, X_new);
+    cusp::krylov::detail::multi_combine(AS, n, AS, 0, Y_wanted, nev, AX_new);
+
+    // P <- [W P] Y(nev:n,active), AP <- [AW AP] Y(nev:n,active)
+    if (n > nev)
+    {
+        cusp::array1d<ValueType,cusp::host_memory> y(n - nev);
+
+        for (size_t k = 0; k < active.size(); k++)
+        {
+            const size_t q = active[k];
+
+            for (size_t i = nev; i < n; i++)
+                y[i - nev] = Y_wanted(i,q);
+
+            typename Matrix::column_view p  = P.column(q);
+            typename Matrix::column_view ap = AP.column(q);
+
+            blas::fill(p,  ValueType(0));
+            blas::fill(ap, ValueType(0));
+
+            cusp::krylov::detail::multi_axpy(S,  nev, n - nev, y, p);
+            cusp::krylov::detail::multi_axpy(AS, nev, n - nev, y, ap);
+
+            NormType p_norm = blas::nrm2(p);
+
+            if (p_norm > NormType(0))
+            {
+                blas::scal(p,  ValueType(1) / p_norm);
+                blas::scal(ap, ValueType(1) / p_norm);
+            }
+        }
+    }
+
+    // X <- X_new, AX <- AX_new
+    for (size_t q = 0; q < nev; q++)
+    {
+        blas::copy(X_new.column(q),  S.column(q));
+        blas::copy(AX_new.column(q), AS.column(q));
+    }
+
+    return 0;
+}
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Array1d,
+          class Array2d>
+size_t lobpcg(LinearOperator& A,
+              Array1d& eigenvalues,
+              Array2d& X,
+              const size_t num_eigenpairs,
+              const bool largest,
+              const size_t max_iterations,
+              const double tolerance)
+{
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+
+    cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+    return cusp::krylov::lobpcg(A, eigenvalues, X, num_eigenpairs, M, largest, max_iterations, tolerance);
+}
+
+template <class LinearOperator,
+          class Array1d,
+          class Array2d,
+          class Preconditioner>
+size_t lobpcg(LinearOperator& A,
+              Array1d& eigenvalues,
+              Array2d& X,
+              const size_t num_eigenpairs,
+              Preconditioner& M,
+              const bool largest,
+              const size_t max_iterations,
+              const double tolerance)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename norm_type<ValueType>::type   NormType;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Basis;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N   = A.num_rows;
+    const size_t nev = std::min(num_eigenpairs, N);
+
+    // S = [X W P] and AS = A S, P and AP are kept per column of X
+    Basis S(N, 3 * nev);
+    Basis AS(N, 3 * nev);
+    Basis P(N, nev);
+    Basis AP(N, nev);
+    Basis X_new(N, nev);
+    Basis AX_new(N, nev);
+
+    cusp::array1d<ValueType,MemorySpace> u(N);
+    cusp::array1d<ValueType,MemorySpace> v(N);
+
+    cusp::array1d<ValueType,cusp::host_memory> lambda(nev);
+    cusp::array1d<ValueType,cusp::host_memory> c(nev);
+
+    // initial guess, or random values in [0,1)
+    if (X.num_rows == N && X.num_cols == nev)
+    {
+        for (size_t q = 0; q < nev; q++)
+            blas::copy(X.column(q), S.column(q));
+    }
+    else
+    {
+        cusp::detail::random_reals<ValueType> random(N * nev);
+        thrust::copy(random.begin(), random.end(), S.values.begin());
+    }
+
+    cusp::krylov::detail::multi_orthonormalize(S, 0, nev);
+    cusp::krylov::detail::lobpcg_apply(A, S, AS, 0, nev, u, v);
+
+    // columns of X that have not converged yet; converged columns are
+    // locked: they stay in X but no longer contribute to W and P
+    std::vector<size_t> active;
+    std::vector<bool>   locked(nev, false);
+
+    // largest Ritz value in magnitude, an estimate of ||A||
+    NormType ritz_max = 0;
+
+    cusp::krylov::detail::lobpcg_rayleigh_ritz(S, AS, nev, nev, largest, lambda, active, P, AP, ritz_max, X_new, AX_new);
+
+    bool has_p = false;
+    size_t num_converged = 0;
+
+    for (size_t iteration = 0; ; iteration++)
+    {
+        active.clear();
+
+        // W <- A X - X Lambda for the active columns, relative to ||A||
+        // so that zero eigenvalues can converge
+        for (size_t q = 0; q < nev; q++)
+        {
+            blas::axpby(AS.column(q), S.column(q), u, ValueType(1), -lambda[q]);
+
+            if (blas::nrm2(u) <= tolerance * std::max(NormType(std::abs(lambda[q])), ritz_max))
+                locked[q] = true;
+
+            if (!locked[q])
+            {
+                blas::copy(u, S.column(nev + active.size()));
+                active.push_back(q);
+            }
+        }
+
+        const size_t num_active = active.size();
+
+        num_converged = nev - num_active;
+
+        if (num_active == 0 || iteration == max_iterations)
+            break;
+
+        for (size_t k = 0; k < num_active; k++)
+        {
+            typename Basis::column_view w = S.column(nev + k);
+
+            // W <- M*W
+            blas::copy(w, u);
+            cusp::multiply(M, u, v);
+            blas::copy(v, w);
+
+            // W <- W - X X^H W
+            cusp::krylov::detail::multi_dotc(S, 0, nev, w, c);
+            for (size_t i = 0; i < nev; i++)
+                c[i] = -c[i];
+            cusp::krylov::detail::multi_axpy(S, 0, nev, c, w);
+
+            // normalize to keep the Gram matrices well conditioned
+            NormType w_norm = blas::nrm2(w);
+            if (w_norm > NormType(0))
+                blas::scal(w, ValueType(1) / w_norm);
+        }
+
+        cusp::krylov::detail::lobpcg_apply(A, S, AS, nev, num_active, u, v);
+
+        // P of the active columns follows W
+        const size_t num_p = has_p ? num_active : 0;
+
+        for (size_t k = 0; k < num_p; k++)
+        {
+            blas::copy(P.column(active[k]),  S.column(nev + num_active + k));
+            blas::copy(AP.column(active[k]), AS.column(nev + num_active + k));
+        }
+
+        // restart without P if [X W P] lost rank
+        if (cusp::krylov::detail::lobpcg_rayleigh_ritz(S, AS, nev + num_active + num_p, nev, largest, lambda,
+                                                       active, P, AP, ritz_max, X_new, AX_new) != 0)
+        {
+            if (num_p == 0 ||
+                cusp::krylov::detail::lobpcg_rayleigh_ritz(S, AS, nev + num_active, nev, largest, lambda,
+                                                           active, P, AP, ritz_max, X_new, AX_new) != 0)
+                break;
+        }
+
+        has_p = true;
+    }
+
+    eigenvalues.resize(nev);
+    for (size_t q = 0; q < nev; q++)
+        eigenvalues[q] = lambda[q];
+
+    X.resize(N, nev);
+    for (size_t q = 0; q < nev; q++)
+        blas::copy(S.column(q), X.column(q));
+
+    return num_converged;
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
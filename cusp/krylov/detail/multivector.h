@@ -0,0 +1,245 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+#pragma once
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+
+#include <vector>
+
+/*
+ * Kernels on blocks of columns of a column-major array2d (a "multivector").
+ *
+ * Krylov methods with several basis or shadow vectors need many inner
+ * products against the same vector, or a linear combination of several
+ * columns.  On the host these are done in a single pass over the rows so
+ * that the shared vector is read once; on the device they fall back to one
+ * blas call per column.  The small coefficient arrays always live on the host.
+ */
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+////////////////
+// Host Paths //
+////////////////
+
+// result[j] = <V(:,first+j), w> for 0 <= j < count
+template <typename Matrix, typename Vector, typename Array>
+void multi_dotc(const Matrix& V, size_t first, size_t count,
+                const Vector& w, Array& result, cusp::host_memory)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  const int N = V.num_rows;
+
+  for (size_t j = 0; j < count; j++)
+    result[j] = ValueType(0);
+
+  if (N == 0 || count == 0)
+    return;
+
+  const ValueType * v_base = thrust::raw_pointer_cast(&V.values[0]) + first * V.pitch;
+  const ValueType * w_ptr  = thrust::raw_pointer_cast(&w[0]);
+  const size_t pitch = V.pitch;
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+  {
+    std::vector<ValueType> partial(count, ValueType(0));
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static) nowait
+#endif
+    for (int i = 0; i < N; i++)
+    {
+      const ValueType w_i = w_ptr[i];
+
+      for (size_t j = 0; j < count; j++)
+        partial[j] += cusp::blas::detail::conjugate<ValueType>()(v_base[j * pitch + i]) * w_i;
+    }
+
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+    for (size_t j = 0; j < count; j++)
+      result[j] += partial[j];
+  }
+}
+
+// y <- y + sum_j coeffs[j] * V(:,first+j) for 0 <= j < count
+template <typename Matrix, typename Array, typename Vector>
+void multi_axpy(const Matrix& V, size_t first, size_t count,
+                const Array& coeffs, Vector& y, cusp::host_memory)
+{
+  typedef typename Matrix::value_type ValueType;
+
+  const int N = V.num_rows;
+
+  if (N == 0 || count == 0)
+    return;
+
+  const ValueType * v_base = thrust::raw_pointer_cast(&V.values[0]) + first * V.pitch;
+  ValueType * y_ptr        = thrust::raw_pointer_cast(&y[0]);
+  const size_t pitch = V.pitch;
+
+  std::vector<ValueType> c(count);
+  for (size_t j = 0; j < count; j++)
+    c[j] = coeffs[j];
+
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+  for (int i = 0; i < N; i++)
+  {
+    ValueType sum = y_ptr[i];
+
+    for (size_t j = 0; j < count; j++)
+      sum += c[j] * v_base[j * pitch + i];
+
+    y_ptr[i] = sum;
+  }
+}
+
+//////////////////
+// Device Paths //
+//////////////////
+template <typename Matrix, typename Vector, typename Array>
+void multi_dotc(const Matrix& V, size_t first, size_t count,
+                const Vector& w, Array& result, cusp::device_memory)
+{
+  typedef typename Matrix::values_array_type::const_iterator Iterator;
+
+  for (size_t j = 0; j < count; j++)
+  {
+    Iterator begin = V.values.begin() + (first + j) * V.pitch;
+    result[j] = cusp::blas::dotc(cusp::make_array1d_view(begin, begin + V.num_rows), w);
+  }
+}
+
+template <typename Matrix, typename Array, typename Vector>
+void multi_axpy(const Matrix& V, size_t first, size_t count,
+                const Array& coeffs, Vector& y, cusp::device_memory)
+{
+  typedef typename Matrix::values_array_type::const_iterator Iterator;
+
+  for (size_t j = 0; j < count; j++)
+  {
+    Iterator begin = V.values.begin() + (first + j) * V.pitch;
+    cusp::blas::axpy(cusp::make_array1d_view(begin, begin + V.num_rows), y, coeffs[j]);
+  }
+}
+
+/////////////////
+// Entry Point //
+/////////////////
+template <typename Matrix, typename Vector, typename Array>
+void multi_dotc(const Matrix& V, size_t first, size_t count,
+                const Vector& w, Array& result)
+{
+  CUSP_PROFILE_SCOPED();
+  cusp::krylov::detail::multi_dotc(V, first, count, w, result,
+                                   typename Matrix::memory_space());
+}
+
+template <typename Matrix, typename Array, typename Vector>
+void multi_axpy(const Matrix& V, size_t first, size_t count,
+                const Array& coeffs, Vector& y)
+{
+  CUSP_PROFILE_SCOPED();
+  cusp::krylov::detail::multi_axpy(V, first, count, coeffs, y,
+                                   typename Matrix::memory_space());
+}
+
+// G(0:n1+n2, j) <- [V1(:,0:n1) V2(:,0:n2)]^H w
+//
+// fills one column of a small host Gram matrix
+template <typename Matrix1, typename Matrix2, typename Vector, typename Array2d>
+void multi_gram_column(const Matrix1& V1, size_t n1,
+                       const Matrix2& V2, size_t n2,
+                       const Vector& w, Array2d& G, size_t j)
+{
+  typedef typename Matrix1::value_type ValueType;
+
+  cusp::array1d<ValueType,cusp::host_memory> g1(n1);
+  cusp::array1d<ValueType,cusp::host_memory> g2(n2);
+
+  cusp::krylov::detail::multi_dotc(V1, 0, n1, w, g1);
+  cusp::krylov::detail::multi_dotc(V2, 0, n2, w, g2);
+
+  for (size_t i = 0; i < n1; i++) G(i,      j) = g1[i];
+  for (size_t i = 0; i < n2; i++) G(n1 + i, j) = g2[i];
+}
+
+// Out(:,j) <- [V1(:,0:n1) V2(:,0:n2)] * Y(:,j) for 0 <= j < num_cols
+//
+// Y is a small host matrix with n1 + n2 rows
+template <typename Matrix1, typename Matrix2, typename Array2d, typename Matrix3>
+void multi_combine(const Matrix1& V1, size_t n1,
+                   const Matrix2& V2, size_t n2,
+                   const Array2d& Y, size_t num_cols, Matrix3& Out)
+{
+  CUSP_PROFILE_SCOPED();
+
+  typedef typename Matrix3::value_type ValueType;
+
+  cusp::array1d<ValueType,cusp::host_memory> y1(n1);
+  cusp::array1d<ValueType,cusp::host_memory> y2(n2);
+
+  for (size_t j = 0; j < num_cols; j++)
+  {
+    for (size_t i = 0; i < n1; i++) y1[i] = Y(i,      j);
+    for (size_t i = 0; i < n2; i++) y2[i] = Y(n1 + i, j);
+
+    typename Matrix3::column_view out_j = Out.column(j);
+
+    cusp::blas::fill(out_j, ValueType(0));
+    cusp::krylov::detail::multi_axpy(V1, 0, n1, y1, out_j);
+    cusp::krylov::detail::multi_axpy(V2, 0, n2, y2, out_j);
+  }
+}
+
+// orthonormalize the columns V(:,first:first+count) in place by
+// modified Gram-Schmidt
+template <typename Matrix>
+void multi_orthonormalize(Matrix& V, size_t first, size_t count)
+{
+  CUSP_PROFILE_SCOPED();
+
+  typedef typename Matrix::value_type ValueType;
+
+  for (size_t j = first; j < first + count; j++)
+  {
+    typename Matrix::column_view v_j = V.column(j);
+
+    for (size_t i = first; i < j; i++)
+      cusp::blas::axpy(V.column(i), v_j, -cusp::blas::dotc(V.column(i), v_j));
+
+    cusp::blas::scal(v_j, ValueType(1) / cusp::blas::nrm2(v_j));
+  }
+}
+
+} // end namespace detail
+} // end namespace krylov
+} // end namespace cusp
+
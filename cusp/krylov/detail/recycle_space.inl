@@ -0,0 +1,167 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file recycle_space.inl
+ *  \brief Inline file for recycle_space.h
+ */
+
+#include <cusp/array1d.h>
+#include <cusp/blas.h>
+#include <cusp/multiply.h>
+#include <cusp/linear_operator.h>
+
+#include <cmath>
+#include <limits>
+
+namespace cusp
+{
+namespace krylov
+{
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    recycle_space<ValueType,MemorySpace>
+    ::recycle_space(size_t max_size)
+        : max_size_(max_size), size_(0)
+    {
+    }
+
+template <typename ValueType, typename MemorySpace>
+    void recycle_space<ValueType,MemorySpace>
+    ::resize(size_t num_rows)
+    {
+        if (U.num_rows == num_rows && U.num_cols == max_size_)
+            return;
+
+        U.resize(num_rows, max_size_);
+        C.resize(num_rows, max_size_);
+        size_ = 0;
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template <typename LinearOperator>
+    void recycle_space<ValueType,MemorySpace>
+    ::update(LinearOperator& A)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        cusp::identity_operator<ValueType,MemorySpace> M(A.num_rows, A.num_cols);
+
+        update(A, M);
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template <typename LinearOperator, typename Preconditioner>
+    void recycle_space<ValueType,MemorySpace>
+    ::update(LinearOperator& A, Preconditioner& M)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        resize(A.num_rows);
+
+        cusp::array1d<ValueType,MemorySpace> u(A.num_rows);
+        cusp::array1d<ValueType,MemorySpace> t(A.num_rows);
+        cusp::array1d<ValueType,MemorySpace> c(A.num_rows);
+
+        for (size_t j = 0; j < size_; j++)
+        {
+            typename basis_type::column_view c_j = C.column(j);
+
+            // C(j) <- M*A*U(j)
+            cusp::blas::copy(U.column(j), u);
+            cusp::multiply(A, u, t);
+            cusp::multiply(M, t, c);
+            cusp::blas::copy(c, c_j);
+        }
+
+        orthonormalize();
+    }
+
+template <typename ValueType, typename MemorySpace>
+    void recycle_space<ValueType,MemorySpace>
+    ::assign(basis_type& U_new, basis_type& C_new, size_t num_vectors)
+    {
+        U.swap(U_new);
+        C.swap(C_new);
+        size_ = num_vectors;
+
+        orthonormalize();
+    }
+
+template <typename ValueType, typename MemorySpace>
+    void recycle_space<ValueType,MemorySpace>
+    ::orthonormalize(void)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        typedef typename norm_type<ValueType>::type NormType;
+
+        // columns whose norm drops below this fraction of their original
+        // norm are numerically dependent on the previous ones
+        const NormType tolerance = std::numeric_limits<NormType>::epsilon() * std::sqrt(NormType(C.num_rows));
+
+        size_t k = 0;
+
+        for (size_t j = 0; j < size_; j++)
+        {
+            typename basis_type::column_view u_j = U.column(j);
+            typename basis_type::column_view c_j = C.column(j);
+
+            const NormType nrm_before = cusp::blas::nrm2(c_j);
+
+            NormType nrm = nrm_before;
+
+            // a second pass restores orthogonality lost to cancellation
+            for (size_t pass = 0; pass < 2 && nrm > NormType(0); pass++)
+            {
+                for (size_t i = 0; i < k; i++)
+                {
+                    ValueType h = cusp::blas::dotc(C.column(i), c_j);
+
+                    cusp::blas::axpy(C.column(i), c_j, -h);
+                    cusp::blas::axpy(U.column(i), u_j, -h);
+                }
+
+                const NormType nrm_pass = nrm;
+
+                nrm = cusp::blas::nrm2(c_j);
+
+                if (nrm > NormType(0.5) * nrm_pass)
+                    break;
+            }
+
+            // drop columns that lie in the span of the previous ones
+            if (nrm <= tolerance * nrm_before)
+                continue;
+
+            cusp::blas::scal(c_j, ValueType(1) / nrm);
+            cusp::blas::scal(u_j, ValueType(1) / nrm);
+
+            if (k != j)
+            {
+                cusp::blas::copy(c_j, C.column(k));
+                cusp::blas::copy(u_j, U.column(k));
+            }
+
+            k++;
+        }
+
+        size_ = k;
+    }
+
+} // end namespace krylov
+} // end namespace cusp
+
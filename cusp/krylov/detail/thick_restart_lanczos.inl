@@ -0,0 +1,220 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/copy.h>
+#include <cusp/multiply.h>
+
+#include <cusp/detail/random.h>
+#include <cusp/detail/symmetric_eigen.h>
+#include <cusp/krylov/detail/multivector.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace blas = cusp::blas;
+
+namespace cusp
+{
+namespace krylov
+{
+namespace detail
+{
+
+// w <- w - V(:,0:n) c, c = V(:,0:n)^H w, returning c
+template <typename Matrix, typename Vector, typename Array>
+void lanczos_orthogonalize(const Matrix& V, size_t n, Vector& w, Array& c)
+{
+    cusp::krylov::detail::multi_dotc(V, 0, n, w, c);
+
+    Array minus_c(c);
+    for (size_t i = 0; i < n; i++)
+        minus_c[i] = -c[i];
+
+    cusp::krylov::detail::multi_axpy(V, 0, n, minus_c, w);
+}
+
+} // end namespace detail
+
+template <class LinearOperator,
+          class Array1d,
+          class Array2d>
+size_t thick_restart_lanczos(LinearOperator& A,
+                             Array1d& eigenvalues,
+                             Array2d& eigenvectors,
+                             const size_t num_eigenpairs,
+                             const bool largest,
+                             const size_t basis_size,
+                             const size_t max_restarts,
+                             const double tolerance)
+{
+    CUSP_PROFILE_SCOPED();
+
+    typedef typename LinearOperator::value_type   ValueType;
+    typedef typename LinearOperator::memory_space MemorySpace;
+    typedef typename norm_type<ValueType>::type   NormType;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> Basis;
+    typedef cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> HostMatrix;
+
+    assert(A.num_rows == A.num_cols);        // sanity check
+
+    const size_t N   = A.num_rows;
+    const size_t nev = std::min(num_eigenpairs, N);
+
+    // number of Lanczos vectors between restarts
+    size_t m = basis_size > 0 ? basis_size : std::max(2 * nev, nev + 20);
+    m = std::min(std::max(m, nev + 1), N);
+
+    // reorthogonalize again when more than this fraction of w cancels
+    const NormType eta = NormType(0.7071);
+
+    // allocate workspace
+    Basis V(N, m + 1);
+    cusp::array1d<ValueType,MemorySpace> v(N);
+    cusp::array1d<ValueType,MemorySpace> w(N);
+
+    // host workspace
+    HostMatrix T(m, m, ValueType(0));
+    cusp::array1d<ValueType,cusp::host_memory> c(m);
+
+    // initialize starting vector to random values in [0,1)
+    cusp::copy(cusp::detail::random_reals<ValueType>(N), v);
+    blas::scal(v, ValueType(1) / blas::nrm2(v));
+    blas::copy(v, V.column(0));
+
+    size_t k = 0;
+
+    for (size_t restart = 0; ; restart++)
+    {
+        size_t m_cur = m;
+        NormType beta = 0;
+
+        // extend the basis from k to m vectors
+        for (size_t j = k; j < m; j++)
+        {
+            // w <- A*V(j)
+            blas::copy(V.column(j), v);
+            cusp::multiply(A, v, w);
+
+            NormType w_norm = blas::nrm2(w);
+
+            // orthogonalize against V(0:j+1); the coefficients against
+            // V(j) and the previous vectors are the entries of T
+            c.resize(j + 1);
+            cusp::krylov::detail::lanczos_orthogonalize(V, j + 1, w, c);
+            T(j,j) = c[j];
+
+            beta = blas::nrm2(w);
+
+            if (beta < eta * w_norm)
+            {
+                cusp::krylov::detail::lanczos_orthogonalize(V, j + 1, w, c);
+                T(j,j) += c[j];
+
+                beta = blas::nrm2(w);
+            }
+
+            // the basis spans an invariant subspace
+            if (beta <= std::numeric_limits<NormType>::epsilon() * w_norm)
+            {
+                beta  = 0;
+                m_cur = j + 1;
+                break;
+            }
+
+            blas::scal(w, ValueType(1) / beta);
+            blas::copy(w, V.column(j + 1));
+
+            if (j + 1 < m)
+                T(j + 1, j) = T(j, j + 1) = beta;
+        }
+
+        // Ritz pairs of the projected matrix
+        HostMatrix S(m_cur, m_cur);
+        for (size_t i = 0; i < m_cur; i++)
+            for (size_t j = 0; j < m_cur; j++)
+                S(i,j) = T(i,j);
+
+        cusp::array1d<ValueType,cusp::host_memory> theta;
+        HostMatrix Y;
+        cusp::detail::symmetric_eigen(S, theta, Y);
+
+        // Ritz pairs ordered from the wanted end of the spectrum
+        const size_t num_wanted = std::min(nev, m_cur);
+        cusp::array1d<size_t,cusp::host_memory> order(m_cur);
+        for (size_t i = 0; i < m_cur; i++)
+            order[i] = largest ? m_cur - 1 - i : i;
+
+        // the residual norm of Ritz pair i is |beta * Y(m-1,i)|
+        size_t num_converged = 0;
+        for (size_t i = 0; i < num_wanted; i++)
+        {
+            NormType residual = std::abs(beta * Y(m_cur - 1, order[i]));
+
+            if (residual <= tolerance * std::abs(theta[order[i]]))
+                num_converged++;
+        }
+
+        const bool done = num_converged == num_wanted || beta == NormType(0) || restart == max_restarts;
+
+        // thick restart keeps the wanted Ritz vectors and half of the rest
+        const size_t num_kept = done ? num_wanted : std::min(nev + (m_cur - nev) / 2, m_cur - 1);
+
+        HostMatrix Y_kept(m_cur, num_kept);
+        for (size_t i = 0; i < m_cur; i++)
+            for (size_t j = 0; j < num_kept; j++)
+                Y_kept(i,j) = Y(i, order[j]);
+
+        if (done)
+        {
+            eigenvalues.resize(num_wanted);
+            for (size_t i = 0; i < num_wanted; i++)
+                eigenvalues[i] = theta[order[i]];
+
+            eigenvectors.resize(N, num_wanted);
+            cusp::krylov::detail::multi_combine(V, m_cur, V, 0, Y_kept, num_wanted, eigenvectors);
+
+            return num_converged;
+        }
+
+        // V(0:k) <- Ritz vectors, V(k) <- last Lanczos vector
+        Basis V_kept(N, num_kept);
+        cusp::krylov::detail::multi_combine(V, m_cur, V, 0, Y_kept, num_kept, V_kept);
+
+        for (size_t j = 0; j < num_kept; j++)
+            blas::copy(V_kept.column(j), V.column(j));
+        blas::copy(V.column(m_cur), V.column(num_kept));
+
+        // T becomes an arrowhead matrix: Ritz values on the diagonal
+        // coupled to the new Lanczos vector by beta * Y(m-1,:)
+        blas::fill(T.values, ValueType(0));
+        for (size_t j = 0; j < num_kept; j++)
+        {
+            T(j,j) = theta[order[j]];
+            T(j, num_kept) = T(num_kept, j) = beta * Y(m_cur - 1, order[j]);
+        }
+
+        k = num_kept;
+    }
+}
+
+} // end namespace krylov
+} // end namespace cusp
+
@@ -0,0 +1,168 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file gcrodr.h
+ *  \brief GCRO with deflated restarting (GCRO-DR) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/krylov/recycle_space.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p gcrodr : GCRO-DR method
+ *
+ * Solves the nonsymmetric, linear system A x = b
+ * using the default convergence criteria.
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space);
+
+/*! \p gcrodr : GCRO-DR method
+ *
+ * Solves the nonsymmetric, linear system A x = b without preconditioning.
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space,
+            Monitor& monitor);
+
+/*! \p gcrodr : GCRO-DR method
+ *
+ * Solves the nonsymmetric, linear system A x = b with preconditioner
+ * \p M, recycling the subspace held in \p space.
+ *
+ * Each cycle minimizes the residual over the recycled subspace \c U
+ * together with <tt>restart - space.size()</tt> new Arnoldi vectors
+ * orthogonal to <tt>C = M A U</tt>.  At the end of every cycle \p space
+ * is replaced by the vectors of the search space along which
+ * <tt>M A</tt> is smallest, which are kept for the following cycles
+ * and the following solves.  With an empty \p space the first cycle
+ * is an ordinary \p gmres cycle.
+ *
+ * \param A matrix of the linear system
+ * \param x approximate solution of the linear system
+ * \param b right-hand side of the linear system
+ * \param restart the method every restart inner iterations
+ * \param space recycled subspace, updated on return
+ * \param monitor montiors iteration and determines stopping conditions
+ * \param M preconditioner for A
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Vector vector
+ * \tparam RecycleSpace is a \p recycle_space
+ * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \note <tt>space.max_size()</tt> must be smaller than \p restart, and
+ * <tt>space.C</tt> must equal <tt>M A space.U</tt>; call
+ * <tt>space.update(A, M)</tt> whenever \p A or \p M changes.
+ *
+ * \note Complex value types are not supported: the harmonic Ritz
+ * vectors are computed with a real symmetric eigensolver.
+ *
+ *  The following code snippet demonstrates how to use \p gcrodr to
+ *  solve a sequence of 10x10 Poisson problems.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/monitor.h>
+ *  #include <cusp/krylov/gcrodr.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 10, 10);
+ *
+ *      // recycle 10 vectors between cycles and solves
+ *      cusp::krylov::recycle_space<float, cusp::device_memory> space(10);
+ *      int restart = 30;
+ *
+ *      for (int i = 0; i < 4; i++)
+ *      {
+ *          // allocate storage for solution (x) and right hand side (b)
+ *          cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *          cusp::array1d<float, cusp::device_memory> b(A.num_rows, i + 1);
+ *
+ *          // set stopping criteria:
+ *          //  iteration_limit    = 100
+ *          //  relative_tolerance = 1e-6
+ *          cusp::verbose_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *          // set preconditioner (identity)
+ *          cusp::identity_operator<float, cusp::device_memory> M(A.num_rows, A.num_rows);
+ *
+ *          // solve the linear system A x = b
+ *          cusp::krylov::gcrodr(A, x, b, restart, space, monitor, M);
+ *      }
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+
+ *  \see \p recycle_space
+ *  \see \p default_monitor
+ *  \see \p verbose_monitor
+ *
+ */
+template <class LinearOperator,
+          class Vector,
+          class RecycleSpace,
+          class Monitor,
+          class Preconditioner>
+void gcrodr(LinearOperator& A,
+            Vector& x,
+            Vector& b,
+            const size_t restart,
+            RecycleSpace& space,
+            Monitor& monitor,
+            Preconditioner& M);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/gcrodr.inl>
+
@@ -22,6 +22,11 @@
 
 #include <cusp/detail/config.h>
 
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/krylov/checkpoint.h>
+
 namespace cusp
 {
    namespace krylov
@@ -125,6 +130,141 @@ namespace cusp
                         const size_t restart,
                         Monitor& monitor,
                         Preconditioner& M);
+
+      /*! \p gmres : GMRES method with checkpointing
+       *
+       * Solves the nonsymmetric, linear system A x = b with
+       * preconditioner \p M and writes a snapshot of the solver state,
+       * including the Arnoldi basis and Hessenberg matrix of the current
+       * cycle, to \p ckpt every <tt>ckpt.interval()</tt> iterations.
+       *
+       * \see \p checkpoint
+       * \see \p gmres_resume
+       */
+      template <class LinearOperator,
+                class Vector,
+                class Monitor,
+                class Preconditioner>
+      void gmres(LinearOperator& A,
+                 Vector& x,
+                 Vector& b,
+                 const size_t restart,
+                 Monitor& monitor,
+                 Preconditioner& M,
+                 checkpoint& ckpt);
+
+      /*! \p gmres_resume : resume a checkpointed GMRES solve
+       *
+       * Restores \p x, the solver state and the iteration count of
+       * \p monitor from the snapshot in \p ckpt and continues the
+       * solve.  \p A, \p b, \p restart and \p M must be those of the
+       * interrupted solve.
+       *
+       * \throws cusp::io_exception if \p ckpt does not hold a \p gmres
+       *         snapshot of a system of this size and restart length
+       *
+       * \see \p checkpoint
+       */
+      template <class LinearOperator,
+                class Vector,
+                class Monitor,
+                class Preconditioner>
+      void gmres_resume(LinearOperator& A,
+                        Vector& x,
+                        Vector& b,
+                        const size_t restart,
+                        Monitor& monitor,
+                        Preconditioner& M,
+                        checkpoint& ckpt);
+
+      /*! \p gmres_solver : resumable GMRES method
+       *
+       * Holds the complete state of a restarted, preconditioned \p gmres
+       * solve, so the solve can advance one Arnoldi iteration at a time.
+       * The constructor computes the initial residual; each call to
+       * \p step performs one inner iteration and, at the end of a cycle,
+       * the solution update and restart.  The iterates are the same as
+       * those of \p gmres.
+       *
+       * The solver keeps pointers to \p A, \p x, \p b, \p monitor and
+       * \p M, which must outlive it.
+       *
+       * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+       * \tparam Vector vector
+       * \tparam Monitor is a monitor such as \p default_monitor or \p verbose_monitor
+       * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+       *
+       *  \see \p cg_solver
+       */
+      template <class LinearOperator,
+                class Vector,
+                class Monitor,
+                class Preconditioner>
+      class gmres_solver
+      {
+          typedef typename LinearOperator::value_type   ValueType;
+          typedef typename LinearOperator::memory_space MemorySpace;
+          typedef typename norm_type<ValueType>::type   NormType;
+
+      public:
+          /*! set up the solve of A x = b and test the initial residual
+           */
+          gmres_solver(LinearOperator& A,
+                       Vector& x,
+                       Vector& b,
+                       const size_t restart,
+                       Monitor& monitor,
+                       Preconditioner& M);
+
+          /*! restore the state of an interrupted solve from \p ckpt
+           */
+          gmres_solver(LinearOperator& A,
+                       Vector& x,
+                       Vector& b,
+                       const size_t restart,
+                       Monitor& monitor,
+                       Preconditioner& M,
+                       checkpoint& ckpt);
+
+          /*! perform one inner iteration, unless the solve is done
+           */
+          void step(void);
+
+          /*! write a snapshot of the current state to \p ckpt
+           */
+          void save(checkpoint& ckpt) const;
+
+          /*! whether the monitor has stopped the iteration
+           */
+          bool done(void) const { return done_; }
+
+      protected:
+          // compute the residual and start a new Arnoldi cycle
+          void start_cycle(void);
+
+          // solve the least squares problem and update x
+          void end_cycle(void);
+
+          LinearOperator * A;
+          Vector         * x;
+          Vector         * b;
+          Monitor        * monitor;
+          Preconditioner * M;
+
+          int R;
+          int i;
+
+          cusp::array1d<NormType,cusp::host_memory> resid;
+          cusp::array1d<ValueType,MemorySpace> w;
+          cusp::array1d<ValueType,MemorySpace> V0;
+          cusp::array2d<ValueType,MemorySpace,cusp::column_major> V;
+          cusp::array2d<ValueType,cusp::host_memory,cusp::column_major> H;
+          cusp::array1d<ValueType,cusp::host_memory> s;
+          cusp::array1d<ValueType,cusp::host_memory> cs;
+          cusp::array1d<ValueType,cusp::host_memory> sn;
+
+          bool done_;
+      };
       /*! \}
       */
 
@@ -0,0 +1,144 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file lobpcg.h
+ *  \brief Locally Optimal Block Preconditioned Conjugate Gradient (LOBPCG) method
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p lobpcg : LOBPCG method
+ *
+ * Computes the \p num_eigenpairs smallest (or largest) eigenpairs of the
+ * symmetric operator \p A without preconditioning.
+ */
+template <class LinearOperator,
+          class Array1d,
+          class Array2d>
+size_t lobpcg(LinearOperator& A,
+              Array1d& eigenvalues,
+              Array2d& X,
+              const size_t num_eigenpairs,
+              const bool largest = false,
+              const size_t max_iterations = 500,
+              const double tolerance = 1e-5);
+
+/*! \p lobpcg : LOBPCG method
+ *
+ * Computes the \p num_eigenpairs smallest (or largest) eigenvalues and
+ * corresponding eigenvectors of the symmetric operator \p A with
+ * preconditioner \p M.
+ *
+ * Every iteration performs a Rayleigh-Ritz projection onto the block
+ * <tt>[X, W, P]</tt> of current eigenvector approximations, the
+ * preconditioned residuals <tt>W = M (A X - X Lambda)</tt> and the
+ * previous search directions.  All inner products of the projection are
+ * formed with fused multivector kernels, so the block is read once per
+ * column of the Gram matrices rather than once per entry.
+ *
+ * An eigenpair <tt>(lambda, x)</tt> is accepted when
+ * <tt>||A x - lambda x|| <= tolerance * max(|lambda|, ||A||)</tt>, where
+ * <tt>||A||</tt> is estimated by the largest Ritz value seen so far, so
+ * zero eigenvalues converge too.  Accepted columns are locked: they stay
+ * in \p X but their residuals and search directions leave the block.
+ *
+ * \param A symmetric matrix or linear operator
+ * \param eigenvalues computed eigenvalues, ordered from the wanted end
+ * \param X <tt>A.num_rows x num_eigenpairs</tt> column-major \p array2d
+ *        of eigenvectors; used as the initial guess if it already has
+ *        this shape, otherwise started from random vectors
+ * \param num_eigenpairs number of eigenpairs to compute
+ * \param M symmetric positive-definite preconditioner, e.g. \p smoothed_aggregation
+ * \param largest compute the largest instead of the smallest eigenvalues
+ * \param max_iterations maximum number of iterations
+ * \param tolerance relative residual tolerance
+ * \return number of eigenpairs that satisfy the tolerance
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Array1d vector
+ * \tparam Array2d column-major \p array2d
+ * \tparam Preconditioner is a matrix or subclass of \p linear_operator
+ *
+ * \note <tt>3 num_eigenpairs</tt> should be well below the size of \p A.
+ * Only real value types are supported.
+ *
+ *  The following code snippet demonstrates how to use \p lobpcg to
+ *  compute the 4 smallest eigenpairs of a 2d Poisson problem with
+ *  a smoothed aggregation preconditioner.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/krylov/lobpcg.h>
+ *  #include <cusp/precond/smoothed_aggregation.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      // setup preconditioner
+ *      cusp::precond::smoothed_aggregation<int, float, cusp::device_memory> M(A);
+ *
+ *      // allocate storage for the eigenpairs
+ *      cusp::array1d<float, cusp::host_memory> S;
+ *      cusp::array2d<float, cusp::device_memory, cusp::column_major> X;
+ *
+ *      // compute the 4 smallest eigenpairs
+ *      cusp::krylov::lobpcg(A, S, X, 4, M);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p thick_restart_lanczos
+ */
+template <class LinearOperator,
+          class Array1d,
+          class Array2d,
+          class Preconditioner>
+size_t lobpcg(LinearOperator& A,
+              Array1d& eigenvalues,
+              Array2d& X,
+              const size_t num_eigenpairs,
+              Preconditioner& M,
+              const bool largest = false,
+              const size_t max_iterations = 500,
+              const double tolerance = 1e-5);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/lobpcg.inl>
+
@@ -0,0 +1,155 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file recycle_space.h
+ *  \brief Recycled Krylov subspace shared by a sequence of solves
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array2d.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p recycle_space : subspace recycled between Krylov solves
+ *
+ *  Sequences of slowly changing linear systems, such as the Jacobians
+ *  of a Newton iteration, tend to share the eigenmodes that make a
+ *  Krylov method converge slowly.  A \p recycle_space keeps a basis \c U
+ *  of (approximations to) those modes together with its image
+ *  <tt>C = A U</tt>, with orthonormal columns, so that the next solve can
+ *  project them out from the start instead of rediscovering them.
+ *
+ *  The same object is passed from solve to solve.  Each solve refines
+ *  \c U from the Krylov subspace it builds.  When the matrix changes,
+ *  call \p update with the new matrix before the next solve; this costs
+ *  one matrix-vector product per recycled vector plus a small
+ *  orthogonalization.  The operator must be the one the solver deflates:
+ *  \c A for \p deflated_cg and <tt>M A</tt> for \p gcrodr with
+ *  preconditioner \c M.
+ *
+ *  \tparam ValueType Type used for vector values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  The following code snippet demonstrates how to use a
+ *  \p recycle_space in a sequence of solves.
+ *
+ *  \code
+ *  #include <cusp/krylov/deflated_cg.h>
+ *  ...
+ *
+ *  // recycle 8 vectors between solves
+ *  cusp::krylov::recycle_space<float, cusp::device_memory> space(8);
+ *
+ *  for (int step = 0; step < num_steps; step++)
+ *  {
+ *      // assemble the new matrix A and right hand side b
+ *      ...
+ *
+ *      // refresh C = A U for the new matrix
+ *      space.update(A);
+ *
+ *      cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *      cusp::krylov::deflated_cg(A, x, b, space, monitor);
+ *  }
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class recycle_space
+{
+public:
+    typedef ValueType   value_type;
+    typedef MemorySpace memory_space;
+    typedef cusp::array2d<ValueType,MemorySpace,cusp::column_major> basis_type;
+
+    /*! recycled basis, only the first \p size() columns are used */
+    basis_type U;
+
+    /*! image of \p U under the operator, with orthonormal columns */
+    basis_type C;
+
+    /*! construct an empty \p recycle_space
+     *
+     * \param max_size number of vectors to recycle
+     */
+    recycle_space(size_t max_size);
+
+    /*! number of vectors the space may hold */
+    size_t max_size(void) const { return max_size_; }
+
+    /*! number of vectors currently held */
+    size_t size(void) const { return size_; }
+
+    /*! whether the space holds no vectors */
+    bool empty(void) const { return size_ == 0; }
+
+    /*! discard all vectors */
+    void clear(void) { size_ = 0; }
+
+    /*! allocate storage for vectors of length \p num_rows, discarding
+     *  the current vectors if their length differs
+     */
+    void resize(size_t num_rows);
+
+    /*! recompute <tt>C = A U</tt> after the matrix has changed
+     *
+     * \param A new matrix
+     */
+    template <typename LinearOperator>
+    void update(LinearOperator& A);
+
+    /*! recompute <tt>C = M A U</tt> after the matrix has changed
+     *
+     * \param A new matrix
+     * \param M preconditioner
+     */
+    template <typename LinearOperator, typename Preconditioner>
+    void update(LinearOperator& A, Preconditioner& M);
+
+    /*! replace the space with the first \p num_vectors columns of
+     *  \p U_new and <tt>C_new = A U_new</tt>.  Both arrays are
+     *  swapped in, and \c C is orthonormalized.
+     */
+    void assign(basis_type& U_new, basis_type& C_new, size_t num_vectors);
+
+private:
+    // orthonormalize C by modified Gram-Schmidt, applying the same
+    // column operations to U so that C = A U still holds; numerically
+    // dependent columns are dropped
+    void orthonormalize(void);
+
+    size_t max_size_;
+    size_t size_;
+};
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/recycle_space.inl>
+
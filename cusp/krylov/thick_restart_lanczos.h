@@ -0,0 +1,121 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file thick_restart_lanczos.h
+ *  \brief Thick-restart Lanczos method for extremal eigenpairs
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+namespace cusp
+{
+namespace krylov
+{
+
+/*! \addtogroup iterative_solvers Iterative Solvers
+ *  \addtogroup krylov_methods Krylov Methods
+ *  \ingroup iterative_solvers
+ *  \{
+ */
+
+/*! \p thick_restart_lanczos : Thick-restart Lanczos method
+ *
+ * Computes the \p num_eigenpairs smallest (or largest) eigenvalues and
+ * corresponding eigenvectors of the symmetric operator \p A.
+ *
+ * The Lanczos basis holds at most \p basis_size vectors.  When it is
+ * full, the method keeps the wanted Ritz vectors plus half of the
+ * remaining ones and continues from the last Lanczos vector, so the
+ * Ritz vectors that have already converged are not recomputed.  Each
+ * new Lanczos vector is orthogonalized against the whole basis with one
+ * fused multivector pass, and a second pass is made only when the
+ * first one cancels most of the vector, so the basis stays orthogonal
+ * without paying for systematic double orthogonalization.
+ *
+ * A Ritz pair <tt>(theta, y)</tt> is accepted when
+ * <tt>||A y - theta y|| <= tolerance * |theta|</tt>.
+ *
+ * \param A symmetric matrix or linear operator
+ * \param eigenvalues computed eigenvalues, ordered from the wanted end
+ * \param eigenvectors <tt>A.num_rows x num_eigenpairs</tt> column-major
+ *        \p array2d of orthonormal eigenvectors
+ * \param num_eigenpairs number of eigenpairs to compute
+ * \param largest compute the largest instead of the smallest eigenvalues
+ * \param basis_size maximum number of Lanczos vectors; 0 selects
+ *        <tt>max(2 num_eigenpairs, num_eigenpairs + 20)</tt>
+ * \param max_restarts maximum number of restarts
+ * \param tolerance relative residual tolerance
+ * \return number of eigenpairs that satisfy the tolerance
+ *
+ * \tparam LinearOperator is a matrix or subclass of \p linear_operator
+ * \tparam Array1d vector
+ * \tparam Array2d column-major \p array2d
+ *
+ * \note A single Lanczos sequence finds one eigenvector per eigenspace,
+ * so of a multiple eigenvalue only one copy is returned; use \p lobpcg
+ * when multiplicities matter.  Only real value types are supported.
+ *
+ *  The following code snippet demonstrates how to use
+ *  \p thick_restart_lanczos to compute the 4 smallest eigenpairs of a
+ *  2d Poisson problem.
+ *
+ *  \code
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/krylov/thick_restart_lanczos.h>
+ *  #include <cusp/gallery/poisson.h>
+ *
+ *  int main(void)
+ *  {
+ *      // create an empty sparse matrix structure (CSR format)
+ *      cusp::csr_matrix<int, float, cusp::device_memory> A;
+ *
+ *      // initialize matrix
+ *      cusp::gallery::poisson5pt(A, 100, 100);
+ *
+ *      // allocate storage for the eigenpairs
+ *      cusp::array1d<float, cusp::host_memory> S;
+ *      cusp::array2d<float, cusp::device_memory, cusp::column_major> X;
+ *
+ *      // compute the 4 smallest eigenpairs
+ *      cusp::krylov::thick_restart_lanczos(A, S, X, 4);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ *
+ *  \see \p lobpcg
+ */
+template <class LinearOperator,
+          class Array1d,
+          class Array2d>
+size_t thick_restart_lanczos(LinearOperator& A,
+                             Array1d& eigenvalues,
+                             Array2d& eigenvectors,
+                             const size_t num_eigenpairs,
+                             const bool largest = false,
+                             const size_t basis_size = 0,
+                             const size_t max_restarts = 100,
+                             const double tolerance = 1e-5);
+/*! \}
+ */
+
+} // end namespace krylov
+} // end namespace cusp
+
+#include <cusp/krylov/detail/thick_restart_lanczos.inl>
+
@@ -119,6 +119,7 @@ class default_monitor
           r_norm(std::numeric_limits<Real>::max()),
           iteration_limit_(iteration_limit),
           iteration_count_(0),
+          check_interval_(1),
           relative_tolerance_(relative_tolerance),
           absolute_tolerance_(absolute_tolerance)
     {}
@@ -128,6 +129,9 @@ class default_monitor
     void operator++(void) {  ++iteration_count_; } // prefix increment
 
     /*! applies convergence criteria to determine whether iteration is finished
+     *
+     *  When a check interval \p k > 1 is set, the residual norm is only
+     *  computed on every k-th iteration and on the last allowed iteration.
      *
      *  \param r residual vector of the linear system (r = b - A x)
      *  \tparam Vector vector
@@ -135,10 +139,29 @@ class default_monitor
     template <typename Vector>
     bool finished(const Vector& r)
     {
+        if (skip_check())
+            return false;
+
         r_norm = cusp::blas::nrm2(r);
         
         return converged() || iteration_count() >= iteration_limit();
     }
+
+    /*! applies convergence criteria using a residual norm that the
+     *  solver has already computed, e.g. from an inner product it needs
+     *  anyway or from the Givens rotations in GMRES.
+     *
+     *  \param r residual vector of the linear system (r = b - A x)
+     *  \param residual_norm Euclidean norm of \p r
+     *  \tparam Vector vector
+     */
+    template <typename Vector>
+    bool finished(const Vector& r, Real residual_norm)
+    {
+        r_norm = residual_norm;
+        
+        return converged() || iteration_count() >= iteration_limit();
+    }
    
     /*! whether the last tested residual satifies the convergence tolerance
      */
@@ -155,10 +178,27 @@ class default_monitor
      */
     size_t iteration_count() const { return iteration_count_; }
 
+    /*! set the number of iterations, e.g. when a solve is resumed
+     *  from a checkpoint
+     */
+    void set_iteration_count(size_t k) { iteration_count_ = k; }
+
     /*! maximum number of iterations
      */
     size_t iteration_limit() const { return iteration_limit_; }
 
+    /*! number of iterations between residual norm computations
+     */
+    size_t check_interval() const { return check_interval_; }
+
+    /*! compute the residual norm only every \p k iterations
+     *
+     *  Useful when computing the residual norm is expensive relative to
+     *  an iteration.  The solver may run up to k - 1 iterations past
+     *  convergence.
+     */
+    void set_check_interval(size_t k) { check_interval_ = k > 0 ? k : 1; }
+
     /*! relative tolerance
      */
     Real relative_tolerance() const { return relative_tolerance_; }
@@ -175,6 +215,13 @@ class default_monitor
     Real tolerance() const { return absolute_tolerance() + relative_tolerance() * b_norm; }
 
     protected:
+
+    // whether this iteration falls between two scheduled checks
+    bool skip_check() const
+    {
+        return iteration_count() % check_interval() != 0 &&
+               iteration_count() < iteration_limit();
+    }
     
     Real r_norm;
     Real b_norm;
@@ -183,6 +230,7 @@ class default_monitor
 
     size_t iteration_limit_;
     size_t iteration_count_;
+    size_t check_interval_;
 };
 
 /*! \p verbose_monitor is similar to \p default monitor except that
@@ -227,7 +275,16 @@ class verbose_monitor : public default_monitor<ValueType>
     template <typename Vector>
     bool finished(const Vector& r)
     {
-        super::r_norm = cusp::blas::nrm2(r);
+        if (super::skip_check())
+            return false;
+
+        return finished(r, cusp::blas::nrm2(r));
+    }
+    
+    template <typename Vector>
+    bool finished(const Vector& r, Real residual_norm)
+    {
+        super::r_norm = residual_norm;
 
         std::cout << "       "  << std::setw(10) << super::iteration_count();
         std::cout << "       "  << std::setw(10) << std::scientific << super::residual_norm() << std::endl;
@@ -294,7 +351,16 @@ class convergence_monitor : public default_monitor<ValueType>
     template <typename Vector>
     bool finished(const Vector& r)
     {
-        super::r_norm = cusp::blas::nrm2(r);
+        if (super::skip_check())
+            return false;
+
+        return finished(r, cusp::blas::nrm2(r));
+    }
+    
+    template <typename Vector>
+    bool finished(const Vector& r, Real residual_norm)
+    {
+        super::r_norm = residual_norm;
 	residuals.push_back(super::r_norm);
 
         return super::converged() || super::iteration_count() >= super::iteration_limit();
@@ -339,5 +405,36 @@ class convergence_monitor : public default_monitor<ValueType>
 /*! \}
  */
 
+namespace detail
+{
+
+// Solvers that already have ||r|| pass it on to the monitors of cusp;
+// other monitors only need to implement finished(r).
+template <typename Monitor, typename Vector, typename Real>
+bool monitor_finished(Monitor& monitor, const Vector& r, Real residual_norm)
+{
+    return monitor.finished(r);
+}
+
+template <typename ValueType, typename Vector, typename Real>
+bool monitor_finished(cusp::default_monitor<ValueType>& monitor, const Vector& r, Real residual_norm)
+{
+    return monitor.finished(r, residual_norm);
+}
+
+template <typename ValueType, typename Vector, typename Real>
+bool monitor_finished(cusp::verbose_monitor<ValueType>& monitor, const Vector& r, Real residual_norm)
+{
+    return monitor.finished(r, residual_norm);
+}
+
+template <typename ValueType, typename Vector, typename Real>
+bool monitor_finished(cusp::convergence_monitor<ValueType>& monitor, const Vector& r, Real residual_norm)
+{
+    return monitor.finished(r, residual_norm);
+}
+
+} // end namespace detail
+
 } // end namespace cusp
 
@@ -0,0 +1,200 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file additive_schwarz.h
+ *  \brief Additive Schwarz domain decomposition preconditioner.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+#include <vector>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! solvers for the subdomain problems of \p additive_schwarz
+ */
+enum schwarz_local_solver
+{
+    /*! incomplete LU factorization with zero fill-in, \p ilu0 */
+    schwarz_ilu0,
+
+    /*! one V-cycle of a \p smoothed_aggregation hierarchy */
+    schwarz_smoothed_aggregation,
+
+    /*! exact dense LU factorization, for small subdomains */
+    schwarz_dense_lu
+};
+
+namespace detail
+{
+
+// interface to the solver of one subdomain
+template <typename ValueType>
+class schwarz_solver_base
+{
+public:
+    virtual ~schwarz_solver_base() {}
+
+    virtual void solve(const cusp::array1d<ValueType, cusp::host_memory>& b,
+                             cusp::array1d<ValueType, cusp::host_memory>& x) = 0;
+};
+
+} // end namespace detail
+
+/*! \p additive_schwarz : additive Schwarz preconditioner
+ *
+ *  Partitions the unknowns into contiguous subdomains, one per thread
+ *  by default, and extends every subdomain by \c overlap layers of
+ *  neighbours in the graph of \c A.  Setup extracts the diagonal
+ *  submatrix \c A_i of every extended subdomain and builds a local
+ *  solver for it; applying the preconditioner computes
+ *  <tt>y = sum_i R_i^T A_i^-1 R_i x</tt>, where \c R_i restricts a
+ *  vector to subdomain \c i.
+ *
+ *  With \p restricted (RAS) every subdomain only writes back the values
+ *  of the unknowns it owns.  This usually converges faster and avoids
+ *  summing the overlap, but the preconditioner is nonsymmetric, so it
+ *  should be used with \p gmres or \p bicgstab.  The plain additive
+ *  form with an exact or symmetric local solver is symmetric.
+ *
+ *  Subdomains are set up and solved concurrently (with OpenMP when it
+ *  is enabled).  Subdomain \c i is always processed by the same thread,
+ *  which also allocated its data, so each thread works on its own
+ *  cache-resident submatrix, factors and vectors.
+ *
+ *  Setup and application run on the host; \p MemorySpace should be
+ *  \c cusp::host_memory.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory)
+ *
+ *  The following code snippet demonstrates how to use an
+ *  \p additive_schwarz preconditioner with one layer of overlap and
+ *  ILU(0) subdomain solves.
+ *
+ *  \code
+ *  #include <cusp/precond/additive_schwarz.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::host_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner
+ *  cusp::precond::additive_schwarz<float, cusp::host_memory>
+ *      M(A, cusp::precond::schwarz_ilu0, 1);
+ *
+ *  // solve
+ *  cusp::krylov::gmres(A, x, b, 50, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class additive_schwarz : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    struct subdomain
+    {
+        cusp::array1d<int, cusp::host_memory> rows;        // global rows in increasing order
+        size_t owned_offset;                               // local position of the first owned row
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> A;
+        detail::schwarz_solver_base<ValueType> * solver;
+        cusp::array1d<ValueType, cusp::host_memory> b;     // restricted input
+        cusp::array1d<ValueType, cusp::host_memory> x;     // local solution
+
+        subdomain() : owned_offset(0), solver(0) {}
+    };
+
+    // rows [partition[i], partition[i+1]) are owned by subdomain i
+    cusp::array1d<int, cusp::host_memory> partition;
+
+    // local positions of the overlap rows of other subdomains, grouped by owner
+    cusp::array1d<int, cusp::host_memory> overlap_offsets;
+    cusp::array1d<int, cusp::host_memory> overlap_subdomains;
+    cusp::array1d<int, cusp::host_memory> overlap_positions;
+
+    std::vector<subdomain> subdomains;
+
+    bool restricted;
+
+    // not copyable, the subdomains own their solvers
+    additive_schwarz(const additive_schwarz&);
+    additive_schwarz& operator=(const additive_schwarz&);
+
+public:
+    /*! construct an \p additive_schwarz preconditioner
+     *
+     * \param A matrix to precondition
+     * \param local_solver solver used for the subdomain problems
+     * \param overlap number of layers of neighbours added to every subdomain
+     * \param restricted only write back the values of owned unknowns (RAS)
+     * \param num_subdomains number of subdomains, \c 0 for one per thread
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square or a
+     *         subdomain matrix lacks a diagonal entry
+     * \throws cusp::runtime_exception if a local factorization fails
+     */
+    template<typename MatrixType>
+    additive_schwarz(const MatrixType& A,
+                     schwarz_local_solver local_solver = schwarz_ilu0,
+                     size_t overlap = 0,
+                     bool restricted = false,
+                     size_t num_subdomains = 0);
+
+    ~additive_schwarz(void);
+
+    /*! number of subdomains
+     */
+    size_t num_subdomains(void) const { return subdomains.size(); }
+
+    /*! number of unknowns of subdomain \p i including its overlap
+     */
+    size_t subdomain_size(size_t i) const { return subdomains[i].rows.size(); }
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y);
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/additive_schwarz.inl>
@@ -0,0 +1,150 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file block_jacobi.h
+ *  \brief Block Jacobi preconditioner.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/array1d.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! \p block_jacobi : block diagonal (block Jacobi) preconditioner
+ *
+ *  Given a matrix \c A whose unknowns are grouped into consecutive
+ *  blocks (e.g. the components of one node of a PDE system), the
+ *  block Jacobi preconditioner extracts the dense diagonal blocks
+ *  \c D_k of \c A, inverts them once at setup and implements
+ *  <tt>y_k = D_k^-1 x_k</tt> for every block when applied to a vector
+ *  \p x.  Unlike \p diagonal it keeps the coupling between the
+ *  unknowns of a block.
+ *
+ *  Blocks either all have the same size (the last one may be smaller
+ *  when it does not divide the number of rows) or are given by an
+ *  array of block offsets.  Blocks of size 1 to 8 are inverted and
+ *  applied with kernels specialized for their size.  Extraction,
+ *  inversion and application process the blocks in parallel (with
+ *  OpenMP when it is enabled).
+ *
+ *  The setup and the application run on the host; \p MemorySpace
+ *  should be \c cusp::host_memory.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory)
+ *
+ *  The following code snippet demonstrates how to use a
+ *  \p block_jacobi preconditioner for a system with 3 unknowns
+ *  per node.
+ *
+ *  \code
+ *  #include <cusp/precond/block_jacobi.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::host_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner with 3x3 blocks
+ *  cusp::precond::block_jacobi<float, cusp::host_memory> M(A, 3);
+ *
+ *  // solve
+ *  cusp::krylov::bicgstab(A, x, b, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class block_jacobi : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    size_t block_size_;
+    cusp::array1d<int, cusp::host_memory> block_offsets;
+    cusp::array1d<int, cusp::host_memory> inverse_offsets;
+    cusp::array1d<ValueType, cusp::host_memory> inverses;
+
+    template<typename MatrixType>
+    void setup(const MatrixType& A);
+
+public:
+    /*! construct a \p block_jacobi preconditioner with blocks of
+     *  \p block_size consecutive rows
+     *
+     * \param A matrix to precondition
+     * \param block_size number of rows per block
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square or
+     *         \p block_size is zero
+     * \throws cusp::runtime_exception if a diagonal block is singular
+     */
+    template<typename MatrixType>
+    block_jacobi(const MatrixType& A, size_t block_size);
+
+    /*! construct a \p block_jacobi preconditioner with variable
+     *  block sizes, block \c k covering rows
+     *  <tt>[block_offsets[k], block_offsets[k+1])</tt>
+     *
+     * \param A matrix to precondition
+     * \param block_offsets increasing offsets from \c 0 to \c A.num_rows
+     * \tparam MatrixType matrix
+     * \tparam OffsetMemorySpace memory space of \p block_offsets
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square or
+     *         \p block_offsets does not partition its rows
+     * \throws cusp::runtime_exception if a diagonal block is singular
+     */
+    template<typename MatrixType, typename OffsetMemorySpace>
+    block_jacobi(const MatrixType& A, const cusp::array1d<int, OffsetMemorySpace>& block_offsets);
+
+    /*! number of diagonal blocks
+     */
+    size_t num_blocks(void) const { return block_offsets.size() - 1; }
+
+    /*! common block size, or \c 0 when the block sizes vary
+     */
+    size_t block_size(void) const { return block_size_; }
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/block_jacobi.inl>
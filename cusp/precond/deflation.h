@@ -0,0 +1,179 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file deflation.h
+ *  \brief Two-level deflation preconditioner with an aggregation coarse space.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/precond/smoothed_aggregation.h>
+#include <cusp/relaxation/polynomial.h>
+#include <cusp/detail/lu.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! one-level smoothers used by \p deflation
+ */
+enum deflation_smoother
+{
+    /*! <tt>M^-1 = D^-1</tt>, the inverse of the diagonal of \c A */
+    deflation_jacobi,
+
+    /*! a Chebyshev polynomial in \c A, as used by \p smoothed_aggregation */
+    deflation_chebyshev
+};
+
+/*! ways of combining the smoother with the coarse correction
+ */
+enum deflation_variant
+{
+    /*! <tt>P^T M^-1 P + Q</tt>, symmetric, works with any initial guess */
+    deflation_balancing,
+
+    /*! <tt>P^T M^-1 + Q</tt> (ADEF2), one coarse solve per application;
+     *  with \p cg start from the guess returned by \p initial_guess */
+    deflation_adef2
+};
+
+/*! \p deflation : two-level deflation preconditioner
+ *
+ *  Uses the aggregates of \p smoothed_aggregation as a coarse space.
+ *  The columns of \c Z are the normalized indicator vectors of the
+ *  aggregates, the tentative prolongator of \c fit_candidates.  Setup
+ *  forms <tt>E = Z^T A Z</tt> with sparse Galerkin products and factors
+ *  it once with a dense LU.  If \c A has more than \p max_coarse_size
+ *  rows after one aggregation, the aggregates are aggregated again,
+ *  so \c Z is the product of the tentative prolongators.
+ *
+ *  With <tt>Q = Z E^-1 Z^T</tt> and <tt>P = I - A Q</tt>, applying the
+ *  preconditioner combines the coarse correction \c Q with a cheap
+ *  smoother \c M^-1.  The coarse space removes the smooth error
+ *  components that make one-level methods such as Jacobi-PCG
+ *  stagnate, at a fraction of the setup cost of a full multigrid
+ *  hierarchy.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  The following code snippet demonstrates how to use a \p deflation
+ *  preconditioner with \p cg.
+ *
+ *  \code
+ *  #include <cusp/precond/deflation.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner
+ *  cusp::precond::deflation<float, cusp::device_memory> M(A);
+ *
+ *  // solve
+ *  cusp::krylov::cg(A, x, b, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class deflation : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    typedef typename amg_container<int,ValueType,MemorySpace>::setup_type SetupMatrixType;
+    typedef typename amg_container<int,ValueType,MemorySpace>::solve_type SolveMatrixType;
+
+    SolveMatrixType matrix;  // A
+    SolveMatrixType Z;       // coarse space basis
+    SolveMatrixType Zt;      // its transpose
+
+    cusp::detail::lu_solver<ValueType, cusp::host_memory> E;
+
+    deflation_smoother smoother;
+    deflation_variant variant;
+
+    cusp::array1d<ValueType, MemorySpace> diagonal_reciprocals;
+    cusp::relaxation::polynomial<ValueType, MemorySpace> chebyshev;
+
+    // workspace
+    cusp::array1d<ValueType, MemorySpace> q, s, z, t, coarse;
+    cusp::array1d<ValueType, cusp::host_memory> coarse_b, coarse_x;
+
+    template <typename Array1, typename Array2>
+    void coarse_solve(const Array1& b, Array2& x);
+
+    template <typename Array1, typename Array2>
+    void smooth(const Array1& b, Array2& x);
+
+public:
+    /*! construct a \p deflation preconditioner
+     *
+     * \param A matrix to precondition
+     * \param smoother one-level smoother
+     * \param variant combination of smoother and coarse correction
+     * \param max_coarse_size aggregate until the coarse space is at most this large
+     * \param theta strength of connection threshold for the aggregation
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::runtime_exception if aggregation stops making progress
+     *         before the coarse space has at most \p max_coarse_size rows
+     */
+    template<typename MatrixType>
+    deflation(const MatrixType& A,
+              deflation_smoother smoother = deflation_jacobi,
+              deflation_variant variant = deflation_balancing,
+              size_t max_coarse_size = 500,
+              ValueType theta = 0);
+
+    /*! dimension of the coarse space, the number of columns of \c Z
+     */
+    size_t coarse_size(void) const { return Z.num_cols; }
+
+    /*! compute the initial guess <tt>x = Q b</tt>, which makes the
+     *  \c deflation_adef2 variant safe to use with \p cg
+     */
+    template <typename Array1, typename Array2>
+    void initial_guess(const Array1& b, Array2& x);
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y);
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/deflation.inl>
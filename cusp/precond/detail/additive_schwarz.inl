@@ -0,0 +1,352 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file additive_schwarz.inl
+ *  \brief Inline file for additive_schwarz.h
+ */
+
+#include <cusp/array2d.h>
+#include <cusp/exception.h>
+#include <cusp/precond/ilu0.h>
+#include <cusp/precond/smoothed_aggregation.h>
+#include <cusp/detail/lu.h>
+
+#include <thrust/fill.h>
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+template <typename Solver, typename ValueType>
+class schwarz_solver : public schwarz_solver_base<ValueType>
+{
+    Solver M;
+
+public:
+    template <typename MatrixType>
+    schwarz_solver(const MatrixType& A) : M(A) {}
+
+    void solve(const cusp::array1d<ValueType, cusp::host_memory>& b,
+                     cusp::array1d<ValueType, cusp::host_memory>& x)
+    {
+        M(b, x);
+    }
+};
+
+// dense LU that reports a singular subdomain matrix, which lu_solver ignores
+template <typename ValueType>
+class schwarz_lu_solver : public schwarz_solver_base<ValueType>
+{
+    cusp::array2d<ValueType, cusp::host_memory> lu;
+    cusp::array1d<int, cusp::host_memory>       pivot;
+
+public:
+    template <typename MatrixType>
+    schwarz_lu_solver(const MatrixType& A) : lu(A), pivot(A.num_rows)
+    {
+        if (cusp::detail::lu_factor(lu, pivot) != 0)
+            throw cusp::runtime_exception("additive_schwarz: singular subdomain matrix");
+    }
+
+    void solve(const cusp::array1d<ValueType, cusp::host_memory>& b,
+                     cusp::array1d<ValueType, cusp::host_memory>& x)
+    {
+        cusp::detail::lu_solve(lu, pivot, b, x);
+    }
+};
+
+template <typename ValueType>
+schwarz_solver_base<ValueType> *
+make_schwarz_solver(const cusp::csr_matrix<int, ValueType, cusp::host_memory>& A, schwarz_local_solver local_solver)
+{
+    switch (local_solver)
+    {
+        case schwarz_ilu0:
+            return new schwarz_solver<cusp::precond::ilu0<ValueType, cusp::host_memory>, ValueType>(A);
+        case schwarz_smoothed_aggregation:
+            return new schwarz_solver<cusp::precond::smoothed_aggregation<int, ValueType, cusp::host_memory>, ValueType>(A);
+        case schwarz_dense_lu:
+            return new schwarz_lu_solver<ValueType>(A);
+    }
+
+    throw cusp::invalid_input_exception("additive_schwarz: unknown local solver");
+}
+
+} // end namespace detail
+
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    additive_schwarz<ValueType,MemorySpace>
+    ::additive_schwarz(const MatrixType& A, schwarz_local_solver local_solver,
+                       size_t overlap, bool restricted, size_t num_subdomains)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, 0),
+          restricted(restricted)
+    {
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("additive_schwarz: matrix must be square");
+
+        const int N = A.num_rows;
+
+        // nothing to partition
+        if (N == 0)
+        {
+            partition.resize(1, 0);
+            overlap_offsets.resize(1, 0);
+            return;
+        }
+
+        if (num_subdomains == 0)
+        {
+#if defined(_OPENMP)
+            num_subdomains = omp_get_max_threads();
+#else
+            num_subdomains = 1;
+#endif
+        }
+        num_subdomains = std::min(num_subdomains, size_t(N));
+
+        const long P = num_subdomains;
+
+        // contiguous blocks of rows of (almost) equal size
+        partition.resize(P + 1);
+        for (long i = 0; i <= P; i++)
+            partition[i] = (N / P) * i + std::min(long(N % P), i);
+
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> B(A);
+
+        subdomains.resize(P);
+
+        std::string error;
+        bool invalid_input = false;
+
+        // each subdomain is built by the thread that later solves it
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+        {
+            cusp::array1d<int, cusp::host_memory> marker(N, -1);
+            cusp::array1d<int, cusp::host_memory> frontier, next;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(static)
+#endif
+            for (long i = 0; i < P; i++)
+            {
+                subdomain& s = subdomains[i];
+
+                // owned rows, then overlap layers of neighbours in the graph of A
+                frontier.clear();
+                for (int r = partition[i]; r < partition[i + 1]; r++)
+                {
+                    marker[r] = i;
+                    frontier.push_back(r);
+                }
+                s.rows = frontier;
+
+                for (size_t level = 0; level < overlap && !frontier.empty(); level++)
+                {
+                    next.clear();
+                    for (size_t f = 0; f < frontier.size(); f++)
+                        for (int jj = B.row_offsets[frontier[f]]; jj < B.row_offsets[frontier[f] + 1]; jj++)
+                        {
+                            const int j = B.column_indices[jj];
+                            if (marker[j] != i)
+                            {
+                                marker[j] = i;
+                                next.push_back(j);
+                                s.rows.push_back(j);
+                            }
+                        }
+                    frontier.swap(next);
+                }
+
+                std::sort(s.rows.begin(), s.rows.end());
+                s.owned_offset = std::lower_bound(s.rows.begin(), s.rows.end(), int(partition[i])) - s.rows.begin();
+
+                // diagonal submatrix A(rows, rows)
+                const int n = s.rows.size();
+                size_t nnz = 0;
+                for (int l = 0; l < n; l++)
+                    for (int jj = B.row_offsets[s.rows[l]]; jj < B.row_offsets[s.rows[l] + 1]; jj++)
+                        if (marker[B.column_indices[jj]] == i)
+                            nnz++;
+
+                s.A.resize(n, n, nnz);
+                s.A.row_offsets[0] = 0;
+                nnz = 0;
+                for (int l = 0; l < n; l++)
+                {
+                    for (int jj = B.row_offsets[s.rows[l]]; jj < B.row_offsets[s.rows[l] + 1]; jj++)
+                    {
+                        const int j = B.column_indices[jj];
+                        if (marker[j] == i)
+                        {
+                            s.A.column_indices[nnz] = std::lower_bound(s.rows.begin(), s.rows.end(), j) - s.rows.begin();
+                            s.A.values[nnz]         = B.values[jj];
+                            nnz++;
+                        }
+                    }
+                    s.A.row_offsets[l + 1] = nnz;
+                }
+
+                s.b.resize(n);
+                s.x.resize(n);
+
+                try
+                {
+                    s.solver = detail::make_schwarz_solver(s.A, local_solver);
+                }
+                // no exception may leave the parallel region
+                catch (std::exception& e)
+                {
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+                    {
+                        if (error.empty())
+                        {
+                            error = e.what();
+                            invalid_input = dynamic_cast<cusp::invalid_input_exception*>(&e) != 0;
+                        }
+                    }
+                }
+                catch (...)
+                {
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+                    {
+                        if (error.empty())
+                            error = "additive_schwarz: local solver setup failed";
+                    }
+                }
+            }
+        }
+
+        if (!error.empty())
+        {
+            for (long i = 0; i < P; i++)
+                delete subdomains[i].solver;
+            if (invalid_input)
+                throw cusp::invalid_input_exception(error);
+            throw cusp::runtime_exception(error);
+        }
+
+        // overlap rows of every subdomain, grouped by the subdomain owning them
+        overlap_offsets.resize(P + 1, 0);
+        for (long j = 0; j < P; j++)
+            for (size_t l = 0; l < subdomains[j].rows.size(); l++)
+            {
+                const int r = subdomains[j].rows[l];
+                const long owner = std::upper_bound(partition.begin(), partition.end(), r) - partition.begin() - 1;
+                if (owner != j)
+                    overlap_offsets[owner + 1]++;
+            }
+        for (long i = 0; i < P; i++)
+            overlap_offsets[i + 1] += overlap_offsets[i];
+
+        overlap_subdomains.resize(overlap_offsets[P]);
+        overlap_positions.resize(overlap_offsets[P]);
+
+        cusp::array1d<int, cusp::host_memory> next_slot(overlap_offsets.begin(), overlap_offsets.end() - 1);
+        for (long j = 0; j < P; j++)
+            for (size_t l = 0; l < subdomains[j].rows.size(); l++)
+            {
+                const int r = subdomains[j].rows[l];
+                const long owner = std::upper_bound(partition.begin(), partition.end(), r) - partition.begin() - 1;
+                if (owner != j)
+                {
+                    overlap_subdomains[next_slot[owner]] = j;
+                    overlap_positions [next_slot[owner]] = l;
+                    next_slot[owner]++;
+                }
+            }
+
+        for (long i = 0; i < P; i++)
+            Parent::num_entries += subdomains[i].A.num_entries;
+    }
+
+// destructor
+template <typename ValueType, typename MemorySpace>
+    additive_schwarz<ValueType,MemorySpace>
+    ::~additive_schwarz(void)
+    {
+        for (size_t i = 0; i < subdomains.size(); i++)
+            delete subdomains[i].solver;
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void additive_schwarz<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y)
+    {
+        const long P = subdomains.size();
+
+        // independent subdomain solves, the same static schedule as the setup
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+        for (long i = 0; i < P; i++)
+        {
+            subdomain& s = subdomains[i];
+
+            for (size_t l = 0; l < s.rows.size(); l++)
+                s.b[l] = x[s.rows[l]];
+            thrust::fill(s.x.begin(), s.x.end(), ValueType(0));
+
+            s.solver->solve(s.b, s.x);
+        }
+
+        // every subdomain writes its owned rows and, unless restricted,
+        // adds the overlap values the other subdomains computed for them
+#if defined(_OPENMP)
+#pragma omp parallel for schedule(static)
+#endif
+        for (long i = 0; i < P; i++)
+        {
+            const subdomain& s = subdomains[i];
+
+            for (int r = partition[i], l = s.owned_offset; r < partition[i + 1]; r++, l++)
+                y[r] = s.x[l];
+
+            if (restricted)
+                continue;
+
+            for (int k = overlap_offsets[i]; k < overlap_offsets[i + 1]; k++)
+            {
+                const subdomain& t = subdomains[overlap_subdomains[k]];
+                const int l = overlap_positions[k];
+                y[t.rows[l]] += t.x[l];
+            }
+        }
+    }
+
+} // end namespace precond
+} // end namespace cusp
@@ -24,7 +24,8 @@
 #include <cusp/multiply.h>
 #include <cusp/csr_matrix.h>
 
-#include <map>
+#include <algorithm>
+#include <functional>
 #include <vector>
 
 namespace cusp
@@ -34,6 +35,9 @@ namespace precond
 namespace detail
 {
 
+// minimum number of row updates in one step before they are spread over threads
+const int ainv_parallel_threshold = 64;
+
 template<typename T>
 bool less_than_abs(const T &a, const T &b)
 {
@@ -42,337 +46,313 @@ bool less_than_abs(const T &a, const T &b)
   return abs_a < abs_b;
 }
 
-template<typename IndexType, typename ValueType>
-class ainv_matrix_row
+template<typename T>
+T abs_value(const T &a)
 {
-public:
-
-  struct map_entry {
-    ValueType value;
-    int heapidx;
-
-    map_entry(const ValueType &v, int i) : value(v), heapidx(i) { }
-    map_entry() { }
-  };
-
-  struct heap_entry {
-    ValueType value;
-    typename std::map<IndexType, typename ainv_matrix_row::map_entry>::iterator mapiter;
-
-    heap_entry(const ValueType &v, const typename std::map<IndexType, typename ainv_matrix_row::map_entry>::iterator &i) : value(v), mapiter(i) { }
-    heap_entry() { }
-  };
-
-  typedef typename std::map<IndexType, typename ainv_matrix_row::map_entry>::const_iterator const_iterator;
+  return a < 0 ? -a : a;
+}
 
-private:
+// All factor rows live in one flat pool.  Each row owns a slice [offset, offset + capacity)
+// holding its entries sorted by column index; a row that outgrows its slice is moved to the
+// end of the pool with twice the room, so growth is amortized and nothing is node-allocated.
+template<typename IndexType, typename ValueType>
+class ainv_row_store
+{
+  std::vector<size_t> offsets;
+  std::vector<size_t> capacities;
+  std::vector<size_t> sizes;
+  std::vector<IndexType> pool_indices;
+  std::vector<ValueType> pool_values;
 
-  typename std::map<IndexType, typename ainv_matrix_row::map_entry> row_map; // row entries sorted by index
-  typename std::vector<typename ainv_matrix_row::heap_entry> row_heap; // row entries sorted by min-abs-val (in a heap)
+public:
 
-  void heap_swap(int i, int j)
+  // start every row as the corresponding row of the identity
+  ainv_row_store(size_t num_rows, size_t initial_capacity = 4)
+    : offsets(num_rows), capacities(num_rows, initial_capacity), sizes(num_rows, 1),
+      pool_indices(num_rows * initial_capacity), pool_values(num_rows * initial_capacity)
   {
-    // swap the entries
-    typename ainv_matrix_row::heap_entry val = this->row_heap[i];
-    this->row_heap[i] = this->row_heap[j];
-    this->row_heap[j] = val;
-
-    // update the backpointers
-    this->row_heap[i].mapiter->second.heapidx = i;
-    this->row_heap[j].mapiter->second.heapidx = j;
-  }
-
-  void downheap(int i) {
-    int child0 = (i+1)*2-1;
-    int child1 = (i+1)*2;
-
-    while ((size_t) child0 < this->row_heap.size() || (size_t) child1 < this->row_heap.size()) {
-      int min_child = child0; // this will be the child with the lowest value that is in-bounds.
-      if ((size_t) child1 < this->row_heap.size() && less_than_abs(this->row_heap[child1].value, this->row_heap[child0].value))
-        min_child = child1;
-      // if either child is lower, swap with whichever is smaller, otherwise we're done
-      if (less_than_abs(this->row_heap[child0].value, this->row_heap[i].value) || ((size_t) child1 < this->row_heap.size() && less_than_abs(this->row_heap[child1].value, this->row_heap[i].value))) 
-        this->heap_swap(i, min_child);
-      else
-        break;
-
-      i = min_child;
-      child0 = (i+1)*2-1;
-      child1 = (i+1)*2;
+    for (size_t i = 0; i < num_rows; i++) {
+      offsets[i] = i * initial_capacity;
+      pool_indices[offsets[i]] = (IndexType) i;
+      pool_values [offsets[i]] = ValueType(1);
     }
   }
 
-  void upheap(int i) {
-    int parent = (i-1)/2;
-    while (i != 0) {
-      if (less_than_abs(this->row_heap[i].value, this->row_heap[parent].value))
-          this->heap_swap(i, parent);
-      else
-        break;
-
-      i = parent;
-      parent = (i-1)/2;
-    }
+  size_t num_rows() const { return sizes.size(); }
+  size_t size(size_t i) const { return sizes[i]; }
+  size_t num_entries() const {
+    size_t nnz = 0;
+    for (size_t i = 0; i < sizes.size(); i++)
+      nnz += sizes[i];
+    return nnz;
   }
 
+  const IndexType * indices(size_t i) const { return &pool_indices[offsets[i]]; }
+  const ValueType * values (size_t i) const { return &pool_values [offsets[i]]; }
 
-  void heap_insert(typename ainv_matrix_row::heap_entry val)
-  {
-    this->row_heap.push_back(val);
-    val.mapiter->second.heapidx = (int) this->row_heap.size()-1;
-    upheap(this->row_heap.size()-1);
-  }
-
-  void heap_pop()
-  {
-    if (this->row_heap.empty()) 
+  // make room for n entries in row i; may reallocate the pool, so it is never called
+  // while other threads hold pointers into the store
+  void reserve(size_t i, size_t n) {
+    if (n <= capacities[i])
       return;
 
-    heap_swap(0, this->row_heap.size()-1);
-    //no need to erase the backpointer, since the tree will be updated elsewhere
-
-    this->row_heap.pop_back();
-    
-    downheap(0);
-  }
-
-  void heap_update(int i, ValueType val)
-  {
-    ValueType old_val = this->row_heap[i].value;
-    this->row_heap[i].value = val;
-
-    if (less_than_abs(val, old_val)) 
-      upheap(i);
-    else
-      downheap(i);
-  }
-
-
-public:
-
-  typename ainv_matrix_row::const_iterator begin() const { return this->row_map.begin(); }
-  typename ainv_matrix_row::const_iterator end()   const { return this->row_map.end(); }
-  size_t size() const { return this->row_map.size(); }
-
-  bool has_entry_at_index(IndexType i) {
-    return this->row_map.count(i) != 0;
-  }
-
-  void mult_by_scalar(ValueType scalar) {
-    // since we already have a table of pointers into the map, this is O(n) via pointer chasing
-    for (int i=0; (size_t) i < this->row_heap.size(); i++) {
-      this->row_heap[i].value *= scalar;
-      this->row_heap[i].mapiter->second.value *= scalar;
-    }
+    size_t new_capacity = std::max(n, 2 * capacities[i]);
+    size_t new_offset   = pool_indices.size();
+    pool_indices.resize(new_offset + new_capacity);
+    pool_values .resize(new_offset + new_capacity);
+    std::copy(pool_indices.begin() + offsets[i], pool_indices.begin() + offsets[i] + sizes[i], pool_indices.begin() + new_offset);
+    std::copy(pool_values .begin() + offsets[i], pool_values .begin() + offsets[i] + sizes[i], pool_values .begin() + new_offset);
+    offsets[i]    = new_offset;
+    capacities[i] = new_capacity;
   }
 
-  void insert(IndexType i, ValueType t) {
-    ainv_matrix_row::map_entry me(t, -1);
-    ainv_matrix_row::heap_entry he;
-
-    // map::insert returns a pair (iterator, bool), so we can grab the iterator from that
-    he.mapiter = this->row_map.insert(std::make_pair(i, me)).first;
-    he.value = t;
-
-    this->heap_insert(he);
+  // overwrite row i with n entries; the caller has reserved enough room
+  void assign(size_t i, const IndexType * idx, const ValueType * val, size_t n) {
+    std::copy(idx, idx + n, pool_indices.begin() + offsets[i]);
+    std::copy(val, val + n, pool_values .begin() + offsets[i]);
+    sizes[i] = n;
   }
 
-  ValueType min_abs_value() const {
-    return this->row_heap.empty() ? (ValueType)0 : this->row_heap.begin()->value;
+  void mult_by_scalar(size_t i, ValueType scalar) {
+    for (size_t k = offsets[i]; k < offsets[i] + sizes[i]; k++)
+      pool_values[k] *= scalar;
   }
+};
 
-  // these are here for the unit test only
-  bool validate_heap() const {
-    for (int i=0; (size_t) i < this->size(); i++) {
-      int child0 = (i+1)*2-1;
-      int child1 = (i+1)*2;
-      if ((size_t) child0 < this->size() && !less_than_abs(this->row_heap[i].value, this->row_heap[child0].value))
-        return false;
-      if ((size_t) child1 < this->size() && !less_than_abs(this->row_heap[i].value, this->row_heap[child1].value))
-        return false;
+// dense sparse accumulator: a full-length value array plus the list of touched positions,
+// so building and clearing a sparse result costs time proportional to its nonzeros
+template<typename IndexType, typename ValueType>
+struct ainv_spa
+{
+  std::vector<ValueType> values;
+  std::vector<char>      occupied;
+  std::vector<IndexType> touched;
 
-    }
-    return true;
-  }
+  ainv_spa(size_t n) : values(n, ValueType(0)), occupied(n, 0) {}
 
-  // these are here for the unit test only
-  bool validate_backpointers() const {
-    for (typename ainv_matrix_row::const_iterator iter = this->row_map.begin(); iter != this->row_map.end(); ++iter) {
-      if (this->row_heap[iter->second.heapidx].mapiter != iter ||
-          this->row_heap[iter->second.heapidx].value != iter->second.value)
-        return false;
+  void clear() {
+    for (size_t k = 0; k < touched.size(); k++) {
+      values  [touched[k]] = ValueType(0);
+      occupied[touched[k]] = 0;
     }
-    return true;
+    touched.clear();
   }
+};
 
-  void add_to_value(IndexType i, ValueType addend) {
-    // update val in map, which is free
-    typename std::map<IndexType, typename ainv_matrix_row::map_entry>::iterator map_iter = this->row_map.find(i);
-    map_iter->second.value += addend;
+// per-thread scratch space for sparse_axpy_drop
+template<typename IndexType, typename ValueType>
+struct ainv_workspace
+{
+  std::vector<IndexType> indices;
+  std::vector<ValueType> values;
+  std::vector<ValueType> magnitudes;
+};
 
-    // update val in heap, which requires re-sorting
-    this->heap_update(map_iter->second.heapidx, map_iter->second.value);
-  }
+// b = x^T A, where x is a sparse row with sorted indices
+template<typename IndexType, typename ValueType>
+void matrix_vector_product(const csr_matrix<IndexType, ValueType, host_memory> &A,
+                           const IndexType * x_indices, const ValueType * x_values, size_t x_size,
+                           ainv_spa<IndexType, ValueType> &b)
+{
+    b.clear();
 
-  void remove_min() {
-    if (this->row_heap.empty())
-      return;
+    for (size_t k = 0; k < x_size; k++) {
+        ValueType x_i = x_values[k];
+        IndexType row = x_indices[k];
 
-    typename std::map<IndexType, typename ainv_matrix_row::map_entry>::iterator iter_to_remove = this->row_heap.begin()->mapiter;
-    this->heap_pop();
-    this->row_map.erase(iter_to_remove);
-  }
+        for (IndexType row_j = A.row_offsets[row]; row_j < A.row_offsets[row + 1]; row_j++) {
+            IndexType col = A.column_indices[row_j];
 
-  void replace_min_if_greater(IndexType i, ValueType t) {
-    if (!less_than_abs(t, this->min_abs_value())) {
-      remove_min();
-      insert(i, t);
+            if (!b.occupied[col]) {
+                b.occupied[col] = 1;
+                b.touched.push_back(col);
+            }
+            b.values[col] += A.values[row_j] * x_i;
+        }
     }
-  }
-}; // end struct ainv_matrix_row
+}
 
 template<typename IndexType, typename ValueType>
-void vector_scalar(std::map<IndexType, ValueType> &vec, ValueType scalar)
+ValueType dot_product(const IndexType * a_indices, const ValueType * a_values, size_t a_size,
+                      const ainv_spa<IndexType, ValueType> &b)
 {
-    for (typename std::map<IndexType, ValueType>::iterator vec_iter = vec.begin(); vec_iter != vec.end(); ++vec_iter) {
-      vec_iter->second *= scalar;
-    }
+    ValueType sum = 0;
+    for (size_t k = 0; k < a_size; k++)
+        sum += a_values[k] * b.values[a_indices[k]];
+    return sum;
 }
 
-
+// collect the entries of b with index > j into (targets, coefficients)
 template<typename IndexType, typename ValueType>
-void matrix_vector_product(const csr_matrix<IndexType, ValueType, host_memory> &A, const detail::ainv_matrix_row<IndexType, ValueType> &x, std::map<IndexType, ValueType> &b)
+void entries_after(const ainv_spa<IndexType, ValueType> &b, IndexType j,
+                   std::vector<IndexType> &targets, std::vector<ValueType> &coefficients)
 {
-    b.clear();
-
-    for (typename detail::ainv_matrix_row<IndexType, ValueType>::const_iterator x_iter = x.begin(); x_iter != x.end(); ++x_iter) {
-        ValueType x_i  = x_iter->second.value;
-        IndexType row = x_iter->first;
+    for (size_t k = 0; k < b.touched.size(); k++) {
+        IndexType i = b.touched[k];
+        if (i > j) {
+            targets.push_back(i);
+            coefficients.push_back(b.values[i]);
+        }
+    }
+}
 
-        IndexType row_start = A.row_offsets[row];
-        IndexType row_end = A.row_offsets[row+1];
+// write into (out_indices, out_values):
+//   result + mult * operand
+// where any term of (mult * operand) smaller than tolerance is dropped.  We use a combination of
+// 2 dropping strategies: a standard drop tolerance, as well as a bound on the number of non-zeros
+// per row.  When the merged row exceeds that bound only its largest entries are kept; they are
+// located with nth_element, so the merge stays linear in the length of both rows.
+// See: Lin, C. and More, J. J. 1999. Incomplete Cholesky Factorizations with Limited Memory.
+//      SIAM J. Sci. Comput. 21, 1 (Aug. 1999), 24-45.
+// Returns the length of the merged row.
+template<typename IndexType, typename ValueType>
+size_t sparse_axpy_drop(const IndexType * r_indices, const ValueType * r_values, size_t r_size,
+                        ValueType mult,
+                        const IndexType * o_indices, const ValueType * o_values, size_t o_size,
+                        ValueType tolerance, int nonzeros_this_row,
+                        ainv_workspace<IndexType, ValueType> &work)
+{
+    work.indices.resize(r_size + o_size);
+    work.values .resize(r_size + o_size);
+
+    size_t r = 0, o = 0, n = 0;
+    while (r < r_size || o < o_size) {
+        if (o == o_size || (r < r_size && r_indices[r] < o_indices[o])) {
+            work.indices[n] = r_indices[r];
+            work.values [n] = r_values [r];
+            n++; r++;
+            continue;
+        }
 
-        for (IndexType row_j = row_start; row_j < row_end; row_j++) {
-            IndexType col = A.column_indices[row_j];
-            ValueType Aij = A.values[row_j];
+        ValueType term = mult * o_values[o];
+        bool keep_term = !(abs_value(term) < tolerance);
 
-            ValueType product = Aij * x_i;
+        if (r < r_size && r_indices[r] == o_indices[o]) {
+            work.indices[n] = r_indices[r];
+            work.values [n] = keep_term ? r_values[r] + term : r_values[r];
+            n++; r++;
+        }
+        else if (keep_term) {
+            work.indices[n] = o_indices[o];
+            work.values [n] = term;
+            n++;
+        }
+        o++;
+    }
 
-            // add to b if it's not already in b
-            typename std::map<IndexType, ValueType>::iterator b_iter = b.find(col);
-            if (b_iter == b.end())
-                b[col] = product;
-            else 
-                b_iter->second += product;
+    if (nonzeros_this_row < 0 || n <= (size_t) nonzeros_this_row)
+        return n;
+
+    // find the magnitude of the k-th largest entry, then keep everything above it (and as many
+    // entries equal to it as still fit) without disturbing the index order
+    size_t k = std::max(nonzeros_this_row, 1);
+    work.magnitudes.resize(n);
+    for (size_t m = 0; m < n; m++)
+        work.magnitudes[m] = abs_value(work.values[m]);
+    std::nth_element(work.magnitudes.begin(), work.magnitudes.begin() + (k - 1), work.magnitudes.end(), std::greater<ValueType>());
+    ValueType threshold = work.magnitudes[k - 1];
+
+    size_t above = 0;
+    for (size_t m = 0; m < n; m++)
+        if (abs_value(work.values[m]) > threshold)
+            above++;
+    size_t ties = k - above;
+
+    size_t kept = 0;
+    for (size_t m = 0; m < n; m++) {
+        ValueType magnitude = abs_value(work.values[m]);
+        if (magnitude > threshold || (magnitude == threshold && ties > 0 && ties--)) {
+            work.indices[kept] = work.indices[m];
+            work.values [kept] = work.values [m];
+            kept++;
         }
     }
 
+    return kept;
 }
 
-
+// per-row nonzero bounds for sparse_axpy_drop, or -1 when rows are unbounded
 template<typename IndexType, typename ValueType>
-ValueType dot_product(const detail::ainv_matrix_row<IndexType, ValueType> &a, const std::map<IndexType, ValueType> &b) 
+std::vector<int> row_nonzero_limits(const csr_matrix<IndexType, ValueType, host_memory> &A, int nonzero_per_row, bool lin_dropping, int lin_param)
 {
-    typename detail::ainv_matrix_row<IndexType, ValueType>::const_iterator a_iter = a.begin();
-    typename std::map<IndexType, ValueType>::const_iterator b_iter = b.begin();
+    std::vector<int> limits(A.num_rows, nonzero_per_row < 0 ? -1 : std::max(nonzero_per_row, 1));
 
-    ValueType sum = 0;
-    while (a_iter != a.end() && b_iter != b.end()) {
-        IndexType a_ind = a_iter->first;
-        IndexType b_ind = b_iter->first;
-        if (a_ind == b_ind) {
-            sum += a_iter->second.value * b_iter->second;
-            ++a_iter;
-            ++b_iter;
+    if (lin_dropping) {
+        for (size_t i = 0; i < A.num_rows; i++) {
+            int row_count = lin_param + (int) (A.row_offsets[i+1] - A.row_offsets[i]);
+            limits[i] = row_count < 1 ? 1 : row_count;
         }
-        else if (a_ind < b_ind) 
-            ++a_iter;
-        else 
-            ++b_iter;
     }
 
-    return sum;
+    return limits;
 }
 
-
+// row[targets[t]] += scales[t] * coefficients[t] * row[j] for every t.  The updates touch
+// distinct rows and only read row j, so they run in parallel once the pool has been grown.
 template<typename IndexType, typename ValueType>
-void vector_add_inplace_drop(detail::ainv_matrix_row<IndexType, ValueType> &result, ValueType mult, const detail::ainv_matrix_row<IndexType, ValueType> &operand, ValueType tolerance, int nonzeros_this_row)
+void update_rows(ainv_row_store<IndexType, ValueType> &store, IndexType j,
+                 const std::vector<IndexType> &targets, const std::vector<ValueType> &coefficients, ValueType scale,
+                 const std::vector<int> &limits, ValueType tolerance,
+                 ainv_workspace<IndexType, ValueType> &work)
 {
-    // write into result:
-    // result += mult * operand
-    // but dropping any terms from (mult * operand) if they are less than tolerance
+    const long count = (long) targets.size();
 
-    for (typename detail::ainv_matrix_row<IndexType, ValueType>::const_iterator op_iter = operand.begin(); op_iter != operand.end(); ++op_iter) {
-        IndexType i = op_iter->first;
-        ValueType term = mult * op_iter->second.value;
-        ValueType abs_term = term < 0 ? -term : term;
+    for (long t = 0; t < count; t++) {
+        size_t bound = store.size(targets[t]) + store.size(j);
+        if (limits[targets[t]] >= 0)
+            bound = std::min(bound, (size_t) limits[targets[t]]);
+        store.reserve(targets[t], bound);
+    }
 
-        if (abs_term < tolerance)
-            continue;
+    if (count < ainv_parallel_threshold) {
+        for (long t = 0; t < count; t++) {
+            IndexType i = targets[t];
+            size_t n = sparse_axpy_drop(store.indices(i), store.values(i), store.size(i), scale * coefficients[t],
+                                        store.indices(j), store.values(j), store.size(j), tolerance, limits[i], work);
+            store.assign(i, &work.indices[0], &work.values[0], n);
+        }
+        return;
+    }
 
-        // We use a combination of 2 dropping strategies: a standard drop tolerance, as well as a bound on the 
-        // number of non-zeros per row.  if we've already reached that maximum size
-        // and this would add a new entry to result, we add it only if it is larger than one of the current entries 
-        // in which case we remove that element in its place.  
-        // This idea has been applied to IC factorization, but not to AINV as far as I'm aware.
-        // See: Lin, C. and More, J. J. 1999. Incomplete Cholesky Factorizations with Limited Memory. 
-        //      SIAM J. Sci. Comput. 21, 1 (Aug. 1999), 24-45. 
-
-        // can improve this by storing min idx & min_abs_val for each matrix row, and keeping up to date.
-        // as new entry is considered, skip if below min_val.  Otherwise, remove entry corresponding to min_val, insert new entry, and search for the new min.
-        // best case, this cuts from O(n) to O(1).  Worst case stays as before.
-        // even better: could i just use a heap?  i need both the map for fast inserts & deletes, and a heap to maintain lowest entry
-        // this makes it O(log n) worst case, i think...
-        // idea: instead of using a map for the matrix rows, wrap it in a struct that also maintains a heap of entries by abs_value
-        if (result.has_entry_at_index(i))
-            result.add_to_value(i, term);
-        else {
-          if (nonzeros_this_row < 0 || result.size() < (size_t) nonzeros_this_row) {
-            // there is an empty slot left, so just insert
-            result.insert(i, term);
-          }
-          else {
-            // check if this is larger than one of the existing values.  If so, replace the smallest value.
-            result.replace_min_if_greater(i, term);
-          }
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+    {
+        ainv_workspace<IndexType, ValueType> local;
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 16)
+#endif
+        for (long t = 0; t < count; t++) {
+            IndexType i = targets[t];
+            size_t n = sparse_axpy_drop(store.indices(i), store.values(i), store.size(i), scale * coefficients[t],
+                                        store.indices(j), store.values(j), store.size(j), tolerance, limits[i], local);
+            store.assign(i, &local.indices[0], &local.values[0], n);
         }
     }
 }
 
 template<typename IndexTypeA, typename ValueTypeA, typename IndexTypeB, typename ValueTypeB, typename MemorySpaceB>
-void convert_to_device_csr(const std::vector<detail::ainv_matrix_row<IndexTypeA, ValueTypeA> > &src, cusp::hyb_matrix<IndexTypeB, ValueTypeB, MemorySpaceB> &dst)
+void convert_to_device_csr(const ainv_row_store<IndexTypeA, ValueTypeA> &src, cusp::hyb_matrix<IndexTypeB, ValueTypeB, MemorySpaceB> &dst)
 {
-  // convert wt to csr
-    IndexTypeA nnz = 0;
-    IndexTypeA n = src.size();
-
-    int i;
-    for (i=0; i < n; i++)
-      nnz += src[i].size();
+    IndexTypeA n = src.num_rows();
 
-    cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_src(n, n, nnz);
+    cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_src(n, n, src.num_entries());
 
     IndexTypeA pos = 0;
     host_src.row_offsets[0] = 0;
 
-    for (i=0; i < n; i++) {
-      typename detail::ainv_matrix_row<IndexTypeA, ValueTypeA>::const_iterator src_iter = src[i].begin();
-      while (src_iter != src[i].end()) {
-        host_src.column_indices[pos] = src_iter->first;
-        host_src.values        [pos] = src_iter->second.value;
-
-        ++src_iter;
-        ++pos;
-      }
+    for (IndexTypeA i = 0; i < n; i++) {
+      std::copy(src.indices(i), src.indices(i) + src.size(i), host_src.column_indices.begin() + pos);
+      std::copy(src.values(i),  src.values(i)  + src.size(i), host_src.values.begin()         + pos);
+      pos += src.size(i);
       host_src.row_offsets[i+1] = pos;
     }
 
-    // copy to device & transpose
+    // copy to device
     dst = host_src;
 }
 
-
-
 } // end namespace detail
 
 
@@ -383,59 +363,47 @@ template <typename ValueType, typename MemorySpace>
     ::nonsym_bridson_ainv(const MatrixTypeA & A, ValueType drop_tolerance, int nonzero_per_row, bool lin_dropping, int lin_param)
         : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_rows)
     {
-        typename MatrixTypeA::index_type n = A.num_rows;
+        typedef typename MatrixTypeA::index_type IndexTypeA;
+        typedef typename MatrixTypeA::value_type ValueTypeA;
+
+        IndexTypeA n = A.num_rows;
         MatrixTypeA At;
         cusp::transpose(A, At);
 
         // copy A, At to host
-        typename cusp::csr_matrix<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type, host_memory> host_A = A;
-        typename cusp::csr_matrix<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type, host_memory> host_At = At;
+        cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_A = A;
+        cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_At = At;
         cusp::array1d<ValueType, host_memory> host_diagonals(n);
-        
-        // perform factorization
-        typename std::vector<detail::ainv_matrix_row<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> > wt_factor(n);
-        typename std::vector<detail::ainv_matrix_row<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> > z_factor(n);
 
-        typename MatrixTypeA::index_type i,j;
-        for (i=0; i < n; i++) {
-          wt_factor[i].insert(i, (typename MatrixTypeA::value_type)1); 
-          z_factor[i].insert(i, (typename MatrixTypeA::value_type)1); 
-        }
+        std::vector<int> limits = detail::row_nonzero_limits(host_A, nonzero_per_row, lin_dropping, lin_param);
 
-        typename std::map<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> u, l;
+        // perform factorization
+        detail::ainv_row_store<IndexTypeA, ValueTypeA> wt_factor(n);
+        detail::ainv_row_store<IndexTypeA, ValueTypeA> z_factor(n);
+
+        detail::ainv_spa<IndexTypeA, ValueTypeA> u(n), l(n);
+        detail::ainv_workspace<IndexTypeA, ValueTypeA> work;
+        std::vector<IndexTypeA> targets;
+        std::vector<ValueTypeA> coefficients;
 
-        for (j=0; j < n; j++)
+        for (IndexTypeA j = 0; j < n; j++)
         {
-          cusp::precond::detail::matrix_vector_product(host_At, wt_factor[j], u);
-          cusp::precond::detail::matrix_vector_product(host_A, z_factor[j], l);
-          typename MatrixTypeA::value_type p = detail::dot_product(wt_factor[j], l);
-          //could also do: typename MatrixTypeA::value_type p = detail::dot_product(z_factor[j], u);
+          detail::matrix_vector_product(host_At, wt_factor.indices(j), wt_factor.values(j), wt_factor.size(j), u);
+          detail::matrix_vector_product(host_A,  z_factor.indices(j),  z_factor.values(j),  z_factor.size(j),  l);
+          ValueTypeA p = detail::dot_product(wt_factor.indices(j), wt_factor.values(j), wt_factor.size(j), l);
+          //could also do: ValueTypeA p = detail::dot_product(z_factor.indices(j), z_factor.values(j), z_factor.size(j), u);
           host_diagonals[j] = (ValueType) (1.0/p);
 
           // for i = j+1 to n, skipping where u_i == 0
-          // this should be a O(1)-time operation, since u is a sparse vector
-          for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-              row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]); 
-              if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(z_factor[i], -u_iter->second/p, z_factor[j], drop_tolerance, row_count);
-          }
-
-          for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator l_iter = l.upper_bound(j); l_iter != l.end(); ++l_iter) {
-            i = l_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-              row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]); 
-              if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(wt_factor[i], -l_iter->second/p, wt_factor[j], drop_tolerance, row_count);
-          }
-
+          targets.clear();
+          coefficients.clear();
+          detail::entries_after(u, j, targets, coefficients);
+          detail::update_rows(z_factor, j, targets, coefficients, ValueTypeA(-1)/p, limits, (ValueTypeA) drop_tolerance, work);
+
+          targets.clear();
+          coefficients.clear();
+          detail::entries_after(l, j, targets, coefficients);
+          detail::update_rows(wt_factor, j, targets, coefficients, ValueTypeA(-1)/p, limits, (ValueTypeA) drop_tolerance, work);
         }
 
         // copy w_factor into w, w_t
@@ -469,42 +437,36 @@ template <typename ValueType, typename MemorySpace>
     ::bridson_ainv(const MatrixTypeA & A, ValueType drop_tolerance, int nonzero_per_row, bool lin_dropping, int lin_param)
         : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_rows)
     {
-        typename MatrixTypeA::index_type n = A.num_rows;
+        typedef typename MatrixTypeA::index_type IndexTypeA;
+        typedef typename MatrixTypeA::value_type ValueTypeA;
+
+        IndexTypeA n = A.num_rows;
   
         // copy A to host
-        typename cusp::csr_matrix<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type, host_memory> host_A = A;
+        cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_A = A;
         cusp::array1d<ValueType, host_memory> host_diagonals(n);
-        
 
-        // perform factorization
-        typename std::vector<detail::ainv_matrix_row<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> > w_factor(n);
+        std::vector<int> limits = detail::row_nonzero_limits(host_A, nonzero_per_row, lin_dropping, lin_param);
 
-        typename MatrixTypeA::index_type i,j;
-        for (i=0; i < n; i++) {
-          w_factor[i].insert(i, (typename MatrixTypeA::value_type)1); 
-        }
+        // perform factorization
+        detail::ainv_row_store<IndexTypeA, ValueTypeA> w_factor(n);
 
-        typename std::map<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> u;
+        detail::ainv_spa<IndexTypeA, ValueTypeA> u(n);
+        detail::ainv_workspace<IndexTypeA, ValueTypeA> work;
+        std::vector<IndexTypeA> targets;
+        std::vector<ValueTypeA> coefficients;
 
-        for (j=0; j < n; j++)
+        for (IndexTypeA j = 0; j < n; j++)
         {
-          cusp::precond::detail::matrix_vector_product(host_A, w_factor[j], u);
-          typename MatrixTypeA::value_type p = detail::dot_product(w_factor[j], u);
+          detail::matrix_vector_product(host_A, w_factor.indices(j), w_factor.values(j), w_factor.size(j), u);
+          ValueTypeA p = detail::dot_product(w_factor.indices(j), w_factor.values(j), w_factor.size(j), u);
           host_diagonals[j] = (ValueType) (1.0/p);
 
           // for i = j+1 to n, skipping where u_i == 0
-          // this should be a O(1)-time operation, since u is a sparse vector
-          for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-              row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]); 
-              if (row_count < 1) row_count = 1;
-            }
-
-            detail::vector_add_inplace_drop(w_factor[i], -u_iter->second/p, w_factor[j], drop_tolerance, row_count);
-          }
-
+          targets.clear();
+          coefficients.clear();
+          detail::entries_after(u, j, targets, coefficients);
+          detail::update_rows(w_factor, j, targets, coefficients, ValueTypeA(-1)/p, limits, (ValueTypeA) drop_tolerance, work);
         }
 
         // copy diagonal & w_factor into w, w_t
@@ -535,40 +497,36 @@ template <typename ValueType, typename MemorySpace>
     ::scaled_bridson_ainv(const MatrixTypeA & A, ValueType drop_tolerance, int nonzero_per_row, bool lin_dropping, int lin_param)
         : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_rows)
     {
-        typename MatrixTypeA::index_type n = A.num_rows;
+        typedef typename MatrixTypeA::index_type IndexTypeA;
+        typedef typename MatrixTypeA::value_type ValueTypeA;
+
+        IndexTypeA n = A.num_rows;
   
         // copy A to host
-        typename cusp::csr_matrix<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type, host_memory> host_A = A;
+        cusp::csr_matrix<IndexTypeA, ValueTypeA, host_memory> host_A = A;
+
+        std::vector<int> limits = detail::row_nonzero_limits(host_A, nonzero_per_row, lin_dropping, lin_param);
         
         // perform factorization
-        typename std::vector<detail::ainv_matrix_row<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> > w_factor(n);
-
-        typename MatrixTypeA::index_type i,j;
-        for (i=0; i < n; i++) {
-          w_factor[i].insert(i, (typename MatrixTypeA::value_type)1); 
-        }
+        detail::ainv_row_store<IndexTypeA, ValueTypeA> w_factor(n);
 
-        typename std::map<typename MatrixTypeA::index_type, typename MatrixTypeA::value_type> u;
+        detail::ainv_spa<IndexTypeA, ValueTypeA> u(n);
+        detail::ainv_workspace<IndexTypeA, ValueTypeA> work;
+        std::vector<IndexTypeA> targets;
+        std::vector<ValueTypeA> coefficients;
 
-        for (j=0; j < n; j++) {
-          cusp::precond::detail::matrix_vector_product(host_A, w_factor[j], u);
-          typename MatrixTypeA::value_type p = detail::dot_product(w_factor[j], u);
+        for (IndexTypeA j = 0; j < n; j++) {
+          detail::matrix_vector_product(host_A, w_factor.indices(j), w_factor.values(j), w_factor.size(j), u);
+          ValueTypeA p = detail::dot_product(w_factor.indices(j), w_factor.values(j), w_factor.size(j), u);
 
-          detail::vector_scalar(u, (typename MatrixTypeA::value_type) (1.0/sqrt((ValueType) p)));
-          w_factor[j].mult_by_scalar((typename MatrixTypeA::value_type) (1.0/sqrt((ValueType) p)));
+          ValueTypeA scale = (ValueTypeA) (1.0/sqrt((ValueType) p));
+          w_factor.mult_by_scalar(j, scale);
 
           // for i = j+1 to n, skipping where u_i == 0
-          // this should be a O(1)-time operation, since u is a sparse vector
-          for (typename std::map<typename MatrixTypeA::index_type,typename MatrixTypeA::value_type>::const_iterator u_iter = u.upper_bound(j); u_iter != u.end(); ++u_iter) {
-            i = u_iter->first;
-            int row_count = nonzero_per_row;
-            if (lin_dropping) {
-              row_count = lin_param + (int) (host_A.row_offsets[i+1] - host_A.row_offsets[i]); 
-              if (row_count < 1) row_count = 1;
-            }
-            detail::vector_add_inplace_drop(w_factor[i], -u_iter->second, w_factor[j], drop_tolerance, row_count);
-          }
-
+          targets.clear();
+          coefficients.clear();
+          detail::entries_after(u, j, targets, coefficients);
+          detail::update_rows(w_factor, j, targets, coefficients, -scale, limits, (ValueTypeA) drop_tolerance, work);
         }
 
         // copy w_factor into w:
@@ -588,4 +546,3 @@ template <typename ValueType, typename MemorySpace>
 
 } // end namespace precond
 } // end namespace cusp
-
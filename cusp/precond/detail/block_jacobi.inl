@@ -0,0 +1,327 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file block_jacobi.inl
+ *  \brief Inline file for block_jacobi.h
+ */
+
+#include <cusp/cmath.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/detail/host/reference/fixed_size.h>
+
+#include <algorithm>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// minimum number of blocks before they are processed in parallel
+const long block_jacobi_parallel_threshold = 256;
+
+// Gauss-Jordan inversion with partial pivoting of the n x n row-major
+// block A, which is overwritten; returns false if A is singular.
+// N > 0 fixes the size at compile time so the loops can be unrolled.
+template <int N, typename T>
+bool gauss_jordan_invert(T * A, T * Ainv, int size)
+{
+    const int n = N > 0 ? N : size;
+
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            Ainv[i * n + j] = (i == j) ? T(1) : T(0);
+
+    for (int k = 0; k < n; k++)
+    {
+        int p = k;
+        for (int i = k + 1; i < n; i++)
+            if (cusp::abs(A[i * n + k]) > cusp::abs(A[p * n + k]))
+                p = i;
+
+        if (A[p * n + k] == T(0))
+            return false;
+
+        if (p != k)
+        {
+            std::swap_ranges(A    + p * n, A    + (p + 1) * n, A    + k * n);
+            std::swap_ranges(Ainv + p * n, Ainv + (p + 1) * n, Ainv + k * n);
+        }
+
+        T pivot = T(1) / A[k * n + k];
+        for (int j = 0; j < n; j++)
+        {
+            A   [k * n + j] *= pivot;
+            Ainv[k * n + j] *= pivot;
+        }
+
+        for (int i = 0; i < n; i++)
+        {
+            T f = A[i * n + k];
+            if (i == k || f == T(0))
+                continue;
+            for (int j = 0; j < n; j++)
+            {
+                A   [i * n + j] -= f * A   [k * n + j];
+                Ainv[i * n + j] -= f * Ainv[k * n + j];
+            }
+        }
+    }
+
+    return true;
+}
+
+template <typename T>
+bool invert_block(T * A, T * Ainv, int n)
+{
+    switch (n)
+    {
+        case 1: return gauss_jordan_invert<1>(A, Ainv, n);
+        case 2: return gauss_jordan_invert<2>(A, Ainv, n);
+        case 3: return gauss_jordan_invert<3>(A, Ainv, n);
+        case 4: return gauss_jordan_invert<4>(A, Ainv, n);
+        case 5: return gauss_jordan_invert<5>(A, Ainv, n);
+        case 6: return gauss_jordan_invert<6>(A, Ainv, n);
+        case 7: return gauss_jordan_invert<7>(A, Ainv, n);
+        case 8: return gauss_jordan_invert<8>(A, Ainv, n);
+    }
+
+    return gauss_jordan_invert<0>(A, Ainv, n);
+}
+
+// y = Ainv * x for one block of N unknowns, x and y may alias
+template <int N, typename T>
+struct block_apply
+{
+    static void apply(const T * Ainv, const T * x, T * y)
+    {
+        T t[N];
+        for (int i = 0; i < N; i++)
+            t[i] = T(0);
+        ::matvec<N,N,1,1>(Ainv, x, t);
+        for (int i = 0; i < N; i++)
+            y[i] = t[i];
+    }
+};
+
+template <typename T>
+void apply_block(const T * Ainv, const T * x, T * y, int n, T * t)
+{
+    switch (n)
+    {
+        case 1: y[0] = Ainv[0] * x[0]; return;
+        case 2: block_apply<2,T>::apply(Ainv, x, y); return;
+        case 3: block_apply<3,T>::apply(Ainv, x, y); return;
+        case 4: block_apply<4,T>::apply(Ainv, x, y); return;
+        case 5: block_apply<5,T>::apply(Ainv, x, y); return;
+        case 6: block_apply<6,T>::apply(Ainv, x, y); return;
+        case 7: block_apply<7,T>::apply(Ainv, x, y); return;
+        case 8: block_apply<8,T>::apply(Ainv, x, y); return;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        T sum = T(0);
+        for (int j = 0; j < n; j++)
+            sum += Ainv[i * n + j] * x[j];
+        t[i] = sum;
+    }
+    std::copy(t, t + n, y);
+}
+
+// all blocks of the same size N, so the size dispatch leaves the loop
+template <int N, typename T>
+void apply_uniform_blocks(const T * inverses, const T * x, T * y, long num_blocks)
+{
+#if defined(_OPENMP)
+#pragma omp parallel for if (num_blocks >= block_jacobi_parallel_threshold)
+#endif
+    for (long k = 0; k < num_blocks; k++)
+        block_apply<N,T>::apply(inverses + k * N * N, x + k * N, y + k * N);
+}
+
+} // end namespace detail
+
+
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    void block_jacobi<ValueType,MemorySpace>
+    ::setup(const MatrixType& A)
+    {
+        const long num_blocks = block_offsets.size() - 1;
+
+        // dense storage for every block, one after the other
+        inverse_offsets.resize(num_blocks + 1);
+        inverse_offsets[0] = 0;
+        for (long k = 0; k < num_blocks; k++)
+        {
+            const int n = block_offsets[k + 1] - block_offsets[k];
+            inverse_offsets[k + 1] = inverse_offsets[k] + n * n;
+        }
+        inverses.resize(inverse_offsets[num_blocks]);
+
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> B(A);
+
+        bool singular = false;
+
+#if defined(_OPENMP)
+#pragma omp parallel if (num_blocks >= detail::block_jacobi_parallel_threshold)
+#endif
+        {
+            cusp::array1d<ValueType, cusp::host_memory> block;
+
+#if defined(_OPENMP)
+#pragma omp for
+#endif
+            for (long k = 0; k < num_blocks; k++)
+            {
+                const int begin = block_offsets[k];
+                const int end   = block_offsets[k + 1];
+                const int n     = end - begin;
+
+                // gather the diagonal block, summing duplicate entries
+                block.assign(n * n, ValueType(0));
+                for (int i = begin; i < end; i++)
+                    for (int jj = B.row_offsets[i]; jj < B.row_offsets[i + 1]; jj++)
+                    {
+                        const int j = B.column_indices[jj];
+                        if (begin <= j && j < end)
+                            block[(i - begin) * n + (j - begin)] += B.values[jj];
+                    }
+
+                if (n > 0 && !detail::invert_block(&block[0], &inverses[inverse_offsets[k]], n))
+                {
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+                    singular = true;
+                }
+            }
+        }
+
+        if (singular)
+            throw cusp::runtime_exception("block_jacobi: singular diagonal block");
+    }
+
+// constructors
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    block_jacobi<ValueType,MemorySpace>
+    ::block_jacobi(const MatrixType& A, size_t block_size)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, 0),
+          block_size_(block_size)
+    {
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("block_jacobi: matrix must be square");
+        if (block_size == 0)
+            throw cusp::invalid_input_exception("block_jacobi: block size must be positive");
+
+        const size_t num_blocks = (A.num_rows + block_size - 1) / block_size;
+
+        block_offsets.resize(num_blocks + 1);
+        for (size_t k = 0; k < num_blocks; k++)
+            block_offsets[k] = k * block_size;
+        block_offsets[num_blocks] = A.num_rows;
+
+        // a short last block is applied separately
+        if (A.num_rows % block_size != 0)
+            block_size_ = num_blocks == 1 ? A.num_rows : 0;
+
+        setup(A);
+        Parent::num_entries = inverses.size();
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType, typename OffsetMemorySpace>
+    block_jacobi<ValueType,MemorySpace>
+    ::block_jacobi(const MatrixType& A, const cusp::array1d<int, OffsetMemorySpace>& offsets)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, 0),
+          block_size_(0), block_offsets(offsets)
+    {
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("block_jacobi: matrix must be square");
+        if (block_offsets.size() < 1 || block_offsets[0] != 0 ||
+            size_t(block_offsets[block_offsets.size() - 1]) != A.num_rows)
+            throw cusp::invalid_input_exception("block_jacobi: block offsets must range from 0 to the number of rows");
+        for (size_t k = 0; k + 1 < block_offsets.size(); k++)
+            if (block_offsets[k + 1] < block_offsets[k])
+                throw cusp::invalid_input_exception("block_jacobi: block offsets must be nondecreasing");
+
+        // blocks of equal size take the specialized path
+        if (block_offsets.size() > 1)
+        {
+            block_size_ = block_offsets[1] - block_offsets[0];
+            for (size_t k = 1; k + 1 < block_offsets.size(); k++)
+                if (size_t(block_offsets[k + 1] - block_offsets[k]) != block_size_)
+                    block_size_ = 0;
+        }
+
+        setup(A);
+        Parent::num_entries = inverses.size();
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void block_jacobi<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y) const
+    {
+        const long num_blocks = block_offsets.size() - 1;
+
+        if (num_blocks == 0 || Parent::num_rows == 0)
+            return;
+
+        const ValueType * X = &x[0];
+        ValueType * Y = &y[0];
+        const ValueType * D = &inverses[0];
+
+        switch (block_size_)
+        {
+            case 1: detail::apply_uniform_blocks<1>(D, X, Y, num_blocks); return;
+            case 2: detail::apply_uniform_blocks<2>(D, X, Y, num_blocks); return;
+            case 3: detail::apply_uniform_blocks<3>(D, X, Y, num_blocks); return;
+            case 4: detail::apply_uniform_blocks<4>(D, X, Y, num_blocks); return;
+            case 5: detail::apply_uniform_blocks<5>(D, X, Y, num_blocks); return;
+            case 6: detail::apply_uniform_blocks<6>(D, X, Y, num_blocks); return;
+            case 7: detail::apply_uniform_blocks<7>(D, X, Y, num_blocks); return;
+            case 8: detail::apply_uniform_blocks<8>(D, X, Y, num_blocks); return;
+        }
+
+        // variable or large blocks
+#if defined(_OPENMP)
+#pragma omp parallel if (num_blocks >= detail::block_jacobi_parallel_threshold)
+#endif
+        {
+            cusp::array1d<ValueType, cusp::host_memory> t;
+
+#if defined(_OPENMP)
+#pragma omp for
+#endif
+            for (long k = 0; k < num_blocks; k++)
+            {
+                const int begin = block_offsets[k];
+                const int n     = block_offsets[k + 1] - begin;
+                if (n > 8 && t.size() < size_t(n))
+                    t.resize(n);
+                detail::apply_block(D + inverse_offsets[k], X + begin, Y + begin, n, n > 8 ? &t[0] : (ValueType *) 0);
+            }
+        }
+    }
+
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,218 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file deflation.inl
+ *  \brief Inline file for deflation.h
+ */
+
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+#include <cusp/precond/diagonal.h>
+
+#include <cusp/detail/format_utils.h>
+#include <cusp/detail/spectral_radius.h>
+
+#include <thrust/fill.h>
+#include <thrust/sequence.h>
+#include <thrust/transform.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    deflation<ValueType,MemorySpace>
+    ::deflation(const MatrixType& A, deflation_smoother smoother, deflation_variant variant,
+                size_t max_coarse_size, ValueType theta)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_entries),
+          smoother(smoother), variant(variant)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        SetupMatrixType A_(A);
+
+        // Z is the product of the tentative prolongators, E the matching Galerkin product
+        SetupMatrixType Z_;
+        SetupMatrixType E_(A_);
+        cusp::array1d<ValueType,MemorySpace> B(A.num_rows, ValueType(1.0));
+        bool coarsened = false;
+
+        while (E_.num_rows > max_coarse_size)
+        {
+            cusp::array1d<int,MemorySpace> aggregates;
+            {
+                SetupMatrixType C;
+                detail::symmetric_strength_of_connection(E_, C, theta);
+
+                aggregates.resize(C.num_rows);
+                cusp::blas::fill(aggregates, 0);
+                detail::standard_aggregation(C, aggregates);
+            }
+
+            SetupMatrixType T;
+            cusp::array1d<ValueType,MemorySpace> B_coarse;
+            detail::fit_candidates(aggregates, B, T, B_coarse);
+
+            // stop when aggregation makes no progress
+            if (T.num_cols == 0 || T.num_cols >= E_.num_rows)
+                break;
+
+            SetupMatrixType Tt;
+            SetupMatrixType ET;
+            SetupMatrixType TtET;
+            cusp::transpose(T, Tt);
+            cusp::multiply(E_, T, ET);
+            cusp::multiply(Tt, ET, TtET);
+            E_.swap(TtET);
+
+            if (coarsened)
+            {
+                SetupMatrixType ZT;
+                cusp::multiply(Z_, T, ZT);
+                Z_.swap(ZT);
+            }
+            else
+            {
+                Z_.swap(T);
+                coarsened = true;
+            }
+
+            B.swap(B_coarse);
+        }
+
+        // do not factor a large coarse matrix densely when aggregation stalls
+        if (E_.num_rows > max_coarse_size)
+            throw cusp::runtime_exception("deflation: aggregation stalled above max_coarse_size");
+
+        // a matrix that is already small is solved exactly, Z = I
+        if (!coarsened)
+        {
+            cusp::coo_matrix<int,ValueType,cusp::host_memory> I(A.num_rows, A.num_rows, A.num_rows);
+            thrust::sequence(I.row_indices.begin(),    I.row_indices.end());
+            thrust::sequence(I.column_indices.begin(), I.column_indices.end());
+            thrust::fill(I.values.begin(), I.values.end(), ValueType(1));
+            Z_ = I;
+        }
+
+        // factor E once
+        cusp::array2d<ValueType,cusp::host_memory> E_dense(E_);
+        E = cusp::detail::lu_solver<ValueType,cusp::host_memory>(E_dense);
+
+        // one-level smoother
+        if (smoother == deflation_jacobi)
+        {
+            cusp::detail::extract_diagonal(A_, diagonal_reciprocals);
+            thrust::transform(diagonal_reciprocals.begin(), diagonal_reciprocals.end(),
+                              diagonal_reciprocals.begin(), detail::reciprocal<ValueType>());
+        }
+        else
+        {
+            cusp::array1d<ValueType,cusp::host_memory> coef;
+            ValueType rho = cusp::detail::ritz_spectral_radius_symmetric(A_, 8);
+            cusp::relaxation::detail::chebyshev_polynomial_coefficients(rho, coef);
+            chebyshev = cusp::relaxation::polynomial<ValueType,MemorySpace>(A_, coef);
+        }
+
+        SetupMatrixType Zt_;
+        cusp::transpose(Z_, Zt_);
+
+        detail::setup_level_matrix(Z,  Z_);
+        detail::setup_level_matrix(Zt, Zt_);
+        detail::setup_level_matrix(matrix, A_);
+
+        q.resize(A.num_rows);
+        s.resize(A.num_rows);
+        z.resize(A.num_rows);
+        t.resize(A.num_rows);
+        coarse.resize(Z.num_cols);
+        coarse_b.resize(Z.num_cols);
+        coarse_x.resize(Z.num_cols);
+    }
+
+// x = Q b = Z E^-1 Z^T b
+template <typename ValueType, typename MemorySpace>
+    template <typename Array1, typename Array2>
+    void deflation<ValueType, MemorySpace>
+    ::coarse_solve(const Array1& b, Array2& x)
+    {
+        cusp::multiply(Zt, b, coarse);
+        coarse_b = coarse;
+        E(coarse_b, coarse_x);
+        coarse = coarse_x;
+        cusp::multiply(Z, coarse, x);
+    }
+
+// x = M^-1 b
+template <typename ValueType, typename MemorySpace>
+    template <typename Array1, typename Array2>
+    void deflation<ValueType, MemorySpace>
+    ::smooth(const Array1& b, Array2& x)
+    {
+        if (smoother == deflation_jacobi)
+            cusp::blas::xmy(diagonal_reciprocals, b, x);
+        else
+            chebyshev.presmooth(matrix, b, x);
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template <typename Array1, typename Array2>
+    void deflation<ValueType, MemorySpace>
+    ::initial_guess(const Array1& b, Array2& x)
+    {
+        coarse_solve(b, x);
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void deflation<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        if (variant == deflation_adef2)
+        {
+            // y = P^T M^-1 x + Q x = z + Q (x - A z) with z = M^-1 x
+            smooth(x, z);
+            cusp::multiply(matrix, z, t);
+            cusp::blas::axpby(x, t, s, ValueType(1), ValueType(-1));
+            coarse_solve(s, t);
+            cusp::blas::axpby(z, t, y, ValueType(1), ValueType(1));
+        }
+        else
+        {
+            // y = P^T M^-1 P x + Q x = z + Q (s - A z) + q
+            // with q = Q x, s = P x = x - A q and z = M^-1 s
+            coarse_solve(x, q);
+            cusp::multiply(matrix, q, t);
+            cusp::blas::axpby(x, t, s, ValueType(1), ValueType(-1));
+            smooth(s, z);
+            cusp::multiply(matrix, z, t);
+            cusp::blas::axpby(s, t, t, ValueType(1), ValueType(-1));
+            coarse_solve(t, t);
+            cusp::blas::axpbypcz(z, t, q, y, ValueType(1), ValueType(1), ValueType(1));
+        }
+    }
+
+} // end namespace precond
+} // end namespace cusp
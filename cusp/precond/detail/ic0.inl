@@ -0,0 +1,145 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ic0.inl
+ *  \brief Inline file for ic0.h
+ */
+
+#include <cusp/exception.h>
+#include <cusp/detail/level_schedule.h>
+#include <cusp/transpose.h>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace precond
+{
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    ic0<ValueType,MemorySpace>
+    ::ic0(const MatrixType& A, bool reorder)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_entries)
+    {
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> B;
+        cusp::array1d<int, cusp::host_memory> diagonal;
+
+        cusp::detail::sorted_csr_with_diagonal(A, B, diagonal, "ic0");
+
+        const int N = B.num_rows;
+
+        // keep the lower triangle, the diagonal is the last entry of each row
+        size_t num_entries = 0;
+        for (int i = 0; i < N; i++)
+            num_entries += diagonal[i] - B.row_offsets[i] + 1;
+
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> LL(N, N, num_entries);
+
+        num_entries = 0;
+        for (int i = 0; i < N; i++)
+        {
+            LL.row_offsets[i] = num_entries;
+
+            for (int jj = B.row_offsets[i]; jj <= diagonal[i]; jj++, num_entries++)
+            {
+                LL.column_indices[num_entries] = B.column_indices[jj];
+                LL.values[num_entries]         = B.values[jj];
+            }
+
+            diagonal[i] = num_entries - 1;
+        }
+        LL.row_offsets[N] = num_entries;
+
+        cusp::detail::level_schedule<int> L_schedule;
+        cusp::detail::build_level_schedule(LL, true, L_schedule);
+
+        // row-wise (up-looking) factorization in place
+        //   l_ik = (a_ik - sum_{j<k} l_ij l_kj) / l_kk
+        //   l_ii = sqrt(a_ii - sum_{j<i} l_ij^2)
+        for (size_t l = 0; l < L_schedule.num_levels(); l++)
+        {
+            const int begin = L_schedule.offsets[l];
+            const int end   = L_schedule.offsets[l + 1];
+
+#if defined(_OPENMP)
+#pragma omp parallel for if (end - begin >= cusp::detail::level_parallel_threshold)
+#endif
+            for (int p = begin; p < end; p++)
+            {
+                const int i = L_schedule.rows[p];
+
+                ValueType d = LL.values[diagonal[i]];
+
+                for (int kk = LL.row_offsets[i]; kk < diagonal[i]; kk++)
+                {
+                    const int k = LL.column_indices[kk];
+
+                    ValueType sum = LL.values[kk];
+
+                    // columns j < k shared by rows i and k
+                    int ii = LL.row_offsets[i];
+                    int jj = LL.row_offsets[k];
+
+                    while (ii < kk && jj < diagonal[k])
+                    {
+                        const int ci = LL.column_indices[ii];
+                        const int ck = LL.column_indices[jj];
+
+                        if (ci == ck)
+                            sum -= LL.values[ii++] * LL.values[jj++];
+                        else if (ci < ck)
+                            ii++;
+                        else
+                            jj++;
+                    }
+
+                    LL.values[kk] = sum / LL.values[diagonal[k]];
+
+                    d -= LL.values[kk] * LL.values[kk];
+                }
+
+                // a non-positive pivot becomes NaN and is reported below
+                LL.values[diagonal[i]] = std::sqrt(d);
+            }
+        }
+
+        for (int i = 0; i < N; i++)
+            if (!(LL.values[diagonal[i]] > ValueType(0)))
+                throw cusp::runtime_exception("ic0: non-positive pivot encountered");
+
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> LLt;
+        cusp::transpose(LL, LLt);
+
+        L.analyze(LL,   true,  false, cusp::triangular_solve_automatic, reorder);
+        Lt.analyze(LLt, false, false, cusp::triangular_solve_automatic, reorder);
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void ic0<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y) const
+    {
+        // L z = x, then L^T y = z in place
+        L.solve(x, y);
+        Lt.solve(y, y);
+    }
+
+} // end namespace precond
+} // end namespace cusp
+
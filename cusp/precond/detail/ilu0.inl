@@ -0,0 +1,110 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ilu0.inl
+ *  \brief Inline file for ilu0.h
+ */
+
+#include <cusp/exception.h>
+#include <cusp/detail/level_schedule.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    ilu0<ValueType,MemorySpace>
+    ::ilu0(const MatrixType& A, bool reorder)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_entries)
+    {
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> LU;
+        cusp::array1d<int, cusp::host_memory> diagonal;
+
+        cusp::detail::sorted_csr_with_diagonal(A, LU, diagonal, "ilu0");
+
+        cusp::detail::level_schedule<int> L_schedule;
+        cusp::detail::build_level_schedule(LU, true, L_schedule);
+
+        // row-wise (IKJ) factorization in place, row i only reads the
+        // finished rows k < i it depends on, i.e. rows of earlier levels
+        for (size_t l = 0; l < L_schedule.num_levels(); l++)
+        {
+            const int begin = L_schedule.offsets[l];
+            const int end   = L_schedule.offsets[l + 1];
+
+#if defined(_OPENMP)
+#pragma omp parallel for if (end - begin >= cusp::detail::level_parallel_threshold)
+#endif
+            for (int p = begin; p < end; p++)
+            {
+                const int i         = L_schedule.rows[p];
+                const int row_end_i = LU.row_offsets[i + 1];
+
+                for (int kk = LU.row_offsets[i]; kk < diagonal[i]; kk++)
+                {
+                    const int k         = LU.column_indices[kk];
+                    const int row_end_k = LU.row_offsets[k + 1];
+
+                    // l_ik = a_ik / u_kk
+                    ValueType l_ik = LU.values[kk] / LU.values[diagonal[k]];
+                    LU.values[kk] = l_ik;
+
+                    // a_ij -= l_ik * u_kj for j > k in the pattern of row i
+                    int ii = kk + 1;
+                    int jj = diagonal[k] + 1;
+
+                    while (ii < row_end_i && jj < row_end_k)
+                    {
+                        const int ci = LU.column_indices[ii];
+                        const int ck = LU.column_indices[jj];
+
+                        if (ci == ck)
+                            LU.values[ii++] -= l_ik * LU.values[jj++];
+                        else if (ci < ck)
+                            ii++;
+                        else
+                            jj++;
+                    }
+                }
+            }
+        }
+
+        for (int i = 0; i < (int) LU.num_rows; i++)
+            if (LU.values[diagonal[i]] == ValueType(0))
+                throw cusp::runtime_exception("ilu0: zero pivot encountered");
+
+        // L and U share the storage of LU, L has a unit diagonal
+        L.analyze(LU, true,  true,  cusp::triangular_solve_automatic, reorder);
+        U.analyze(LU, false, false, cusp::triangular_solve_automatic, reorder);
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void ilu0<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y) const
+    {
+        // L z = x, then U y = z in place
+        L.solve(x, y);
+        U.solve(y, y);
+    }
+
+} // end namespace precond
+} // end namespace cusp
+
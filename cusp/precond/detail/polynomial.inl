@@ -0,0 +1,222 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file polynomial.inl
+ *  \brief Inline file for polynomial.h
+ */
+
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/exception.h>
+#include <cusp/krylov/chebyshev.h>
+
+#include <cusp/detail/axpy_multiply.h>
+#include <cusp/detail/lu.h>
+#include <cusp/detail/spectral_radius.h>
+
+#include <thrust/for_each.h>
+#include <thrust/iterator/zip_iterator.h>
+
+#include <cmath>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// coefficients c of p(lambda) = sum_j c_j T_j(2 lambda / lambda_max - 1) that
+// minimize sum_i (1 - lambda_i p(lambda_i))^2 over Chebyshev nodes of [0, lambda_max]
+template <typename ValueType>
+void least_squares_polynomial_coefficients(const ValueType lambda_max, const size_t degree,
+                                           cusp::array1d<ValueType,cusp::host_memory>& coefficients)
+{
+    const size_t n = degree + 1;
+    const size_t m = 4 * n;
+
+    // normal equations G c = h
+    cusp::array2d<double,cusp::host_memory> G(n, n, 0.0);
+    cusp::array1d<double,cusp::host_memory> h(n, 0.0);
+    cusp::array1d<double,cusp::host_memory> T(n);
+
+    for (size_t i = 0; i < m; i++)
+    {
+        const double s      = std::cos(M_PI * (double(i) + 0.5) / double(m));
+        const double lambda = 0.5 * double(lambda_max) * (1.0 + s);
+
+        // T_j(s) by the three-term recurrence
+        T[0] = 1.0;
+        if (n > 1) T[1] = s;
+        for (size_t j = 2; j < n; j++)
+            T[j] = 2.0 * s * T[j-1] - T[j-2];
+
+        for (size_t j = 0; j < n; j++)
+        {
+            h[j] += lambda * T[j];
+            for (size_t k = 0; k < n; k++)
+                G(j,k) += lambda * lambda * T[j] * T[k];
+        }
+    }
+
+    cusp::array1d<double,cusp::host_memory> c(n);
+    cusp::detail::lu_solver<double,cusp::host_memory> solver(G);
+    solver(h, c);
+
+    coefficients.resize(n);
+    for (size_t j = 0; j < n; j++)
+        coefficients[j] = ValueType(c[j]);
+}
+
+} // end namespace detail
+
+// constructors
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    polynomial<ValueType,MemorySpace>
+    ::polynomial(const MatrixType& A, polynomial_kind kind, size_t degree)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_entries),
+          kind(kind), poly_degree(degree)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        // Ritz values underestimate the spectral radius, so widen the interval
+        upper = ValueType(1.1) * ValueType(cusp::detail::ritz_spectral_radius_symmetric(A, 8));
+        lower = upper / ValueType(30);
+
+        setup(A);
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    polynomial<ValueType,MemorySpace>
+    ::polynomial(const MatrixType& A, polynomial_kind kind, size_t degree,
+                 ValueType lambda_min, ValueType lambda_max)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, A.num_entries),
+          kind(kind), poly_degree(degree), lower(lambda_min), upper(lambda_max)
+    {
+        CUSP_PROFILE_SCOPED();
+
+        setup(A);
+    }
+
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    void polynomial<ValueType,MemorySpace>
+    ::setup(const MatrixType& A)
+    {
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("polynomial preconditioner requires a square matrix");
+
+        if (!(upper > ValueType(0)) || (kind == polynomial_chebyshev && !(ValueType(0) < lower && lower < upper)))
+            throw cusp::invalid_input_exception("polynomial preconditioner requires 0 < lambda_min < lambda_max");
+
+        matrix = A;
+
+        if (kind == polynomial_least_squares)
+            detail::least_squares_polynomial_coefficients(upper, poly_degree, coefficients);
+
+        r.resize(A.num_rows);
+        d.resize(A.num_rows);
+        t.resize(A.num_rows);
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void polynomial<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y) const
+    {
+        CUSP_PROFILE_SCOPED();
+
+        if (kind == polynomial_chebyshev)
+        {
+            // degree + 1 steps of the Chebyshev iteration for A y = x from y = 0
+            const ValueType theta = (upper + lower) / ValueType(2);
+            const ValueType delta = (upper - lower) / ValueType(2);
+            const ValueType sigma = theta / delta;
+
+            ValueType rho = ValueType(1) / sigma;
+
+            cusp::blas::copy(x, r);
+            cusp::blas::axpby(x, x, d, ValueType(1) / theta, ValueType(0));
+            cusp::blas::fill(y, ValueType(0));
+
+            for (size_t i = 0; i < poly_degree; i++)
+            {
+                // r <- r - A*d
+                cusp::detail::axpy_multiply(matrix, d, r, ValueType(-1), t);
+
+                ValueType rho_new = ValueType(1) / (ValueType(2) * sigma - rho);
+
+                // y <- y + d
+                // d <- rho_new * rho * d + 2 * rho_new / delta * r
+                thrust::for_each(thrust::make_zip_iterator(thrust::make_tuple(y.begin(), d.begin(), r.begin())),
+                                 thrust::make_zip_iterator(thrust::make_tuple(y.end(),   d.end(),   r.end())),
+                                 cusp::krylov::detail::chebyshev_update<ValueType>(rho_new * rho, ValueType(2) * rho_new / delta));
+
+                rho = rho_new;
+            }
+
+            cusp::blas::axpy(d, y, ValueType(1));
+        }
+        else if (kind == polynomial_neumann)
+        {
+            // y <- y + omega * (x - A*y), degree times from y = omega * x
+            const ValueType omega = ValueType(1) / upper;
+
+            cusp::blas::axpby(x, x, y, omega, ValueType(0));
+
+            for (size_t i = 0; i < poly_degree; i++)
+            {
+                cusp::blas::copy(x, r);
+                cusp::detail::axpy_multiply(matrix, y, r, ValueType(-1), t);
+                cusp::blas::axpy(r, y, omega);
+            }
+        }
+        else
+        {
+            // Clenshaw recurrence for sum_j c_j T_j(S) x with S = 2 A / lambda_max - I
+            //   b_j = c_j x + 2 S b_{j+1} - b_{j+2}
+            //   y   = c_0 x +   S b_1     - b_2
+            // r holds b_{j+1} and d holds b_{j+2}
+            const size_t n = coefficients.size();
+
+            cusp::blas::axpby(x, x, r, coefficients[n - 1], ValueType(0));
+            cusp::blas::fill(d, ValueType(0));
+
+            for (size_t j = n - 1; j-- > 1; )
+            {
+                cusp::blas::axpbypcz(x, r, d, d, coefficients[j], ValueType(-2), ValueType(-1));
+                cusp::detail::axpy_multiply(matrix, r, d, ValueType(4) / upper, t);
+                r.swap(d);
+            }
+
+            if (n == 1)
+            {
+                cusp::blas::copy(r, y);
+            }
+            else
+            {
+                cusp::blas::axpbypcz(x, r, d, y, coefficients[0], ValueType(-1), ValueType(-1));
+                cusp::detail::axpy_multiply(matrix, r, y, ValueType(2) / upper, t);
+            }
+        }
+    }
+
+} // end namespace precond
+} // end namespace cusp
+
@@ -15,6 +15,7 @@
  */
 
 #include <cusp/blas.h>
+#include <cusp/composite_operator.h>
 #include <cusp/elementwise.h>
 #include <cusp/multiply.h>
 #include <cusp/monitor.h>
@@ -42,32 +43,19 @@ namespace detail
 {
 
 
-template <typename MatrixType>
-struct Dinv_A : public cusp::linear_operator<typename MatrixType::value_type, typename MatrixType::memory_space>
-{
-    const MatrixType& A;
-    const cusp::precond::diagonal<typename MatrixType::value_type, typename MatrixType::memory_space> Dinv;
-
-    Dinv_A(const MatrixType& A)
-        : A(A), Dinv(A),
-          cusp::linear_operator<typename MatrixType::value_type, typename MatrixType::memory_space>(A.num_rows, A.num_cols, A.num_entries + A.num_rows)
-          {}
-
-    template <typename Array1, typename Array2>
-    void operator()(const Array1& x, Array2& y) const
-    {
-        cusp::multiply(A,x,y);
-        cusp::multiply(Dinv,y,y);
-    }
-};
-
 template <typename MatrixType>
 double estimate_rho_Dinv_A(const MatrixType& A)
 {
     typedef typename MatrixType::value_type   ValueType;
     typedef typename MatrixType::memory_space MemorySpace;
 
-    Dinv_A<MatrixType> Dinv_A(A);
+    cusp::array1d<ValueType,MemorySpace> Dinv;
+    cusp::detail::extract_diagonal(A, Dinv);
+    thrust::transform(Dinv.begin(), Dinv.end(), Dinv.begin(), detail::reciprocal<ValueType>());
+
+    // D^-1 A is applied lazily, one pass per product
+    cusp::diagonal_scaled_operator<cusp::array1d<ValueType,MemorySpace>, MatrixType>
+        Dinv_A = cusp::make_diagonal_scaled_operator(Dinv, A);
 
     return cusp::detail::ritz_spectral_radius(Dinv_A, 8);
 }
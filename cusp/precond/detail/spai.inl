@@ -0,0 +1,291 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file spai.inl
+ *  \brief Inline file for spai.h
+ */
+
+#include <cusp/cmath.h>
+#include <cusp/complex.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/exception.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace cusp
+{
+namespace precond
+{
+namespace detail
+{
+
+// per-thread scratch space for the least-squares problem of one column
+template <typename ValueType>
+struct spai_workspace
+{
+    std::vector<int> in_J;        // in_J[j] == k if column j is in the pattern of column k
+    std::vector<int> in_I;        // in_I[i] == k if row i is touched by that pattern
+    std::vector<int> position;    // position of row i in I
+    std::vector<int> J, I, frontier, next;
+    std::vector<ValueType> dense; // A(I,J), column major
+    std::vector<ValueType> rhs;
+    std::vector<ValueType> rdiag;
+
+    spai_workspace(size_t n) : in_J(n, -1), in_I(n, -1), position(n) {}
+};
+
+// J = pattern of column k of (I + A)^power, found by following the
+// columns of A (the rows of At) power times from k
+template <typename Matrix, typename ValueType>
+void spai_column_pattern(const Matrix& At, int k, size_t power, spai_workspace<ValueType>& work)
+{
+    work.J.clear();
+    work.frontier.clear();
+
+    work.in_J[k] = k;
+    work.J.push_back(k);
+    work.frontier.push_back(k);
+
+    for (size_t p = 0; p < power && !work.frontier.empty(); p++)
+    {
+        work.next.clear();
+        for (size_t f = 0; f < work.frontier.size(); f++)
+        {
+            const int j = work.frontier[f];
+            for (int jj = At.row_offsets[j]; jj < At.row_offsets[j + 1]; jj++)
+            {
+                const int i = At.column_indices[jj];
+                if (work.in_J[i] != k)
+                {
+                    work.in_J[i] = k;
+                    work.J.push_back(i);
+                    work.next.push_back(i);
+                }
+            }
+        }
+        work.frontier.swap(work.next);
+    }
+}
+
+// least-squares solution of min || A x - b || for the m x n column major
+// matrix A by Householder QR; A and b are overwritten and x is returned
+// in the first n entries of b.  Returns false if A is rank deficient.
+template <typename ValueType>
+bool householder_least_squares(ValueType * A, ValueType * b, ValueType * rdiag, int m, int n)
+{
+    typedef typename cusp::norm_type<ValueType>::type Real;
+
+    if (m < n)
+        return false;
+
+    for (int j = 0; j < n; j++)
+    {
+        ValueType * a = A + j * m;
+
+        Real norm2 = 0;
+        for (int i = j; i < m; i++)
+            norm2 += cusp::abs(a[i]) * cusp::abs(a[i]);
+
+        if (norm2 == Real(0))
+            return false;
+
+        // reflect a(j:m) onto alpha * e_j with v = a(j:m) - alpha e_j stored
+        // in place; alpha has the opposite phase of a[j] to avoid cancellation
+        const Real      magnitude = cusp::abs(a[j]);
+        const ValueType phase     = magnitude == Real(0) ? ValueType(1) : a[j] / magnitude;
+        const ValueType alpha     = -phase * cusp::sqrt(norm2);
+        a[j] -= alpha;
+        rdiag[j] = alpha;
+
+        Real vnorm2 = 0;
+        for (int i = j; i < m; i++)
+            vnorm2 += cusp::abs(a[i]) * cusp::abs(a[i]);
+
+        for (int c = j + 1; c <= n; c++)
+        {
+            // the right hand side is treated as column n
+            ValueType * y = (c < n) ? A + c * m : b;
+
+            // y -= 2 v (v^H y) / (v^H v)
+            ValueType s = 0;
+            for (int i = j; i < m; i++)
+                s += cusp::conj(a[i]) * y[i];
+            s = ValueType(2) * s / vnorm2;
+            for (int i = j; i < m; i++)
+                y[i] -= s * a[i];
+        }
+    }
+
+    // back substitution with R
+    for (int j = n - 1; j >= 0; j--)
+    {
+        ValueType sum = b[j];
+        for (int c = j + 1; c < n; c++)
+            sum -= A[c * m + j] * b[c];
+        b[j] = sum / rdiag[j];
+    }
+
+    return true;
+}
+
+// solve for the values of column k of M on the pattern in work.J
+template <typename Matrix, typename ValueType>
+bool spai_column(const Matrix& At, int k, spai_workspace<ValueType>& work)
+{
+    // rows reached by the columns in J
+    work.I.clear();
+    for (size_t c = 0; c < work.J.size(); c++)
+    {
+        const int j = work.J[c];
+        for (int jj = At.row_offsets[j]; jj < At.row_offsets[j + 1]; jj++)
+        {
+            const int i = At.column_indices[jj];
+            if (work.in_I[i] != k)
+            {
+                work.in_I[i] = k;
+                work.position[i] = work.I.size();
+                work.I.push_back(i);
+            }
+        }
+    }
+
+    const int m = work.I.size();
+    const int n = work.J.size();
+
+    // gather A(I,J), summing duplicate entries
+    work.dense.assign(size_t(m) * n, ValueType(0));
+    for (int c = 0; c < n; c++)
+    {
+        const int j = work.J[c];
+        for (int jj = At.row_offsets[j]; jj < At.row_offsets[j + 1]; jj++)
+            work.dense[size_t(c) * m + work.position[At.column_indices[jj]]] += At.values[jj];
+    }
+
+    // e_k restricted to I
+    work.rhs.assign(std::max(m, n), ValueType(0));
+    if (work.in_I[k] == k)
+        work.rhs[work.position[k]] = ValueType(1);
+
+    work.rdiag.resize(n);
+
+    return m > 0 && householder_least_squares(&work.dense[0], &work.rhs[0], &work.rdiag[0], m, n);
+}
+
+} // end namespace detail
+
+
+// constructor
+template <typename ValueType, typename MemorySpace>
+    template<typename MatrixType>
+    spai<ValueType,MemorySpace>
+    ::spai(const MatrixType& A, size_t pattern_power)
+        : linear_operator<ValueType,MemorySpace>(A.num_rows, A.num_cols, 0)
+    {
+        if (A.num_rows != A.num_cols)
+            throw cusp::invalid_input_exception("spai: matrix must be square");
+
+        const long N = A.num_rows;
+
+        // columns of A are the rows of At
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> B(A);
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> At;
+        cusp::transpose(B, At);
+
+        // Mt holds the columns of M as rows, first count the pattern sizes
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> Mt;
+        Mt.row_offsets.resize(N + 1);
+        Mt.row_offsets[0] = 0;
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+        {
+            detail::spai_workspace<ValueType> work(N);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 64)
+#endif
+            for (long k = 0; k < N; k++)
+            {
+                detail::spai_column_pattern(At, k, pattern_power, work);
+                Mt.row_offsets[k + 1] = work.J.size();
+            }
+        }
+
+        for (long k = 0; k < N; k++)
+            Mt.row_offsets[k + 1] += Mt.row_offsets[k];
+
+        Mt.resize(N, N, Mt.row_offsets[N]);
+
+        // then solve the independent least-squares problems
+        bool rank_deficient = false;
+
+#if defined(_OPENMP)
+#pragma omp parallel
+#endif
+        {
+            detail::spai_workspace<ValueType> work(N);
+
+#if defined(_OPENMP)
+#pragma omp for schedule(dynamic, 16)
+#endif
+            for (long k = 0; k < N; k++)
+            {
+                detail::spai_column_pattern(At, k, pattern_power, work);
+                std::sort(work.J.begin(), work.J.end());
+
+                if (!detail::spai_column(At, k, work))
+                {
+#if defined(_OPENMP)
+#pragma omp critical
+#endif
+                    rank_deficient = true;
+                    continue;
+                }
+
+                const int offset = Mt.row_offsets[k];
+                for (size_t c = 0; c < work.J.size(); c++)
+                {
+                    Mt.column_indices[offset + c] = work.J[c];
+                    Mt.values        [offset + c] = work.rhs[c];
+                }
+            }
+        }
+
+        if (rank_deficient)
+            throw cusp::runtime_exception("spai: rank deficient least-squares problem, matrix may be singular");
+
+        cusp::csr_matrix<int, ValueType, cusp::host_memory> M;
+        cusp::transpose(Mt, M);
+
+        inverse = M;
+        Parent::num_entries = M.num_entries;
+    }
+
+// linear operator
+template <typename ValueType, typename MemorySpace>
+    template <typename VectorType1, typename VectorType2>
+    void spai<ValueType, MemorySpace>
+    ::operator()(const VectorType1& x, VectorType2& y) const
+    {
+        cusp::multiply(inverse, x, y);
+    }
+
+} // end namespace precond
+} // end namespace cusp
@@ -0,0 +1,118 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ic0.h
+ *  \brief Incomplete Cholesky factorization with zero fill-in, IC(0)
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/triangular_solve.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! \p ic0 : incomplete Cholesky preconditioner with zero fill-in
+ *
+ *  Computes <tt>A ~ L L^T</tt> for a symmetric positive definite
+ *  matrix \c A, where \c L keeps the sparsity pattern of the lower
+ *  triangle of \c A.  Only the lower triangle of \c A is read.
+ *  Applying the preconditioner solves <tt>L L^T y = x</tt>, so \p ic0
+ *  is suitable for \p cg.
+ *
+ *  As with \p ilu0, the factorization is level scheduled, the
+ *  triangular solves use \p triangular_solver and \p reorder stores the
+ *  factors with the rows in level order.  The factorization runs on the host; \p MemorySpace
+ *  should be \c cusp::host_memory and \p ValueType a real type.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory)
+ *
+ *  The following code snippet demonstrates how to use an \p ic0
+ *  preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/ic0.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::host_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner with level-ordered storage
+ *  cusp::precond::ic0<float, cusp::host_memory> M(A, true);
+ *
+ *  // solve
+ *  cusp::krylov::cg(A, x, b, monitor, M);
+ *  \endcode
+ *
+ *  \see \p ilu0
+ */
+template <typename ValueType, typename MemorySpace>
+class ic0 : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    cusp::triangular_solver<int, ValueType> L;
+    cusp::triangular_solver<int, ValueType> Lt;
+
+public:
+    /*! construct an \p ic0 preconditioner
+     *
+     * \param A symmetric positive definite matrix to precondition
+     * \param reorder store the factors in level order
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square or
+     *         lacks a diagonal entry
+     * \throws cusp::runtime_exception if a non-positive pivot is encountered
+     */
+    template<typename MatrixType>
+    ic0(const MatrixType& A, bool reorder = false);
+
+    /*! number of levels in the schedules of \c L and \c L^T
+     */
+    size_t num_levels(void) const { return L.num_levels() + Lt.num_levels(); }
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/ic0.inl>
@@ -0,0 +1,122 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file ilu0.h
+ *  \brief Incomplete LU factorization with zero fill-in, ILU(0)
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/triangular_solve.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! \p ilu0 : incomplete LU preconditioner with zero fill-in
+ *
+ *  Computes <tt>A ~ L U</tt> where \c L is unit lower triangular,
+ *  \c U is upper triangular and both keep the sparsity pattern of
+ *  the corresponding triangle of \c A.  Applying the preconditioner
+ *  solves <tt>L U y = x</tt>.
+ *
+ *  Setup computes a level schedule for the dependency DAG of \c L once.
+ *  The rows of each level are independent, so the factorization
+ *  processes one level at a time with the rows of a level in parallel
+ *  (with OpenMP when it is enabled).  The triangular solves use
+ *  \p triangular_solver, which analyzes \c L and \c U once at setup;
+ *  with \p reorder level-set solves store the factors with the rows in
+ *  level order, so the rows processed together are contiguous in
+ *  memory.
+ *
+ *  The factorization runs on the host; \p MemorySpace should be
+ *  \c cusp::host_memory.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory)
+ *
+ *  The following code snippet demonstrates how to use an \p ilu0
+ *  preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/ilu0.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::host_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner
+ *  cusp::precond::ilu0<float, cusp::host_memory> M(A);
+ *
+ *  // solve
+ *  cusp::krylov::bicgstab(A, x, b, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class ilu0 : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    cusp::triangular_solver<int, ValueType> L;
+    cusp::triangular_solver<int, ValueType> U;
+
+public:
+    /*! construct an \p ilu0 preconditioner
+     *
+     * \param A matrix to precondition
+     * \param reorder store the factors in level order
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square or
+     *         lacks a diagonal entry
+     * \throws cusp::runtime_exception if a zero pivot is encountered
+     */
+    template<typename MatrixType>
+    ilu0(const MatrixType& A, bool reorder = false);
+
+    /*! number of levels in the schedules of \c L and \c U
+     */
+    size_t num_levels(void) const { return L.num_levels() + U.num_levels(); }
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/ilu0.inl>
@@ -0,0 +1,159 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file polynomial.h
+ *  \brief Polynomial preconditioner.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/hyb_matrix.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! polynomials used by \p polynomial
+ */
+enum polynomial_kind
+{
+    /*! Chebyshev semi-iteration on <tt>[lambda_min, lambda_max]</tt> */
+    polynomial_chebyshev,
+
+    /*! least-squares fit of <tt>1 - lambda p(lambda)</tt> on <tt>[0, lambda_max]</tt> */
+    polynomial_least_squares,
+
+    /*! truncated Neumann series of <tt>(omega A)^-1</tt> with <tt>omega = 1 / lambda_max</tt> */
+    polynomial_neumann
+};
+
+/*! \p polynomial : polynomial preconditioner
+ *
+ *  Approximates <tt>A^-1</tt> by a fixed polynomial <tt>p(A)</tt> of
+ *  the given degree, so each application costs \p degree sparse
+ *  matrix-vector products and no inner products.  Every product is
+ *  fused with the vector update that consumes it.
+ *
+ *  The polynomial is built from an interval that contains the spectrum
+ *  of \c A, so \c A should be symmetric positive definite, or at least
+ *  have its eigenvalues on the positive real axis.  When no bounds are
+ *  given the largest eigenvalue is estimated with a few Lanczos steps
+ *  and \c lambda_min is taken as <tt>lambda_max / 30</tt>.  Since
+ *  <tt>p(A)</tt> commutes with \c A the preconditioner is symmetric
+ *  whenever \c A is, and can be used with \p cg.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  The following code snippet demonstrates how to use a
+ *  \p polynomial preconditioner with \p cg.
+ *
+ *  \code
+ *  #include <cusp/precond/polynomial.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup a degree 8 Chebyshev preconditioner
+ *  cusp::precond::polynomial<float, cusp::device_memory> M(A, cusp::precond::polynomial_chebyshev, 8);
+ *
+ *  // solve
+ *  cusp::krylov::cg(A, x, b, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class polynomial : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+    cusp::hyb_matrix<int, ValueType, MemorySpace> matrix;
+
+    polynomial_kind kind;
+    size_t poly_degree;
+    ValueType lower, upper;
+
+    // least-squares coefficients in the Chebyshev basis of [0, upper]
+    cusp::array1d<ValueType, cusp::host_memory> coefficients;
+
+    // workspace
+    mutable cusp::array1d<ValueType, MemorySpace> r, d, t;
+
+    template <typename MatrixType>
+    void setup(const MatrixType& A);
+
+public:
+    /*! construct a \p polynomial preconditioner, estimating the
+     *  spectral interval of \c A
+     *
+     * \param A matrix to precondition
+     * \param kind polynomial to apply
+     * \param degree degree of the polynomial, the number of products with \c A per application
+     * \tparam MatrixType matrix
+     */
+    template<typename MatrixType>
+    polynomial(const MatrixType& A,
+               polynomial_kind kind = polynomial_chebyshev,
+               size_t degree = 4);
+
+    /*! construct a \p polynomial preconditioner on a known spectral interval
+     *
+     * \param A matrix to precondition
+     * \param kind polynomial to apply
+     * \param degree degree of the polynomial, the number of products with \c A per application
+     * \param lambda_min lower bound of the spectrum, only used by \c polynomial_chebyshev
+     * \param lambda_max upper bound of the spectrum
+     * \tparam MatrixType matrix
+     */
+    template<typename MatrixType>
+    polynomial(const MatrixType& A,
+               polynomial_kind kind,
+               size_t degree,
+               ValueType lambda_min,
+               ValueType lambda_max);
+
+    /*! degree of the polynomial
+     */
+    size_t degree(void) const { return poly_degree; }
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/polynomial.inl>
@@ -0,0 +1,115 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+
+/*! \file spai.h
+ *  \brief Sparse approximate inverse (SPAI) preconditioner.
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/hyb_matrix.h>
+
+namespace cusp
+{
+namespace precond
+{
+
+/*! \addtogroup preconditioners Preconditioners
+ *  \ingroup preconditioners
+ *  \{
+ */
+
+/*! \p spai : static-pattern sparse approximate inverse preconditioner
+ *
+ *  Computes a sparse matrix \c M that minimizes <tt>|| A M - I ||_F</tt>
+ *  over a fixed sparsity pattern, the pattern of <tt>(I + A)^k</tt>
+ *  for a chosen power \c k.  The minimization decouples into one small
+ *  least-squares problem per column of \c M, each solved with a dense
+ *  Householder QR.  The columns are independent, so they are computed
+ *  in parallel (with OpenMP when it is enabled).  Applying the
+ *  preconditioner is a single sparse matrix-vector product with \c M.
+ *
+ *  \c M is generally not symmetric even when \c A is, so \p spai is
+ *  meant for nonsymmetric solvers such as \p bicgstab or \p gmres.
+ *  Higher powers give better approximations at a rapidly growing
+ *  setup and application cost.
+ *
+ *  The setup runs on the host; \c M is stored in \p MemorySpace.
+ *
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  The following code snippet demonstrates how to use a \p spai
+ *  preconditioner to solve a linear system.
+ *
+ *  \code
+ *  #include <cusp/precond/spai.h>
+ *  ...
+ *
+ *  cusp::array1d<float, cusp::device_memory> x(A.num_rows, 0);
+ *  cusp::array1d<float, cusp::device_memory> b(A.num_rows, 1);
+ *
+ *  cusp::default_monitor<float> monitor(b, 100, 1e-6);
+ *
+ *  // setup preconditioner on the pattern of A
+ *  cusp::precond::spai<float, cusp::device_memory> M(A);
+ *
+ *  // solve
+ *  cusp::krylov::bicgstab(A, x, b, monitor, M);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class spai : public linear_operator<ValueType, MemorySpace>
+{
+    typedef linear_operator<ValueType, MemorySpace> Parent;
+
+public:
+    cusp::hyb_matrix<int, ValueType, MemorySpace> inverse;
+
+    /*! construct a \p spai preconditioner
+     *
+     * \param A matrix to precondition
+     * \param pattern_power \c M gets the pattern of <tt>(I + A)^pattern_power</tt>
+     * \tparam MatrixType matrix
+     *
+     * \throws cusp::invalid_input_exception if \p A is not square
+     * \throws cusp::runtime_exception if a least-squares problem is
+     *         rank deficient, which happens when \p A is singular
+     */
+    template<typename MatrixType>
+    spai(const MatrixType& A, size_t pattern_power = 1);
+
+    /*! apply the preconditioner to vector \p x and store the result in \p y
+     *
+     * \param x input vector
+     * \param y ouput vector
+     * \tparam VectorType1 vector
+     * \tparam VectorType2 vector
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace precond
+} // end namespace cusp
+
+#include <cusp/precond/detail/spai.inl>
@@ -0,0 +1,152 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file stencil_operator.h
+ *  \brief Matrix-free operator for structured grid stencils
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+
+namespace cusp
+{
+
+/*! \addtogroup composite_operators Composite Operators
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! \p stencil_operator : matrix-free stencil on a 1D, 2D or 3D grid
+ *
+ *  Applies the same operator that \p cusp::gallery::generate_matrix_from_stencil
+ *  builds as a \p dia_matrix, without storing it.  The stencil and
+ *  grid are described the same way: each stencil point is a tuple of
+ *  grid offsets and a coefficient, the grid is a tuple of sizes with
+ *  the first dimension varying fastest, and neighbors outside the grid
+ *  are dropped.
+ *
+ *  Coefficients are either constant, taken from the stencil, or vary
+ *  over the grid.  Variable coefficients are an array2d with one row
+ *  per grid point and one column per stencil point, so entry
+ *  <tt>(i,k)</tt> couples grid point \c i with its \c k-th neighbor.
+ *
+ *  On the host each grid line is computed with unit-stride loops over
+ *  its interior, which the compiler vectorizes, and only the ends of
+ *  the line check the boundaries.  Lines are processed in tiles of
+ *  neighboring rows, which share their neighbor lines in cache, and
+ *  tiles are distributed over OpenMP threads.  On the device each
+ *  thread computes one grid point.
+ *
+ *  The operator works as \c A in the Krylov solvers and, since it
+ *  provides \p extract_diagonal, with the \p jacobi and \p polynomial
+ *  relaxation methods.
+ *
+ *  \tparam ValueType Type used for values (e.g. \c float or \c double).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  The following code snippet solves a 3D Poisson problem with \p cg.
+ *
+ *  \code
+ *  #include <cusp/stencil_operator.h>
+ *  ...
+ *
+ *  typedef thrust::tuple<int,int,int>           StencilIndex;
+ *  typedef thrust::tuple<StencilIndex,float>    StencilPoint;
+ *
+ *  cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+ *  stencil.push_back(StencilPoint(StencilIndex( 0, 0, 0),  6));
+ *  stencil.push_back(StencilPoint(StencilIndex(-1, 0, 0), -1));
+ *  stencil.push_back(StencilPoint(StencilIndex( 1, 0, 0), -1));
+ *  stencil.push_back(StencilPoint(StencilIndex( 0,-1, 0), -1));
+ *  stencil.push_back(StencilPoint(StencilIndex( 0, 1, 0), -1));
+ *  stencil.push_back(StencilPoint(StencilIndex( 0, 0,-1), -1));
+ *  stencil.push_back(StencilPoint(StencilIndex( 0, 0, 1), -1));
+ *
+ *  cusp::stencil_operator<float, cusp::host_memory> A(stencil, StencilIndex(64, 64, 64));
+ *
+ *  cusp::krylov::cg(A, x, b, monitor);
+ *  \endcode
+ */
+template <typename ValueType, typename MemorySpace>
+class stencil_operator : public cusp::linear_operator<ValueType, MemorySpace>
+{
+    typedef cusp::linear_operator<ValueType, MemorySpace> Parent;
+
+    template <typename StencilPoint, typename GridDimension>
+    void initialize(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil,
+                    const GridDimension& grid);
+
+public:
+    /*! grid sizes, padded with ones to three dimensions */
+    int grid[3];
+
+    /*! grid offsets of the stencil points, three per point */
+    cusp::array1d<int, MemorySpace> offsets;
+
+    /*! constant coefficients of the stencil points */
+    cusp::array1d<ValueType, MemorySpace> weights;
+
+    /*! variable coefficients, one row per grid point, empty when constant */
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> coefficients;
+
+    /*! construct an operator with constant coefficients
+     *
+     * \param stencil array of (offsets, coefficient) tuples
+     * \param grid tuple of grid sizes, at most three
+     */
+    template <typename StencilPoint, typename GridDimension>
+    stencil_operator(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil,
+                     const GridDimension& grid);
+
+    /*! construct an operator with variable coefficients
+     *
+     * \param stencil array of (offsets, coefficient) tuples, the coefficients are ignored
+     * \param grid tuple of grid sizes, at most three
+     * \param coefficients one row per grid point, one column per stencil point
+     */
+    template <typename StencilPoint, typename GridDimension, typename MemorySpace2, typename Orientation>
+    stencil_operator(const cusp::array1d<StencilPoint,cusp::host_memory>& stencil,
+                     const GridDimension& grid,
+                     const cusp::array2d<ValueType,MemorySpace2,Orientation>& coefficients);
+
+    /*! number of stencil points
+     */
+    size_t num_points(void) const { return weights.size(); }
+
+    /*! store the main diagonal of the operator in \p output
+     */
+    template <typename Array>
+    void extract_diagonal(Array& output) const;
+
+    /*! compute <tt>y = A x</tt>
+     *
+     * \param x input vector
+     * \param y ouput vector, must not alias \p x
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/stencil_operator.inl>
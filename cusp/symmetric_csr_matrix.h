@@ -0,0 +1,163 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file symmetric_csr_matrix.h
+ *  \brief Symmetric and Hermitian matrices stored as one CSR triangle
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/linear_operator.h>
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+
+namespace cusp
+{
+
+/*! \addtogroup sparse_matrices Sparse Matrices
+ *  \{
+ */
+
+/*! relation between the stored upper triangle and the implied lower one
+ */
+enum symmetry_kind
+{
+    symmetry_symmetric,      //!< <tt>A(j,i) = A(i,j)</tt>
+    symmetry_hermitian,      //!< <tt>A(j,i) = conj(A(i,j))</tt>
+    symmetry_skew_symmetric  //!< <tt>A(j,i) = -A(i,j)</tt>, zero diagonal
+};
+
+/*! \p symmetric_csr_matrix : symmetric, Hermitian or skew-symmetric
+ *  matrix that stores only its upper triangle
+ *
+ *  The upper triangle, including the diagonal, is kept as a
+ *  \p csr_matrix with rows sorted by column, which takes about half the
+ *  memory of the full matrix and halves the bytes read by SpMV.
+ *
+ *  The host SpMV reads every stored entry once and applies it to both
+ *  triangles: row \c i gathers <tt>A(i,j) x(j)</tt> and scatters the
+ *  mirrored <tt>A(j,i) x(i)</tt> into <tt>y(j)</tt>.  Rows are split into
+ *  blocks of equal stored entries, one per OpenMP thread.  Scattered
+ *  updates that fall inside a thread's own block go to \c y directly;
+ *  the others go to a per-thread partial buffer that covers only the
+ *  rows the block reaches, and the buffers are summed at the end.
+ *
+ *  On the device the matrix is expanded to a full \p csr_matrix on the
+ *  first multiply and that copy is used from then on.
+ *
+ *  \p cusp::io::read_matrix_market_file fills the matrix from a
+ *  symmetric, Hermitian or skew-symmetric file without expanding it.
+ *
+ *  \tparam IndexType Type used for matrix indices (e.g. \c int).
+ *  \tparam ValueType Type used for matrix values (e.g. \c float).
+ *  \tparam MemorySpace A memory space (e.g. \c cusp::host_memory or cusp::device_memory)
+ *
+ *  \code
+ *  #include <cusp/symmetric_csr_matrix.h>
+ *  #include <cusp/io/matrix_market.h>
+ *  #include <cusp/krylov/cg.h>
+ *  ...
+ *
+ *  cusp::symmetric_csr_matrix<int, double, cusp::host_memory> A;
+ *  cusp::io::read_matrix_market_file(A, "spd.mtx");
+ *
+ *  cusp::krylov::cg(A, x, b, monitor);
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType, typename MemorySpace>
+class symmetric_csr_matrix : public cusp::linear_operator<ValueType, MemorySpace, IndexType>
+{
+    typedef cusp::linear_operator<ValueType, MemorySpace, IndexType> Parent;
+
+public:
+    /*! construct an empty matrix
+     */
+    symmetric_csr_matrix(void);
+
+    /*! construct from the upper triangle of a full matrix
+     *
+     * \param A symmetric, Hermitian or skew-symmetric matrix in any format,
+     *        its lower triangle is ignored
+     * \param symmetry relation between the triangles of \p A
+     */
+    template <typename MatrixType>
+    symmetric_csr_matrix(const MatrixType& A, symmetry_kind symmetry = symmetry_symmetric);
+
+    /*! take ownership of an upper triangle
+     *
+     * \param U upper triangle with the diagonal, rows sorted by column
+     * \param symmetry relation of the lower triangle to \p U
+     *
+     * \throw cusp::invalid_input_exception if \p U is not square, has an
+     *        entry below the diagonal or a row that is not sorted
+     */
+    void assign_upper(cusp::csr_matrix<IndexType, ValueType, MemorySpace>& U,
+                      symmetry_kind symmetry = symmetry_symmetric);
+
+    /*! relation of the lower triangle to the stored one
+     */
+    symmetry_kind symmetry(void) const { return symmetry_; }
+
+    /*! upper triangle with the diagonal, rows sorted by column
+     *
+     * \note The triangle is read-only so that the device copy of the
+     *       full matrix stays current; replace it with \p assign_upper.
+     */
+    const cusp::csr_matrix<IndexType, ValueType, MemorySpace>& upper(void) const { return upper_; }
+
+    /*! store the full matrix in \p A
+     */
+    template <typename MatrixType>
+    void expand(MatrixType& A) const;
+
+    /*! store the main diagonal in \p output
+     */
+    template <typename Array>
+    void extract_diagonal(Array& output) const;
+
+    /*! compute <tt>y = A x</tt>
+     *
+     * \param x input vector
+     * \param y ouput vector, must not alias \p x
+     */
+    template <typename VectorType1, typename VectorType2>
+    void operator()(const VectorType1& x, VectorType2& y) const;
+
+private:
+    symmetry_kind symmetry_;
+
+    cusp::csr_matrix<IndexType, ValueType, MemorySpace> upper_;
+
+    // per-thread partial sums of the host SpMV
+    mutable cusp::array1d<ValueType, cusp::host_memory> workspace;
+
+    // full matrix used by the device SpMV, built on first use
+    mutable cusp::csr_matrix<IndexType, ValueType, MemorySpace> general;
+
+    template <typename VectorType1, typename VectorType2>
+    void multiply(const VectorType1& x, VectorType2& y, cusp::host_memory) const;
+
+    template <typename VectorType1, typename VectorType2, typename MemorySpace2>
+    void multiply(const VectorType1& x, VectorType2& y, MemorySpace2) const;
+};
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/symmetric_csr_matrix.inl>
@@ -0,0 +1,207 @@
+/*
+ *  Copyright 2008-2009 NVIDIA Corporation
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*! \file triangular_solve.h
+ *  \brief Sparse triangular solves
+ */
+
+#pragma once
+
+#include <cusp/detail/config.h>
+
+#include <cusp/array1d.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/detail/level_schedule.h>
+
+namespace cusp
+{
+
+/*! \addtogroup algorithms Algorithms
+ *  \ingroup algorithms
+ *  \{
+ */
+
+/*! algorithms used by \p triangular_solver
+ */
+enum triangular_solve_algorithm
+{
+    /*! choose from the shape of the dependency DAG */
+    triangular_solve_automatic,
+
+    /*! process the rows level by level, rows of a level in parallel */
+    triangular_solve_level_set,
+
+    /*! process the rows in order in parallel, each row waits only for
+     *  the rows it depends on */
+    triangular_solve_sync_free
+};
+
+/*! \p triangular_solver : analyzed sparse triangular solve
+ *
+ *  Solves <tt>T x = b</tt> where \c T is the lower or upper triangle
+ *  of a sparse matrix \c A, including its diagonal or with an implied
+ *  unit diagonal.  Entries of \c A outside the requested triangle are
+ *  ignored, so the same matrix can supply both factors of an LU
+ *  factorization, or the lower triangle of \c A for Gauss-Seidel.
+ *
+ *  The constructor (or \p analyze) performs the analysis phase once: it
+ *  extracts the triangle, computes the level schedule of its dependency
+ *  DAG and chooses the solve algorithm.  \p solve may then be called
+ *  any number of times, with a vector or with an \p array2d holding
+ *  several right-hand sides as its columns.
+ *
+ *  Two parallel algorithms are available (rows run in parallel with
+ *  OpenMP when it is enabled):
+ *   - \c triangular_solve_level_set processes the levels in order and
+ *     the rows of each level in parallel, with a barrier between
+ *     levels.  It suits DAGs with few, wide levels.  With \p reorder
+ *     the rows are stored in level order for locality.
+ *   - \c triangular_solve_sync_free hands out the rows in order to all
+ *     threads; a row waits on completion flags of the rows it depends
+ *     on, never on a whole level.  It suits deep DAGs with many narrow
+ *     levels, where barriers would dominate.
+ *  \c triangular_solve_automatic picks the level-set algorithm when the
+ *  levels hold on average enough rows to be worth a barrier each, and
+ *  the sync-free algorithm otherwise.  Both compute every row with the
+ *  same operations in the same order, so their results are identical.
+ *
+ *  The solve runs on the host; vectors must be in \c cusp::host_memory.
+ *
+ *  \tparam IndexType Type used for matrix indices (e.g. \c int).
+ *  \tparam ValueType Type used for matrix values (e.g. \c float or \c double).
+ *
+ *  The following code snippet demonstrates how to reuse an analyzed
+ *  solve for many right-hand sides.
+ *
+ *  \code
+ *  #include <cusp/triangular_solve.h>
+ *  #include <cusp/csr_matrix.h>
+ *  #include <cusp/array2d.h>
+ *
+ *  int main(void)
+ *  {
+ *      cusp::csr_matrix<int, float, cusp::host_memory> L;
+ *      ...
+ *
+ *      // analysis phase: lower triangle with its diagonal
+ *      cusp::triangular_solver<int, float> solver(L, true);
+ *
+ *      // solve for 8 right-hand sides at once
+ *      cusp::array2d<float, cusp::host_memory, cusp::column_major> B(L.num_rows, 8, 1);
+ *      cusp::array2d<float, cusp::host_memory, cusp::column_major> X(L.num_rows, 8);
+ *
+ *      solver.solve(B, X);
+ *
+ *      return 0;
+ *  }
+ *  \endcode
+ */
+template <typename IndexType, typename ValueType>
+class triangular_solver
+{
+public:
+    /*! construct an empty solver, see \p analyze
+     */
+    triangular_solver(void);
+
+    /*! construct a solver for the lower or upper triangle of \p A
+     *
+     *  \param A matrix, converted to CSR if it is in another format
+     *  \param lower solve with the lower (true) or upper (false) triangle
+     *  \param unit_diagonal assume a unit diagonal instead of reading it from \p A
+     *  \param algorithm solve algorithm
+     *  \param reorder store the rows in level order (level-set algorithm only)
+     *
+     *  \throws cusp::invalid_input_exception if \p A is not square or, unless
+     *          \p unit_diagonal is set, has a missing or zero diagonal entry
+     */
+    template <typename MatrixType>
+    triangular_solver(const MatrixType& A,
+                      bool lower,
+                      bool unit_diagonal = false,
+                      triangular_solve_algorithm algorithm = triangular_solve_automatic,
+                      bool reorder = false);
+
+    /*! analysis phase, replaces any previous analysis
+     *
+     *  \see triangular_solver(const MatrixType&, bool, bool, triangular_solve_algorithm, bool)
+     */
+    template <typename MatrixType>
+    void analyze(const MatrixType& A,
+                 bool lower,
+                 bool unit_diagonal = false,
+                 triangular_solve_algorithm algorithm = triangular_solve_automatic,
+                 bool reorder = false);
+
+    /*! solve T x = b
+     *
+     *  \param b right-hand side, an \p array1d or an \p array2d with one
+     *         right-hand side per column
+     *  \param x solution, of the same shape as \p b.  May be the same
+     *         object as \p b.
+     */
+    template <typename Array1, typename Array2>
+    void solve(const Array1& b, Array2& x) const;
+
+    /*! the algorithm chosen in the analysis phase
+     */
+    triangular_solve_algorithm algorithm(void) const { return algorithm_; }
+
+    /*! number of levels in the dependency DAG, i.e. the length of its
+     *  critical path
+     */
+    size_t num_levels(void) const { return schedule.num_levels(); }
+
+protected:
+    bool lower;
+    bool reorder;
+    triangular_solve_algorithm algorithm_;
+
+    // strict triangle, rows in level order when reorder is set
+    cusp::csr_matrix<IndexType, ValueType, cusp::host_memory> T;
+
+    // reciprocals of the diagonal, empty for a unit diagonal
+    cusp::array1d<ValueType, cusp::host_memory> inv_diagonal;
+
+    cusp::detail::level_schedule<IndexType> schedule;
+};
+
+/*! \p triangular_solve : solve a sparse triangular system
+ *
+ *  Solves <tt>T x = b</tt> where \c T is the lower or upper triangle of
+ *  \p A.  This performs the analysis phase on every call; use a
+ *  \p triangular_solver to solve repeatedly with the same matrix.
+ *
+ *  \param A matrix
+ *  \param x solution vector or \p array2d of solutions
+ *  \param b right-hand side vector or \p array2d of right-hand sides
+ *  \param lower solve with the lower (true) or upper (false) triangle
+ *  \param unit_diagonal assume a unit diagonal instead of reading it from \p A
+ *
+ *  \see triangular_solver
+ */
+template <typename MatrixType, typename Array1, typename Array2>
+void triangular_solve(const MatrixType& A,
+                      Array1& x,
+                      const Array2& b,
+                      bool lower,
+                      bool unit_diagonal = false);
+/*! \}
+ */
+
+} // end namespace cusp
+
+#include <cusp/detail/triangular_solve.inl>
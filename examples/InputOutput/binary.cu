@@ -0,0 +1,34 @@
+#include <cusp/io/binary.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/multiply.h>
+#include <cusp/print.h>
+
+int main(void)
+{
+    // create a 2d Poisson problem
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    // save A to disk in the native binary format
+    cusp::io::write_binary(A, "A.bin");
+
+    // load A from disk into a device csr_matrix
+    cusp::csr_matrix<int, float, cusp::device_memory> B;
+    cusp::io::read_binary(B, "A.bin");
+
+    // or map the file and use it in place without copying
+    typedef cusp::io::binary_views<int, float>::csr_matrix View;
+
+    cusp::io::binary_file file("A.bin");
+    View C = file.view<View>();
+
+    cusp::array1d<float, cusp::host_memory> x(C.num_cols, 1);
+    cusp::array1d<float, cusp::host_memory> y(C.num_rows);
+    cusp::multiply(C, x, y);
+
+    // print y
+    cusp::print(y);
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <cusp/stencil_operator.h>
+#include <cusp/krylov/cg.h>
+
+// This example shows how to use cusp::stencil_operator to solve a
+// linear system on a structured grid without storing a matrix.  The
+// 7-point finite-difference stencil of the 3D Laplacian is applied
+// directly to the grid, which reads each vector entry a few times
+// instead of streaming a matrix with seven values per row.
+
+// where to perform the computation
+typedef cusp::host_memory MemorySpace;
+
+int main(void)
+{
+    // number of grid points in each dimension
+    const int N = 32;
+
+    typedef thrust::tuple<int,int,int>        StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    // 7-point Laplacian
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  0),  6));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0, -1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0, -1), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  1), -1));
+
+    // create a matrix-free linear operator
+    cusp::stencil_operator<float, MemorySpace> A(stencil, StencilIndex(N, N, N));
+
+    // allocate storage for solution (x) and right hand side (b)
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1);
+
+    // set stopping criteria:
+    //  iteration_limit    = 200
+    //  relative_tolerance = 1e-6
+    cusp::verbose_monitor<float> monitor(b, 200, 1e-6);
+
+    // solve the linear system A * x = b with the Conjugate Gradient method
+    cusp::krylov::cg(A, x, b, monitor);
+
+    return 0;
+}
@@ -0,0 +1,73 @@
+#include <cusp/precond/block_jacobi.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+
+#include <iostream>
+
+// where to perform the computation (the setup runs on the host)
+typedef cusp::host_memory MemorySpace;
+
+// which floating point type to use
+typedef float ValueType;
+
+int main(void)
+{
+    // create a 2d Poisson problem
+    cusp::coo_matrix<int, ValueType, MemorySpace> P;
+    cusp::gallery::poisson5pt(P, 64, 64);
+
+    // couple two unknowns per grid node: A = P (x) [1 0.9; 0.9 1]
+    cusp::coo_matrix<int, ValueType, MemorySpace> C(2 * P.num_rows, 2 * P.num_cols, 4 * P.num_entries);
+    for (size_t n = 0, k = 0; n < P.num_entries; n++)
+        for (int a = 0; a < 2; a++)
+            for (int b = 0; b < 2; b++, k++)
+            {
+                C.row_indices[k]    = 2 * P.row_indices[n] + a;
+                C.column_indices[k] = 2 * P.column_indices[n] + b;
+                C.values[k]         = P.values[n] * (a == b ? 1.0f : 0.9f);
+            }
+    C.sort_by_row_and_column();
+
+    cusp::csr_matrix<int, ValueType, MemorySpace> A(C);
+
+    // solve with diagonal preconditioner
+    {
+        std::cout << "\nSolving with diagonal preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // setup preconditioner
+        cusp::precond::diagonal<ValueType, MemorySpace> M(A);
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+
+    // solve with block Jacobi preconditioner
+    {
+        std::cout << "\nSolving with 2x2 block Jacobi preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // setup preconditioner
+        cusp::precond::block_jacobi<ValueType, MemorySpace> M(A, 2);
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+
+    return 0;
+}
@@ -0,0 +1,62 @@
+#include <cusp/precond/deflation.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+
+#include <iostream>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef float ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (CSR format)
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 256x256 mesh
+    cusp::gallery::poisson5pt(A, 256, 256);
+
+    // solve with diagonal preconditioner
+    {
+        std::cout << "\nSolving with diagonal preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // setup preconditioner
+        cusp::precond::diagonal<ValueType, MemorySpace> M(A);
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+
+    // solve with two-level deflation preconditioner
+    {
+        std::cout << "\nSolving with two-level deflation preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // setup preconditioner with Jacobi smoothing and an aggregation coarse space
+        cusp::precond::deflation<ValueType, MemorySpace> M(A);
+
+        std::cout << "coarse space dimension " << M.coarse_size() << std::endl;
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+
+    return 0;
+}
@@ -0,0 +1,56 @@
+#include <cusp/precond/polynomial.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+
+#include <iostream>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef float ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (CSR format)
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 256x256 mesh
+    cusp::gallery::poisson5pt(A, 256, 256);
+
+    // solve without preconditioning
+    {
+        std::cout << "\nSolving without preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor);
+    }
+
+    // solve with a degree 8 Chebyshev polynomial preconditioner
+    {
+        std::cout << "\nSolving with Chebyshev polynomial preconditioner" << std::endl;
+
+        // allocate storage for solution (x) and right hand side (b)
+        cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+        cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+        // set stopping criteria (iteration_limit = 1000, relative_tolerance = 1e-6)
+        cusp::verbose_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+        // setup preconditioner
+        cusp::precond::polynomial<ValueType, MemorySpace> M(A, cusp::precond::polynomial_chebyshev, 8);
+
+        // solve
+        cusp::krylov::cg(A, x, b, monitor, M);
+    }
+
+    return 0;
+}
@@ -0,0 +1,40 @@
+#include <cusp/hyb_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/chebyshev.h>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef float ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (HYB format)
+    cusp::hyb_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 10x10 mesh
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    // allocate storage for solution (x) and right hand side (b)
+    cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+    // set stopping criteria:
+    //  iteration_limit    = 200
+    //  relative_tolerance = 1e-3
+    cusp::verbose_monitor<ValueType> monitor(b, 200, 1e-3);
+
+    // test the residual only every 10 iterations, the
+    // Chebyshev iteration itself needs no inner products
+    monitor.set_check_interval(10);
+
+    // set preconditioner (identity)
+    cusp::identity_operator<ValueType, MemorySpace> M(A.num_rows, A.num_rows);
+
+    // solve the linear system A * x = b with the Chebyshev iteration,
+    // given that the eigenvalues of A lie in [0.15, 8]
+    cusp::krylov::chebyshev(A, x, b, monitor, M, ValueType(0.15), ValueType(8));
+
+    return 0;
+}
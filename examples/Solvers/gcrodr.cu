@@ -0,0 +1,47 @@
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/gcrodr.h>
+
+#include <iostream>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef float ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (CSR format)
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 50x50 mesh
+    cusp::gallery::poisson5pt(A, 50, 50);
+
+    // keep 10 vectors between restart cycles and solves
+    cusp::krylov::recycle_space<ValueType, MemorySpace> space(10);
+
+    // allocate storage for solution (x) and right hand side (b)
+    cusp::array1d<ValueType, MemorySpace> x(A.num_rows, 0);
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, 1);
+
+    // solve a sequence of slowly changing systems
+    for (int step = 0; step < 5; step++)
+    {
+        // perturb the matrix and refresh the recycled space
+        cusp::blas::scal(A.values, ValueType(1.01));
+        space.update(A);
+
+        // set stopping criteria:
+        //  iteration_limit    = 500
+        //  relative_tolerance = 1e-6
+        cusp::default_monitor<ValueType> monitor(b, 500, 1e-6);
+
+        // solve the linear system A * x = b, starting from the previous solution
+        cusp::krylov::gcrodr(A, x, b, 40, space, monitor);
+
+        std::cout << "step " << step << ": " << monitor.iteration_count() << " iterations" << std::endl;
+    }
+
+    return 0;
+}
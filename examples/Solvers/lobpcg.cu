@@ -0,0 +1,38 @@
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/precond/smoothed_aggregation.h>
+#include <cusp/krylov/lobpcg.h>
+
+#include <iostream>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef double ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (CSR format)
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 256x256 mesh
+    cusp::gallery::poisson5pt(A, 256, 256);
+
+    // setup preconditioner
+    cusp::precond::smoothed_aggregation<int, ValueType, MemorySpace> M(A);
+
+    // allocate storage for the eigenvalues (S) and eigenvectors (X)
+    cusp::array1d<ValueType, cusp::host_memory> S;
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> X;
+
+    // compute the 6 smallest eigenpairs to a relative residual of 1e-8
+    size_t num_converged = cusp::krylov::lobpcg(A, S, X, 6, M, false, 200, 1e-8);
+
+    std::cout << num_converged << " eigenpairs converged" << std::endl;
+
+    for (size_t i = 0; i < S.size(); i++)
+        std::cout << "lambda[" << i << "] = " << S[i] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,34 @@
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/thick_restart_lanczos.h>
+
+#include <iostream>
+
+// where to perform the computation
+typedef cusp::device_memory MemorySpace;
+
+// which floating point type to use
+typedef double ValueType;
+
+int main(void)
+{
+    // create an empty sparse matrix structure (CSR format)
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+
+    // create a 2d Poisson problem on a 256x256 mesh
+    cusp::gallery::poisson5pt(A, 256, 256);
+
+    // allocate storage for the eigenvalues (S) and eigenvectors (X)
+    cusp::array1d<ValueType, cusp::host_memory> S;
+    cusp::array2d<ValueType, MemorySpace, cusp::column_major> X;
+
+    // compute the 5 largest eigenpairs with a basis of 40 Lanczos vectors
+    size_t num_converged = cusp::krylov::thick_restart_lanczos(A, S, X, 5, true, 40, 100, 1e-8);
+
+    std::cout << num_converged << " eigenpairs converged" << std::endl;
+
+    for (size_t i = 0; i < S.size(); i++)
+        std::cout << "lambda[" << i << "] = " << S[i] << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,132 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/additive_schwarz.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/multiply.h>
+
+void TestAdditiveSchwarzSingleSubdomain(void)
+{
+    // one subdomain with an exact local solver is A^-1
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 6, 6);
+
+    cusp::precond::additive_schwarz<double, cusp::host_memory>
+        M(A, cusp::precond::schwarz_dense_lu, 0, false, 1);
+
+    ASSERT_EQUAL(M.num_subdomains(), 1);
+    ASSERT_EQUAL(M.subdomain_size(0), A.num_rows);
+
+    cusp::array1d<double, cusp::host_memory> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i % 5) - 2.0;
+
+    cusp::array1d<double, cusp::host_memory> Ax(A.num_rows);
+    cusp::array1d<double, cusp::host_memory> y(A.num_rows);
+    cusp::multiply(A, x, Ax);
+    M(Ax, y);
+
+    ASSERT_ALMOST_EQUAL(y, x);
+}
+DECLARE_UNITTEST(TestAdditiveSchwarzSingleSubdomain);
+
+void TestAdditiveSchwarzOverlap(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 24, 24);
+
+    cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1.0f);
+
+    cusp::precond::additive_schwarz<float, cusp::host_memory>
+        M0(A, cusp::precond::schwarz_dense_lu, 0, false, 8);
+    cusp::precond::additive_schwarz<float, cusp::host_memory>
+        M1(A, cusp::precond::schwarz_dense_lu, 1, false, 8);
+
+    // one layer of overlap adds a grid line on each side of the 3 line strips
+    ASSERT_EQUAL(M0.subdomain_size(0), 72);
+    ASSERT_EQUAL(M1.subdomain_size(0), 96);
+    ASSERT_EQUAL(M1.subdomain_size(3), 120);
+
+    cusp::array1d<float, cusp::host_memory> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 200, 1e-5);
+    cusp::krylov::cg(A, x0, b, monitor0, M0);
+
+    cusp::array1d<float, cusp::host_memory> x1(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 200, 1e-5);
+    cusp::krylov::cg(A, x1, b, monitor1, M1);
+
+    ASSERT_EQUAL(monitor0.converged(), true);
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+}
+DECLARE_UNITTEST(TestAdditiveSchwarzOverlap);
+
+void TestAdditiveSchwarzLocalSolvers(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 32, 32);
+
+    cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1.0f);
+
+    cusp::precond::schwarz_local_solver solvers[3] = { cusp::precond::schwarz_ilu0,
+                                                       cusp::precond::schwarz_smoothed_aggregation,
+                                                       cusp::precond::schwarz_dense_lu };
+
+    for (int s = 0; s < 3; s++)
+    {
+        for (int restricted = 0; restricted < 2; restricted++)
+        {
+            cusp::precond::additive_schwarz<float, cusp::host_memory>
+                M(A, solvers[s], 1, restricted == 1, 4);
+
+            cusp::array1d<float, cusp::host_memory> x(A.num_rows, 0.0f);
+            cusp::default_monitor<float> monitor(b, 300, 1e-5);
+            cusp::krylov::gmres(A, x, b, 30, monitor, M);
+
+            ASSERT_EQUAL(monitor.converged(), true);
+        }
+    }
+}
+DECLARE_UNITTEST(TestAdditiveSchwarzLocalSolvers);
+
+void TestAdditiveSchwarzInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A(3, 2, 0);
+    A.row_offsets[0] = 0; A.row_offsets[1] = 0; A.row_offsets[2] = 0; A.row_offsets[3] = 0;
+
+    ASSERT_THROWS((cusp::precond::additive_schwarz<float, cusp::host_memory>(A)), cusp::invalid_input_exception);
+
+    // the ILU(0) subdomain solver needs the diagonal
+    cusp::csr_matrix<int, float, cusp::host_memory> B(2, 2, 2);
+    B.row_offsets[0] = 0; B.row_offsets[1] = 1; B.row_offsets[2] = 2;
+    B.column_indices[0] = 1; B.column_indices[1] = 0;
+    B.values[0] = 1; B.values[1] = 1;
+
+    ASSERT_THROWS((cusp::precond::additive_schwarz<float, cusp::host_memory>(B, cusp::precond::schwarz_ilu0, 0, false, 2)), cusp::invalid_input_exception);
+
+    // a singular subdomain matrix fails the dense LU
+    cusp::csr_matrix<int, float, cusp::host_memory> C(2, 2, 4);
+    C.row_offsets[0] = 0; C.row_offsets[1] = 2; C.row_offsets[2] = 4;
+    C.column_indices[0] = 0; C.column_indices[1] = 1; C.column_indices[2] = 0; C.column_indices[3] = 1;
+    C.values[0] = 1; C.values[1] = 1; C.values[2] = 1; C.values[3] = 1;
+
+    ASSERT_THROWS((cusp::precond::additive_schwarz<float, cusp::host_memory>(C, cusp::precond::schwarz_dense_lu, 0, false, 1)), cusp::runtime_exception);
+}
+DECLARE_UNITTEST(TestAdditiveSchwarzInvalidInput);
+
+void TestAdditiveSchwarzEmptyMatrix(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A(0, 0, 0);
+    A.row_offsets[0] = 0;
+
+    cusp::precond::additive_schwarz<float, cusp::host_memory> M(A);
+
+    cusp::array1d<float, cusp::host_memory> x;
+    cusp::array1d<float, cusp::host_memory> y;
+    M(x, y);
+
+    ASSERT_EQUAL(y.size(), (size_t) 0);
+}
+DECLARE_UNITTEST(TestAdditiveSchwarzEmptyMatrix);
@@ -5,6 +5,10 @@
 #include <cusp/gallery/poisson.h>
 #include <cusp/krylov/cg.h>
 
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
 inline
 __host__ __device__
 unsigned int hash32(unsigned int a)
@@ -27,34 +31,68 @@ struct hash_01
     }
 };
 
-void TestAINVHeap(void)
+void TestAINVSparseAxpyDrop(void)
 {
   hash_01 rng;
   int seed = 100;
 
-  for (int trial = 0; trial < 10000; trial ++) {
-    cusp::precond::detail::ainv_matrix_row<int, float> row;
+  cusp::precond::detail::ainv_workspace<int, float> work;
 
-    int size =100;
+  for (int trial = 0; trial < 1000; trial ++) {
+    // result has entries at even indices, operand at multiples of 3
+    std::vector<int>   r_indices, o_indices;
+    std::vector<float> r_values,  o_values;
     int i;
-    for (i=0; i < size; i++) 
-      row.insert(i, rng(seed++));
-
-    for (i=0; i < size; i++) 
-      row.add_to_value(i, rng(seed++) - .5);
-
-    for (i=0; i < size/2; i++) 
-      row.remove_min();
-
-    for (i=0; i < size; i++) 
-      row.insert(i+size, rng(seed++));
+    for (i=0; i < 100; i += 2) {
+      r_indices.push_back(i);
+      r_values.push_back(rng(seed++) - .5f);
+    }
+    for (i=0; i < 100; i += 3) {
+      o_indices.push_back(i);
+      o_values.push_back(rng(seed++) - .5f);
+    }
 
-    ASSERT_EQUAL(row.validate_heap(), true);
-    ASSERT_EQUAL(row.validate_backpointers(), true);
+    // dense reference: result + 2 * operand, skipping operand terms below the tolerance
+    std::vector<float> dense(100, 0);
+    std::vector<bool>  present(100, false);
+    for (i=0; i < (int) r_indices.size(); i++) {
+      dense[r_indices[i]] = r_values[i];
+      present[r_indices[i]] = true;
+    }
+    for (i=0; i < (int) o_indices.size(); i++) {
+      float term = 2 * o_values[i];
+      if (std::abs(term) >= 0.25f) {
+        dense[o_indices[i]] += term;
+        present[o_indices[i]] = true;
+      }
+    }
 
+    int limit = trial % 2 ? -1 : 20;
+    size_t n = cusp::precond::detail::sparse_axpy_drop(&r_indices[0], &r_values[0], r_indices.size(), 2.0f,
+                                                       &o_indices[0], &o_values[0], o_indices.size(),
+                                                       0.25f, limit, work);
+
+    std::vector<float> magnitudes;
+    for (i=0; i < 100; i++)
+      if (present[i])
+        magnitudes.push_back(std::abs(dense[i]));
+    std::sort(magnitudes.begin(), magnitudes.end());
+
+    size_t expected = limit < 0 ? magnitudes.size() : std::min(magnitudes.size(), (size_t) limit);
+    ASSERT_EQUAL(n, expected);
+
+    // kept entries are sorted by index, match the reference, and are the largest ones
+    float smallest_kept = magnitudes[magnitudes.size() - expected];
+    for (i=0; i < (int) n; i++) {
+      if (i > 0)
+        ASSERT_EQUAL(work.indices[i-1] < work.indices[i], true);
+      ASSERT_EQUAL(present[work.indices[i]], true);
+      ASSERT_ALMOST_EQUAL(work.values[i], dense[work.indices[i]]);
+      ASSERT_EQUAL(std::abs(work.values[i]) >= smallest_kept * 0.999f, true);
+    }
   }
 }
-DECLARE_UNITTEST(TestAINVHeap);
+DECLARE_UNITTEST(TestAINVSparseAxpyDrop);
 
 
 void TestAINVFactorization(void)
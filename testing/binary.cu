@@ -0,0 +1,341 @@
+#include <unittest/unittest.h>
+
+#include <cusp/io/binary.h>
+
+#include <cusp/array1d.h>
+#include <cusp/array2d.h>
+#include <cusp/complex.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/multiply.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+#include <stdio.h>
+
+const char binary_file_name[] = "test_20481736512907.bin";
+
+template <typename MemorySpace>
+void TestReadWriteBinaryArray1d(void)
+{
+    cusp::array1d<float, MemorySpace> a(7);
+    for (size_t i = 0; i < a.size(); i++)
+        a[i] = 1.5f * i - 2.0f;
+
+    cusp::io::write_binary(a, binary_file_name);
+
+    cusp::array1d<float, MemorySpace> b;
+    cusp::io::read_binary(b, binary_file_name);
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(a, b);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadWriteBinaryArray1d);
+
+void TestReadWriteBinaryComplexArray1d(void)
+{
+    cusp::array1d<cusp::complex<double>, cusp::host_memory> a(5);
+    for (size_t i = 0; i < a.size(); i++)
+        a[i] = cusp::complex<double>(i + 0.25, -2.0 * i);
+
+    cusp::io::write_binary(a, binary_file_name, false);
+
+    cusp::array1d<cusp::complex<double>, cusp::host_memory> b;
+    cusp::io::read_binary(b, binary_file_name);
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(a == b, true);
+}
+DECLARE_UNITTEST(TestReadWriteBinaryComplexArray1d);
+
+template <typename MemorySpace>
+void TestReadWriteBinaryArray2d(void)
+{
+    cusp::array2d<float, MemorySpace, cusp::row_major> A(3, 4);
+    for (size_t i = 0; i < A.num_rows; i++)
+        for (size_t j = 0; j < A.num_cols; j++)
+            A(i,j) = 10 * i + j;
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    // the orientation of the destination may differ
+    cusp::array2d<float, MemorySpace, cusp::row_major>    B;
+    cusp::array2d<float, MemorySpace, cusp::column_major> C;
+    cusp::io::read_binary(B, binary_file_name);
+    cusp::io::read_binary(C, binary_file_name);
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(B.num_rows, A.num_rows);
+    ASSERT_EQUAL(B.num_cols, A.num_cols);
+    ASSERT_EQUAL(B.values,   A.values);
+    ASSERT_EQUAL(C == A, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadWriteBinaryArray2d);
+
+template <class TestMatrix>
+void TestReadWriteBinarySparseMatrix(void)
+{
+    // nonsymmetric matrix with one long row so HYB has a COO part
+    cusp::array2d<float, cusp::host_memory> D;
+    cusp::gallery::poisson5pt(D, 5, 4);
+    for (size_t j = 0; j < D.num_cols; j += 2)
+        D(3,j) = 0.5f * j + 1.0f;
+
+    TestMatrix A(D);
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    TestMatrix B;
+    cusp::io::read_binary(B, binary_file_name);
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(B.num_rows,    A.num_rows);
+    ASSERT_EQUAL(B.num_cols,    A.num_cols);
+    ASSERT_EQUAL(B.num_entries, A.num_entries);
+
+    cusp::array2d<float, cusp::host_memory> E(B);
+    ASSERT_EQUAL(E == D, true);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestReadWriteBinarySparseMatrix);
+
+template <typename Matrix, typename View>
+void verify_binary_view(void)
+{
+    cusp::array2d<float, cusp::host_memory> D;
+    cusp::gallery::poisson5pt(D, 6, 5);
+    D(0, D.num_cols - 1) = 3.0f;
+
+    Matrix A(D);
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_cols);
+    for (size_t i = 0; i < x.size(); i++)
+        x[i] = (i * 5) % 7 - 3.0f;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+    cusp::array1d<float, cusp::host_memory> expected(A.num_rows);
+    cusp::multiply(A, x, expected);
+
+    {
+        cusp::io::binary_file file(binary_file_name, true);
+
+        View V = file.view<View>();
+
+        ASSERT_EQUAL(V.num_rows,    A.num_rows);
+        ASSERT_EQUAL(V.num_cols,    A.num_cols);
+        ASSERT_EQUAL(V.num_entries, A.num_entries);
+
+        cusp::multiply(V, x, y);
+    }
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(y, expected);
+}
+
+void TestBinaryFileView(void)
+{
+    typedef cusp::io::binary_views<int, float> Views;
+
+    verify_binary_view< cusp::coo_matrix<int, float, cusp::host_memory>, Views::coo_matrix >();
+    verify_binary_view< cusp::csr_matrix<int, float, cusp::host_memory>, Views::csr_matrix >();
+    verify_binary_view< cusp::dia_matrix<int, float, cusp::host_memory>, Views::dia_matrix >();
+    verify_binary_view< cusp::ell_matrix<int, float, cusp::host_memory>, Views::ell_matrix >();
+}
+DECLARE_UNITTEST(TestBinaryFileView);
+
+void TestBinaryFileViewArray(void)
+{
+    typedef cusp::io::binary_views<int, double> Views;
+
+    cusp::array2d<double, cusp::host_memory, cusp::column_major> A(4, 3);
+    for (size_t i = 0; i < A.num_rows; i++)
+        for (size_t j = 0; j < A.num_cols; j++)
+            A(i,j) = i - 2.0 * j;
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    {
+        cusp::io::binary_file file(binary_file_name);
+
+        Views::array2d_column_major V = file.view<Views::array2d_column_major>();
+
+        ASSERT_EQUAL(V.num_rows, A.num_rows);
+        ASSERT_EQUAL(V.num_cols, A.num_cols);
+        for (size_t i = 0; i < A.num_rows; i++)
+            for (size_t j = 0; j < A.num_cols; j++)
+                ASSERT_EQUAL(V(i,j), A(i,j));
+
+        // stored orientation must match the view
+        ASSERT_THROWS(file.view<Views::array2d>(), cusp::io_exception);
+        ASSERT_THROWS(file.view<Views::array1d>(), cusp::io_exception);
+    }
+
+    remove(binary_file_name);
+}
+DECLARE_UNITTEST(TestBinaryFileViewArray);
+
+void TestReadBinaryMismatch(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    cusp::csr_matrix<int, double, cusp::host_memory> B;
+    cusp::coo_matrix<int, float, cusp::host_memory>  C;
+    cusp::csr_matrix<long long, float, cusp::host_memory> D;
+
+    ASSERT_THROWS((cusp::io::read_binary(B, binary_file_name)), cusp::io_exception);
+    ASSERT_THROWS((cusp::io::read_binary(C, binary_file_name)), cusp::io_exception);
+    ASSERT_THROWS((cusp::io::read_binary(D, binary_file_name)), cusp::io_exception);
+
+    remove(binary_file_name);
+
+    ASSERT_THROWS((cusp::io::read_binary(A, binary_file_name)), cusp::io_exception);
+}
+DECLARE_UNITTEST(TestReadBinaryMismatch);
+
+void TestReadBinaryChecksum(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::io::write_binary(A, binary_file_name);
+
+    // corrupt the last value
+    FILE * file = fopen(binary_file_name, "r+b");
+    fseek(file, -1, SEEK_END);
+    fputc(0x5a, file);
+    fclose(file);
+
+    cusp::csr_matrix<int, float, cusp::host_memory> B;
+    ASSERT_THROWS((cusp::io::read_binary(B, binary_file_name)), cusp::io_exception);
+    ASSERT_THROWS((cusp::io::binary_file(binary_file_name, true)), cusp::io_exception);
+
+    // without verification the mapping is handed out as is
+    {
+        cusp::io::binary_file mapped(binary_file_name);
+        ASSERT_EQUAL(mapped.num_entries(), A.num_entries);
+    }
+
+    remove(binary_file_name);
+}
+DECLARE_UNITTEST(TestReadBinaryChecksum);
+
+
+// stores value at offset in the byte order opposite to the host's
+template <typename T>
+void put_foreign(std::vector<char>& bytes, size_t offset, T value)
+{
+    std::memcpy(&bytes[offset], &value, sizeof(T));
+    std::reverse(&bytes[offset], &bytes[offset] + sizeof(T));
+}
+
+void TestReadBinaryForeignByteOrder(void)
+{
+    using namespace cusp::io::detail;
+
+    // a 3x3 csr_matrix written by a machine with the other byte order
+    // (big-endian on x86), built field by field
+    const int   row_offsets[]    = {0, 2, 3, 5};
+    const int   column_indices[] = {0, 2, 1, 0, 2};
+    const float values[]         = {1.5f, -2.0f, 3.25f, 4.0f, -0.5f};
+
+    const size_t offsets[] = {256, 320, 384};
+    const size_t sizes[]   = {4, 5, 5};
+
+    std::vector<char> bytes(404, 0);
+
+    std::memcpy(&bytes[0], binary_magic, sizeof(binary_magic));
+    put_foreign(bytes, offsetof(binary_header, version),      binary_version);
+    put_foreign(bytes, offsetof(binary_header, byte_order),   binary_byte_order);
+    put_foreign(bytes, offsetof(binary_header, format),       (unsigned int) binary_csr);
+    put_foreign(bytes, offsetof(binary_header, index_type),   binary_type<int>::tag);
+    put_foreign(bytes, offsetof(binary_header, value_type),   binary_type<float>::tag);
+    put_foreign(bytes, offsetof(binary_header, flags),        binary_has_checksums);
+    put_foreign(bytes, offsetof(binary_header, num_sections), 3u);
+    put_foreign(bytes, offsetof(binary_header, num_rows),     3ull);
+    put_foreign(bytes, offsetof(binary_header, num_cols),     3ull);
+    put_foreign(bytes, offsetof(binary_header, num_entries),  5ull);
+
+    for (size_t i = 0; i < 4; i++) put_foreign(bytes, offsets[0] + 4 * i, row_offsets[i]);
+    for (size_t i = 0; i < 5; i++) put_foreign(bytes, offsets[1] + 4 * i, column_indices[i]);
+    for (size_t i = 0; i < 5; i++) put_foreign(bytes, offsets[2] + 4 * i, values[i]);
+
+    for (size_t i = 0; i < 3; i++)
+    {
+        const size_t section = sizeof(binary_header) + i * sizeof(binary_section);
+        const unsigned int type = i < 2 ? binary_type<int>::tag : binary_type<float>::tag;
+
+        put_foreign(bytes, section + offsetof(binary_section, offset),   (unsigned long long) offsets[i]);
+        put_foreign(bytes, section + offsetof(binary_section, size),     (unsigned long long) sizes[i]);
+        put_foreign(bytes, section + offsetof(binary_section, checksum), binary_checksum(&bytes[offsets[i]], 4 * sizes[i]));
+        put_foreign(bytes, section + offsetof(binary_section, type),     type);
+    }
+
+    {
+        std::ofstream file(binary_file_name, std::ios::binary);
+        file.write(&bytes[0], bytes.size());
+    }
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::io::read_binary(A, binary_file_name);
+
+    // mapped views cannot convert the byte order
+    {
+        cusp::io::binary_file mapped(binary_file_name, true);
+        ASSERT_EQUAL(mapped.num_entries(), (size_t) 5);
+        ASSERT_THROWS((mapped.view<cusp::io::binary_views<int, float>::csr_matrix>()), cusp::io_exception);
+    }
+
+    remove(binary_file_name);
+
+    ASSERT_EQUAL(A.num_rows,    (size_t) 3);
+    ASSERT_EQUAL(A.num_cols,    (size_t) 3);
+    ASSERT_EQUAL(A.num_entries, (size_t) 5);
+    for (size_t i = 0; i < 4; i++) ASSERT_EQUAL(A.row_offsets[i],    row_offsets[i]);
+    for (size_t i = 0; i < 5; i++) ASSERT_EQUAL(A.column_indices[i], column_indices[i]);
+    for (size_t i = 0; i < 5; i++) ASSERT_EQUAL(A.values[i],         values[i]);
+}
+DECLARE_UNITTEST(TestReadBinaryForeignByteOrder);
+
+void TestReadBinaryInvalidPitch(void)
+{
+    using namespace cusp::io::detail;
+
+    typedef cusp::io::binary_views<int, float>::array2d View;
+
+    cusp::array2d<float, cusp::host_memory> A(3, 4, 1.0f);
+
+    // a pitch that overruns the section, then one shorter than a row
+    const unsigned long long pitches[] = {100, 2};
+
+    for (size_t k = 0; k < 2; k++)
+    {
+        cusp::io::write_binary(A, binary_file_name);
+
+        FILE * file = fopen(binary_file_name, "r+b");
+        fseek(file, sizeof(binary_header) + offsetof(binary_section, pitch), SEEK_SET);
+        fwrite(&pitches[k], sizeof(unsigned long long), 1, file);
+        fclose(file);
+
+        cusp::array2d<float, cusp::host_memory> B;
+        ASSERT_THROWS((cusp::io::read_binary(B, binary_file_name)), cusp::io_exception);
+
+        cusp::io::binary_file mapped(binary_file_name);
+        ASSERT_THROWS((mapped.view<View>()), cusp::io_exception);
+    }
+
+    remove(binary_file_name);
+}
+DECLARE_UNITTEST(TestReadBinaryInvalidPitch);
@@ -0,0 +1,140 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/block_jacobi.h>
+#include <cusp/precond/diagonal.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/multiply.h>
+
+void TestBlockJacobiExactOnBlockDiagonal(void)
+{
+    // block diagonal matrix with blocks of size 1, 2 and 3
+    cusp::array2d<double, cusp::host_memory> D(6, 6, 0.0);
+    D(0,0) = 2;
+    D(1,1) = 1; D(1,2) = 3;
+    D(2,1) = 4; D(2,2) = 1;
+    D(3,3) = 2; D(3,4) = 1; D(3,5) = 5;
+    D(4,3) = 0; D(4,4) = 3; D(4,5) = 1;
+    D(5,3) = 6; D(5,4) = 1; D(5,5) = 2;
+
+    cusp::csr_matrix<int, double, cusp::host_memory> A(D);
+
+    cusp::array1d<int, cusp::host_memory> offsets(4);
+    offsets[0] = 0; offsets[1] = 1; offsets[2] = 3; offsets[3] = 6;
+
+    cusp::precond::block_jacobi<double, cusp::host_memory> M(A, offsets);
+
+    ASSERT_EQUAL(M.num_blocks(), 3);
+    ASSERT_EQUAL(M.block_size(), 0);
+
+    cusp::array1d<double, cusp::host_memory> x(6);
+    for (int i = 0; i < 6; i++)
+        x[i] = i + 1;
+
+    cusp::array1d<double, cusp::host_memory> Ax(6);
+    cusp::array1d<double, cusp::host_memory> y(6);
+    cusp::multiply(A, x, Ax);
+    M(Ax, y);
+
+    ASSERT_ALMOST_EQUAL(y, x);
+}
+DECLARE_UNITTEST(TestBlockJacobiExactOnBlockDiagonal);
+
+void TestBlockJacobiFixedSize(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 5, 5);
+
+    // 25 rows in blocks of 4 leave a last block of 1 row
+    for (size_t block_size = 1; block_size <= 9; block_size++)
+    {
+        cusp::precond::block_jacobi<double, cusp::host_memory> M(A, block_size);
+
+        ASSERT_EQUAL(M.num_blocks(), (A.num_rows + block_size - 1) / block_size);
+        ASSERT_EQUAL(M.block_size(), A.num_rows % block_size == 0 ? block_size : 0);
+
+        // compare with the same blocks given as offsets
+        cusp::array1d<int, cusp::host_memory> offsets(M.num_blocks() + 1);
+        for (size_t k = 0; k < M.num_blocks(); k++)
+            offsets[k] = k * block_size;
+        offsets[M.num_blocks()] = A.num_rows;
+
+        cusp::precond::block_jacobi<double, cusp::host_memory> N(A, offsets);
+
+        cusp::array1d<double, cusp::host_memory> x(A.num_rows);
+        for (size_t i = 0; i < A.num_rows; i++)
+            x[i] = (i % 7) - 3.0;
+
+        cusp::array1d<double, cusp::host_memory> y0(A.num_rows);
+        cusp::array1d<double, cusp::host_memory> y1(A.num_rows);
+        M(x, y0);
+        N(x, y1);
+
+        ASSERT_ALMOST_EQUAL(y0, y1);
+
+        // applying in place gives the same result
+        M(x, x);
+        ASSERT_ALMOST_EQUAL(x, y0);
+    }
+}
+DECLARE_UNITTEST(TestBlockJacobiFixedSize);
+
+void TestBlockJacobiCoupledSystem(void)
+{
+    // three strongly coupled unknowns per node: A = P (x) C
+    cusp::coo_matrix<int, float, cusp::host_memory> P;
+    cusp::gallery::poisson5pt(P, 12, 12);
+
+    float C[3][3] = {{1.0f, 0.9f, 0.9f},
+                     {0.9f, 1.0f, 0.9f},
+                     {0.9f, 0.9f, 1.0f}};
+
+    cusp::coo_matrix<int, float, cusp::host_memory> A(3 * P.num_rows, 3 * P.num_cols, 9 * P.num_entries);
+    for (size_t n = 0, k = 0; n < P.num_entries; n++)
+        for (int a = 0; a < 3; a++)
+            for (int b = 0; b < 3; b++, k++)
+            {
+                A.row_indices[k]    = 3 * P.row_indices[n] + a;
+                A.column_indices[k] = 3 * P.column_indices[n] + b;
+                A.values[k]         = P.values[n] * C[a][b];
+            }
+    A.sort_by_row_and_column();
+
+    cusp::csr_matrix<int, float, cusp::host_memory> B(A);
+
+    cusp::array1d<float, cusp::host_memory> b(B.num_rows, 1.0f);
+
+    cusp::array1d<float, cusp::host_memory> x0(B.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 500, 1e-5);
+    cusp::precond::diagonal<float, cusp::host_memory> M0(B);
+    cusp::krylov::cg(B, x0, b, monitor0, M0);
+
+    cusp::array1d<float, cusp::host_memory> x1(B.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 500, 1e-5);
+    cusp::precond::block_jacobi<float, cusp::host_memory> M1(B, 3);
+    cusp::krylov::cg(B, x1, b, monitor1, M1);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+}
+DECLARE_UNITTEST(TestBlockJacobiCoupledSystem);
+
+void TestBlockJacobiInvalidInput(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 3, 3);
+
+    ASSERT_THROWS((cusp::precond::block_jacobi<float, cusp::host_memory>(A, size_t(0))), cusp::invalid_input_exception);
+
+    cusp::array1d<int, cusp::host_memory> offsets(2);
+    offsets[0] = 0; offsets[1] = 5;
+    ASSERT_THROWS((cusp::precond::block_jacobi<float, cusp::host_memory>(A, offsets)), cusp::invalid_input_exception);
+
+    // a zero block is singular
+    cusp::csr_matrix<int, float, cusp::host_memory> Z(2, 2, 0);
+    Z.row_offsets[0] = 0; Z.row_offsets[1] = 0; Z.row_offsets[2] = 0;
+    ASSERT_THROWS((cusp::precond::block_jacobi<float, cusp::host_memory>(Z, size_t(2))), cusp::runtime_exception);
+}
+DECLARE_UNITTEST(TestBlockJacobiInvalidInput);
@@ -69,3 +69,30 @@ void TestConjugateGradientM(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientM);
 
+
+template <class MemorySpace>
+void TestConjugateGradientMBlocked(void)
+{
+    typedef float ValueType;
+
+    // more rows than one block of the host kernels
+    cusp::csr_matrix<int, ValueType, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 80, 80);
+
+    size_t N_s = 3;
+    cusp::array1d<ValueType, MemorySpace> x(A.num_rows*N_s, ValueType(0));
+    cusp::array1d<ValueType, MemorySpace> b(A.num_rows, ValueType(1));
+
+    // the large shifts converge long before the seed system
+    cusp::array1d<ValueType, MemorySpace> sigma(N_s);
+    sigma[0] = ValueType(0.05);
+    sigma[1] = ValueType(2.0);
+    sigma[2] = ValueType(50.0);
+
+    cusp::default_monitor<ValueType> monitor(b, 1000, 1e-6);
+
+    cusp::krylov::cg_m(A, x, b, sigma, monitor);
+
+    check_residuals(A, x, b, sigma);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientMBlocked);
@@ -0,0 +1,163 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/chebyshev.h>
+
+template <class MemorySpace>
+void TestChebyshevIteration(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::default_monitor<float> monitor(b, 200, 1e-4);
+
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_cols);
+
+    // eigenvalues of the 5-point Laplacian lie in (0,8)
+    cusp::krylov::chebyshev(A, x, b, monitor, M, 0.15f, 8.0f);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevIteration);
+
+
+template <class MemorySpace>
+void TestChebyshevIterationEstimatedBounds(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::default_monitor<float> monitor(b, 200, 1e-4);
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevIterationEstimatedBounds);
+
+
+template <class MemorySpace>
+void TestChebyshevIterationZeroResidual(void)
+{
+    cusp::array2d<float, MemorySpace> M(2,2);
+    M(0,0) = 8; M(0,1) = 0;
+    M(1,0) = 0; M(1,1) = 4;
+
+    cusp::csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows);
+
+    cusp::multiply(A, x, b);
+
+    cusp::default_monitor<float> monitor(b, 20, 0.0f);
+
+    cusp::identity_operator<float, MemorySpace> I(A.num_rows, A.num_cols);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, I, 4.0f, 8.0f);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(),        true);
+    ASSERT_EQUAL(monitor.iteration_count(),     0);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevIterationZeroResidual);
+
+
+template <class MemorySpace>
+void TestChebyshevIterationEstimatedBoundsBreakdown(void)
+{
+    // every vector is an eigenvector, so Lanczos breaks down at once
+    cusp::array2d<double, cusp::host_memory> D(20, 20, 0.0);
+    for (size_t i = 0; i < D.num_rows; i++)
+        D(i,i) = 5.0;
+
+    cusp::csr_matrix<int, double, MemorySpace> A(D);
+
+    cusp::identity_operator<double, MemorySpace> M(A.num_rows, A.num_cols);
+
+    double lambda_min, lambda_max;
+    cusp::krylov::detail::chebyshev_bounds(A, M, lambda_min, lambda_max);
+
+    ASSERT_EQUAL(lambda_min < 5.0 && 5.0 < lambda_max, true);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0.0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1.0);
+
+    cusp::default_monitor<double> monitor(b, 20, 1e-8);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevIterationEstimatedBoundsBreakdown);
+
+template <class MemorySpace>
+void TestChebyshevIterationEstimatedBoundsEarlyBreakdown(void)
+{
+    // two distinct eigenvalues: Lanczos breaks down after two steps
+    cusp::array2d<double, cusp::host_memory> D(20, 20, 0.0);
+    for (size_t i = 0; i < D.num_rows; i++)
+        D(i,i) = (i % 2) ? 10.0 : 1.0;
+
+    cusp::csr_matrix<int, double, MemorySpace> A(D);
+
+    cusp::identity_operator<double, MemorySpace> M(A.num_rows, A.num_cols);
+
+    double lambda_min, lambda_max;
+    cusp::krylov::detail::chebyshev_bounds(A, M, lambda_min, lambda_max);
+
+    ASSERT_EQUAL(0.0 < lambda_min && lambda_min <= 1.0 && 10.0 <= lambda_max, true);
+
+    cusp::array1d<double, MemorySpace> x(A.num_rows, 0.0);
+    cusp::array1d<double, MemorySpace> b(A.num_rows, 1.0);
+
+    cusp::default_monitor<double> monitor(b, 100, 1e-8);
+
+    cusp::krylov::chebyshev(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    // fewer unknowns than Lanczos steps: the last step is kept
+    cusp::array2d<double, cusp::host_memory> E(5, 5, 0.0);
+    for (size_t i = 0; i < E.num_rows; i++)
+        E(i,i) = i + 1.0;
+
+    cusp::csr_matrix<int, double, MemorySpace> B(E);
+
+    cusp::identity_operator<double, MemorySpace> I(B.num_rows, B.num_cols);
+
+    cusp::krylov::detail::chebyshev_bounds(B, I, lambda_min, lambda_max);
+
+    ASSERT_EQUAL(0.0 < lambda_min && lambda_min <= 1.0 && 5.0 <= lambda_max, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestChebyshevIterationEstimatedBoundsEarlyBreakdown);
@@ -0,0 +1,90 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/krylov/checkpoint.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/gmres.h>
+
+template <class MemorySpace>
+void TestCheckpointConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_rows);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    // uninterrupted solve
+    cusp::array1d<float, MemorySpace> x_ref(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor_ref(b, 100, 1e-5);
+    cusp::krylov::cg(A, x_ref, b, monitor_ref, M);
+
+    cusp::krylov::checkpoint ckpt("checkpoint_cg.tmp", 5);
+
+    // the iteration limit stands in for a killed job after 12 iterations,
+    // the last snapshot is taken after iteration 10
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    {
+        cusp::default_monitor<float> monitor(b, 12, 1e-5);
+        cusp::krylov::cg(A, x, b, monitor, M, ckpt);
+    }
+    ASSERT_EQUAL(ckpt.exists(), true);
+
+    // resume into a fresh vector
+    cusp::array1d<float, MemorySpace> x_resumed(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor(b, 100, 1e-5);
+    cusp::krylov::cg_resume(A, x_resumed, b, monitor, M, ckpt);
+
+    ASSERT_EQUAL(monitor.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(x_resumed, x_ref);
+
+    ckpt.remove();
+    ASSERT_EQUAL(ckpt.exists(), false);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCheckpointConjugateGradient);
+
+template <class MemorySpace>
+void TestCheckpointGmres(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::identity_operator<float, MemorySpace> M(A.num_rows, A.num_rows);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::array1d<float, MemorySpace> x_ref(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor_ref(b, 200, 1e-5);
+    cusp::krylov::gmres(A, x_ref, b, 7, monitor_ref, M);
+
+    // snapshots fall in the middle of a restart cycle
+    cusp::krylov::checkpoint ckpt("checkpoint_gmres.tmp", 5);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    {
+        cusp::default_monitor<float> monitor(b, 23, 1e-5);
+        cusp::krylov::gmres(A, x, b, 7, monitor, M, ckpt);
+    }
+
+    cusp::array1d<float, MemorySpace> x_resumed(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor(b, 200, 1e-5);
+    cusp::krylov::gmres_resume(A, x_resumed, b, 7, monitor, M, ckpt);
+
+    ASSERT_EQUAL(monitor.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(monitor.converged(), monitor_ref.converged());
+    ASSERT_EQUAL(x_resumed, x_ref);
+
+    // a different restart length does not match the snapshot
+    cusp::default_monitor<float> monitor_bad(b, 200, 1e-5);
+    ASSERT_THROWS(cusp::krylov::gmres_resume(A, x_resumed, b, 8, monitor_bad, M, ckpt), cusp::io_exception);
+
+    // neither does a different solver
+    ASSERT_THROWS(cusp::krylov::cg_resume(A, x_resumed, b, monitor_bad, M, ckpt), cusp::io_exception);
+
+    ckpt.remove();
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCheckpointGmres);
@@ -0,0 +1,109 @@
+#include <unittest/unittest.h>
+
+#include <cusp/composite_operator.h>
+
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/dia_matrix.h>
+#include <cusp/ell_matrix.h>
+#include <cusp/hyb_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/transpose.h>
+
+template <typename MatrixType>
+void initialize_composite_matrices(MatrixType& A, MatrixType& B)
+{
+    cusp::array2d<float, cusp::host_memory> D(4,4);
+
+    D(0,0) =  2.0;  D(0,1) = -1.0;  D(0,2) =  0.0;  D(0,3) =  0.5;
+    D(1,0) = -1.0;  D(1,1) =  3.0;  D(1,2) = -1.0;  D(1,3) =  0.0;
+    D(2,0) =  0.0;  D(2,1) = -2.0;  D(2,2) =  4.0;  D(2,3) = -1.0;
+    D(3,0) =  1.0;  D(3,1) =  0.0;  D(3,2) = -1.0;  D(3,3) =  5.0;
+
+    A = D;
+
+    D(0,0) =  1.0;  D(0,1) =  0.0;  D(0,2) =  2.0;  D(0,3) =  0.0;
+    D(1,0) =  0.0;  D(1,1) = -1.0;  D(1,2) =  0.0;  D(1,3) =  3.0;
+    D(2,0) =  4.0;  D(2,1) =  0.0;  D(2,2) =  1.0;  D(2,3) =  0.0;
+    D(3,0) =  0.0;  D(3,1) =  0.5;  D(3,2) =  0.0;  D(3,3) = -2.0;
+
+    B = D;
+}
+
+template <typename SparseMatrix>
+void TestCompositeOperators(void)
+{
+    typedef typename SparseMatrix::value_type   ValueType;
+    typedef typename SparseMatrix::memory_space MemorySpace;
+    typedef cusp::array1d<ValueType, MemorySpace> Array;
+
+    SparseMatrix A, B;
+    initialize_composite_matrices(A, B);
+
+    Array x(4);
+    x[0] = 1.0;  x[1] = -2.0;  x[2] = 3.0;  x[3] = 0.5;
+
+    Array Ax(4), Bx(4);
+    cusp::multiply(A, x, Ax);
+    cusp::multiply(B, x, Bx);
+
+    Array y(4), expected(4);
+
+    // alpha * A
+    cusp::scaled_operator<SparseMatrix> A_scaled = cusp::make_scaled_operator(A, 3.0f);
+    cusp::multiply(A_scaled, x, y);
+    cusp::blas::axpby(Ax, Ax, expected, ValueType(3), ValueType(0));
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // A - sigma * I
+    cusp::make_shifted_operator(A, -1.5f)(x, y);
+    cusp::blas::axpby(Ax, x, expected, ValueType(1), ValueType(-1.5));
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // diag(d) * A
+    Array d(4);
+    d[0] = 0.5;  d[1] = 2.0;  d[2] = -1.0;  d[3] = 0.25;
+    cusp::make_diagonal_scaled_operator(d, A)(x, y);
+    cusp::blas::xmy(d, Ax, expected);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // alpha * A + beta * B
+    cusp::make_sum_operator(A, B, 2.0f, -0.5f)(x, y);
+    cusp::blas::axpby(Ax, Bx, expected, ValueType(2), ValueType(-0.5));
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // A * B
+    cusp::make_product_operator(A, B)(x, y);
+    cusp::multiply(A, Bx, expected);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // A^T
+    {
+        SparseMatrix At;
+        cusp::transpose(A, At);
+        cusp::make_transpose_operator(A)(x, y);
+        cusp::multiply(At, x, expected);
+        ASSERT_ALMOST_EQUAL(y, expected);
+    }
+
+    // nested expression: (2 A - I) + B
+    cusp::make_sum_operator(cusp::make_shifted_operator(cusp::make_scaled_operator(A, 2.0f), -1.0f), B)(x, y);
+    cusp::blas::axpbypcz(Ax, x, Bx, expected, ValueType(2), ValueType(-1), ValueType(1));
+    ASSERT_ALMOST_EQUAL(y, expected);
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestCompositeOperators);
+
+template <typename MemorySpace>
+void TestCompositeOperatorsInvalidShapes(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A(4, 3, 0);
+    cusp::csr_matrix<int, float, MemorySpace> B(4, 4, 0);
+    cusp::array1d<float, MemorySpace> d(3);
+
+    ASSERT_THROWS((cusp::make_shifted_operator(A, 1.0f)), cusp::invalid_input_exception);
+    ASSERT_THROWS((cusp::make_diagonal_scaled_operator(d, A)), cusp::invalid_input_exception);
+    ASSERT_THROWS((cusp::make_sum_operator(A, B)), cusp::invalid_input_exception);
+    ASSERT_THROWS((cusp::make_product_operator(A, A)), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestCompositeOperatorsInvalidShapes);
@@ -0,0 +1,165 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/deflated_cg.h>
+
+#include <cmath>
+
+template <class MemorySpace>
+void TestDeflatedConjugateGradient(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::krylov::recycle_space<float, MemorySpace> space(8);
+
+    for (int i = 0; i < 3; i++)
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        cusp::array1d<float, MemorySpace> b(A.num_rows, float(i + 1));
+        b[i] = 0.0f;
+
+        cusp::default_monitor<float> monitor(b, 200, 1e-4);
+
+        cusp::krylov::deflated_cg(A, x, b, space, monitor);
+
+        // check residual norm
+        cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+        ASSERT_EQUAL(space.size(), 8);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDeflatedConjugateGradient);
+
+
+template <class MemorySpace>
+void TestDeflatedConjugateGradientRecycling(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+
+    // plain PCG
+    cusp::array1d<float, MemorySpace> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 200, 1e-5);
+    cusp::krylov::cg(A, x0, b, monitor0, M);
+
+    // the first solve fills the space, the second one uses it
+    cusp::krylov::recycle_space<float, MemorySpace> space(8);
+
+    cusp::array1d<float, MemorySpace> x1(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 200, 1e-5);
+    cusp::krylov::deflated_cg(A, x1, b, space, monitor1, M);
+
+    cusp::array1d<float, MemorySpace> x2(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor2(b, 200, 1e-5);
+    cusp::krylov::deflated_cg(A, x2, b, space, monitor2, M);
+
+    ASSERT_EQUAL(monitor0.converged(), true);
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor2.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count(), monitor0.iteration_count());
+    ASSERT_EQUAL(monitor2.iteration_count() < monitor0.iteration_count(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestDeflatedConjugateGradientRecycling);
+
+
+template <class MemorySpace>
+void TestRecycleSpaceUpdate(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::krylov::recycle_space<float, MemorySpace> space(4);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    cusp::krylov::deflated_cg(A, x, b, space);
+
+    ASSERT_EQUAL(space.size(), 4);
+
+    // scale the matrix and refresh C = A U
+    cusp::blas::scal(A.values, 2.0f);
+    space.update(A);
+
+    ASSERT_EQUAL(space.size(), 4);
+
+    for (size_t j = 0; j < space.size(); j++)
+    {
+        cusp::array1d<float, MemorySpace> u(space.U.column(j));
+        cusp::array1d<float, MemorySpace> c(space.C.column(j));
+        cusp::array1d<float, MemorySpace> Au(A.num_rows);
+
+        cusp::multiply(A, u, Au);
+        cusp::blas::axpy(c, Au, -1.0f);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(Au) < 1e-4, true);
+        ASSERT_EQUAL(std::fabs(cusp::blas::nrm2(c) - 1.0f) < 1e-4, true);
+
+        for (size_t i = 0; i < j; i++)
+            ASSERT_EQUAL(std::fabs(cusp::blas::dotc(space.C.column(i), c)) < 1e-4, true);
+    }
+
+    space.clear();
+    ASSERT_EQUAL(space.empty(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRecycleSpaceUpdate);
+
+
+template <class MemorySpace>
+void TestRecycleSpaceDependentColumns(void)
+{
+    typedef typename cusp::krylov::recycle_space<float, MemorySpace>::basis_type Basis;
+
+    const size_t N = 50;
+
+    // the third column is a combination of the first two, so it only
+    // survives orthogonalization as rounding error
+    cusp::array2d<float, cusp::host_memory, cusp::column_major> V(N, 4);
+    for (size_t i = 0; i < N; i++)
+    {
+        V(i,0) = std::sin(float(i + 1));
+        V(i,1) = std::cos(float(3 * i));
+        V(i,2) = 0.3f * V(i,0) + 0.7f * V(i,1);
+        V(i,3) = float(i % 5);
+    }
+
+    // C = A U with A = I
+    Basis U(V);
+    Basis C(V);
+
+    cusp::krylov::recycle_space<float, MemorySpace> space(4);
+    space.assign(U, C, 4);
+
+    ASSERT_EQUAL(space.size(), 3);
+
+    for (size_t j = 0; j < space.size(); j++)
+    {
+        cusp::array1d<float, MemorySpace> u(space.U.column(j));
+        cusp::array1d<float, MemorySpace> c(space.C.column(j));
+
+        ASSERT_EQUAL(std::fabs(cusp::blas::nrm2(c) - 1.0f) < 1e-4, true);
+
+        cusp::blas::axpy(c, u, -1.0f);
+        ASSERT_EQUAL(cusp::blas::nrm2(u) < 1e-4, true);
+
+        for (size_t i = 0; i < j; i++)
+            ASSERT_EQUAL(std::fabs(cusp::blas::dotc(space.C.column(i), c)) < 1e-4, true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestRecycleSpaceDependentColumns);
+
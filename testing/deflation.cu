@@ -0,0 +1,115 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/deflation.h>
+#include <cusp/precond/diagonal.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/multiply.h>
+
+void TestDeflationExactCoarseSolve(void)
+{
+    // a matrix below the coarse size limit is its own coarse space, M = A^-1
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 5, 5);
+
+    cusp::array1d<double, cusp::host_memory> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i % 3) - 1.0;
+
+    cusp::array1d<double, cusp::host_memory> Ax(A.num_rows);
+    cusp::multiply(A, x, Ax);
+
+    for (int variant = 0; variant < 2; variant++)
+    {
+        cusp::precond::deflation<double, cusp::host_memory>
+            M(A, cusp::precond::deflation_jacobi,
+              variant ? cusp::precond::deflation_adef2 : cusp::precond::deflation_balancing);
+
+        ASSERT_EQUAL(M.coarse_size(), A.num_rows);
+
+        cusp::array1d<double, cusp::host_memory> y(A.num_rows);
+        M(Ax, y);
+
+        ASSERT_ALMOST_EQUAL(y, x);
+    }
+}
+DECLARE_UNITTEST(TestDeflationExactCoarseSolve);
+
+void TestDeflationStalledAggregation(void)
+{
+    // a diagonal matrix has no strong connections, so nothing aggregates
+    cusp::csr_matrix<int, double, cusp::host_memory> A(50, 50, 50);
+    for (size_t i = 0; i < A.num_rows; i++)
+    {
+        A.row_offsets[i]    = i;
+        A.column_indices[i] = i;
+        A.values[i]         = 2.0;
+    }
+    A.row_offsets[A.num_rows] = A.num_rows;
+
+    ASSERT_THROWS((cusp::precond::deflation<double, cusp::host_memory>
+                   (A, cusp::precond::deflation_jacobi, cusp::precond::deflation_balancing, 10)),
+                  cusp::runtime_exception);
+}
+DECLARE_UNITTEST(TestDeflationStalledAggregation);
+
+template <class MemorySpace>
+void _TestDeflationCG(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 40, 40);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::array1d<float, MemorySpace> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 500, 1e-5);
+    cusp::precond::diagonal<float, MemorySpace> M0(A);
+    cusp::krylov::cg(A, x0, b, monitor0, M0);
+
+    cusp::precond::deflation_smoother smoothers[2] = { cusp::precond::deflation_jacobi,
+                                                       cusp::precond::deflation_chebyshev };
+
+    for (int i = 0; i < 2; i++)
+    {
+        cusp::precond::deflation<float, MemorySpace> M1(A, smoothers[i], cusp::precond::deflation_balancing, 200);
+
+        ASSERT_EQUAL(M1.coarse_size() <= 200, true);
+        ASSERT_EQUAL(M1.coarse_size() > 0, true);
+
+        cusp::array1d<float, MemorySpace> x1(A.num_rows, 0.0f);
+        cusp::default_monitor<float> monitor1(b, 500, 1e-5);
+        cusp::krylov::cg(A, x1, b, monitor1, M1);
+
+        ASSERT_EQUAL(monitor1.converged(), true);
+        ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+    }
+}
+
+void TestDeflationCG(void)
+{
+    _TestDeflationCG<cusp::host_memory>();
+    _TestDeflationCG<cusp::device_memory>();
+}
+DECLARE_UNITTEST(TestDeflationCG);
+
+void TestDeflationADEF2(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 40, 40);
+
+    cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1.0f);
+
+    cusp::precond::deflation<float, cusp::host_memory>
+        M(A, cusp::precond::deflation_jacobi, cusp::precond::deflation_adef2, 200);
+
+    // ADEF2 keeps cg in the deflated subspace when started from Q b
+    cusp::array1d<float, cusp::host_memory> x(A.num_rows);
+    M.initial_guess(b, x);
+
+    cusp::default_monitor<float> monitor(b, 500, 1e-5);
+    cusp::krylov::cg(A, x, b, monitor, M);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_UNITTEST(TestDeflationADEF2);
@@ -0,0 +1,114 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/gmres.h>
+#include <cusp/krylov/gcrodr.h>
+
+template <class MemorySpace>
+void TestGCRODR(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::krylov::recycle_space<float, MemorySpace> space(5);
+
+    for (int i = 0; i < 3; i++)
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        cusp::array1d<float, MemorySpace> b(A.num_rows, float(i + 1));
+        b[i] = 0.0f;
+
+        cusp::default_monitor<float> monitor(b, 200, 1e-4);
+
+        cusp::krylov::gcrodr(A, x, b, 20, space, monitor);
+
+        // check residual norm
+        cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGCRODR);
+
+
+template <class MemorySpace>
+void TestGCRODRRecycling(void)
+{
+    // upwinded convection-diffusion in 1D
+    size_t N = 100;
+    cusp::array2d<float, MemorySpace> D(N, N, 0.0f);
+    for (size_t i = 0; i < N; i++)
+    {
+        D(i,i) = 2.0f;
+        if (i > 0)     D(i,i-1) = -1.3f;
+        if (i + 1 < N) D(i,i+1) = -0.7f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(D);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+
+    // restarted GMRES
+    cusp::array1d<float, MemorySpace> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 1000, 1e-5);
+    cusp::krylov::gmres(A, x0, b, 20, monitor0, M);
+
+    // GCRO-DR keeps 5 vectors across cycles and solves
+    cusp::krylov::recycle_space<float, MemorySpace> space(5);
+
+    cusp::array1d<float, MemorySpace> x1(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 1000, 1e-5);
+    cusp::krylov::gcrodr(A, x1, b, 20, space, monitor1, M);
+
+    cusp::array1d<float, MemorySpace> x2(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor2(b, 1000, 1e-5);
+    cusp::krylov::gcrodr(A, x2, b, 20, space, monitor2, M);
+
+    ASSERT_EQUAL(monitor0.converged(), true);
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor2.converged(), true);
+    ASSERT_EQUAL(monitor2.iteration_count() < monitor0.iteration_count(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGCRODRRecycling);
+
+
+template <class MemorySpace>
+void TestGCRODRZeroResidual(void)
+{
+    cusp::array2d<float, MemorySpace> M(2,2);
+    M(0,0) = 8; M(0,1) = 0;
+    M(1,0) = 0; M(1,1) = 4;
+
+    cusp::csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows);
+
+    cusp::multiply(A, x, b);
+
+    cusp::krylov::recycle_space<float, MemorySpace> space(1);
+
+    cusp::default_monitor<float> monitor(b, 20, 0.0f);
+
+    cusp::krylov::gcrodr(A, x, b, 2, space, monitor);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(),        true);
+    ASSERT_EQUAL(monitor.iteration_count(),     0);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGCRODRZeroResidual);
+
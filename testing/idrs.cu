@@ -0,0 +1,127 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/idrs.h>
+
+template <class MemorySpace>
+void TestInducedDimensionReduction(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    for (size_t s = 1; s <= 4; s++)
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+        
+        cusp::default_monitor<float> monitor(b, 100, 1e-4);
+
+        cusp::krylov::idrs(A, x, b, s, monitor);
+        
+        // check residual norm
+        cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+        cusp::multiply(A, x, residual);
+        cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-3 * cusp::blas::nrm2(b), true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestInducedDimensionReduction);
+
+
+template <class MemorySpace>
+void TestInducedDimensionReductionNonsymmetric(void)
+{
+    // upwinded convection-diffusion in 1D
+    size_t N = 50;
+    cusp::array2d<float, MemorySpace> D(N, N, 0.0f);
+    for (size_t i = 0; i < N; i++)
+    {
+        D(i,i) = 3.0f;
+        if (i > 0)     D(i,i-1) = -2.5f;
+        if (i + 1 < N) D(i,i+1) = -0.5f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(D);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    
+    cusp::default_monitor<float> monitor(b, 200, 1e-5);
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+
+    cusp::krylov::idrs(A, x, b, 4, monitor, M);
+    
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual) < 1e-4 * cusp::blas::nrm2(b), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestInducedDimensionReductionNonsymmetric);
+
+
+template <class MemorySpace>
+void TestInducedDimensionReductionZeroResidual(void)
+{
+    cusp::array2d<float, MemorySpace> M(2,2);
+    M(0,0) = 8; M(0,1) = 0;
+    M(1,0) = 0; M(1,1) = 4;
+
+    cusp::csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows);
+
+    cusp::multiply(A, x, b);
+
+    cusp::default_monitor<float> monitor(b, 20, 0.0f);
+    
+    cusp::krylov::idrs(A, x, b, 2, monitor);
+
+    // check residual norm
+    cusp::array1d<float, MemorySpace> residual(A.num_rows, 0.0f);
+    cusp::multiply(A, x, residual);
+    cusp::blas::axpby(residual, b, residual, -1.0f, 1.0f);
+
+    ASSERT_EQUAL(monitor.converged(),        true);
+    ASSERT_EQUAL(monitor.iteration_count(),     0);
+    ASSERT_EQUAL(cusp::blas::nrm2(residual), 0.0f);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestInducedDimensionReductionZeroResidual);
+
+template <class MemorySpace>
+void TestInducedDimensionReductionExactStep(void)
+{
+    // the first step solves 2 I x = b exactly, on an iteration the
+    // monitor does not check
+    cusp::array2d<float, MemorySpace> M(3,3, 0.0f);
+    M(0,0) = 2; M(1,1) = 2; M(2,2) = 2;
+
+    cusp::csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows);
+    b[0] = 2; b[1] = -4; b[2] = 6;
+
+    cusp::default_monitor<float> monitor(b, 20, 1e-6f);
+    monitor.set_check_interval(2);
+
+    cusp::krylov::idrs(A, x, b, 1, monitor);
+
+    cusp::array1d<float, MemorySpace> expected(A.num_rows);
+    expected[0] = 1; expected[1] = -2; expected[2] = 3;
+
+    ASSERT_EQUAL(monitor.converged(), true);
+    ASSERT_EQUAL(x, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestInducedDimensionReductionExactStep);
+
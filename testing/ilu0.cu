@@ -0,0 +1,115 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/ilu0.h>
+#include <cusp/precond/ic0.h>
+#include <cusp/precond/diagonal.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/multiply.h>
+
+void TestILU0Tridiagonal(void)
+{
+    // ILU(0) of a tridiagonal matrix is the exact LU factorization
+    cusp::array2d<double, cusp::host_memory> D(4, 4, 0.0);
+    D(0,0) =  4; D(0,1) = -1;
+    D(1,0) = -2; D(1,1) =  4; D(1,2) = -1;
+                 D(2,1) = -2; D(2,2) =  4; D(2,3) = -1;
+                              D(3,2) = -2; D(3,3) =  4;
+
+    cusp::csr_matrix<int, double, cusp::host_memory> A(D);
+
+    cusp::array1d<double, cusp::host_memory> b(4);
+    b[0] = 1; b[1] = 2; b[2] = 3; b[3] = 4;
+
+    for (int reorder = 0; reorder < 2; reorder++)
+    {
+        cusp::precond::ilu0<double, cusp::host_memory> M(A, reorder == 1);
+
+        cusp::array1d<double, cusp::host_memory> x(4);
+        cusp::array1d<double, cusp::host_memory> Ax(4);
+
+        M(b, x);
+        cusp::multiply(A, x, Ax);
+
+        ASSERT_ALMOST_EQUAL(Ax, b);
+    }
+}
+DECLARE_UNITTEST(TestILU0Tridiagonal);
+
+void TestILU0Bicgstab(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::array1d<float, cusp::host_memory> b(A.num_rows, 1.0f);
+
+    cusp::array1d<float, cusp::host_memory> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 200, 1e-5);
+    cusp::precond::diagonal<float, cusp::host_memory> M0(A);
+    cusp::krylov::bicgstab(A, x0, b, monitor0, M0);
+
+    cusp::array1d<float, cusp::host_memory> x1(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 200, 1e-5);
+    cusp::precond::ilu0<float, cusp::host_memory> M1(A);
+    cusp::krylov::bicgstab(A, x1, b, monitor1, M1);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+
+    // the level-ordered layout gives the same preconditioner
+    cusp::precond::ilu0<float, cusp::host_memory> M2(A, true);
+    cusp::array1d<float, cusp::host_memory> y1(A.num_rows);
+    cusp::array1d<float, cusp::host_memory> y2(A.num_rows);
+    M1(b, y1);
+    M2(b, y2);
+    ASSERT_EQUAL(y1, y2);
+}
+DECLARE_UNITTEST(TestILU0Bicgstab);
+
+void TestILU0MissingDiagonal(void)
+{
+    cusp::array2d<float, cusp::host_memory> D(2, 2, 0.0f);
+    D(0,1) = 1; D(1,0) = 1;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A(D);
+
+    ASSERT_THROWS((cusp::precond::ilu0<float, cusp::host_memory>(A)), cusp::invalid_input_exception);
+    ASSERT_THROWS((cusp::precond::ic0<float, cusp::host_memory>(A)),  cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestILU0MissingDiagonal);
+
+void TestIC0ConjugateGradient(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::array1d<double, cusp::host_memory> b(A.num_rows, 1.0);
+
+    // IC(0) and ILU(0) coincide for symmetric matrices
+    cusp::precond::ic0<double, cusp::host_memory>  M0(A);
+    cusp::precond::ic0<double, cusp::host_memory>  M1(A, true);
+    cusp::precond::ilu0<double, cusp::host_memory> M2(A);
+
+    cusp::array1d<double, cusp::host_memory> y0(A.num_rows);
+    cusp::array1d<double, cusp::host_memory> y1(A.num_rows);
+    cusp::array1d<double, cusp::host_memory> y2(A.num_rows);
+    M0(b, y0);
+    M1(b, y1);
+    M2(b, y2);
+    ASSERT_ALMOST_EQUAL(y0, y1);
+    ASSERT_ALMOST_EQUAL(y0, y2);
+
+    cusp::array1d<double, cusp::host_memory> x0(A.num_rows, 0.0);
+    cusp::default_monitor<double> monitor0(b, 200, 1e-8);
+    cusp::krylov::cg(A, x0, b, monitor0);
+
+    cusp::array1d<double, cusp::host_memory> x1(A.num_rows, 0.0);
+    cusp::default_monitor<double> monitor1(b, 200, 1e-8);
+    cusp::krylov::cg(A, x1, b, monitor1, M0);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+}
+DECLARE_UNITTEST(TestIC0ConjugateGradient);
@@ -0,0 +1,124 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/monitor.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/gmres.h>
+
+#include <vector>
+
+template <class MemorySpace>
+void TestConjugateGradientSolverStep(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace>           Matrix;
+    typedef cusp::array1d<float, MemorySpace>                   Array;
+    typedef cusp::default_monitor<float>                        Monitor;
+    typedef cusp::precond::diagonal<float, MemorySpace>         Precond;
+    typedef cusp::krylov::cg_solver<Matrix, Array, Monitor, Precond> Solver;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    Precond M(A);
+
+    Array b(A.num_rows, 1.0f);
+
+    // reference solve
+    Array x_ref(A.num_rows, 0.0f);
+    Monitor monitor_ref(b, 30, 1e-5);
+    cusp::krylov::cg(A, x_ref, b, monitor_ref, M);
+
+    // two independent solves advanced in round-robin order
+    Array x0(A.num_rows, 0.0f);
+    Array x1(A.num_rows, 0.0f);
+    Monitor monitor0(b, 30, 1e-5);
+    Monitor monitor1(b, 30, 1e-5);
+
+    std::vector<Solver> solvers;
+    solvers.push_back(Solver(A, x0, b, monitor0, M));
+    solvers.push_back(Solver(A, x1, b, monitor1, M));
+
+    while (!solvers[0].done() || !solvers[1].done())
+    {
+        solvers[0].step();
+        solvers[1].step();
+    }
+
+    ASSERT_EQUAL(monitor0.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(monitor1.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(x0, x_ref);
+    ASSERT_EQUAL(x1, x_ref);
+
+    // stepping a finished solver has no effect
+    solvers[0].step();
+    ASSERT_EQUAL(monitor0.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(x0, x_ref);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestConjugateGradientSolverStep);
+
+template <class MemorySpace>
+void TestBiCGstabSolverStep(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace>           Matrix;
+    typedef cusp::array1d<float, MemorySpace>                   Array;
+    typedef cusp::default_monitor<float>                        Monitor;
+    typedef cusp::identity_operator<float, MemorySpace>         Precond;
+    typedef cusp::krylov::bicgstab_solver<Matrix, Array, Monitor, Precond> Solver;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    Precond M(A.num_rows, A.num_cols);
+
+    Array b(A.num_rows, 1.0f);
+
+    Array x_ref(A.num_rows, 0.0f);
+    Monitor monitor_ref(b, 30, 1e-5);
+    cusp::krylov::bicgstab(A, x_ref, b, monitor_ref, M);
+
+    Array x(A.num_rows, 0.0f);
+    Monitor monitor(b, 30, 1e-5);
+    Solver solver(A, x, b, monitor, M);
+
+    while (!solver.done())
+        solver.step();
+
+    ASSERT_EQUAL(monitor.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(monitor.converged(),       monitor_ref.converged());
+    ASSERT_EQUAL(x, x_ref);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestBiCGstabSolverStep);
+
+template <class MemorySpace>
+void TestGmresSolverStep(void)
+{
+    typedef cusp::csr_matrix<int, float, MemorySpace>           Matrix;
+    typedef cusp::array1d<float, MemorySpace>                   Array;
+    typedef cusp::default_monitor<float>                        Monitor;
+    typedef cusp::identity_operator<float, MemorySpace>         Precond;
+    typedef cusp::krylov::gmres_solver<Matrix, Array, Monitor, Precond> Solver;
+
+    Matrix A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+    Precond M(A.num_rows, A.num_cols);
+
+    Array b(A.num_rows, 1.0f);
+
+    // a short restart length exercises several cycles
+    Array x_ref(A.num_rows, 0.0f);
+    Monitor monitor_ref(b, 100, 1e-5);
+    cusp::krylov::gmres(A, x_ref, b, 10, monitor_ref, M);
+
+    Array x(A.num_rows, 0.0f);
+    Monitor monitor(b, 100, 1e-5);
+    Solver solver(A, x, b, 10, monitor, M);
+
+    while (!solver.done())
+        solver.step();
+
+    ASSERT_EQUAL(monitor.iteration_count(), monitor_ref.iteration_count());
+    ASSERT_EQUAL(monitor.converged(),       monitor_ref.converged());
+    ASSERT_EQUAL(x, x_ref);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestGmresSolverStep);
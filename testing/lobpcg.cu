@@ -0,0 +1,103 @@
+#include <unittest/unittest.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/precond/diagonal.h>
+#include <cusp/krylov/lobpcg.h>
+
+#include <cmath>
+
+template <class MemorySpace>
+void TestLOBPCG(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    // eigenvalues 4 - 2 cos(i pi / 11) - 2 cos(j pi / 11)
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, cusp::host_memory> S;
+    cusp::array2d<float, MemorySpace, cusp::column_major> X;
+
+    cusp::precond::diagonal<float, MemorySpace> M(A);
+
+    size_t num_converged = cusp::krylov::lobpcg(A, S, X, 4, M, false, 500, 1e-5);
+
+    ASSERT_EQUAL(num_converged, 4);
+    ASSERT_EQUAL(S.size(), 4);
+    ASSERT_EQUAL(X.num_cols, 4);
+
+    const float pi = 3.14159265358979f;
+    const float c1 = std::cos(1 * pi / 11);
+    const float c2 = std::cos(2 * pi / 11);
+
+    // the second eigenvalue is double
+    float expected[4] = { 4 - 4 * c1, 4 - 2 * c1 - 2 * c2, 4 - 2 * c1 - 2 * c2, 4 - 4 * c2 };
+
+    for (size_t k = 0; k < 4; k++)
+    {
+        ASSERT_EQUAL(std::fabs(S[k] - expected[k]) < 1e-3 * expected[k], true);
+
+        // check residual norm
+        cusp::array1d<float, MemorySpace> x(X.column(k));
+        cusp::array1d<float, MemorySpace> r(A.num_rows);
+        cusp::multiply(A, x, r);
+        cusp::blas::axpy(x, r, -S[k]);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(r) <= 1e-3 * S[k] * cusp::blas::nrm2(x), true);
+    }
+
+    // eigenvectors of the double eigenvalue are independent
+    ASSERT_EQUAL(std::fabs(cusp::blas::dotc(X.column(1), X.column(2))) < 1e-2, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestLOBPCG);
+
+
+template <class MemorySpace>
+void TestLOBPCGLargest(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, cusp::host_memory> S;
+    cusp::array2d<float, MemorySpace, cusp::column_major> X;
+
+    size_t num_converged = cusp::krylov::lobpcg(A, S, X, 1, true, 500, 1e-3);
+
+    ASSERT_EQUAL(num_converged, 1);
+
+    const float pi = 3.14159265358979f;
+
+    ASSERT_EQUAL(std::fabs(S[0] - (4 + 4 * std::cos(pi / 11))) < 1e-2, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestLOBPCGLargest);
+
+
+template <class MemorySpace>
+void TestLOBPCGZeroEigenvalue(void)
+{
+    // Laplacian of a path, its smallest eigenvalue is zero
+    cusp::array2d<float, cusp::host_memory> L(20, 20, 0.0f);
+    for (size_t i = 0; i + 1 < L.num_rows; i++)
+    {
+        L(i,i)     += 1.0f; L(i,i+1) = -1.0f;
+        L(i+1,i+1) += 1.0f; L(i+1,i) = -1.0f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(L);
+
+    cusp::array1d<float, cusp::host_memory> S;
+    cusp::array2d<float, MemorySpace, cusp::column_major> X;
+
+    size_t num_converged = cusp::krylov::lobpcg(A, S, X, 2, false, 500, 1e-4);
+
+    ASSERT_EQUAL(num_converged, 2);
+    ASSERT_EQUAL(std::fabs(S[0]) < 1e-3, true);
+
+    const float pi = 3.14159265358979f;
+
+    ASSERT_EQUAL(std::fabs(S[1] - (2 - 2 * std::cos(pi / 20))) < 1e-3, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestLOBPCGZeroEigenvalue);
+
@@ -4,9 +4,18 @@
 
 #include <cusp/coo_matrix.h>
 #include <cusp/csr_matrix.h>
+#include <cusp/symmetric_csr_matrix.h>
 #include <cusp/array2d.h>
+#include <cusp/gallery/poisson.h>
 
 #include <stdio.h>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <stdexcept>
+#include <string>
 
 const char random_file_name[] = "test_93298409283221.mtx";
 
@@ -164,6 +173,168 @@ void TestReadMatrixMarketFileArrayRealGeneral(void)
 }
 DECLARE_UNITTEST(TestReadMatrixMarketFileArrayRealGeneral);
 
+void TestReadMatrixMarketFileChunked(void)
+{
+  // symmetric band matrix large enough to be parsed in several chunks,
+  // written in reverse order with blank lines in the body
+  const int N = 4000;
+  const int K = 5;
+
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real symmetric\n";
+    file << "% band matrix\n";
+    file << N << " " << N << " " << (N * K - K * (K - 1) / 2) << "\n";
+
+    for (int i = N - 1; i >= 0; i--)
+    {
+      for (int j = i; j >= 0 && j > i - K; j--)
+        file << (i + 1) << "\t" << (j + 1) << " " << (0.25 * i - 1.5 * j) << "\r\n";
+
+      if (i % 1000 == 0)
+        file << "\n";
+    }
+  }
+
+  cusp::coo_matrix<int, double, cusp::host_memory> A;
+  cusp::io::read_matrix_market_file(A, random_file_name);
+
+  cusp::coo_matrix<int, double, cusp::host_memory> B;
+  {
+    std::ifstream file(random_file_name);
+    cusp::io::read_matrix_market_stream(B, file);
+  }
+
+  // CSR is assembled directly from the file
+  cusp::csr_matrix<int, double, cusp::host_memory> C;
+  cusp::io::read_matrix_market_file(C, random_file_name);
+
+  remove(random_file_name);
+
+  cusp::csr_matrix<int, double, cusp::host_memory> E(B);
+  ASSERT_EQUAL(C.row_offsets,    E.row_offsets);
+  ASSERT_EQUAL(C.column_indices, E.column_indices);
+  ASSERT_EQUAL(C.values,         E.values);
+
+  ASSERT_EQUAL(A.num_rows,    (size_t) N);
+  ASSERT_EQUAL(A.num_entries, (size_t) (N * (2 * K - 1) - K * (K - 1)));
+  ASSERT_EQUAL(A.row_indices,    B.row_indices);
+  ASSERT_EQUAL(A.column_indices, B.column_indices);
+  ASSERT_EQUAL(A.values,         B.values);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileChunked);
+
+void TestReadMatrixMarketFileInvalid(void)
+{
+  cusp::coo_matrix<int, float, cusp::host_memory> A;
+
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+    file << "2 2 2\n";
+    file << "1 1 1.0\n";
+  }
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+    file << "2 2 1\n";
+    file << "3 1 1.0\n";
+  }
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+    file << "2 2 1\n";
+    file << "1 2 one\n";
+  }
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  remove(random_file_name);
+
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileInvalid);
+
+void TestReadMatrixMarketFileLongValues(void)
+{
+  // values the fast path leaves to the fallback, which must ignore a
+  // global locale whose decimal point is a comma
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix array real general\n";
+    file << "4 1\n";
+    file << "1.5e-300\n";
+    file << "0.12345678901234567890123\n";
+    file << "-inf\n";
+    file << "2.5E+100\n";
+  }
+
+  const std::locale previous;
+
+  try
+  {
+    std::locale::global(std::locale("de_DE.UTF-8"));
+  }
+  catch (std::runtime_error&)
+  {
+    // locale not installed, the values are still checked
+  }
+
+  cusp::array1d<double, cusp::host_memory> a;
+
+  try
+  {
+    cusp::io::read_matrix_market_file(a, random_file_name);
+  }
+  catch (...)
+  {
+    std::locale::global(previous);
+    remove(random_file_name);
+    throw;
+  }
+
+  std::locale::global(previous);
+  remove(random_file_name);
+
+  ASSERT_EQUAL(a.size(), (size_t) 4);
+  ASSERT_EQUAL(a[0], 1.5e-300);
+  ASSERT_EQUAL(a[1], 0.12345678901234567890123);
+  ASSERT_EQUAL(a[2], -std::numeric_limits<double>::infinity());
+  ASSERT_EQUAL(a[3], 2.5e+100);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileLongValues);
+
+void TestReadMatrixMarketFileOversizedIndex(void)
+{
+  cusp::coo_matrix<int, float, cusp::host_memory> A;
+
+  // 2^64 + 1 would wrap around to a valid index
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+    file << "2 2 1\n";
+    file << "18446744073709551617 1 1.0\n";
+  }
+
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  // and so would a size
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real general\n";
+    file << "18446744073709551618 2 1\n";
+    file << "1 1 1.0\n";
+  }
+
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  remove(random_file_name);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileOversizedIndex);
+
 template <typename MemorySpace>
 void TestReadMatrixMarketFileToCsrMatrix(void)
 {
@@ -186,6 +357,136 @@ void TestReadMatrixMarketFileToCsrMatrix(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileToCsrMatrix);
 
+template <typename MemorySpace>
+void TestReadMatrixMarketFileSymmetricToCsrMatrix(void)
+{
+  // load matrix
+  cusp::csr_matrix<int, float, MemorySpace> csr;
+  cusp::io::read_matrix_market_file(csr, "data/test/coordinate_pattern_symmetric.mtx");
+
+  // convert to array2d
+  cusp::array2d<float, cusp::host_memory> D(csr);
+
+  // expected result
+  cusp::array2d<float, cusp::host_memory> E(5, 5);
+  E(0,0) =  1.000e+00; E(0,1) =  0.000e+00; E(0,2) =  0.000e+00; E(0,3) =  0.000e+00; E(0,4) =  0.000e+00;
+  E(1,0) =  0.000e+00; E(1,1) =  1.000e+00; E(1,2) =  0.000e+00; E(1,3) =  1.000e+00; E(1,4) =  0.000e+00;
+  E(2,0) =  0.000e+00; E(2,1) =  0.000e+00; E(2,2) =  1.000e+00; E(2,3) =  0.000e+00; E(2,4) =  0.000e+00;
+  E(3,0) =  0.000e+00; E(3,1) =  1.000e+00; E(3,2) =  0.000e+00; E(3,3) =  1.000e+00; E(3,4) =  1.000e+00;
+  E(4,0) =  0.000e+00; E(4,1) =  0.000e+00; E(4,2) =  0.000e+00; E(4,3) =  1.000e+00; E(4,4) =  1.000e+00;
+
+  ASSERT_EQUAL(csr.num_entries, (size_t) 9);
+  ASSERT_EQUAL(D == E, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileSymmetricToCsrMatrix);
+
+void TestReadMatrixMarketFileSkewSymmetric(void)
+{
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate real skew-symmetric\n";
+    file << "3 3 2\n";
+    file << "2 1 1.5\n";
+    file << "3 2 -4.0\n";
+  }
+
+  cusp::array2d<float, cusp::host_memory> E(3, 3, 0.0f);
+  E(1,0) =  1.5f; E(0,1) = -1.5f;
+  E(2,1) = -4.0f; E(1,2) =  4.0f;
+
+  cusp::coo_matrix<int, float, cusp::host_memory> A;
+  cusp::io::read_matrix_market_file(A, random_file_name);
+
+  cusp::csr_matrix<int, float, cusp::host_memory> B;
+  cusp::io::read_matrix_market_file(B, random_file_name);
+
+  cusp::coo_matrix<int, float, cusp::host_memory> C;
+  {
+    std::ifstream file(random_file_name);
+    cusp::io::read_matrix_market_stream(C, file);
+  }
+
+  remove(random_file_name);
+
+  ASSERT_EQUAL(cusp::array2d<float, cusp::host_memory>(A) == E, true);
+  ASSERT_EQUAL(cusp::array2d<float, cusp::host_memory>(B) == E, true);
+  ASSERT_EQUAL(cusp::array2d<float, cusp::host_memory>(C) == E, true);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileSkewSymmetric);
+
+void TestReadMatrixMarketFileHermitian(void)
+{
+  typedef cusp::complex<float> ValueType;
+
+  {
+    std::ofstream file(random_file_name);
+    file << "%%MatrixMarket matrix coordinate complex hermitian\n";
+    file << "2 2 3\n";
+    file << "1 1 2.0 0.0\n";
+    file << "2 1 1.0 3.0\n";
+    file << "2 2 5.0 0.0\n";
+  }
+
+  cusp::array2d<ValueType, cusp::host_memory> E(2, 2);
+  E(0,0) = ValueType(2.0f,  0.0f); E(0,1) = ValueType(1.0f, -3.0f);
+  E(1,0) = ValueType(1.0f,  3.0f); E(1,1) = ValueType(5.0f,  0.0f);
+
+  cusp::coo_matrix<int, ValueType, cusp::host_memory> A;
+  cusp::io::read_matrix_market_file(A, random_file_name);
+
+  cusp::csr_matrix<int, ValueType, cusp::host_memory> B;
+  cusp::io::read_matrix_market_file(B, random_file_name);
+
+  cusp::coo_matrix<int, ValueType, cusp::host_memory> C;
+  {
+    std::ifstream file(random_file_name);
+    cusp::io::read_matrix_market_stream(C, file);
+  }
+
+  remove(random_file_name);
+
+  ASSERT_EQUAL(cusp::array2d<ValueType, cusp::host_memory>(A) == E, true);
+  ASSERT_EQUAL(cusp::array2d<ValueType, cusp::host_memory>(B) == E, true);
+  ASSERT_EQUAL(cusp::array2d<ValueType, cusp::host_memory>(C) == E, true);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileHermitian);
+
+template <typename MemorySpace>
+void TestReadMatrixMarketFileToSymmetricCsrMatrix(void)
+{
+  // only the stored triangle is kept
+  cusp::symmetric_csr_matrix<int, float, MemorySpace> A;
+  cusp::io::read_matrix_market_file(A, "data/test/coordinate_pattern_symmetric.mtx");
+
+  ASSERT_EQUAL(A.symmetry() == cusp::symmetry_symmetric, true);
+  ASSERT_EQUAL(A.num_entries,         (size_t) 9);
+  ASSERT_EQUAL(A.upper().num_entries, (size_t) 7);
+
+  cusp::csr_matrix<int, float, MemorySpace> B;
+  cusp::io::read_matrix_market_file(B, "data/test/coordinate_pattern_symmetric.mtx");
+
+  cusp::csr_matrix<int, float, MemorySpace> C;
+  A.expand(C);
+
+  ASSERT_EQUAL(C.row_offsets,    B.row_offsets);
+  ASSERT_EQUAL(C.column_indices, B.column_indices);
+  ASSERT_EQUAL(C.values,         B.values);
+
+  cusp::symmetric_csr_matrix<int, float, MemorySpace> D;
+  {
+    std::ifstream file("data/test/coordinate_pattern_symmetric.mtx");
+    cusp::io::read_matrix_market_stream(D, file);
+  }
+
+  ASSERT_EQUAL(D.upper().row_offsets,    A.upper().row_offsets);
+  ASSERT_EQUAL(D.upper().column_indices, A.upper().column_indices);
+  ASSERT_EQUAL(D.upper().values,         A.upper().values);
+
+  // general files have no triangle to keep
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, "data/test/coordinate_real_general.mtx")), cusp::io_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestReadMatrixMarketFileToSymmetricCsrMatrix);
+
 template <typename MemorySpace>
 void TestWriteMatrixMarketFileCoordinateRealGeneral(void)
 {
@@ -240,3 +541,216 @@ void TestWriteMatrixMarketFileCoordinateComplexGeneral(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestWriteMatrixMarketFileCoordinateComplexGeneral);
 
+
+void TestWriteMatrixMarketFileRoundTrip(void)
+{
+  // values that need up to 17 significant digits, written in several chunks
+  const int N = 40000;
+
+  cusp::coo_matrix<int, double, cusp::host_memory> A(N, N, N);
+  for (int i = 0; i < N; i++)
+  {
+    A.row_indices[i]    = i;
+    A.column_indices[i] = (7 * i) % N;
+    A.values[i]         = (i % 3 == 0) ? double(i - N / 2) : 1.0 / (i + 3);
+  }
+  A.sort_by_row_and_column();
+  A.values[0] = 4.9406564584124654e-324;
+
+  cusp::io::write_matrix_market_file(A, random_file_name);
+
+  cusp::coo_matrix<int, double, cusp::host_memory> B;
+  cusp::io::read_matrix_market_file(B, random_file_name);
+
+  ASSERT_EQUAL(B.row_indices,    A.row_indices);
+  ASSERT_EQUAL(B.column_indices, A.column_indices);
+  ASSERT_EQUAL(B.values,         A.values);
+
+  // dense arrays in all value types
+  cusp::array2d<float, cusp::host_memory> C(3, 2);
+  C(0,0) = 1.0f / 3.0f; C(0,1) = -2.0f;
+  C(1,0) = 1e-40f;      C(1,1) = 3.4028235e38f;
+  C(2,0) = 0.1f;        C(2,1) = 0.0f;
+
+  cusp::io::write_matrix_market_file(C, random_file_name);
+
+  cusp::array2d<float, cusp::host_memory> D;
+  cusp::io::read_matrix_market_file(D, random_file_name);
+
+  ASSERT_EQUAL(D == C, true);
+
+  cusp::array1d<cusp::complex<double>, cusp::host_memory> x(3);
+  x[0] = cusp::complex<double>(0.1, -1.0 / 3.0);
+  x[1] = cusp::complex<double>(1e300, 2.0);
+  x[2] = cusp::complex<double>(-0.5, 1.0 / 7.0);
+
+  cusp::io::write_matrix_market_file(x, random_file_name);
+
+  cusp::array1d<cusp::complex<double>, cusp::host_memory> y;
+  cusp::io::read_matrix_market_file(y, random_file_name);
+
+  remove(random_file_name);
+
+  ASSERT_EQUAL(x == y, true);
+}
+DECLARE_UNITTEST(TestWriteMatrixMarketFileRoundTrip);
+
+void verify_compressed_matrix_market_file(const char * filename, const unsigned char * magic, size_t magic_size)
+{
+  cusp::csr_matrix<int, double, cusp::host_memory> A;
+  cusp::gallery::poisson5pt(A, 200, 200);
+
+  cusp::io::write_matrix_market_file(A, filename);
+
+  // the file is compressed
+  {
+    std::ifstream file(filename, std::ios::binary);
+    for (size_t i = 0; i < magic_size; i++)
+      ASSERT_EQUAL(file.get(), (int) magic[i]);
+  }
+
+  cusp::csr_matrix<int, double, cusp::host_memory> B;
+  cusp::io::read_matrix_market_file(B, filename);
+
+  ASSERT_EQUAL(B.row_offsets,    A.row_offsets);
+  ASSERT_EQUAL(B.column_indices, A.column_indices);
+  ASSERT_EQUAL(B.values,         A.values);
+
+  cusp::coo_matrix<int, double, cusp::host_memory> C;
+  cusp::io::read_matrix_market_file(C, filename);
+
+  ASSERT_EQUAL(C.num_entries, A.num_entries);
+
+  cusp::array2d<float, cusp::host_memory> D(3, 2, 0.5f);
+  cusp::io::write_matrix_market_file(D, filename);
+
+  cusp::array2d<float, cusp::host_memory> E;
+  cusp::io::read_matrix_market_file(E, filename);
+
+  remove(filename);
+
+  ASSERT_EQUAL(D == E, true);
+}
+
+void verify_compressed_matrix_market_blocks(const char * filename, cusp::io::detail::compression_format format)
+{
+  // tiny blocks, so lines straddle blocks and the decoder runs ahead
+  // of the parser until the block queue is full
+  const size_t block_bytes = 61;
+
+  cusp::csr_matrix<int, double, cusp::host_memory> A;
+  cusp::gallery::poisson5pt(A, 30, 30);
+
+  // a comment block that spans many blocks
+  std::string text;
+  {
+    std::ostringstream output;
+    cusp::io::write_matrix_market_stream(A, output);
+    text = output.str();
+
+    std::string comments;
+    for (int i = 0; i < 20; i++)
+      comments += "% comment lines longer than a block must not hide the size line\n";
+    comments += "\n";
+
+    text.insert(text.find('\n') + 1, comments);
+  }
+
+  {
+    cusp::io::detail::compressed_filebuf buffer(filename, format, block_bytes);
+    std::ostream output(&buffer);
+
+    output.write(text.data(), text.size());
+
+    buffer.close();
+  }
+
+  std::string contents;
+  {
+    std::ifstream file(filename, std::ios::binary);
+    contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+  }
+
+  {
+    cusp::io::detail::decompressed_source source(contents.data(), contents.data() + contents.size(), format, block_bytes);
+
+    cusp::csr_matrix<int, double, cusp::host_memory> B;
+    cusp::io::detail::read_matrix_market_source(B, source, cusp::csr_format());
+
+    ASSERT_EQUAL(B.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(B.column_indices, A.column_indices);
+    ASSERT_EQUAL(B.values,         A.values);
+  }
+
+  {
+    std::istringstream input(text);
+    cusp::io::detail::stream_source<std::istringstream> source(input, block_bytes);
+
+    cusp::csr_matrix<int, double, cusp::host_memory> B;
+    cusp::io::detail::read_matrix_market_source(B, source, cusp::csr_format());
+
+    ASSERT_EQUAL(B.row_offsets,    A.row_offsets);
+    ASSERT_EQUAL(B.column_indices, A.column_indices);
+    ASSERT_EQUAL(B.values,         A.values);
+  }
+
+  cusp::csr_matrix<int, double, cusp::host_memory> C;
+
+  // truncated
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(contents.data(), contents.size() / 2);
+  }
+
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(C, filename)), cusp::io_exception);
+
+  // corrupt
+  std::string corrupt(contents);
+  for (size_t i = corrupt.size() / 2; i < corrupt.size() / 2 + 16; i++)
+    corrupt[i] = ~corrupt[i];
+
+  {
+    std::ofstream file(filename, std::ios::binary);
+    file.write(corrupt.data(), corrupt.size());
+  }
+
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(C, filename)), cusp::io_exception);
+
+  remove(filename);
+}
+
+#if defined(CUSP_USE_ZLIB)
+void TestMatrixMarketFileGzip(void)
+{
+  const unsigned char magic[] = {0x1f, 0x8b};
+  verify_compressed_matrix_market_file("test_93298409283221.mtx.gz", magic, sizeof(magic));
+  verify_compressed_matrix_market_blocks("test_93298409283221.mtx.gz", cusp::io::detail::compression_gzip);
+}
+DECLARE_UNITTEST(TestMatrixMarketFileGzip);
+#endif
+
+#if defined(CUSP_USE_ZSTD)
+void TestMatrixMarketFileZstd(void)
+{
+  const unsigned char magic[] = {0x28, 0xb5, 0x2f, 0xfd};
+  verify_compressed_matrix_market_file("test_93298409283221.mtx.zst", magic, sizeof(magic));
+  verify_compressed_matrix_market_blocks("test_93298409283221.mtx.zst", cusp::io::detail::compression_zstd);
+}
+DECLARE_UNITTEST(TestMatrixMarketFileZstd);
+#endif
+
+#if !defined(CUSP_USE_ZLIB)
+void TestReadMatrixMarketFileGzipUnsupported(void)
+{
+  {
+    std::ofstream file(random_file_name, std::ios::binary);
+    file << '\x1f' << '\x8b' << '\x08' << '\x00';
+  }
+
+  cusp::coo_matrix<int, float, cusp::host_memory> A;
+  ASSERT_THROWS((cusp::io::read_matrix_market_file(A, random_file_name)), cusp::io_exception);
+
+  remove(random_file_name);
+}
+DECLARE_UNITTEST(TestReadMatrixMarketFileGzipUnsupported);
+#endif
@@ -2,6 +2,12 @@
 
 #include <cusp/monitor.h>
 
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/krylov/gmres.h>
+
 template <typename MemorySpace>
 void TestMonitorSimple(void)
 {
@@ -61,3 +67,125 @@ void TestMonitorSimple(void)
 }
 DECLARE_HOST_DEVICE_UNITTEST(TestMonitorSimple);
 
+
+template <typename MemorySpace>
+void TestMonitorResidualNorm(void)
+{
+    cusp::array1d<float,MemorySpace> b(2);
+    b[0] = 10;
+    b[1] =  0;
+    
+    cusp::array1d<float,MemorySpace> r(2);
+    r[0] = 10;
+    r[1] =  0;
+
+    cusp::default_monitor<float> monitor(b, 5, 0.5, 1.0);
+
+    // the norm supplied by the solver is used instead of ||r||
+    ASSERT_EQUAL(monitor.finished(r, 7.0f), false);
+    ASSERT_EQUAL(monitor.residual_norm(), 7.0);
+    
+    ASSERT_EQUAL(monitor.finished(r, 2.0f), true);
+    ASSERT_EQUAL(monitor.residual_norm(), 2.0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMonitorResidualNorm);
+
+template <typename MemorySpace>
+void TestMonitorCheckInterval(void)
+{
+    cusp::array1d<float,MemorySpace> b(2);
+    b[0] = 10;
+    b[1] =  0;
+    
+    cusp::array1d<float,MemorySpace> r(2);
+    r[0] = 10;
+    r[1] =  0;
+
+    cusp::default_monitor<float> monitor(b, 5, 0.5, 1.0);
+    monitor.set_check_interval(2);
+
+    ASSERT_EQUAL(monitor.check_interval(), 2);
+    
+    ASSERT_EQUAL(monitor.finished(r), false);
+    ASSERT_EQUAL(monitor.residual_norm(), 10.0);
+
+    ++monitor;
+    r[0] = 2;
+
+    // odd iterations are not checked
+    ASSERT_EQUAL(monitor.finished(r), false);
+    ASSERT_EQUAL(monitor.residual_norm(), 10.0);
+    
+    ++monitor;
+    
+    ASSERT_EQUAL(monitor.finished(r), true);
+    ASSERT_EQUAL(monitor.residual_norm(), 2.0);
+    
+    r[0] = 7;
+    ++monitor;
+    ++monitor;
+    ++monitor;
+
+    // the iteration limit is always checked
+    ASSERT_EQUAL(monitor.finished(r), true);
+    ASSERT_EQUAL(monitor.iteration_count(), 5);
+    ASSERT_EQUAL(monitor.residual_norm(), 7.0);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMonitorCheckInterval);
+
+// a monitor outside cusp that only implements finished(r)
+template <typename ValueType>
+class counting_monitor : public cusp::default_monitor<ValueType>
+{
+    typedef cusp::default_monitor<ValueType> Parent;
+
+public:
+    size_t num_checks;
+
+    template <typename Vector>
+    counting_monitor(const Vector& b) : Parent(b, 100, 1e-4), num_checks(0) {}
+
+    template <typename Vector>
+    bool finished(const Vector& r)
+    {
+        num_checks++;
+        return Parent::finished(r);
+    }
+};
+
+template <typename MemorySpace>
+void TestMonitorUserDefined(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        counting_monitor<float> monitor(b);
+        cusp::krylov::cg(A, x, b, monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.num_checks, monitor.iteration_count() + 1);
+    }
+
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        counting_monitor<float> monitor(b);
+        cusp::krylov::bicgstab(A, x, b, monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.num_checks > 0, true);
+    }
+
+    {
+        cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+        counting_monitor<float> monitor(b);
+        cusp::krylov::gmres(A, x, b, 20, monitor);
+
+        ASSERT_EQUAL(monitor.converged(), true);
+        ASSERT_EQUAL(monitor.num_checks > 0, true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestMonitorUserDefined);
@@ -217,6 +217,48 @@ void TestSparseMatrixVectorMultiply()
 }
 DECLARE_SPARSE_MATRIX_UNITTEST(TestSparseMatrixVectorMultiply);
 
+template <class TestMatrix>
+void TestSparseMatrixVectorMultiplyFixedWidth(void)
+{
+    // gallery stencils, the diagonal counts with specialized DIA kernels
+    {
+        cusp::array2d<float,cusp::host_memory> A;
+        cusp::gallery::poisson5pt(A, 7, 5);
+        CompareSparseMatrixVectorMultiply<TestMatrix>(A);
+    }
+    {
+        cusp::array2d<float,cusp::host_memory> A;
+        cusp::gallery::poisson9pt(A, 6, 7);
+        CompareSparseMatrixVectorMultiply<TestMatrix>(A);
+    }
+    {
+        cusp::array2d<float,cusp::host_memory> A;
+        cusp::gallery::poisson7pt(A, 4, 3, 5);
+        CompareSparseMatrixVectorMultiply<TestMatrix>(A);
+    }
+    {
+        cusp::array2d<float,cusp::host_memory> A;
+        cusp::gallery::poisson27pt(A, 3, 4, 5);
+        CompareSparseMatrixVectorMultiply<TestMatrix>(A);
+    }
+
+    // constant row widths below, inside and above the specialized ELL range
+    const int widths[6] = { 2, 3, 8, 17, 32, 33 };
+
+    for (int w = 0; w < 6; w++)
+    {
+        const int N = 40;
+
+        cusp::array2d<float,cusp::host_memory> A(N, N, 0.0f);
+        for (int i = 0; i < N; i++)
+            for (int k = 0; k < widths[w]; k++)
+                A(i, (i + 3 * k) % N) = (i + k) % 7 - 3 + (k == 0 ? 10 : 0);
+
+        CompareSparseMatrixVectorMultiply<TestMatrix>(A);
+    }
+}
+DECLARE_SPARSE_MATRIX_UNITTEST(TestSparseMatrixVectorMultiplyFixedWidth);
+
 
 //////////////////////////////
 // General Linear Operators //
@@ -0,0 +1,122 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/polynomial.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+
+template <class MemorySpace>
+void _TestPolynomialPreconditionerNeumann(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i % 5) - 2.0f;
+
+    const float omega = 1.0f / 8.0f;
+
+    // expected = omega * (x + (I - omega A) x + (I - omega A)^2 x)
+    cusp::array1d<float, MemorySpace> term(x);
+    cusp::array1d<float, MemorySpace> sum(x);
+    cusp::array1d<float, MemorySpace> Aterm(A.num_rows);
+    for (int j = 0; j < 2; j++)
+    {
+        cusp::multiply(A, term, Aterm);
+        cusp::blas::axpy(Aterm, term, -omega);
+        cusp::blas::axpy(term, sum, 1.0f);
+    }
+    cusp::blas::scal(sum, omega);
+
+    cusp::precond::polynomial<float, MemorySpace> M(A, cusp::precond::polynomial_neumann, 2, 0.0f, 8.0f);
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows);
+    M(x, y);
+
+    ASSERT_EQUAL(M.degree(), 2);
+    ASSERT_ALMOST_EQUAL(y, sum);
+}
+
+void TestPolynomialPreconditionerNeumann(void)
+{
+    _TestPolynomialPreconditionerNeumann<cusp::host_memory>();
+    _TestPolynomialPreconditionerNeumann<cusp::device_memory>();
+}
+DECLARE_UNITTEST(TestPolynomialPreconditionerNeumann);
+
+void TestPolynomialPreconditionerDegreeZero(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = i + 1.0f;
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows);
+    cusp::array1d<float, cusp::host_memory> expected(A.num_rows);
+
+    // Chebyshev: y = x / theta with theta the center of the interval
+    cusp::precond::polynomial<float, cusp::host_memory> M0(A, cusp::precond::polynomial_chebyshev, 0, 1.0f, 7.0f);
+    M0(x, y);
+    cusp::blas::axpby(x, x, expected, 0.25f, 0.0f);
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // least-squares: a constant, the same for every entry
+    cusp::precond::polynomial<float, cusp::host_memory> M1(A, cusp::precond::polynomial_least_squares, 0, 0.0f, 8.0f);
+    M1(x, y);
+    for (size_t i = 0; i < A.num_rows; i++)
+        ASSERT_ALMOST_EQUAL(y[i] / x[i], y[0] / x[0]);
+}
+DECLARE_UNITTEST(TestPolynomialPreconditionerDegreeZero);
+
+template <class MemorySpace>
+void _TestPolynomialPreconditionerCG(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 32, 32);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::array1d<float, MemorySpace> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 500, 1e-5);
+    cusp::krylov::cg(A, x0, b, monitor0);
+
+    cusp::precond::polynomial_kind kinds[3] = { cusp::precond::polynomial_chebyshev,
+                                                cusp::precond::polynomial_least_squares,
+                                                cusp::precond::polynomial_neumann };
+
+    for (int i = 0; i < 3; i++)
+    {
+        cusp::precond::polynomial<float, MemorySpace> M(A, kinds[i], 4);
+
+        cusp::array1d<float, MemorySpace> x1(A.num_rows, 0.0f);
+        cusp::default_monitor<float> monitor1(b, 500, 1e-5);
+        cusp::krylov::cg(A, x1, b, monitor1, M);
+
+        ASSERT_EQUAL(monitor1.converged(), true);
+        ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+    }
+}
+
+void TestPolynomialPreconditionerCG(void)
+{
+    _TestPolynomialPreconditionerCG<cusp::host_memory>();
+    _TestPolynomialPreconditionerCG<cusp::device_memory>();
+}
+DECLARE_UNITTEST(TestPolynomialPreconditionerCG);
+
+void TestPolynomialPreconditionerInvalidBounds(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 4, 4);
+
+    typedef cusp::precond::polynomial<float, cusp::host_memory> Polynomial;
+
+    ASSERT_THROWS((Polynomial(A, cusp::precond::polynomial_chebyshev, 4, 2.0f, 1.0f)), cusp::invalid_input_exception);
+    ASSERT_THROWS((Polynomial(A, cusp::precond::polynomial_neumann,   4, 0.0f, 0.0f)), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestPolynomialPreconditionerInvalidBounds);
@@ -0,0 +1,88 @@
+#include <unittest/unittest.h>
+
+#include <cusp/precond/spai.h>
+
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/bicgstab.h>
+#include <cusp/multiply.h>
+
+void TestSPAIFullPattern(void)
+{
+    // the pattern of (I + A)^3 of a 4x4 tridiagonal matrix is dense, so M = A^-1
+    cusp::array2d<double, cusp::host_memory> D(4, 4, 0.0);
+    D(0,0) =  4; D(0,1) = -1;
+    D(1,0) = -2; D(1,1) =  4; D(1,2) = -1;
+                 D(2,1) = -2; D(2,2) =  4; D(2,3) = -1;
+                              D(3,2) = -2; D(3,3) =  4;
+
+    cusp::csr_matrix<int, double, cusp::host_memory> A(D);
+
+    cusp::precond::spai<double, cusp::host_memory> M(A, 3);
+
+    ASSERT_EQUAL(M.num_entries, 16);
+
+    cusp::array1d<double, cusp::host_memory> x(4);
+    x[0] = 1; x[1] = -2; x[2] = 3; x[3] = 4;
+
+    cusp::array1d<double, cusp::host_memory> Ax(4);
+    cusp::array1d<double, cusp::host_memory> y(4);
+    cusp::multiply(A, x, Ax);
+    M(Ax, y);
+
+    ASSERT_ALMOST_EQUAL(y, x);
+}
+DECLARE_UNITTEST(TestSPAIFullPattern);
+
+void TestSPAIPattern(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    // power 0 is a diagonal, power 1 the pattern of A
+    cusp::precond::spai<float, cusp::host_memory> M0(A, 0);
+    cusp::precond::spai<float, cusp::host_memory> M1(A, 1);
+
+    ASSERT_EQUAL(M0.num_entries, A.num_rows);
+    ASSERT_EQUAL(M1.num_entries, A.num_entries);
+}
+DECLARE_UNITTEST(TestSPAIPattern);
+
+template <class MemorySpace>
+void _TestSPAIBicgstab(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> A;
+    cusp::gallery::poisson5pt(A, 20, 20);
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::array1d<float, MemorySpace> x0(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor0(b, 200, 1e-5);
+    cusp::krylov::bicgstab(A, x0, b, monitor0);
+
+    cusp::array1d<float, MemorySpace> x1(A.num_rows, 0.0f);
+    cusp::default_monitor<float> monitor1(b, 200, 1e-5);
+    cusp::precond::spai<float, MemorySpace> M(A);
+    cusp::krylov::bicgstab(A, x1, b, monitor1, M);
+
+    ASSERT_EQUAL(monitor1.converged(), true);
+    ASSERT_EQUAL(monitor1.iteration_count() < monitor0.iteration_count(), true);
+}
+
+void TestSPAIBicgstab(void)
+{
+    _TestSPAIBicgstab<cusp::host_memory>();
+    _TestSPAIBicgstab<cusp::device_memory>();
+}
+DECLARE_UNITTEST(TestSPAIBicgstab);
+
+void TestSPAISingular(void)
+{
+    // an empty column makes the least-squares problem rank deficient
+    cusp::array2d<float, cusp::host_memory> D(2, 2, 0.0f);
+    D(0,0) = 1; D(1,0) = 1;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> A(D);
+
+    ASSERT_THROWS((cusp::precond::spai<float, cusp::host_memory>(A)), cusp::runtime_exception);
+}
+DECLARE_UNITTEST(TestSPAISingular);
@@ -0,0 +1,193 @@
+#include <unittest/unittest.h>
+
+#include <cusp/stencil_operator.h>
+
+#include <cusp/dia_matrix.h>
+#include <cusp/gallery/stencil.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/multiply.h>
+#include <cusp/relaxation/jacobi.h>
+
+template <typename MemorySpace, typename StencilPoint, typename GridDimension>
+void verify_stencil_operator(const cusp::array1d<StencilPoint, cusp::host_memory>& stencil,
+                             const GridDimension& grid)
+{
+    cusp::dia_matrix<int, float, MemorySpace> M;
+    cusp::gallery::generate_matrix_from_stencil(M, stencil, grid);
+
+    cusp::stencil_operator<float, MemorySpace> A(stencil, grid);
+
+    ASSERT_EQUAL(A.num_rows, M.num_rows);
+    ASSERT_EQUAL(A.num_cols, M.num_cols);
+    ASSERT_EQUAL(A.num_entries, M.num_entries);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i * 7) % 11 - 5.0f;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows);
+    cusp::array1d<float, MemorySpace> expected(A.num_rows);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(M, x, expected);
+
+    ASSERT_EQUAL(y, expected);
+}
+
+template <typename MemorySpace>
+void TestStencilOperator1d(void)
+{
+    typedef thrust::tuple<int>                StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex(-1), 1));
+    stencil.push_back(StencilPoint(StencilIndex( 0), 2));
+    stencil.push_back(StencilPoint(StencilIndex( 2), 3));
+
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(4));
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(100));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperator1d);
+
+template <typename MemorySpace>
+void TestStencilOperator2d(void)
+{
+    typedef thrust::tuple<int,int>            StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex(-1, -1), 1));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0), 2));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0), 3));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0), 4));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  2), 5));
+
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(2, 3));
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(37, 21));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperator2d);
+
+template <typename MemorySpace>
+void TestStencilOperator3d(void)
+{
+    typedef thrust::tuple<int,int,int>        StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  0),  6));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0, -1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0, -1), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0,  1), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 2, -1,  1),  0.5));
+
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(5, 4, 3));
+    verify_stencil_operator<MemorySpace>(stencil, StencilIndex(30, 20, 10));
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperator3d);
+
+template <typename MemorySpace>
+void TestStencilOperatorVariableCoefficients(void)
+{
+    typedef thrust::tuple<int,int>            StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex( 0, 0), 0));
+    stencil.push_back(StencilPoint(StencilIndex(-1, 0), 0));
+    stencil.push_back(StencilPoint(StencilIndex( 0, 1), 0));
+
+    const int nx = 7, ny = 5, N = nx * ny;
+
+    cusp::array2d<float, cusp::host_memory> C(N, 3);
+    cusp::array2d<float, cusp::host_memory> D(N, N, 0.0f);
+
+    for (int i = 0; i < N; i++)
+    {
+        C(i,0) = 4.0f + (i % 3);
+        C(i,1) = -1.0f - (i % 2);
+        C(i,2) = 0.5f * (i % 5);
+
+        D(i,i) = C(i,0);
+        if (i % nx > 0)  D(i,i - 1)  = C(i,1);
+        if (i / nx < ny - 1) D(i,i + nx) = C(i,2);
+    }
+
+    cusp::stencil_operator<float, MemorySpace> A(stencil, StencilIndex(nx, ny), C);
+
+    cusp::array1d<float, MemorySpace> x(N);
+    for (int i = 0; i < N; i++)
+        x[i] = (i * 3) % 7 - 3.0f;
+
+    cusp::array1d<float, MemorySpace> y(N);
+    cusp::multiply(A, x, y);
+
+    cusp::array2d<float, MemorySpace> M(D);
+    cusp::array1d<float, MemorySpace> expected(N);
+    cusp::multiply(M, x, expected);
+
+    ASSERT_ALMOST_EQUAL(y, expected);
+
+    // diagonal comes from the coefficients of the center point
+    cusp::array1d<float, MemorySpace> diagonal;
+    A.extract_diagonal(diagonal);
+
+    cusp::array1d<float, MemorySpace> expected_diagonal(N);
+    for (int i = 0; i < N; i++)
+        expected_diagonal[i] = C(i,0);
+
+    ASSERT_EQUAL(diagonal, expected_diagonal);
+
+    // coefficients of the wrong shape
+    cusp::array2d<float, cusp::host_memory> B(N, 2);
+    ASSERT_THROWS((cusp::stencil_operator<float, MemorySpace>(stencil, StencilIndex(nx, ny), B)), cusp::invalid_input_exception);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperatorVariableCoefficients);
+
+template <typename MemorySpace>
+void TestStencilOperatorSolve(void)
+{
+    typedef thrust::tuple<int,int>            StencilIndex;
+    typedef thrust::tuple<StencilIndex,float> StencilPoint;
+
+    cusp::array1d<StencilPoint, cusp::host_memory> stencil;
+    stencil.push_back(StencilPoint(StencilIndex( 0, -1), -1));
+    stencil.push_back(StencilPoint(StencilIndex(-1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  0),  4));
+    stencil.push_back(StencilPoint(StencilIndex( 1,  0), -1));
+    stencil.push_back(StencilPoint(StencilIndex( 0,  1), -1));
+
+    cusp::stencil_operator<float, MemorySpace> A(stencil, StencilIndex(16, 16));
+
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> r(A.num_rows);
+
+    // Krylov solver
+    cusp::default_monitor<float> monitor(b, 100, 1e-5);
+    cusp::krylov::cg(A, x, b, monitor);
+    ASSERT_EQUAL(monitor.converged(), true);
+
+    cusp::multiply(A, x, r);
+    cusp::blas::axpy(b, r, -1.0f);
+    ASSERT_EQUAL(cusp::blas::nrm2(r) < 1e-4 * cusp::blas::nrm2(b), true);
+
+    // smoother target, the diagonal is extracted from the stencil
+    cusp::relaxation::jacobi<float, MemorySpace> M(A, 2.0f / 3.0f);
+
+    cusp::blas::fill(x, 0.0f);
+    cusp::multiply(A, x, r);
+    cusp::blas::axpy(b, r, -1.0f);
+    float r0 = cusp::blas::nrm2(r);
+
+    for (int i = 0; i < 10; i++)
+        M(A, b, x);
+
+    cusp::multiply(A, x, r);
+    cusp::blas::axpy(b, r, -1.0f);
+    ASSERT_EQUAL(cusp::blas::nrm2(r) < r0, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestStencilOperatorSolve);
@@ -0,0 +1,242 @@
+#include <unittest/unittest.h>
+
+#include <cusp/symmetric_csr_matrix.h>
+
+#include <cusp/array2d.h>
+#include <cusp/blas.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/gallery/poisson.h>
+#include <cusp/krylov/cg.h>
+#include <cusp/multiply.h>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+template <typename MemorySpace>
+void TestSymmetricCsrMatrixPoisson(void)
+{
+    // large enough for the parallel host kernel
+    cusp::csr_matrix<int, float, MemorySpace> M;
+    cusp::gallery::poisson5pt(M, 150, 150);
+
+    cusp::symmetric_csr_matrix<int, float, MemorySpace> A(M);
+
+    ASSERT_EQUAL(A.num_rows,    M.num_rows);
+    ASSERT_EQUAL(A.num_cols,    M.num_cols);
+    ASSERT_EQUAL(A.num_entries, M.num_entries);
+    ASSERT_EQUAL(A.upper().num_entries, (M.num_entries + M.num_rows) / 2);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i * 7) % 11 - 5.0f;
+
+    cusp::array1d<float, MemorySpace> y(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> expected(A.num_rows);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(M, x, expected);
+
+    ASSERT_EQUAL(y, expected);
+
+    cusp::csr_matrix<int, float, MemorySpace> B;
+    A.expand(B);
+
+    ASSERT_EQUAL(B.row_offsets,    M.row_offsets);
+    ASSERT_EQUAL(B.column_indices, M.column_indices);
+    ASSERT_EQUAL(B.values,         M.values);
+
+    cusp::array1d<float, MemorySpace> diagonal;
+    cusp::array1d<float, MemorySpace> expected_diagonal(A.num_rows, 4.0f);
+    A.extract_diagonal(diagonal);
+
+    ASSERT_EQUAL(diagonal, expected_diagonal);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricCsrMatrixPoisson);
+
+template <typename MemorySpace>
+void TestSymmetricCsrMatrixSkewSymmetric(void)
+{
+    cusp::array2d<float, cusp::host_memory> M(4, 4, 0.0f);
+    M(0,1) =  1.0f; M(1,0) = -1.0f;
+    M(0,3) =  2.0f; M(3,0) = -2.0f;
+    M(1,2) = -3.0f; M(2,1) =  3.0f;
+    M(2,3) =  4.0f; M(3,2) = -4.0f;
+
+    cusp::symmetric_csr_matrix<int, float, MemorySpace> A(M, cusp::symmetry_skew_symmetric);
+
+    ASSERT_EQUAL(A.num_entries,         (size_t) 8);
+    ASSERT_EQUAL(A.upper().num_entries, (size_t) 4);
+
+    cusp::array2d<float, cusp::host_memory> B;
+    A.expand(B);
+
+    ASSERT_EQUAL(B == M, true);
+
+    cusp::array1d<float, MemorySpace> x(4);
+    x[0] = 1.0f; x[1] = -2.0f; x[2] = 3.0f; x[3] = 0.5f;
+
+    cusp::array1d<float, MemorySpace> y(4);
+    cusp::multiply(A, x, y);
+
+    cusp::array1d<float, cusp::host_memory> x_host(x);
+    cusp::array1d<float, cusp::host_memory> expected(4);
+    cusp::multiply(M, x_host, expected);
+
+    ASSERT_EQUAL(y, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricCsrMatrixSkewSymmetric);
+
+template <typename MemorySpace>
+void TestSymmetricCsrMatrixHermitian(void)
+{
+    typedef cusp::complex<float> ValueType;
+
+    cusp::array2d<ValueType, cusp::host_memory> M(3, 3, ValueType(0.0f, 0.0f));
+    M(0,0) = ValueType(2.0f,  0.0f);
+    M(0,1) = ValueType(1.0f,  1.0f); M(1,0) = ValueType(1.0f, -1.0f);
+    M(1,1) = ValueType(3.0f,  0.0f);
+    M(0,2) = ValueType(0.0f, -2.0f); M(2,0) = ValueType(0.0f,  2.0f);
+    M(2,2) = ValueType(1.0f,  0.0f);
+
+    cusp::symmetric_csr_matrix<int, ValueType, MemorySpace> A(M, cusp::symmetry_hermitian);
+
+    ASSERT_EQUAL(A.num_entries,         (size_t) 7);
+    ASSERT_EQUAL(A.upper().num_entries, (size_t) 5);
+
+    cusp::array2d<ValueType, cusp::host_memory> B;
+    A.expand(B);
+
+    ASSERT_EQUAL(B == M, true);
+
+    cusp::array1d<ValueType, MemorySpace> x(3);
+    x[0] = ValueType(1.0f, 0.0f); x[1] = ValueType(0.0f, 1.0f); x[2] = ValueType(-1.0f, 2.0f);
+
+    cusp::array1d<ValueType, MemorySpace> y(3);
+    cusp::multiply(A, x, y);
+
+    cusp::array1d<ValueType, cusp::host_memory> x_host(x);
+    cusp::array1d<ValueType, cusp::host_memory> expected(3);
+    cusp::multiply(M, x_host, expected);
+
+    ASSERT_EQUAL(y, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricCsrMatrixHermitian);
+
+template <typename MemorySpace>
+void TestSymmetricCsrMatrixCG(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> M;
+    cusp::gallery::poisson5pt(M, 20, 20);
+
+    cusp::symmetric_csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 0.0f);
+    cusp::array1d<float, MemorySpace> b(A.num_rows, 1.0f);
+
+    cusp::default_monitor<float> monitor(b, 200, 1e-5);
+    cusp::krylov::cg(A, x, b, monitor);
+
+    ASSERT_EQUAL(monitor.converged(), true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricCsrMatrixCG);
+
+void TestSymmetricCsrMatrixNonSquare(void)
+{
+    cusp::array2d<float, cusp::host_memory> M(2, 3, 1.0f);
+
+    ASSERT_THROWS((cusp::symmetric_csr_matrix<int, float, cusp::host_memory>(M)), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestSymmetricCsrMatrixNonSquare);
+
+void TestSymmetricCsrMatrixNestedParallel(void)
+{
+#if defined(_OPENMP)
+    cusp::csr_matrix<int, float, cusp::host_memory> M;
+    cusp::gallery::poisson5pt(M, 150, 150);
+
+    cusp::symmetric_csr_matrix<int, float, cusp::host_memory> A(M);
+
+    cusp::array1d<float, cusp::host_memory> x(A.num_rows);
+    for (size_t i = 0; i < A.num_rows; i++)
+        x[i] = (i * 7) % 11 - 5.0f;
+
+    cusp::array1d<float, cusp::host_memory> expected(A.num_rows);
+    cusp::multiply(M, x, expected);
+
+    // the kernel's team may get fewer threads than it asks for
+    const int dynamic = omp_get_dynamic();
+    omp_set_dynamic(1);
+
+    cusp::array1d<float, cusp::host_memory> y(A.num_rows, 1.0f);
+    cusp::multiply(A, x, y);
+
+    ASSERT_EQUAL(y, expected);
+
+    // nested inside an outer parallel region
+    cusp::array1d<float, cusp::host_memory> z(A.num_rows, 1.0f);
+
+#pragma omp parallel num_threads(2)
+    {
+#pragma omp single
+        cusp::multiply(A, x, z);
+    }
+
+    omp_set_dynamic(dynamic);
+
+    ASSERT_EQUAL(z, expected);
+#endif
+}
+DECLARE_UNITTEST(TestSymmetricCsrMatrixNestedParallel);
+
+void TestSymmetricCsrMatrixAssignUpperInvalid(void)
+{
+    cusp::symmetric_csr_matrix<int, float, cusp::host_memory> A;
+
+    // entry below the diagonal
+    cusp::csr_matrix<int, float, cusp::host_memory> L(2, 2, 2);
+    L.row_offsets[0] = 0; L.row_offsets[1] = 1; L.row_offsets[2] = 2;
+    L.column_indices[0] = 0; L.values[0] = 1.0f;
+    L.column_indices[1] = 0; L.values[1] = 2.0f;
+
+    ASSERT_THROWS(A.assign_upper(L), cusp::invalid_input_exception);
+
+    // row not sorted by column
+    cusp::csr_matrix<int, float, cusp::host_memory> U(2, 2, 3);
+    U.row_offsets[0] = 0; U.row_offsets[1] = 2; U.row_offsets[2] = 3;
+    U.column_indices[0] = 1; U.values[0] = 2.0f;
+    U.column_indices[1] = 0; U.values[1] = 1.0f;
+    U.column_indices[2] = 1; U.values[2] = 3.0f;
+
+    ASSERT_THROWS(A.assign_upper(U), cusp::invalid_input_exception);
+}
+DECLARE_UNITTEST(TestSymmetricCsrMatrixAssignUpperInvalid);
+
+template <typename MemorySpace>
+void TestSymmetricCsrMatrixAssignUpperNewValues(void)
+{
+    cusp::csr_matrix<int, float, MemorySpace> M;
+    cusp::gallery::poisson5pt(M, 10, 10);
+
+    cusp::symmetric_csr_matrix<int, float, MemorySpace> A(M);
+
+    cusp::array1d<float, MemorySpace> x(A.num_rows, 1.0f);
+    cusp::array1d<float, MemorySpace> y(A.num_rows);
+    cusp::array1d<float, MemorySpace> expected(A.num_rows);
+
+    cusp::multiply(A, x, y);
+
+    // same pattern, new values: the device copy must be rebuilt
+    cusp::csr_matrix<int, float, MemorySpace> U(A.upper());
+    cusp::blas::scal(U.values, 2.0f);
+    A.assign_upper(U);
+
+    cusp::blas::scal(M.values, 2.0f);
+
+    cusp::multiply(A, x, y);
+    cusp::multiply(M, x, expected);
+
+    ASSERT_EQUAL(y, expected);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestSymmetricCsrMatrixAssignUpperNewValues);
@@ -0,0 +1,72 @@
+#include <unittest/unittest.h>
+
+#include <cusp/detail/symmetric_eigen.h>
+
+#include <cmath>
+
+void TestSymmetricEigen(void)
+{
+    cusp::array2d<float, cusp::host_memory> A(3,3);
+    A(0,0) =  2.0;  A(0,1) = -1.0;  A(0,2) =  0.0;
+    A(1,0) = -1.0;  A(1,1) =  2.0;  A(1,2) = -1.0;
+    A(2,0) =  0.0;  A(2,1) = -1.0;  A(2,2) =  2.0;
+
+    cusp::array2d<float, cusp::host_memory> S(A);
+    cusp::array1d<float, cusp::host_memory> lambda;
+    cusp::array2d<float, cusp::host_memory> V;
+
+    cusp::detail::symmetric_eigen(S, lambda, V);
+
+    ASSERT_EQUAL(lambda.size(), 3);
+    ASSERT_EQUAL(std::fabs(lambda[0] - (2.0f - std::sqrt(2.0f))) < 1e-5, true);
+    ASSERT_EQUAL(std::fabs(lambda[1] -  2.0f)                    < 1e-5, true);
+    ASSERT_EQUAL(std::fabs(lambda[2] - (2.0f + std::sqrt(2.0f))) < 1e-5, true);
+
+    // check A V = V Lambda
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            float sum = 0;
+            for (int k = 0; k < 3; k++)
+                sum += A(i,k) * V(k,j);
+            ASSERT_EQUAL(std::fabs(sum - lambda[j] * V(i,j)) < 1e-5, true);
+        }
+}
+DECLARE_UNITTEST(TestSymmetricEigen);
+
+void TestGeneralizedSymmetricEigen(void)
+{
+    cusp::array2d<float, cusp::host_memory> A(3,3);
+    A(0,0) =  2.0;  A(0,1) = -1.0;  A(0,2) =  0.0;
+    A(1,0) = -1.0;  A(1,1) =  2.0;  A(1,2) = -1.0;
+    A(2,0) =  0.0;  A(2,1) = -1.0;  A(2,2) =  2.0;
+
+    cusp::array2d<float, cusp::host_memory> B(3,3, 0.0f);
+    B(0,0) = 1.0;  B(1,1) = 2.0;  B(2,2) = 4.0;
+
+    cusp::array1d<float, cusp::host_memory> lambda;
+    cusp::array2d<float, cusp::host_memory> Y;
+
+    ASSERT_EQUAL(cusp::detail::generalized_symmetric_eigen(A, B, lambda, Y), 0);
+
+    ASSERT_EQUAL(lambda[0] <= lambda[1] && lambda[1] <= lambda[2], true);
+
+    // check A Y = B Y Lambda
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+        {
+            float lhs = 0, rhs = 0;
+            for (int k = 0; k < 3; k++)
+            {
+                lhs += A(i,k) * Y(k,j);
+                rhs += B(i,k) * Y(k,j);
+            }
+            ASSERT_EQUAL(std::fabs(lhs - lambda[j] * rhs) < 1e-4, true);
+        }
+
+    // B must be positive definite
+    B(2,2) = -1.0;
+    ASSERT_EQUAL(cusp::detail::generalized_symmetric_eigen(A, B, lambda, Y), -1);
+}
+DECLARE_UNITTEST(TestGeneralizedSymmetricEigen);
+
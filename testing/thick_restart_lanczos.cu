@@ -0,0 +1,82 @@
+#include <unittest/unittest.h>
+
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/krylov/thick_restart_lanczos.h>
+
+#include <cmath>
+
+template <class MemorySpace>
+void TestThickRestartLanczos(void)
+{
+    // 1D Laplacian, eigenvalues 2 - 2 cos(k pi / (N + 1))
+    size_t N = 50;
+    cusp::array2d<float, MemorySpace> D(N, N, 0.0f);
+    for (size_t i = 0; i < N; i++)
+    {
+        D(i,i) = 2.0f;
+        if (i > 0)     D(i,i-1) = -1.0f;
+        if (i + 1 < N) D(i,i+1) = -1.0f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(D);
+
+    cusp::array1d<float, cusp::host_memory> S;
+    cusp::array2d<float, MemorySpace, cusp::column_major> X;
+
+    // a small basis forces several restarts
+    size_t num_converged = cusp::krylov::thick_restart_lanczos(A, S, X, 3, false, 12, 500, 1e-4);
+
+    ASSERT_EQUAL(num_converged, 3);
+    ASSERT_EQUAL(S.size(), 3);
+    ASSERT_EQUAL(X.num_rows, N);
+    ASSERT_EQUAL(X.num_cols, 3);
+
+    const float pi = 3.14159265358979f;
+
+    for (size_t k = 0; k < 3; k++)
+    {
+        float expected = 2.0f - 2.0f * std::cos((k + 1) * pi / (N + 1));
+        ASSERT_EQUAL(std::fabs(S[k] - expected) < 1e-4, true);
+
+        // check residual norm
+        cusp::array1d<float, MemorySpace> x(X.column(k));
+        cusp::array1d<float, MemorySpace> r(N);
+        cusp::multiply(A, x, r);
+        cusp::blas::axpy(x, r, -S[k]);
+
+        ASSERT_EQUAL(cusp::blas::nrm2(r) < 1e-3, true);
+        ASSERT_EQUAL(std::fabs(cusp::blas::nrm2(x) - 1.0f) < 1e-4, true);
+    }
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestThickRestartLanczos);
+
+
+template <class MemorySpace>
+void TestThickRestartLanczosLargest(void)
+{
+    size_t N = 50;
+    cusp::array2d<float, MemorySpace> D(N, N, 0.0f);
+    for (size_t i = 0; i < N; i++)
+    {
+        D(i,i) = 2.0f;
+        if (i > 0)     D(i,i-1) = -1.0f;
+        if (i + 1 < N) D(i,i+1) = -1.0f;
+    }
+
+    cusp::csr_matrix<int, float, MemorySpace> A(D);
+
+    cusp::array1d<float, cusp::host_memory> S;
+    cusp::array2d<float, MemorySpace, cusp::column_major> X;
+
+    size_t num_converged = cusp::krylov::thick_restart_lanczos(A, S, X, 2, true);
+
+    ASSERT_EQUAL(num_converged, 2);
+
+    const float pi = 3.14159265358979f;
+
+    ASSERT_EQUAL(std::fabs(S[0] - (2.0f - 2.0f * std::cos(N       * pi / (N + 1)))) < 1e-4, true);
+    ASSERT_EQUAL(std::fabs(S[1] - (2.0f - 2.0f * std::cos((N - 1) * pi / (N + 1)))) < 1e-4, true);
+}
+DECLARE_HOST_DEVICE_UNITTEST(TestThickRestartLanczosLargest);
+
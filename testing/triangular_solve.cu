@@ -0,0 +1,160 @@
+#include <unittest/unittest.h>
+
+#include <cusp/triangular_solve.h>
+
+#include <cusp/array2d.h>
+#include <cusp/coo_matrix.h>
+#include <cusp/csr_matrix.h>
+#include <cusp/multiply.h>
+#include <cusp/gallery/poisson.h>
+
+// the lower or upper triangle of A, with a unit diagonal if requested
+template <typename Matrix>
+void triangle(const Matrix& A, bool lower, bool unit_diagonal, Matrix& T)
+{
+    typedef typename Matrix::value_type ValueType;
+
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> C(A);
+    cusp::coo_matrix<int, ValueType, cusp::host_memory> D(C.num_rows, C.num_cols, C.num_entries);
+
+    size_t n = 0;
+    for (size_t k = 0; k < C.num_entries; k++)
+    {
+        int i = C.row_indices[k];
+        int j = C.column_indices[k];
+
+        if ((lower && j <= i) || (!lower && j >= i))
+        {
+            D.row_indices[n]    = i;
+            D.column_indices[n] = j;
+            D.values[n]         = (i == j && unit_diagonal) ? ValueType(1) : C.values[k];
+            n++;
+        }
+    }
+    D.resize(C.num_rows, C.num_cols, n);
+
+    T = D;
+}
+
+void TestTriangularSolver(void)
+{
+    cusp::csr_matrix<int, double, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 12, 9);
+
+    cusp::array1d<double, cusp::host_memory> x_true(A.num_rows);
+    for (size_t i = 0; i < x_true.size(); i++)
+        x_true[i] = (i % 7) - 3.0;
+
+    for (int lower = 0; lower < 2; lower++)
+    {
+        for (int unit = 0; unit < 2; unit++)
+        {
+            cusp::csr_matrix<int, double, cusp::host_memory> T;
+            triangle(A, lower == 1, unit == 1, T);
+
+            cusp::array1d<double, cusp::host_memory> b(A.num_rows);
+            cusp::multiply(T, x_true, b);
+
+            cusp::triangular_solve_algorithm algorithms[2] = { cusp::triangular_solve_level_set,
+                                                               cusp::triangular_solve_sync_free };
+
+            for (int a = 0; a < 2; a++)
+            {
+                for (int reorder = 0; reorder < 2; reorder++)
+                {
+                    // A holds both triangles, only the requested one is used
+                    cusp::triangular_solver<int, double> solver(A, lower == 1, unit == 1, algorithms[a], reorder == 1);
+
+                    ASSERT_EQUAL(solver.algorithm(), algorithms[a]);
+                    ASSERT_EQUAL(solver.num_levels(), 12 + 9 - 1);
+
+                    cusp::array1d<double, cusp::host_memory> x(A.num_rows, 0.0);
+                    solver.solve(b, x);
+                    ASSERT_ALMOST_EQUAL(x, x_true);
+
+                    // in place
+                    cusp::array1d<double, cusp::host_memory> y(b);
+                    solver.solve(y, y);
+                    ASSERT_EQUAL(y, x);
+                }
+            }
+        }
+    }
+}
+DECLARE_UNITTEST(TestTriangularSolver);
+
+template <typename Orientation>
+void _TestTriangularSolverMultipleRHS(void)
+{
+    cusp::csr_matrix<int, float, cusp::host_memory> A;
+    cusp::gallery::poisson5pt(A, 10, 10);
+
+    cusp::triangular_solver<int, float> solver(A, true);
+
+    cusp::array2d<float, cusp::host_memory, Orientation> B(A.num_rows, 3);
+    for (size_t i = 0; i < A.num_rows; i++)
+        for (size_t j = 0; j < 3; j++)
+            B(i,j) = float(i * (j + 1) % 5);
+
+    cusp::array2d<float, cusp::host_memory, Orientation> X(A.num_rows, 3);
+    solver.solve(B, X);
+
+    // each column matches a single right-hand side solve
+    for (size_t j = 0; j < 3; j++)
+    {
+        cusp::array1d<float, cusp::host_memory> b(A.num_rows);
+        cusp::array1d<float, cusp::host_memory> x(A.num_rows);
+
+        for (size_t i = 0; i < A.num_rows; i++)
+            b[i] = B(i,j);
+
+        solver.solve(b, x);
+
+        for (size_t i = 0; i < A.num_rows; i++)
+            ASSERT_EQUAL(X(i,j), x[i]);
+    }
+}
+void TestTriangularSolverMultipleRHS(void)
+{
+    _TestTriangularSolverMultipleRHS<cusp::row_major>();
+    _TestTriangularSolverMultipleRHS<cusp::column_major>();
+}
+DECLARE_UNITTEST(TestTriangularSolverMultipleRHS);
+
+void TestTriangularSolve(void)
+{
+    cusp::array2d<float, cusp::host_memory> D(3, 3, 0.0f);
+    D(0,0) = 2;
+    D(1,0) = 1; D(1,1) = 4;
+    D(2,0) = 3; D(2,1) = 2; D(2,2) = 1;
+
+    cusp::csr_matrix<int, float, cusp::host_memory> L(D);
+
+    cusp::array1d<float, cusp::host_memory> b(3);
+    b[0] = 2; b[1] = 9; b[2] = 10;
+
+    cusp::array1d<float, cusp::host_memory> x(3);
+    cusp::triangular_solve(L, x, b, true);
+
+    ASSERT_EQUAL(x[0], 1.0f);
+    ASSERT_EQUAL(x[1], 2.0f);
+    ASSERT_EQUAL(x[2], 3.0f);
+
+    // the upper triangle of L is its diagonal
+    cusp::triangular_solve(L, x, b, false);
+
+    ASSERT_EQUAL(x[0],  1.0f);
+    ASSERT_EQUAL(x[1],  2.25f);
+    ASSERT_EQUAL(x[2], 10.0f);
+
+    // a missing diagonal entry is an error unless the diagonal is implied
+    D(1,1) = 0;
+    cusp::csr_matrix<int, float, cusp::host_memory> S(D);
+    ASSERT_THROWS(cusp::triangular_solve(S, x, b, true), cusp::invalid_input_exception);
+
+    cusp::triangular_solve(S, x, b, true, true);
+    ASSERT_EQUAL(x[0], 2.0f);
+    ASSERT_EQUAL(x[1], 7.0f);
+    ASSERT_EQUAL(x[2], -10.0f);
+}
+DECLARE_UNITTEST(TestTriangularSolve);